@@ -0,0 +1,147 @@
+// apfloat_arithmetic_benchmark.cpp - Floating point arithmetic benchmark
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times APFloat addition, multiplication, division and fused multiply-add on
+// random normal values of each IEEE format, and conversions between them,
+// rounding to nearest.
+
+#include <bijou/APFloat.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bijou;
+
+namespace {
+
+/// Returns the time of one call of F in nanoseconds, as the best average over
+/// a few runs of at least a millisecond each.
+template<typename F>
+double measure(F &&f) {
+  using Clock = std::chrono::steady_clock;
+
+  unsigned iterations = 1;
+  double best = 0;
+  for (unsigned run = 0; run < 5;) {
+    auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+      f();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    if (elapsed.count() < 1e6) {
+      iterations *= 2;
+      continue;
+    }
+    double average = elapsed.count() / iterations;
+    if (run++ == 0 || average < best)
+      best = average;
+  }
+  return best;
+}
+
+} // end anonymous namespace
+
+int main() {
+  static const struct {
+    const char *Name;
+    const fltSemantics &(*Semantics)();
+  } Formats[] = {
+    {"half", APFloat::IEEEhalf},
+    {"bfloat", APFloat::BFloat},
+    {"single", APFloat::IEEEsingle},
+    {"double", APFloat::IEEEdouble},
+    {"x87", APFloat::x87DoubleExtended},
+    {"quad", APFloat::IEEEquad},
+  };
+  const unsigned NumValues = 256;
+  const APFloat::roundingMode RM = APFloat::rmNearestTiesToEven;
+
+  std::mt19937_64 rng(42);
+
+  printf("%8s %10s %10s %10s %10s\n", "format", "add ns", "mul ns", "div ns",
+         "fma ns");
+
+  for (const auto &Format : Formats) {
+    const fltSemantics &Sem = Format.Semantics();
+    unsigned Bits = APFloat::getSizeInBits(Sem);
+    std::vector<APFloat> Values;
+    while (Values.size() < NumValues + 2) {
+      uint64_t Words[2] = {rng(), rng()};
+      APFloat V(Sem, APInt(Bits, Words));
+      // Keep the results in range with exponents near zero.
+      if (V.isFiniteNonZero() && !V.isDenormal() && std::abs(ilogb(V)) < 8)
+        Values.push_back(V);
+    }
+
+    APFloat R(Sem);
+    auto time = [&](auto Operation) {
+      return measure([&] {
+        for (unsigned i = 0; i < NumValues; i++) {
+          R = Values[i];
+          Operation(R, Values[i + 1], Values[i + 2]);
+        }
+      }) / NumValues;
+    };
+    double add = time([&](APFloat &X, const APFloat &Y, const APFloat &) {
+      X.add(Y, RM);
+    });
+    double mul = time([&](APFloat &X, const APFloat &Y, const APFloat &) {
+      X.multiply(Y, RM);
+    });
+    double div = time([&](APFloat &X, const APFloat &Y, const APFloat &) {
+      X.divide(Y, RM);
+    });
+    double fma = time([&](APFloat &X, const APFloat &Y, const APFloat &Z) {
+      X.fusedMultiplyAdd(Y, Z, RM);
+    });
+    printf("%8s %10.1f %10.1f %10.1f %10.1f\n", Format.Name, add, mul, div,
+           fma);
+  }
+
+  // Conversions between the formats, including the copy of the source
+  // value.
+  static const struct {
+    const char *Name;
+    const fltSemantics &(*Semantics)();
+  } Conversions[] = {
+    {"half", APFloat::IEEEhalf},
+    {"bfloat", APFloat::BFloat},
+    {"single", APFloat::IEEEsingle},
+    {"double", APFloat::IEEEdouble},
+    {"x87", APFloat::x87DoubleExtended},
+    {"quad", APFloat::IEEEquad},
+  };
+  printf("\n%8s", "convert");
+  for (const auto &To : Conversions)
+    printf(" %7s ns", To.Name);
+  printf("\n");
+  for (const auto &From : Conversions) {
+    std::vector<APFloat> Values;
+    const fltSemantics &Sem = From.Semantics();
+    unsigned Bits = APFloat::getSizeInBits(Sem);
+    while (Values.size() < NumValues) {
+      uint64_t Words[2] = {rng(), rng()};
+      APFloat V(Sem, APInt(Bits, Words));
+      if (V.isFiniteNonZero() && !V.isDenormal() && std::abs(ilogb(V)) < 8)
+        Values.push_back(V);
+    }
+    printf("%8s", From.Name);
+    for (const auto &To : Conversions) {
+      const fltSemantics &ToSem = To.Semantics();
+      printf(" %10.1f", measure([&] {
+               for (unsigned i = 0; i < NumValues; i++) {
+                 APFloat R = Values[i];
+                 bool LosesInfo;
+                 R.convert(ToSem, RM, &LosesInfo);
+               }
+             }) / NumValues);
+    }
+    printf("\n");
+  }
+}
@@ -0,0 +1,93 @@
+// apfloat_tostring_benchmark.cpp - Floating point printing benchmark
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times APFloat::toString with the default format and with a precision of six
+// digits, for random finite values of each IEEE format.
+
+#include <bijou/APFloat.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bijou;
+
+namespace {
+
+/// Returns the time of one call of F in nanoseconds, as the best average over
+/// a few runs of at least a millisecond each.
+template<typename F>
+double measure(F &&f) {
+  using Clock = std::chrono::steady_clock;
+
+  unsigned iterations = 1;
+  double best = 0;
+  for (unsigned run = 0; run < 5;) {
+    auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+      f();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    if (elapsed.count() < 1e6) {
+      iterations *= 2;
+      continue;
+    }
+    double average = elapsed.count() / iterations;
+    if (run++ == 0 || average < best)
+      best = average;
+  }
+  return best;
+}
+
+} // end anonymous namespace
+
+int main() {
+  static const struct {
+    const char *Name;
+    const fltSemantics &(*Semantics)();
+  } Formats[] = {
+    {"half", APFloat::IEEEhalf},
+    {"bfloat", APFloat::BFloat},
+    {"single", APFloat::IEEEsingle},
+    {"double", APFloat::IEEEdouble},
+    {"x87", APFloat::x87DoubleExtended},
+    {"quad", APFloat::IEEEquad},
+  };
+  const unsigned NumValues = 256;
+
+  std::mt19937_64 rng(42);
+
+  printf("%8s %18s %18s\n", "format", "default ns", "precision 6 ns");
+
+  for (const auto &Format : Formats) {
+    const fltSemantics &Sem = Format.Semantics();
+    unsigned Bits = APFloat::getSizeInBits(Sem);
+    std::vector<APFloat> Values;
+    while (Values.size() < NumValues) {
+      uint64_t Words[2] = {rng(), rng()};
+      APFloat V(Sem, APInt(Bits, Words));
+      if (V.isFinite())
+        Values.push_back(V);
+    }
+
+    std::string S;
+    double shortest = measure([&] {
+      for (const APFloat &V : Values) {
+        S.clear();
+        V.toString(S);
+      }
+    });
+    double fixed = measure([&] {
+      for (const APFloat &V : Values) {
+        S.clear();
+        V.toString(S, 6);
+      }
+    });
+    printf("%8s %18.0f %18.0f\n", Format.Name, shortest / NumValues,
+           fixed / NumValues);
+  }
+}
@@ -0,0 +1,87 @@
+// apint_bitwise_benchmark.cpp - Word-wise APInt operation benchmark
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times the bitwise operators, equality and population count of APInts of a
+// range of widths. Below APINT_VECTOR_THRESHOLD words the operators and
+// equality loop inline in the header, from it on they call the vector
+// kernels chosen for the host CPU, so the rows around the threshold show
+// whether it is in the right place.
+
+#include <bijou/APInt.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace bijou;
+using WordType = APInt::WordType;
+
+namespace {
+
+/// Returns the time of one call of F in nanoseconds, as the best average over
+/// a few runs of at least a millisecond each.
+template<typename F>
+double measure(F &&f) {
+  using Clock = std::chrono::steady_clock;
+
+  unsigned iterations = 1;
+  double best = 0;
+  for (unsigned run = 0; run < 5;) {
+    auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+      f();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    if (elapsed.count() < 1e6) {
+      iterations *= 2;
+      continue;
+    }
+    double average = elapsed.count() / iterations;
+    if (run++ == 0 || average < best)
+      best = average;
+  }
+  return best;
+}
+
+APInt randomAPInt(std::mt19937_64 &rng, unsigned parts) {
+  std::vector<WordType> words(parts);
+  for (unsigned i = 0; i < parts; i++)
+    words[i] = rng();
+  return APInt(parts * APInt::APINT_BITS_PER_WORD, words);
+}
+
+} // end anonymous namespace
+
+int main() {
+  static const unsigned Sizes[] = {
+    2, 4, 7, 8, 16, 32, 64, 128, 256,
+  };
+
+  std::mt19937_64 rng(42);
+  volatile unsigned sink = 0;
+
+  printf("threshold: vector = %u words\n\n",
+         unsigned(APInt::APINT_VECTOR_THRESHOLD));
+  printf("%6s %7s %12s %12s %12s %12s\n",
+         "words", "bits", "&= |= ns", "^= ns", "== ns", "popcount ns");
+
+  for (unsigned parts : Sizes) {
+    APInt lhs = randomAPInt(rng, parts), rhs = randomAPInt(rng, parts);
+    APInt copy = lhs;
+
+    double andOr = measure([&] {
+      lhs &= rhs;
+      lhs |= copy;
+    });
+    double xorAssign = measure([&] { lhs ^= rhs; });
+    double equal = measure([&] { sink = sink + (lhs == copy); });
+    double population = measure([&] { sink = sink + lhs.countPopulation(); });
+
+    printf("%6u %7u %12.1f %12.1f %12.1f %12.1f\n",
+           parts, parts * APInt::APINT_BITS_PER_WORD, andOr, xorAssign, equal,
+           population);
+  }
+}
@@ -0,0 +1,82 @@
+// apint_fromstring_benchmark.cpp - Decimal parsing benchmark
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times parsing decimal strings into APInts for a range of bit widths,
+// against accumulating one digit at a time with a multiply and add per digit.
+
+#include <bijou/APInt.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bijou;
+
+namespace {
+
+APInt digitByDigit(unsigned Bits, const std::string &Str) {
+  APInt V(Bits, 0);
+  for (char C : Str) {
+    V *= 10;
+    V += C - '0';
+  }
+  return V;
+}
+
+/// Returns the time of one call of F in nanoseconds, as the best average over
+/// a few runs of at least a millisecond each.
+template<typename F>
+double measure(F &&f) {
+  using Clock = std::chrono::steady_clock;
+
+  unsigned iterations = 1;
+  double best = 0;
+  for (unsigned run = 0; run < 5;) {
+    auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+      f();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    if (elapsed.count() < 1e6) {
+      iterations *= 2;
+      continue;
+    }
+    double average = elapsed.count() / iterations;
+    if (run++ == 0 || average < best)
+      best = average;
+  }
+  return best;
+}
+
+} // end anonymous namespace
+
+int main() {
+  static const unsigned Widths[] = {
+    64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536,
+  };
+
+  std::mt19937_64 rng(42);
+
+  printf("%7s %8s %18s %18s\n", "bits", "digits", "digit by digit ns",
+         "fromString ns");
+
+  for (unsigned Bits : Widths) {
+    std::vector<uint64_t> Words(Bits / APInt::APINT_BITS_PER_WORD);
+    for (uint64_t &W : Words)
+      W = rng();
+    std::string Str = APInt(Bits, Words).toStringUnsigned(10);
+
+    if (APInt(Bits, Str, 10) != digitByDigit(Bits, Str)) {
+      fprintf(stderr, "mismatch at %u bits\n", Bits);
+      return 1;
+    }
+
+    double slow = measure([&] { (void)digitByDigit(Bits, Str); });
+    double fast = measure([&] { APInt(Bits, Str, 10); });
+    printf("%7u %8zu %18.0f %18.0f\n", Bits, Str.size(), slow, fast);
+  }
+}
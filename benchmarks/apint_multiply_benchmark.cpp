@@ -0,0 +1,100 @@
+// apint_multiply_benchmark.cpp - Multiplication algorithm crossover benchmark
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times one top level step of each multiplication algorithm for a range of
+// operand sizes. The sub-products below the top level always use the
+// algorithm the configured thresholds pick, so the size at which a column
+// starts to win is where its threshold should go. Set the thresholds with the
+// BIJOU_APINT_KARATSUBA_THRESHOLD and BIJOU_APINT_TOOM3_THRESHOLD CMake
+// variables.
+
+#include <bijou/APInt.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace bijou;
+using WordType = APInt::WordType;
+
+namespace {
+
+void schoolbookMultiply(WordType *dst, const WordType *lhs,
+                        const WordType *rhs, unsigned parts) {
+  APInt::tcSet(dst, 0, parts);
+  for (unsigned i = 0; i < parts; i++)
+    APInt::tcMultiplyPart(&dst[i], rhs, lhs[i], 0, parts, parts + 1, true);
+}
+
+/// Returns the time of one call of F in nanoseconds, as the best average over
+/// a few runs of at least a millisecond each.
+template<typename F>
+double measure(F &&f) {
+  using Clock = std::chrono::steady_clock;
+
+  unsigned iterations = 1;
+  double best = 0;
+  for (unsigned run = 0; run < 5;) {
+    auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+      f();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    if (elapsed.count() < 1e6) {
+      iterations *= 2;
+      continue;
+    }
+    double average = elapsed.count() / iterations;
+    if (run++ == 0 || average < best)
+      best = average;
+  }
+  return best;
+}
+
+} // end anonymous namespace
+
+int main() {
+  static const unsigned Sizes[] = {
+    8, 12, 16, 20, 24, 32, 48, 64, 80, 96, 128, 192, 256, 384, 512, 1024,
+  };
+
+  std::mt19937_64 rng(42);
+
+  printf("thresholds: karatsuba = %u, toom3 = %u words\n\n",
+         unsigned(APInt::APINT_KARATSUBA_THRESHOLD),
+         unsigned(APInt::APINT_TOOM3_THRESHOLD));
+  printf("%6s %7s %14s %14s %14s  %s\n",
+         "words", "bits", "schoolbook ns", "karatsuba ns", "toom3 ns",
+         "fastest");
+
+  for (unsigned parts : Sizes) {
+    std::vector<WordType> lhs(parts), rhs(parts), dst(2 * parts);
+    for (unsigned i = 0; i < parts; i++) {
+      lhs[i] = rng();
+      rhs[i] = rng();
+    }
+
+    double schoolbook = measure([&] {
+      schoolbookMultiply(dst.data(), lhs.data(), rhs.data(), parts);
+    });
+    double karatsuba = measure([&] {
+      APInt::tcKaratsubaMultiply(dst.data(), lhs.data(), rhs.data(), parts);
+    });
+    double toom3 = measure([&] {
+      APInt::tcToom3Multiply(dst.data(), lhs.data(), rhs.data(), parts);
+    });
+
+    const char *fastest = "schoolbook";
+    if (karatsuba < schoolbook && karatsuba <= toom3)
+      fastest = "karatsuba";
+    else if (toom3 < schoolbook && toom3 < karatsuba)
+      fastest = "toom3";
+
+    printf("%6u %7u %14.0f %14.0f %14.0f  %s\n",
+           parts, parts * APInt::APINT_BITS_PER_WORD, schoolbook, karatsuba,
+           toom3, fastest);
+  }
+}
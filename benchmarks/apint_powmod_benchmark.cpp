@@ -0,0 +1,92 @@
+// apint_powmod_benchmark.cpp - Modular exponentiation benchmark
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times a modular exponentiation with a full sized exponent, once with
+// MontgomeryContext::powmod and once by square and multiply with APInt
+// multiplication followed by urem.
+
+#include <bijou/MontgomeryContext.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+using namespace bijou;
+
+namespace {
+
+/// Returns the time of one call of F in nanoseconds, as the best average over
+/// a few runs of at least a millisecond each.
+template<typename F>
+double measure(F &&f) {
+  using Clock = std::chrono::steady_clock;
+
+  unsigned iterations = 1;
+  double best = 0;
+  for (unsigned run = 0; run < 5;) {
+    auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+      f();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    if (elapsed.count() < 1e6) {
+      iterations *= 2;
+      continue;
+    }
+    double average = elapsed.count() / iterations;
+    if (run++ == 0 || average < best)
+      best = average;
+  }
+  return best;
+}
+
+APInt randomAPInt(std::mt19937_64 &rng, unsigned bits) {
+  std::vector<uint64_t> words(APInt::getNumWords(bits));
+  for (uint64_t &word : words)
+    word = rng();
+  return APInt(bits, words);
+}
+
+APInt naivePowMod(const APInt &base, const APInt &exp, const APInt &mod) {
+  unsigned bits = mod.getBitWidth();
+  APInt wideMod = mod.zext(2 * bits);
+  APInt result = APInt(2 * bits, 1);
+  APInt wideBase = base.zext(2 * bits);
+  for (unsigned i = exp.getActiveBits(); i-- > 0;) {
+    result = (result * result).urem(wideMod);
+    if (exp[i])
+      result = (result * wideBase).urem(wideMod);
+  }
+  return result.trunc(bits);
+}
+
+} // end anonymous namespace
+
+int main() {
+  static const unsigned Sizes[] = {256, 512, 1024, 2048, 4096};
+
+  std::mt19937_64 rng(42);
+
+  printf("%6s %14s %14s %8s\n", "bits", "naive ns", "montgomery ns", "speedup");
+
+  for (unsigned bits : Sizes) {
+    APInt mod = randomAPInt(rng, bits);
+    mod.setBit(0);
+    mod.setBit(bits - 1);
+    APInt base = randomAPInt(rng, bits).urem(mod);
+    APInt exp = randomAPInt(rng, bits);
+
+    MontgomeryContext ctx(mod);
+    APInt result(bits, 0);
+
+    double naive = measure([&] { result = naivePowMod(base, exp, mod); });
+    double montgomery = measure([&] { ctx.powmod(result, base, exp); });
+
+    printf("%6u %14.0f %14.0f %8.1f\n", bits, naive, montgomery,
+           naive / montgomery);
+  }
+}
@@ -13,6 +13,18 @@
 //   * Removed unused LLVM helper APIs (such as FoldingSetNode, DenseMap)
 //   * Added APIs to print classes defined in this file with C stdio routines.
 //   * Changed doxygen comments to consistenly use '@' command prefix.
+//   * Added toChars, fromChars and getMaxChars, which convert to and from
+//     caller provided character buffers.
+//   * Optionally compute IEEEsingle, IEEEdouble and x87DoubleExtended
+//     arithmetic and conversions with the host FPU, IEEEquad arithmetic with
+//     the compiler's quad routines, and IEEEhalf and BFloat arithmetic and
+//     conversions in float, where they give the same result and status.
+//   * Store significands of up to two parts inline, and use stack scratch
+//     space for the multiplication, division and fused multiply-add of the
+//     built-in semantics.
+//   * Compute the next value, integral rounding and integer conversion of
+//     PPCDoubleDouble exactly on the pair of doubles, and convert between
+//     the pair and the legacy semantics without bitcasts through APInt.
 //
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
@@ -27,6 +39,7 @@
 #ifndef BIJOU_ADT_APFLOAT_H
 #define BIJOU_ADT_APFLOAT_H
 
+#include <charconv>                // for to_chars_result, from_chars_result
 #include <functional>              // for hash
 #include <memory>                  // for unique_ptr
 #include <utility>                 // for forward, move
@@ -266,6 +279,11 @@ struct APFloatBase {
 
 namespace detail {
 
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+/// The operations IEEEFloat can compute with host floating point types.
+enum class HostOperation { Add, Subtract, Multiply, Divide, FusedMultiplyAdd };
+#endif
+
 class IEEEFloat final : public APFloatBase {
 public:
   /// @name Constructors
@@ -284,7 +302,7 @@ public:
   /// @}
 
   /// Returns whether this instance allocated memory.
-  bool needsCleanup() const { return partCount() > 1; }
+  bool needsCleanup() const { return partCount() > InlineParts; }
 
   /// @name Convenience "constructors"
   /// @{
@@ -458,6 +476,17 @@ public:
   void toString(std::string &Str, unsigned FormatPrecision = 0,
                 unsigned FormatMaxPadding = 3, bool TruncateZero = true) const;
 
+  /// Writes the same characters as toString to [First, Last), without
+  /// allocating unless FormatPrecision asks for more digits than fit on the
+  /// stack.
+  ///
+  /// @returns {end of the output, errc()} on success, or
+  /// {Last, errc::value_too_large} if the output does not fit.
+  std::to_chars_result toChars(char *First, char *Last,
+                               unsigned FormatPrecision = 0,
+                               unsigned FormatMaxPadding = 3,
+                               bool TruncateZero = true) const;
+
   /// If this value has an exact multiplicative inverse, store it in inv and
   /// return true.
   bool getExactInverse(APFloat *inv) const;
@@ -515,6 +544,7 @@ private:
   integerPart addSignificand(const IEEEFloat &);
   integerPart subtractSignificand(const IEEEFloat &, integerPart);
   lostFraction addOrSubtractSignificand(const IEEEFloat &, bool subtract);
+  lostFraction addOrSubtractSignificand(IEEEFloat &&, bool subtract);
   lostFraction multiplySignificand(const IEEEFloat &, IEEEFloat);
   lostFraction multiplySignificand(const IEEEFloat&);
   lostFraction divideSignificand(const IEEEFloat &);
@@ -562,6 +592,23 @@ private:
                                  roundingMode) const;
   opStatus roundSignificandWithExponent(const integerPart *, unsigned int, int,
                                         roundingMode);
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+  bool hostArithmetic(HostOperation, const IEEEFloat &, const IEEEFloat *,
+                      roundingMode, opStatus &);
+  template <typename T>
+  bool hostArithmetic(HostOperation, const IEEEFloat &, const IEEEFloat *,
+                      roundingMode, opStatus &);
+  bool hostConvert(const fltSemantics &, roundingMode, bool *, opStatus &);
+  template <typename From, typename To>
+  bool hostConvert(const fltSemantics &, roundingMode, bool *, opStatus &);
+  bool promotedArithmetic(HostOperation, const IEEEFloat &, const IEEEFloat *,
+                          roundingMode, opStatus &);
+  bool promotedConvert(const fltSemantics &, roundingMode, bool *, opStatus &);
+  template <typename T> T toHost() const;
+  template <typename T> void initFromHost(T, int);
+  template <typename T>
+  bool roundFromHost(T, int, const fltSemantics &, roundingMode, opStatus &);
+#endif
   ExponentType exponentNaN() const;
   ExponentType exponentInf() const;
   ExponentType exponentZero() const;
@@ -592,11 +639,15 @@ private:
   /// The semantics that this value obeys.
   const fltSemantics *semantics;
 
+  /// The number of significand parts stored inline, which suffices for all
+  /// the built-in semantics.
+  static constexpr unsigned InlineParts = 2;
+
   /// A binary fraction with an explicit integer bit.
   ///
   /// The significand must be at least one bit wider than the target precision.
   union Significand {
-    integerPart part;
+    integerPart part[InlineParts];
     integerPart *parts;
   } significand;
 
@@ -632,6 +683,12 @@ class DoubleAPFloat final : public APFloatBase {
   opStatus addWithSpecial(const DoubleAPFloat &LHS, const DoubleAPFloat &RHS,
                           DoubleAPFloat &Out, roundingMode RM);
 
+  /// Converts to and from the legacy 106-bit semantics for the operations
+  /// that are not computed on the pair, with the same rounding as the bitcast
+  /// through APInt.
+  IEEEFloat toLegacy() const;
+  void assignLegacy(const IEEEFloat &Legacy);
+
 public:
   DoubleAPFloat(const fltSemantics &S);
   DoubleAPFloat(const fltSemantics &S, uninitializedTag);
@@ -706,6 +763,10 @@ public:
 
   void toString(std::string &Str, unsigned FormatPrecision,
                 unsigned FormatMaxPadding, bool TruncateZero = true) const;
+  std::to_chars_result toChars(char *First, char *Last,
+                               unsigned FormatPrecision,
+                               unsigned FormatMaxPadding,
+                               bool TruncateZero = true) const;
 
   bool getExactInverse(APFloat *inv) const;
 
@@ -1257,6 +1318,38 @@ public:
         toString(Str, FormatPrecision, FormatMaxPadding, TruncateZero));
   }
 
+  /// Writes the same characters as toString to [First, Last). For the
+  /// built-in IEEE semantics this does not allocate.
+  ///
+  /// @returns {end of the output, errc()} on success, or
+  /// {Last, errc::value_too_large} if the output does not fit.
+  std::to_chars_result toChars(char *First, char *Last,
+                               unsigned FormatPrecision = 0,
+                               unsigned FormatMaxPadding = 3,
+                               bool TruncateZero = true) const {
+    APFLOAT_DISPATCH_ON_SEMANTICS(toChars(First, Last, FormatPrecision,
+                                          FormatMaxPadding, TruncateZero));
+  }
+
+  /// @returns a buffer size that is large enough for toChars to format any
+  /// value of the given semantics with the given format options.
+  static unsigned getMaxChars(const fltSemantics &Sem,
+                              unsigned FormatPrecision = 0,
+                              unsigned FormatMaxPadding = 3);
+
+  /// Parses a number in any syntax convertFromString accepts from the start
+  /// of [First, Last), rounding it to this value's semantics with RM. Unlike
+  /// convertFromString, the number may be followed by other characters. For
+  /// the built-in IEEE semantics this does not allocate, unless the number
+  /// has more than about a hundred significant digits.
+  ///
+  /// @returns {end of the number, errc()} on success,
+  /// {First, errc::invalid_argument} if there is no number, or
+  /// {end of the number, errc::result_out_of_range} if it overflows or
+  /// underflows to zero. The value is left unchanged on error.
+  std::from_chars_result fromChars(const char *First, const char *Last,
+                                   roundingMode RM = rmNearestTiesToEven);
+
 #ifdef BIJOU_USE_IOSTREAM
   void print(std::iostream &) const;
 #endif
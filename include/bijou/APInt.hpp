@@ -13,6 +13,20 @@
 //   * Removed uses of some LLVM helper APIs (such as FoldingSetNode, DenseMap)
 //   * Added APIs to print classes defined in this file with C stdio routines.
 //   * Changed doxygen comments to consistenly use '@' command prefix.
+//   * Store multi-word values of up to BIJOU_APINT_INLINE_WORDS words inline.
+//   * Added Karatsuba and Toom-3 multiplication for wide values.
+//   * Allocate word buffers with allocateWords, which can pool them per thread.
+//   * Made APInt usable in constant expressions, with transient allocation for
+//     values wider than the inline words.
+//   * Run the word-wise bitwise, population count and comparison slow cases
+//     with AVX2 or AVX-512 kernels, selected by the host CPU at run time.
+//   * Run the carry chains of tcAdd, tcSubtract and tcMultiplyPart with
+//     out-of-line kernels, using MULX, ADCX and ADOX if the host CPU has them.
+//   * Added sqr() and tcSquare, which compute each cross product once.
+//   * Jump from tcAdd, tcSubtract, tcShiftLeft, tcShiftRight, tcCompare and
+//     tcMultiply to fully unrolled kernels for two to four words.
+//   * Added toChars, fromChars and getMaxChars, which convert to and from
+//     caller provided character buffers.
 //
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
@@ -27,19 +41,22 @@
 #ifndef BIJOU_APINT_HPP
 #define BIJOU_APINT_HPP
 
+#include <algorithm>              // for copy_n, fill_n, min, equal
+#include <charconv>               // for to_chars_result, from_chars_result
 #include <functional>             // for hash
+#include <type_traits>            // for is_constant_evaluated
 #include <utility>                // for move
 #include <cassert>                // for assert
 #include <climits>                // for CHAR_BIT
 #include <cstdint>                // for uint64_t, int64_t, uint8_t, UINT64_MAX
 #include <cstdio>                 // for FILE
 #include <cstddef>                // for size_t
-#include <cstring>                // for memset, memcpy
+#include <cstring>                // for memcpy
 #include <string>                 // for string
 #include <optional>               // for optional
 #include <span>                   // for span
 #include <string_view>            // for string_view
-#include "bijou/bijou-config.h"   // for BIJOU_USE_IOSTREAM
+#include "bijou/bijou-config.h"   // for BIJOU_USE_IOSTREAM, BIJOU_APINT_INLINE...
 
 #ifdef BIJOU_USE_IOSTREAM
 #  include <iosfwd>
@@ -47,12 +64,13 @@
 
 #include "bijou/Compiler.hpp"     // for BIJOU_READONLY, BIJOU_UNLIKELY, ...
 #include "bijou/MathExtras.hpp"   // for SignExtend64, BitsToDouble, BitsToF...
+#include "bijou/WordAllocator.hpp" // for allocateWords, deallocateWords
 
 namespace bijou {
 
 class APInt;
 
-inline APInt operator-(APInt);
+constexpr APInt operator-(APInt);
 
 //===----------------------------------------------------------------------===//
 //                              APInt Class
@@ -87,6 +105,13 @@ inline APInt operator-(APInt);
 ///     shifts are defined, but sign extension and ashr is not.  Zero bit values
 ///     compare and hash equal to themselves, and countLeadingZeros returns 0.
 ///
+/// Construction, the arithmetic, bitwise, shift and comparison operations and
+/// the tc* bignum helpers are constexpr, so that tables of APInt constants
+/// can be built at compile time. Values wider than APINT_INLINE_WORDS words
+/// allocate transiently, so they may be used during constant evaluation but
+/// not be the value of a constexpr variable. String conversion, printing and
+/// the conversions to and from floating point are not constexpr.
+///
 class [[nodiscard]] APInt {
 public:
   typedef uint64_t WordType;
@@ -96,9 +121,37 @@ public:
     /// Byte size of a word.
     APINT_WORD_SIZE = sizeof(WordType),
     /// Bits in a word.
-    APINT_BITS_PER_WORD = APINT_WORD_SIZE * CHAR_BIT
+    APINT_BITS_PER_WORD = APINT_WORD_SIZE * CHAR_BIT,
+    /// Number of words stored inline, without a heap allocation.
+    APINT_INLINE_WORDS = BIJOU_APINT_INLINE_WORDS,
+    /// Operand size in words from which multiplication uses Karatsuba's
+    /// algorithm instead of the schoolbook one.
+    APINT_KARATSUBA_THRESHOLD = BIJOU_APINT_KARATSUBA_THRESHOLD,
+    /// Operand size in words from which multiplication uses the Toom-Cook
+    /// 3-way algorithm instead of Karatsuba's.
+    APINT_TOOM3_THRESHOLD = BIJOU_APINT_TOOM3_THRESHOLD,
+    /// Largest word count with fully unrolled tcAdd, tcSubtract, tcShiftLeft,
+    /// tcShiftRight, tcCompare and tcMultiply kernels.
+    APINT_MAX_UNROLLED_PARTS = 4,
+    /// Operand size in words from which tcAdd and tcSubtract call the
+    /// out-of-line carry chain kernels instead of looping inline.
+    APINT_CARRY_CHAIN_THRESHOLD = APINT_MAX_UNROLLED_PARTS + 1,
+    /// Operand size in words from which the word-wise slow cases of the
+    /// bitwise operators and comparisons call the out-of-line vector kernels
+    /// instead of looping inline. Population count always calls them, as the
+    /// word loop has no hardware popcount without target flags.
+    APINT_VECTOR_THRESHOLD = 8,
   };
 
+  static_assert(APINT_INLINE_WORDS >= 1,
+                "APInt must store at least one word inline");
+  static_assert(APINT_MAX_UNROLLED_PARTS == 4,
+                "The tc* entry points switch over two to four words");
+  static_assert(APINT_KARATSUBA_THRESHOLD >= 2,
+                "Karatsuba multiplication needs at least two words");
+  static_assert(APINT_TOOM3_THRESHOLD >= 5,
+                "Toom-3 multiplication needs at least five words");
+
   enum class Rounding {
     DOWN,
     TOWARD_ZERO,
@@ -120,7 +173,7 @@ public:
   /// @param numBits the bit width of the constructed APInt
   /// @param val the initial value of the APInt
   /// @param isSigned how to treat signedness of val
-  APInt(unsigned numBits, uint64_t val, bool isSigned = false)
+  constexpr APInt(unsigned numBits, uint64_t val, bool isSigned = false)
       : BitWidth(numBits) {
     if (isSingleWord()) {
       U.VAL = val;
@@ -137,7 +190,7 @@ public:
   ///
   /// @param numBits the bit width of the constructed APInt
   /// @param bigVal a sequence of words to form the initial value of the APInt
-  APInt(unsigned numBits, std::span<const uint64_t> bigVal);
+  constexpr APInt(unsigned numBits, std::span<const uint64_t> bigVal);
 
   /// Equivalent to APInt(numBits, ArrayRef<uint64_t>(bigVal, numWords)), but
   /// deprecated because this constructor is prone to ambiguity with the
@@ -146,7 +199,7 @@ public:
   /// If this overload is ever deleted, care should be taken to prevent calls
   /// from being incorrectly captured by the APInt(unsigned, uint64_t, bool)
   /// constructor.
-  APInt(unsigned numBits, unsigned numWords, const uint64_t bigVal[]);
+  constexpr APInt(unsigned numBits, unsigned numWords, const uint64_t bigVal[]);
 
   /// Construct an APInt from a string representation.
   ///
@@ -162,26 +215,29 @@ public:
   APInt(unsigned numBits, std::string_view str, uint8_t radix);
 
   /// Default constructor that creates an APInt with a 1-bit zero value.
-  explicit APInt() : BitWidth(1) { U.VAL = 0; }
+  explicit constexpr APInt() : BitWidth(1) { U.VAL = 0; }
 
   /// Copy Constructor.
-  APInt(const APInt &that) : BitWidth(that.BitWidth) {
-    if (isSingleWord())
-      U.VAL = that.U.VAL;
+  constexpr APInt(const APInt &that) : BitWidth(that.BitWidth) {
+    if (!needsCleanup())
+      U = that.U;
     else
       initSlowCase(that);
   }
 
   /// Move Constructor.
-  APInt(APInt &&that) : BitWidth(that.BitWidth) {
-    memcpy(&U, &that.U, sizeof(U));
+  constexpr APInt(APInt &&that) : BitWidth(that.BitWidth) {
+    if (std::is_constant_evaluated())
+      U = that.U;
+    else
+      memcpy(&U, &that.U, sizeof(U));
     that.BitWidth = 0;
   }
 
   /// Destructor.
-  ~APInt() {
+  constexpr ~APInt() {
     if (needsCleanup())
-      delete[] U.pVal;
+      freeMemory(U.pVal, getNumWords());
   }
 
   /// @}
@@ -189,31 +245,35 @@ public:
   /// @{
 
   /// Get the '0' value for the specified bit-width.
-  static APInt getZero(unsigned numBits) { return APInt(numBits, 0); }
+  static constexpr APInt getZero(unsigned numBits) { return APInt(numBits, 0); }
 
   /// NOTE: This is soft-deprecated.  Please use `getZero()` instead.
-  static APInt getNullValue(unsigned numBits) { return getZero(numBits); }
+  static constexpr APInt getNullValue(unsigned numBits) {
+    return getZero(numBits);
+  }
 
   /// Return an APInt zero bits wide.
-  static APInt getZeroWidth() { return getZero(0); }
+  static constexpr APInt getZeroWidth() { return getZero(0); }
 
   /// Gets maximum unsigned value of APInt for specific bit width.
-  static APInt getMaxValue(unsigned numBits) {
+  static constexpr APInt getMaxValue(unsigned numBits) {
     return getAllOnesValue(numBits);
   }
 
   /// Gets maximum signed value of APInt for a specific bit width.
-  static APInt getSignedMaxValue(unsigned numBits) {
+  static constexpr APInt getSignedMaxValue(unsigned numBits) {
     APInt API = getAllOnesValue(numBits);
     API.clearBit(numBits - 1);
     return API;
   }
 
   /// Gets minimum unsigned value of APInt for a specific bit width.
-  static APInt getMinValue(unsigned numBits) { return APInt(numBits, 0); }
+  static constexpr APInt getMinValue(unsigned numBits) {
+    return APInt(numBits, 0);
+  }
 
   /// Gets minimum signed value of APInt for a specific bit width.
-  static APInt getSignedMinValue(unsigned numBits) {
+  static constexpr APInt getSignedMinValue(unsigned numBits) {
     APInt API(numBits, 0);
     API.setBit(numBits - 1);
     return API;
@@ -223,20 +283,22 @@ public:
   ///
   /// This is just a wrapper function of getSignedMinValue(), and it helps code
   /// readability when we want to get a SignMask.
-  static APInt getSignMask(unsigned BitWidth) {
+  static constexpr APInt getSignMask(unsigned BitWidth) {
     return getSignedMinValue(BitWidth);
   }
 
   /// Return an APInt of a specified width with all bits set.
-  static APInt getAllOnes(unsigned numBits) {
+  static constexpr APInt getAllOnes(unsigned numBits) {
     return APInt(numBits, WORDTYPE_MAX, true);
   }
 
   /// NOTE: This is soft-deprecated.  Please use `getAllOnes()` instead.
-  static APInt getAllOnesValue(unsigned numBits) { return getAllOnes(numBits); }
+  static constexpr APInt getAllOnesValue(unsigned numBits) {
+    return getAllOnes(numBits);
+  }
 
   /// Return an APInt with exactly one bit set in the result.
-  static APInt getOneBitSet(unsigned numBits, unsigned BitNo) {
+  static constexpr APInt getOneBitSet(unsigned numBits, unsigned BitNo) {
     APInt Res(numBits, 0);
     Res.setBit(BitNo);
     return Res;
@@ -255,7 +317,8 @@ public:
   /// @param hiBit the index of the highest bit set.
   ///
   /// @returns An APInt value with the requested bits set.
-  static APInt getBitsSet(unsigned numBits, unsigned loBit, unsigned hiBit) {
+  static constexpr APInt getBitsSet(unsigned numBits, unsigned loBit,
+                                    unsigned hiBit) {
     APInt Res(numBits, 0);
     Res.setBits(loBit, hiBit);
     return Res;
@@ -267,8 +330,8 @@ public:
   /// with parameters (32, 28, 4), you would get 0xF000000F.
   /// If @p hiBit is equal to @p loBit, you would get a result with all bits
   /// set.
-  static APInt getBitsSetWithWrap(unsigned numBits, unsigned loBit,
-                                  unsigned hiBit) {
+  static constexpr APInt getBitsSetWithWrap(unsigned numBits, unsigned loBit,
+                                            unsigned hiBit) {
     APInt Res(numBits, 0);
     Res.setBitsWithWrap(loBit, hiBit);
     return Res;
@@ -283,7 +346,7 @@ public:
   /// @param loBit the index of the lowest bit to set.
   ///
   /// @returns An APInt value with the requested bits set.
-  static APInt getBitsSetFrom(unsigned numBits, unsigned loBit) {
+  static constexpr APInt getBitsSetFrom(unsigned numBits, unsigned loBit) {
     APInt Res(numBits, 0);
     Res.setBitsFrom(loBit);
     return Res;
@@ -293,7 +356,7 @@ public:
   ///
   /// @param numBits the bitwidth of the result
   /// @param hiBitsSet the number of high-order bits set in the result.
-  static APInt getHighBitsSet(unsigned numBits, unsigned hiBitsSet) {
+  static constexpr APInt getHighBitsSet(unsigned numBits, unsigned hiBitsSet) {
     APInt Res(numBits, 0);
     Res.setHighBits(hiBitsSet);
     return Res;
@@ -303,7 +366,7 @@ public:
   ///
   /// @param numBits the bitwidth of the result
   /// @param loBitsSet the number of low-order bits set in the result.
-  static APInt getLowBitsSet(unsigned numBits, unsigned loBitsSet) {
+  static constexpr APInt getLowBitsSet(unsigned numBits, unsigned loBitsSet) {
     APInt Res(numBits, 0);
     Res.setLowBits(loBitsSet);
     return Res;
@@ -319,33 +382,35 @@ public:
   /// Determine if this APInt just has one word to store value.
   ///
   /// @returns true if the number of bits <= 64, false otherwise.
-  bool isSingleWord() const { return BitWidth <= APINT_BITS_PER_WORD; }
+  constexpr bool isSingleWord() const {
+    return BitWidth <= APINT_BITS_PER_WORD;
+  }
 
   /// Determine sign of this APInt.
   ///
   /// This tests the high bit of this APInt to determine if it is set.
   ///
   /// @returns true if this APInt is negative, false otherwise
-  bool isNegative() const { return (*this)[BitWidth - 1]; }
+  constexpr bool isNegative() const { return (*this)[BitWidth - 1]; }
 
   /// Determine if this APInt Value is non-negative (>= 0)
   ///
   /// This tests the high bit of the APInt to determine if it is unset.
-  bool isNonNegative() const { return !isNegative(); }
+  constexpr bool isNonNegative() const { return !isNegative(); }
 
   /// Determine if sign bit of this APInt is set.
   ///
   /// This tests the high bit of this APInt to determine if it is set.
   ///
   /// @returns true if this APInt has its sign bit set, false otherwise.
-  bool isSignBitSet() const { return (*this)[BitWidth - 1]; }
+  constexpr bool isSignBitSet() const { return (*this)[BitWidth - 1]; }
 
   /// Determine if sign bit of this APInt is clear.
   ///
   /// This tests the high bit of this APInt to determine if it is clear.
   ///
   /// @returns true if this APInt has its sign bit clear, false otherwise.
-  bool isSignBitClear() const { return !isSignBitSet(); }
+  constexpr bool isSignBitClear() const { return !isSignBitSet(); }
 
   /// Determine if this APInt Value is positive.
   ///
@@ -353,15 +418,17 @@ public:
   /// that 0 is not a positive value.
   ///
   /// @returns true if this APInt is positive.
-  bool isStrictlyPositive() const { return isNonNegative() && !isZero(); }
+  constexpr bool isStrictlyPositive() const {
+    return isNonNegative() && !isZero();
+  }
 
   /// Determine if this APInt Value is non-positive (<= 0).
   ///
   /// @returns true if this APInt is non-positive.
-  bool isNonPositive() const { return !isStrictlyPositive(); }
+  constexpr bool isNonPositive() const { return !isStrictlyPositive(); }
 
   /// Determine if all bits are set.
-  bool isAllOnes() const {
+  constexpr bool isAllOnes() const {
     if (isSingleWord()) {
       // Calculate the shift amount, handling the zero-bit wide case without UB.
       unsigned ShiftAmt =
@@ -372,41 +439,41 @@ public:
   }
 
   /// NOTE: This is soft-deprecated.  Please use `isAllOnes()` instead.
-  bool isAllOnesValue() const { return isAllOnes(); }
+  constexpr bool isAllOnesValue() const { return isAllOnes(); }
 
   /// Determine if this value is zero, i.e. all bits are clear.
-  bool isZero() const {
+  constexpr bool isZero() const {
     if (isSingleWord())
       return U.VAL == 0;
     return countLeadingZerosSlowCase() == BitWidth;
   }
 
   /// NOTE: This is soft-deprecated.  Please use `isZero()` instead.
-  bool isNullValue() const { return isZero(); }
+  constexpr bool isNullValue() const { return isZero(); }
 
   /// Determine if this is a value of 1.
   ///
   /// This checks to see if the value of this APInt is one.
-  bool isOne() const {
+  constexpr bool isOne() const {
     if (isSingleWord())
       return U.VAL == 1;
     return countLeadingZerosSlowCase() == BitWidth - 1;
   }
 
   /// NOTE: This is soft-deprecated.  Please use `isOne()` instead.
-  bool isOneValue() const { return isOne(); }
+  constexpr bool isOneValue() const { return isOne(); }
 
   /// Determine if this is the largest unsigned value.
   ///
   /// This checks to see if the value of this APInt is the maximum unsigned
   /// value for the APInt's bit width.
-  bool isMaxValue() const { return isAllOnes(); }
+  constexpr bool isMaxValue() const { return isAllOnes(); }
 
   /// Determine if this is the largest signed value.
   ///
   /// This checks to see if the value of this APInt is the maximum signed
   /// value for the APInt's bit width.
-  bool isMaxSignedValue() const {
+  constexpr bool isMaxSignedValue() const {
     if (isSingleWord()) {
       assert(BitWidth && "zero width values not allowed");
       return U.VAL == ((WordType(1) << (BitWidth - 1)) - 1);
@@ -418,13 +485,13 @@ public:
   ///
   /// This checks to see if the value of this APInt is the minimum unsigned
   /// value for the APInt's bit width.
-  bool isMinValue() const { return isZero(); }
+  constexpr bool isMinValue() const { return isZero(); }
 
   /// Determine if this is the smallest signed value.
   ///
   /// This checks to see if the value of this APInt is the minimum signed
   /// value for the APInt's bit width.
-  bool isMinSignedValue() const {
+  constexpr bool isMinSignedValue() const {
     if (isSingleWord()) {
       assert(BitWidth && "zero width values not allowed");
       return U.VAL == (WordType(1) << (BitWidth - 1));
@@ -433,15 +500,17 @@ public:
   }
 
   /// Check if this APInt has an N-bits unsigned integer value.
-  bool isIntN(unsigned N) const { return getActiveBits() <= N; }
+  constexpr bool isIntN(unsigned N) const { return getActiveBits() <= N; }
 
   /// Check if this APInt has an N-bits signed integer value.
-  bool isSignedIntN(unsigned N) const { return getMinSignedBits() <= N; }
+  constexpr bool isSignedIntN(unsigned N) const {
+    return getMinSignedBits() <= N;
+  }
 
   /// Check if this APInt's value is a power of two greater than zero.
   ///
   /// @returns true if the argument APInt value is a power of two > 0.
-  bool isPowerOf2() const {
+  constexpr bool isPowerOf2() const {
     if (isSingleWord()) {
       assert(BitWidth && "zero width values not allowed");
       return isPowerOf2_64(U.VAL);
@@ -452,16 +521,16 @@ public:
   /// Check if the APInt's value is returned by getSignMask.
   ///
   /// @returns true if this is the value returned by getSignMask.
-  bool isSignMask() const { return isMinSignedValue(); }
+  constexpr bool isSignMask() const { return isMinSignedValue(); }
 
   /// Convert APInt to a boolean value.
   ///
   /// This converts the APInt to a boolean value as a test against zero.
-  bool getBoolValue() const { return !isZero(); }
+  constexpr bool getBoolValue() const { return !isZero(); }
 
   /// If this value is smaller than the specified limit, return it, otherwise
   /// return the limit value.  This causes the value to saturate to the limit.
-  uint64_t getLimitedValue(uint64_t Limit = UINT64_MAX) const {
+  constexpr uint64_t getLimitedValue(uint64_t Limit = UINT64_MAX) const {
     return ugt(Limit) ? Limit : getZExtValue();
   }
 
@@ -474,7 +543,7 @@ public:
 
   /// @returns true if this APInt value is a sequence of @param numBits ones
   /// starting at the least significant bit with the remainder zero.
-  bool isMask(unsigned numBits) const {
+  constexpr bool isMask(unsigned numBits) const {
     assert(numBits != 0 && "numBits must be non-zero");
     assert(numBits <= BitWidth && "numBits out of range");
     if (isSingleWord())
@@ -487,7 +556,7 @@ public:
   /// @returns true if this APInt is a non-empty sequence of ones starting at
   /// the least significant bit with the remainder zero.
   /// Ex. isMask(0x0000FFFFU) == true.
-  bool isMask() const {
+  constexpr bool isMask() const {
     if (isSingleWord())
       return isMask_64(U.VAL);
     unsigned Ones = countTrailingOnesSlowCase();
@@ -496,7 +565,7 @@ public:
 
   /// Return true if this APInt value contains a sequence of ones with
   /// the remainder zero.
-  bool isShiftedMask() const {
+  constexpr bool isShiftedMask() const {
     if (isSingleWord())
       return isShiftedMask_64(U.VAL);
     unsigned Ones = countPopulationSlowCase();
@@ -510,7 +579,7 @@ public:
   /// bits and right shift to the least significant bit.
   ///
   /// @returns the high "numBits" bits of this APInt.
-  APInt getHiBits(unsigned numBits) const;
+  constexpr APInt getHiBits(unsigned numBits) const;
 
   /// Compute an APInt containing numBits lowbits from this APInt.
   ///
@@ -518,11 +587,11 @@ public:
   /// bits.
   ///
   /// @returns the low "numBits" bits of this APInt.
-  APInt getLoBits(unsigned numBits) const;
+  constexpr APInt getLoBits(unsigned numBits) const;
 
   /// Determine if two APInts have the same value, after zero-extending
   /// one of them (if needed!) to ensure that the bit-widths match.
-  static bool isSameValue(const APInt &I1, const APInt &I2) {
+  static constexpr bool isSameValue(const APInt &I1, const APInt &I2) {
     if (I1.getBitWidth() == I2.getBitWidth())
       return I1 == I2;
 
@@ -538,10 +607,10 @@ public:
   /// This function returns a pointer to the internal storage of the APInt.
   /// This is useful for writing out the APInt in binary form without any
   /// conversions.
-  const uint64_t *getRawData() const {
+  constexpr const uint64_t *getRawData() const {
     if (isSingleWord())
       return &U.VAL;
-    return &U.pVal[0];
+    return getWords();
   }
 
   /// @}
@@ -551,7 +620,7 @@ public:
   /// Postfix increment operator.  Increment *this by 1.
   ///
   /// @returns a new APInt value representing the original value of *this.
-  APInt operator++(int) {
+  constexpr APInt operator++(int) {
     APInt API(*this);
     ++(*this);
     return API;
@@ -560,12 +629,12 @@ public:
   /// Prefix increment operator.
   ///
   /// @returns *this incremented by one
-  APInt &operator++();
+  constexpr APInt &operator++();
 
   /// Postfix decrement operator. Decrement *this by 1.
   ///
   /// @returns a new APInt value representing the original value of *this.
-  APInt operator--(int) {
+  constexpr APInt operator--(int) {
     APInt API(*this);
     --(*this);
     return API;
@@ -574,11 +643,11 @@ public:
   /// Prefix decrement operator.
   ///
   /// @returns *this decremented by one.
-  APInt &operator--();
+  constexpr APInt &operator--();
 
   /// Logical negation operation on this APInt returns true if zero, like normal
   /// integers.
-  bool operator!() const { return isZero(); }
+  constexpr bool operator!() const { return isZero(); }
 
   /// @}
   /// @name Assignment Operators
@@ -587,11 +656,11 @@ public:
   /// Copy assignment operator.
   ///
   /// @returns *this after assignment of RHS.
-  APInt &operator=(const APInt &RHS) {
+  constexpr APInt &operator=(const APInt &RHS) {
     // The common case (both source or dest being inline) doesn't require
     // allocation or deallocation.
-    if (isSingleWord() && RHS.isSingleWord()) {
-      U.VAL = RHS.U.VAL;
+    if (!needsCleanup() && !RHS.needsCleanup()) {
+      U = RHS.U;
       BitWidth = RHS.BitWidth;
       return *this;
     }
@@ -601,19 +670,23 @@ public:
   }
 
   /// Move assignment operator.
-  APInt &operator=(APInt &&that) {
+  constexpr APInt &operator=(APInt &&that) {
 #ifdef EXPENSIVE_CHECKS
     // Some std::shuffle implementations still do self-assignment.
     if (this == &that)
       return *this;
 #endif
     assert(this != &that && "Self-move not supported");
-    if (!isSingleWord())
-      delete[] U.pVal;
+    if (needsCleanup())
+      freeMemory(U.pVal, getNumWords());
 
-    // Use memcpy so that type based alias analysis sees both VAL and pVal
-    // as modified.
-    memcpy(&U, &that.U, sizeof(U));
+    // Use memcpy so that type based alias analysis sees VAL, pVal and Inline
+    // as modified. Constant evaluation has no memcpy, and no aliasing to
+    // worry about.
+    if (std::is_constant_evaluated())
+      U = that.U;
+    else
+      memcpy(&U, &that.U, sizeof(U));
 
     BitWidth = that.BitWidth;
     that.BitWidth = 0;
@@ -627,13 +700,14 @@ public:
   /// than 64, the value is zero filled in the unspecified high order bits.
   ///
   /// @returns *this after assignment of RHS value.
-  APInt &operator=(uint64_t RHS) {
+  constexpr APInt &operator=(uint64_t RHS) {
     if (isSingleWord()) {
       U.VAL = RHS;
       return clearUnusedBits();
     }
-    U.pVal[0] = RHS;
-    memset(U.pVal + 1, 0, (getNumWords() - 1) * APINT_WORD_SIZE);
+    uint64_t *Words = getWords();
+    Words[0] = RHS;
+    std::fill_n(Words + 1, getNumWords() - 1, 0);
     return *this;
   }
 
@@ -643,7 +717,7 @@ public:
   /// assigned to *this.
   ///
   /// @returns *this after ANDing with RHS.
-  APInt &operator&=(const APInt &RHS) {
+  constexpr APInt &operator&=(const APInt &RHS) {
     assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
     if (isSingleWord())
       U.VAL &= RHS.U.VAL;
@@ -657,13 +731,14 @@ public:
   /// Performs a bitwise AND operation on this APInt and RHS. RHS is
   /// logically zero-extended or truncated to match the bit-width of
   /// the LHS.
-  APInt &operator&=(uint64_t RHS) {
+  constexpr APInt &operator&=(uint64_t RHS) {
     if (isSingleWord()) {
       U.VAL &= RHS;
       return *this;
     }
-    U.pVal[0] &= RHS;
-    memset(U.pVal + 1, 0, (getNumWords() - 1) * APINT_WORD_SIZE);
+    uint64_t *Words = getWords();
+    Words[0] &= RHS;
+    std::fill_n(Words + 1, getNumWords() - 1, 0);
     return *this;
   }
 
@@ -673,7 +748,7 @@ public:
   /// assigned *this;
   ///
   /// @returns *this after ORing with RHS.
-  APInt &operator|=(const APInt &RHS) {
+  constexpr APInt &operator|=(const APInt &RHS) {
     assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
     if (isSingleWord())
       U.VAL |= RHS.U.VAL;
@@ -687,12 +762,12 @@ public:
   /// Performs a bitwise OR operation on this APInt and RHS. RHS is
   /// logically zero-extended or truncated to match the bit-width of
   /// the LHS.
-  APInt &operator|=(uint64_t RHS) {
+  constexpr APInt &operator|=(uint64_t RHS) {
     if (isSingleWord()) {
       U.VAL |= RHS;
       return clearUnusedBits();
     }
-    U.pVal[0] |= RHS;
+    getWords()[0] |= RHS;
     return *this;
   }
 
@@ -702,7 +777,7 @@ public:
   /// assigned to *this.
   ///
   /// @returns *this after XORing with RHS.
-  APInt &operator^=(const APInt &RHS) {
+  constexpr APInt &operator^=(const APInt &RHS) {
     assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
     if (isSingleWord())
       U.VAL ^= RHS.U.VAL;
@@ -716,12 +791,12 @@ public:
   /// Performs a bitwise XOR operation on this APInt and RHS. RHS is
   /// logically zero-extended or truncated to match the bit-width of
   /// the LHS.
-  APInt &operator^=(uint64_t RHS) {
+  constexpr APInt &operator^=(uint64_t RHS) {
     if (isSingleWord()) {
       U.VAL ^= RHS;
       return clearUnusedBits();
     }
-    U.pVal[0] ^= RHS;
+    getWords()[0] ^= RHS;
     return *this;
   }
 
@@ -730,31 +805,31 @@ public:
   /// Multiplies this APInt by RHS and assigns the result to *this.
   ///
   /// @returns *this
-  APInt &operator*=(const APInt &RHS);
-  APInt &operator*=(uint64_t RHS);
+  constexpr APInt &operator*=(const APInt &RHS);
+  constexpr APInt &operator*=(uint64_t RHS);
 
   /// Addition assignment operator.
   ///
   /// Adds RHS to *this and assigns the result to *this.
   ///
   /// @returns *this
-  APInt &operator+=(const APInt &RHS);
-  APInt &operator+=(uint64_t RHS);
+  constexpr APInt &operator+=(const APInt &RHS);
+  constexpr APInt &operator+=(uint64_t RHS);
 
   /// Subtraction assignment operator.
   ///
   /// Subtracts RHS from *this and assigns the result to *this.
   ///
   /// @returns *this
-  APInt &operator-=(const APInt &RHS);
-  APInt &operator-=(uint64_t RHS);
+  constexpr APInt &operator-=(const APInt &RHS);
+  constexpr APInt &operator-=(uint64_t RHS);
 
   /// Left-shift assignment function.
   ///
   /// Shifts *this left by shiftAmt and assigns the result to *this.
   ///
   /// @returns *this after shifting left by ShiftAmt
-  APInt &operator<<=(unsigned ShiftAmt) {
+  constexpr APInt &operator<<=(unsigned ShiftAmt) {
     assert(ShiftAmt <= BitWidth && "Invalid shift amount");
     if (isSingleWord()) {
       if (ShiftAmt == BitWidth)
@@ -772,7 +847,7 @@ public:
   /// Shifts *this left by shiftAmt and assigns the result to *this.
   ///
   /// @returns *this after shifting left by ShiftAmt
-  APInt &operator<<=(const APInt &ShiftAmt);
+  constexpr APInt &operator<<=(const APInt &ShiftAmt);
 
   /// @}
   /// @name Binary Operators
@@ -781,29 +856,36 @@ public:
   /// Multiplication operator.
   ///
   /// Multiplies this APInt by RHS and returns the result.
-  APInt operator*(const APInt &RHS) const;
+  constexpr APInt operator*(const APInt &RHS) const;
+
+  /// Squaring.
+  ///
+  /// @returns this * this, truncated to the bit width. Each product of two
+  /// different words is computed once, so this needs about half the word
+  /// multiplications of operator*.
+  constexpr APInt sqr() const;
 
   /// Left logical shift operator.
   ///
   /// Shifts this APInt left by @p Bits and returns the result.
-  APInt operator<<(unsigned Bits) const { return shl(Bits); }
+  constexpr APInt operator<<(unsigned Bits) const { return shl(Bits); }
 
   /// Left logical shift operator.
   ///
   /// Shifts this APInt left by @p Bits and returns the result.
-  APInt operator<<(const APInt &Bits) const { return shl(Bits); }
+  constexpr APInt operator<<(const APInt &Bits) const { return shl(Bits); }
 
   /// Arithmetic right-shift function.
   ///
   /// Arithmetic right-shift this APInt by shiftAmt.
-  APInt ashr(unsigned ShiftAmt) const {
+  constexpr APInt ashr(unsigned ShiftAmt) const {
     APInt R(*this);
     R.ashrInPlace(ShiftAmt);
     return R;
   }
 
   /// Arithmetic right-shift this APInt by ShiftAmt in place.
-  void ashrInPlace(unsigned ShiftAmt) {
+  constexpr void ashrInPlace(unsigned ShiftAmt) {
     assert(ShiftAmt <= BitWidth && "Invalid shift amount");
     if (isSingleWord()) {
       int64_t SExtVAL = SignExtend64(U.VAL, BitWidth);
@@ -820,14 +902,14 @@ public:
   /// Logical right-shift function.
   ///
   /// Logical right-shift this APInt by shiftAmt.
-  APInt lshr(unsigned shiftAmt) const {
+  constexpr APInt lshr(unsigned shiftAmt) const {
     APInt R(*this);
     R.lshrInPlace(shiftAmt);
     return R;
   }
 
   /// Logical right-shift this APInt by ShiftAmt in place.
-  void lshrInPlace(unsigned ShiftAmt) {
+  constexpr void lshrInPlace(unsigned ShiftAmt) {
     assert(ShiftAmt <= BitWidth && "Invalid shift amount");
     if (isSingleWord()) {
       if (ShiftAmt == BitWidth)
@@ -842,56 +924,56 @@ public:
   /// Left-shift function.
   ///
   /// Left-shift this APInt by shiftAmt.
-  APInt shl(unsigned shiftAmt) const {
+  constexpr APInt shl(unsigned shiftAmt) const {
     APInt R(*this);
     R <<= shiftAmt;
     return R;
   }
 
   /// Rotate left by rotateAmt.
-  APInt rotl(unsigned rotateAmt) const;
+  constexpr APInt rotl(unsigned rotateAmt) const;
 
   /// Rotate right by rotateAmt.
-  APInt rotr(unsigned rotateAmt) const;
+  constexpr APInt rotr(unsigned rotateAmt) const;
 
   /// Arithmetic right-shift function.
   ///
   /// Arithmetic right-shift this APInt by shiftAmt.
-  APInt ashr(const APInt &ShiftAmt) const {
+  constexpr APInt ashr(const APInt &ShiftAmt) const {
     APInt R(*this);
     R.ashrInPlace(ShiftAmt);
     return R;
   }
 
   /// Arithmetic right-shift this APInt by shiftAmt in place.
-  void ashrInPlace(const APInt &shiftAmt);
+  constexpr void ashrInPlace(const APInt &shiftAmt);
 
   /// Logical right-shift function.
   ///
   /// Logical right-shift this APInt by shiftAmt.
-  APInt lshr(const APInt &ShiftAmt) const {
+  constexpr APInt lshr(const APInt &ShiftAmt) const {
     APInt R(*this);
     R.lshrInPlace(ShiftAmt);
     return R;
   }
 
   /// Logical right-shift this APInt by ShiftAmt in place.
-  void lshrInPlace(const APInt &ShiftAmt);
+  constexpr void lshrInPlace(const APInt &ShiftAmt);
 
   /// Left-shift function.
   ///
   /// Left-shift this APInt by shiftAmt.
-  APInt shl(const APInt &ShiftAmt) const {
+  constexpr APInt shl(const APInt &ShiftAmt) const {
     APInt R(*this);
     R <<= ShiftAmt;
     return R;
   }
 
   /// Rotate left by rotateAmt.
-  APInt rotl(const APInt &rotateAmt) const;
+  constexpr APInt rotl(const APInt &rotateAmt) const;
 
   /// Rotate right by rotateAmt.
-  APInt rotr(const APInt &rotateAmt) const;
+  constexpr APInt rotr(const APInt &rotateAmt) const;
 
   /// Concatenate the bits from "NewLSB" onto the bottom of *this.  This is
   /// equivalent to:
@@ -911,16 +993,16 @@ public:
   ///
   /// @returns a new APInt value containing the division result, rounded towards
   /// zero.
-  APInt udiv(const APInt &RHS) const;
-  APInt udiv(uint64_t RHS) const;
+  constexpr APInt udiv(const APInt &RHS) const;
+  constexpr APInt udiv(uint64_t RHS) const;
 
   /// Signed division function for APInt.
   ///
   /// Signed divide this APInt by APInt RHS.
   ///
   /// The result is rounded towards zero.
-  APInt sdiv(const APInt &RHS) const;
-  APInt sdiv(int64_t RHS) const;
+  constexpr APInt sdiv(const APInt &RHS) const;
+  constexpr APInt sdiv(int64_t RHS) const;
 
   /// Unsigned remainder operation.
   ///
@@ -931,14 +1013,14 @@ public:
   /// is *this.
   ///
   /// @returns a new APInt value containing the remainder result
-  APInt urem(const APInt &RHS) const;
-  uint64_t urem(uint64_t RHS) const;
+  constexpr APInt urem(const APInt &RHS) const;
+  constexpr uint64_t urem(uint64_t RHS) const;
 
   /// Function for signed remainder operation.
   ///
   /// Signed remainder operation on APInt.
-  APInt srem(const APInt &RHS) const;
-  int64_t srem(int64_t RHS) const;
+  constexpr APInt srem(const APInt &RHS) const;
+  constexpr int64_t srem(int64_t RHS) const;
 
   /// Dual division/remainder interface.
   ///
@@ -947,15 +1029,15 @@ public:
   /// computation making it a little more efficient. The pair of input arguments
   /// may overlap with the pair of output arguments. It is safe to call
   /// udivrem(X, Y, X, Y), for example.
-  static void udivrem(const APInt &LHS, const APInt &RHS, APInt &Quotient,
-                      APInt &Remainder);
-  static void udivrem(const APInt &LHS, uint64_t RHS, APInt &Quotient,
-                      uint64_t &Remainder);
+  static constexpr void udivrem(const APInt &LHS, const APInt &RHS,
+                                APInt &Quotient, APInt &Remainder);
+  static constexpr void udivrem(const APInt &LHS, uint64_t RHS,
+                                APInt &Quotient, uint64_t &Remainder);
 
-  static void sdivrem(const APInt &LHS, const APInt &RHS, APInt &Quotient,
-                      APInt &Remainder);
-  static void sdivrem(const APInt &LHS, int64_t RHS, APInt &Quotient,
-                      int64_t &Remainder);
+  static constexpr void sdivrem(const APInt &LHS, const APInt &RHS,
+                                APInt &Quotient, APInt &Remainder);
+  static constexpr void sdivrem(const APInt &LHS, int64_t RHS,
+                                APInt &Quotient, int64_t &Remainder);
 
   // Operations that return overflow indicators.
   APInt sadd_ov(const APInt &RHS, bool &Overflow) const;
@@ -981,7 +1063,7 @@ public:
   /// Array-indexing support.
   ///
   /// @returns the bit value at bitPosition
-  bool operator[](unsigned bitPosition) const {
+  constexpr bool operator[](unsigned bitPosition) const {
     assert(bitPosition < getBitWidth() && "Bit position out of bounds!");
     return (maskBit(bitPosition) & getWord(bitPosition)) != 0;
   }
@@ -994,7 +1076,7 @@ public:
   ///
   /// Compares this APInt with RHS for the validity of the equality
   /// relationship.
-  bool operator==(const APInt &RHS) const {
+  constexpr bool operator==(const APInt &RHS) const {
     assert(BitWidth == RHS.BitWidth && "Comparison requires equal bit widths");
     if (isSingleWord())
       return U.VAL == RHS.U.VAL;
@@ -1007,7 +1089,7 @@ public:
   /// relationship.
   ///
   /// @returns true if *this == Val
-  bool operator==(uint64_t Val) const {
+  constexpr bool operator==(uint64_t Val) const {
     return (isSingleWord() || getActiveBits() <= 64) && getZExtValue() == Val;
   }
 
@@ -1017,7 +1099,7 @@ public:
   /// relationship.
   ///
   /// @returns true if *this == Val
-  bool eq(const APInt &RHS) const { return (*this) == RHS; }
+  constexpr bool eq(const APInt &RHS) const { return (*this) == RHS; }
 
   /// Inequality operator.
   ///
@@ -1025,7 +1107,9 @@ public:
   /// relationship.
   ///
   /// @returns true if *this != Val
-  bool operator!=(const APInt &RHS) const { return !((*this) == RHS); }
+  constexpr bool operator!=(const APInt &RHS) const {
+    return !((*this) == RHS);
+  }
 
   /// Inequality operator.
   ///
@@ -1033,7 +1117,7 @@ public:
   /// relationship.
   ///
   /// @returns true if *this != Val
-  bool operator!=(uint64_t Val) const { return !((*this) == Val); }
+  constexpr bool operator!=(uint64_t Val) const { return !((*this) == Val); }
 
   /// Inequality comparison
   ///
@@ -1041,7 +1125,7 @@ public:
   /// relationship.
   ///
   /// @returns true if *this != Val
-  bool ne(const APInt &RHS) const { return !((*this) == RHS); }
+  constexpr bool ne(const APInt &RHS) const { return !((*this) == RHS); }
 
   /// Unsigned less than comparison
   ///
@@ -1049,7 +1133,7 @@ public:
   /// the validity of the less-than relationship.
   ///
   /// @returns true if *this < RHS when both are considered unsigned.
-  bool ult(const APInt &RHS) const { return compare(RHS) < 0; }
+  constexpr bool ult(const APInt &RHS) const { return compare(RHS) < 0; }
 
   /// Unsigned less than comparison
   ///
@@ -1057,7 +1141,7 @@ public:
   /// the validity of the less-than relationship.
   ///
   /// @returns true if *this < RHS when considered unsigned.
-  bool ult(uint64_t RHS) const {
+  constexpr bool ult(uint64_t RHS) const {
     // Only need to check active bits if not a single word.
     return (isSingleWord() || getActiveBits() <= 64) && getZExtValue() < RHS;
   }
@@ -1068,7 +1152,7 @@ public:
   /// validity of the less-than relationship.
   ///
   /// @returns true if *this < RHS when both are considered signed.
-  bool slt(const APInt &RHS) const { return compareSigned(RHS) < 0; }
+  constexpr bool slt(const APInt &RHS) const { return compareSigned(RHS) < 0; }
 
   /// Signed less than comparison
   ///
@@ -1076,7 +1160,7 @@ public:
   /// the validity of the less-than relationship.
   ///
   /// @returns true if *this < RHS when considered signed.
-  bool slt(int64_t RHS) const {
+  constexpr bool slt(int64_t RHS) const {
     return (!isSingleWord() && getMinSignedBits() > 64) ? isNegative()
                                                         : getSExtValue() < RHS;
   }
@@ -1087,7 +1171,7 @@ public:
   /// validity of the less-or-equal relationship.
   ///
   /// @returns true if *this <= RHS when both are considered unsigned.
-  bool ule(const APInt &RHS) const { return compare(RHS) <= 0; }
+  constexpr bool ule(const APInt &RHS) const { return compare(RHS) <= 0; }
 
   /// Unsigned less or equal comparison
   ///
@@ -1095,7 +1179,7 @@ public:
   /// the validity of the less-or-equal relationship.
   ///
   /// @returns true if *this <= RHS when considered unsigned.
-  bool ule(uint64_t RHS) const { return !ugt(RHS); }
+  constexpr bool ule(uint64_t RHS) const { return !ugt(RHS); }
 
   /// Signed less or equal comparison
   ///
@@ -1103,7 +1187,7 @@ public:
   /// validity of the less-or-equal relationship.
   ///
   /// @returns true if *this <= RHS when both are considered signed.
-  bool sle(const APInt &RHS) const { return compareSigned(RHS) <= 0; }
+  constexpr bool sle(const APInt &RHS) const { return compareSigned(RHS) <= 0; }
 
   /// Signed less or equal comparison
   ///
@@ -1111,7 +1195,7 @@ public:
   /// validity of the less-or-equal relationship.
   ///
   /// @returns true if *this <= RHS when considered signed.
-  bool sle(uint64_t RHS) const { return !sgt(RHS); }
+  constexpr bool sle(uint64_t RHS) const { return !sgt(RHS); }
 
   /// Unsigned greater than comparison
   ///
@@ -1119,7 +1203,7 @@ public:
   /// the validity of the greater-than relationship.
   ///
   /// @returns true if *this > RHS when both are considered unsigned.
-  bool ugt(const APInt &RHS) const { return !ule(RHS); }
+  constexpr bool ugt(const APInt &RHS) const { return !ule(RHS); }
 
   /// Unsigned greater than comparison
   ///
@@ -1127,7 +1211,7 @@ public:
   /// the validity of the greater-than relationship.
   ///
   /// @returns true if *this > RHS when considered unsigned.
-  bool ugt(uint64_t RHS) const {
+  constexpr bool ugt(uint64_t RHS) const {
     // Only need to check active bits if not a single word.
     return (!isSingleWord() && getActiveBits() > 64) || getZExtValue() > RHS;
   }
@@ -1138,7 +1222,7 @@ public:
   /// validity of the greater-than relationship.
   ///
   /// @returns true if *this > RHS when both are considered signed.
-  bool sgt(const APInt &RHS) const { return !sle(RHS); }
+  constexpr bool sgt(const APInt &RHS) const { return !sle(RHS); }
 
   /// Signed greater than comparison
   ///
@@ -1146,7 +1230,7 @@ public:
   /// the validity of the greater-than relationship.
   ///
   /// @returns true if *this > RHS when considered signed.
-  bool sgt(int64_t RHS) const {
+  constexpr bool sgt(int64_t RHS) const {
     return (!isSingleWord() && getMinSignedBits() > 64) ? !isNegative()
                                                         : getSExtValue() > RHS;
   }
@@ -1157,7 +1241,7 @@ public:
   /// validity of the greater-or-equal relationship.
   ///
   /// @returns true if *this >= RHS when both are considered unsigned.
-  bool uge(const APInt &RHS) const { return !ult(RHS); }
+  constexpr bool uge(const APInt &RHS) const { return !ult(RHS); }
 
   /// Unsigned greater or equal comparison
   ///
@@ -1165,7 +1249,7 @@ public:
   /// the validity of the greater-or-equal relationship.
   ///
   /// @returns true if *this >= RHS when considered unsigned.
-  bool uge(uint64_t RHS) const { return !ult(RHS); }
+  constexpr bool uge(uint64_t RHS) const { return !ult(RHS); }
 
   /// Signed greater or equal comparison
   ///
@@ -1173,7 +1257,7 @@ public:
   /// validity of the greater-or-equal relationship.
   ///
   /// @returns true if *this >= RHS when both are considered signed.
-  bool sge(const APInt &RHS) const { return !slt(RHS); }
+  constexpr bool sge(const APInt &RHS) const { return !slt(RHS); }
 
   /// Signed greater or equal comparison
   ///
@@ -1181,11 +1265,11 @@ public:
   /// the validity of the greater-or-equal relationship.
   ///
   /// @returns true if *this >= RHS when considered signed.
-  bool sge(int64_t RHS) const { return !slt(RHS); }
+  constexpr bool sge(int64_t RHS) const { return !slt(RHS); }
 
   /// This operation tests if there are any pairs of corresponding bits
   /// between this APInt and RHS that are both set.
-  bool intersects(const APInt &RHS) const {
+  constexpr bool intersects(const APInt &RHS) const {
     assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
     if (isSingleWord())
       return (U.VAL & RHS.U.VAL) != 0;
@@ -1193,7 +1277,7 @@ public:
   }
 
   /// This operation checks that all bits set in this APInt are also set in RHS.
-  bool isSubsetOf(const APInt &RHS) const {
+  constexpr bool isSubsetOf(const APInt &RHS) const {
     assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
     if (isSingleWord())
       return (U.VAL & ~RHS.U.VAL) == 0;
@@ -1208,20 +1292,20 @@ public:
   ///
   /// Truncate the APInt to a specified width. It is an error to specify a width
   /// that is greater than or equal to the current width.
-  APInt trunc(unsigned width) const;
+  constexpr APInt trunc(unsigned width) const;
 
   /// Truncate to new width with unsigned saturation.
   ///
   /// If the APInt, treated as unsigned integer, can be losslessly truncated to
   /// the new bitwidth, then return truncated APInt. Else, return max value.
-  APInt truncUSat(unsigned width) const;
+  constexpr APInt truncUSat(unsigned width) const;
 
   /// Truncate to new width with signed saturation.
   ///
   /// If this APInt, treated as signed integer, can be losslessly truncated to
   /// the new bitwidth, then return truncated APInt. Else, return either
   /// signed min value if the APInt was negative, or signed max value.
-  APInt truncSSat(unsigned width) const;
+  constexpr APInt truncSSat(unsigned width) const;
 
   /// Sign extend to a new width.
   ///
@@ -1229,75 +1313,75 @@ public:
   /// bit is set, the fill on the left will be done with 1 bits, otherwise zero.
   /// It is an error to specify a width that is less than or equal to the
   /// current width.
-  APInt sext(unsigned width) const;
+  constexpr APInt sext(unsigned width) const;
 
   /// Zero extend to a new width.
   ///
   /// This operation zero extends the APInt to a new width. The high order bits
   /// are filled with 0 bits.  It is an error to specify a width that is less
   /// than or equal to the current width.
-  APInt zext(unsigned width) const;
+  constexpr APInt zext(unsigned width) const;
 
   /// Sign extend or truncate to width
   ///
   /// Make this APInt have the bit width given by @p width. The value is sign
   /// extended, truncated, or left alone to make it that width.
-  APInt sextOrTrunc(unsigned width) const;
+  constexpr APInt sextOrTrunc(unsigned width) const;
 
   /// Zero extend or truncate to width
   ///
   /// Make this APInt have the bit width given by @p width. The value is zero
   /// extended, truncated, or left alone to make it that width.
-  APInt zextOrTrunc(unsigned width) const;
+  constexpr APInt zextOrTrunc(unsigned width) const;
 
   /// Truncate to width
   ///
   /// Make this APInt have the bit width given by @p width. The value is
   /// truncated or left alone to make it that width.
-  APInt truncOrSelf(unsigned width) const;
+  constexpr APInt truncOrSelf(unsigned width) const;
 
   /// Sign extend or truncate to width
   ///
   /// Make this APInt have the bit width given by @p width. The value is sign
   /// extended, or left alone to make it that width.
-  APInt sextOrSelf(unsigned width) const;
+  constexpr APInt sextOrSelf(unsigned width) const;
 
   /// Zero extend or truncate to width
   ///
   /// Make this APInt have the bit width given by @p width. The value is zero
   /// extended, or left alone to make it that width.
-  APInt zextOrSelf(unsigned width) const;
+  constexpr APInt zextOrSelf(unsigned width) const;
 
   /// @}
   /// @name Bit Manipulation Operators
   /// @{
 
   /// Set every bit to 1.
-  void setAllBits() {
+  constexpr void setAllBits() {
     if (isSingleWord())
       U.VAL = WORDTYPE_MAX;
     else
       // Set all the bits in all the words.
-      memset(U.pVal, -1, getNumWords() * APINT_WORD_SIZE);
+      std::fill_n(getWords(), getNumWords(), WORDTYPE_MAX);
     // Clear the unused ones
     clearUnusedBits();
   }
 
   /// Set the given bit to 1 whose position is given as "bitPosition".
-  void setBit(unsigned BitPosition) {
+  constexpr void setBit(unsigned BitPosition) {
     assert(BitPosition < BitWidth && "BitPosition out of range");
     WordType Mask = maskBit(BitPosition);
     if (isSingleWord())
       U.VAL |= Mask;
     else
-      U.pVal[whichWord(BitPosition)] |= Mask;
+      getWords()[whichWord(BitPosition)] |= Mask;
   }
 
   /// Set the sign bit to 1.
-  void setSignBit() { setBit(BitWidth - 1); }
+  constexpr void setSignBit() { setBit(BitWidth - 1); }
 
   /// Set a given bit to a given value.
-  void setBitVal(unsigned BitPosition, bool BitValue) {
+  constexpr void setBitVal(unsigned BitPosition, bool BitValue) {
     if (BitValue)
       setBit(BitPosition);
     else
@@ -1308,7 +1392,7 @@ public:
   /// This function handles "wrap" case when @p loBit >= @p hiBit, and calls
   /// setBits when @p loBit < @p hiBit.
   /// For @p loBit == @p hiBit wrap case, set every bit to 1.
-  void setBitsWithWrap(unsigned loBit, unsigned hiBit) {
+  constexpr void setBitsWithWrap(unsigned loBit, unsigned hiBit) {
     assert(hiBit <= BitWidth && "hiBit out of range");
     assert(loBit <= BitWidth && "loBit out of range");
     if (loBit < hiBit) {
@@ -1321,7 +1405,7 @@ public:
 
   /// Set the bits from loBit (inclusive) to hiBit (exclusive) to 1.
   /// This function handles case when @p loBit <= @p hiBit.
-  void setBits(unsigned loBit, unsigned hiBit) {
+  constexpr void setBits(unsigned loBit, unsigned hiBit) {
     assert(hiBit <= BitWidth && "hiBit out of range");
     assert(loBit <= BitWidth && "loBit out of range");
     assert(loBit <= hiBit && "loBit greater than hiBit");
@@ -1333,55 +1417,57 @@ public:
       if (isSingleWord())
         U.VAL |= mask;
       else
-        U.pVal[0] |= mask;
+        getWords()[0] |= mask;
     } else {
       setBitsSlowCase(loBit, hiBit);
     }
   }
 
   /// Set the top bits starting from loBit.
-  void setBitsFrom(unsigned loBit) { return setBits(loBit, BitWidth); }
+  constexpr void setBitsFrom(unsigned loBit) {
+    return setBits(loBit, BitWidth);
+  }
 
   /// Set the bottom loBits bits.
-  void setLowBits(unsigned loBits) { return setBits(0, loBits); }
+  constexpr void setLowBits(unsigned loBits) { return setBits(0, loBits); }
 
   /// Set the top hiBits bits.
-  void setHighBits(unsigned hiBits) {
+  constexpr void setHighBits(unsigned hiBits) {
     return setBits(BitWidth - hiBits, BitWidth);
   }
 
   /// Set every bit to 0.
-  void clearAllBits() {
+  constexpr void clearAllBits() {
     if (isSingleWord())
       U.VAL = 0;
     else
-      memset(U.pVal, 0, getNumWords() * APINT_WORD_SIZE);
+      std::fill_n(getWords(), getNumWords(), 0);
   }
 
   /// Set a given bit to 0.
   ///
   /// Set the given bit to 0 whose position is given as "bitPosition".
-  void clearBit(unsigned BitPosition) {
+  constexpr void clearBit(unsigned BitPosition) {
     assert(BitPosition < BitWidth && "BitPosition out of range");
     WordType Mask = ~maskBit(BitPosition);
     if (isSingleWord())
       U.VAL &= Mask;
     else
-      U.pVal[whichWord(BitPosition)] &= Mask;
+      getWords()[whichWord(BitPosition)] &= Mask;
   }
 
   /// Set bottom loBits bits to 0.
-  void clearLowBits(unsigned loBits) {
+  constexpr void clearLowBits(unsigned loBits) {
     assert(loBits <= BitWidth && "More bits than bitwidth");
     APInt Keep = getHighBitsSet(BitWidth, BitWidth - loBits);
     *this &= Keep;
   }
 
   /// Set the sign bit to 0.
-  void clearSignBit() { clearBit(BitWidth - 1); }
+  constexpr void clearSignBit() { clearBit(BitWidth - 1); }
 
   /// Toggle every bit to its opposite value.
-  void flipAllBits() {
+  constexpr void flipAllBits() {
     if (isSingleWord()) {
       U.VAL ^= WORDTYPE_MAX;
       clearUnusedBits();
@@ -1394,10 +1480,10 @@ public:
   ///
   /// Toggle a given bit to its opposite value whose position is given
   /// as "bitPosition".
-  void flipBit(unsigned bitPosition);
+  constexpr void flipBit(unsigned bitPosition);
 
   /// Negate this APInt in place.
-  void negate() {
+  constexpr void negate() {
     flipAllBits();
     ++(*this);
   }
@@ -1415,14 +1501,14 @@ public:
   /// @{
 
   /// Return the number of bits in the APInt.
-  unsigned getBitWidth() const { return BitWidth; }
+  constexpr unsigned getBitWidth() const { return BitWidth; }
 
   /// Get the number of words.
   ///
   /// Here one word's bitwidth equals to that of uint64_t.
   ///
   /// @returns the number of words to hold the integer value of this APInt.
-  unsigned getNumWords() const { return getNumWords(BitWidth); }
+  constexpr unsigned getNumWords() const { return getNumWords(BitWidth); }
 
   /// Get the number of words.
   ///
@@ -1430,7 +1516,7 @@ public:
   ///
   /// @returns the number of words to hold the integer value with a given bit
   /// width.
-  static unsigned getNumWords(unsigned BitWidth) {
+  static constexpr unsigned getNumWords(unsigned BitWidth) {
     return ((uint64_t)BitWidth + APINT_BITS_PER_WORD - 1) / APINT_BITS_PER_WORD;
   }
 
@@ -1439,13 +1525,15 @@ public:
   /// This function returns the number of active bits which is defined as the
   /// bit width minus the number of leading zeros. This is used in several
   /// computations to see how "wide" the value is.
-  unsigned getActiveBits() const { return BitWidth - countLeadingZeros(); }
+  constexpr unsigned getActiveBits() const {
+    return BitWidth - countLeadingZeros();
+  }
 
   /// Compute the number of active words in the value of this APInt.
   ///
   /// This is used in conjunction with getActiveData to extract the raw value of
   /// the APInt.
-  unsigned getActiveWords() const {
+  constexpr unsigned getActiveWords() const {
     unsigned numActiveBits = getActiveBits();
     return numActiveBits ? whichWord(numActiveBits - 1) + 1 : 1;
   }
@@ -1458,20 +1546,22 @@ public:
   /// returns the smallest bit width that will retain the negative value. For
   /// example, -1 can be written as 0b1 or 0xFFFFFFFFFF. 0b1 is shorter and so
   /// for -1, this function will always return 1.
-  unsigned getMinSignedBits() const { return BitWidth - getNumSignBits() + 1; }
+  constexpr unsigned getMinSignedBits() const {
+    return BitWidth - getNumSignBits() + 1;
+  }
 
   /// Get zero extended value
   ///
   /// This method attempts to return the value of this APInt as a zero extended
   /// uint64_t. The bitwidth must be <= 64 or the value must fit within a
   /// uint64_t. Otherwise an assertion will result.
-  uint64_t getZExtValue() const {
+  constexpr uint64_t getZExtValue() const {
     if (isSingleWord()) {
       assert(BitWidth && "zero width values not allowed");
       return U.VAL;
     }
     assert(getActiveBits() <= 64 && "Too many bits for uint64_t");
-    return U.pVal[0];
+    return getWords()[0];
   }
 
   /// Get sign extended value
@@ -1479,11 +1569,11 @@ public:
   /// This method attempts to return the value of this APInt as a sign extended
   /// int64_t. The bit width must be <= 64 or the value must fit within an
   /// int64_t. Otherwise an assertion will result.
-  int64_t getSExtValue() const {
+  constexpr int64_t getSExtValue() const {
     if (isSingleWord())
       return SignExtend64(U.VAL, BitWidth);
     assert(getMinSignedBits() <= 64 && "Too many bits for int64_t");
-    return int64_t(U.pVal[0]);
+    return int64_t(getWords()[0]);
   }
 
   /// Get bits required for string value.
@@ -1500,7 +1590,7 @@ public:
   ///
   /// @returns BitWidth if the value is zero, otherwise returns the number of
   ///   zeros from the most significant bit to the first one bits.
-  unsigned countLeadingZeros() const {
+  constexpr unsigned countLeadingZeros() const {
     if (isSingleWord()) {
       unsigned unusedBits = APINT_BITS_PER_WORD - BitWidth;
       return bijou::countLeadingZeros(U.VAL) - unusedBits;
@@ -1516,7 +1606,7 @@ public:
   ///
   /// @returns 0 if the high order bit is not set, otherwise returns the number
   /// of 1 bits from the most significant to the least
-  unsigned countLeadingOnes() const {
+  constexpr unsigned countLeadingOnes() const {
     if (isSingleWord()) {
       if (BIJOU_UNLIKELY(BitWidth == 0))
         return 0;
@@ -1527,7 +1617,7 @@ public:
 
   /// Computes the number of leading bits of this APInt that are equal to its
   /// sign bit.
-  unsigned getNumSignBits() const {
+  constexpr unsigned getNumSignBits() const {
     return isNegative() ? countLeadingOnes() : countLeadingZeros();
   }
 
@@ -1539,7 +1629,7 @@ public:
   ///
   /// @returns BitWidth if the value is zero, otherwise returns the number of
   /// zeros from the least significant bit to the first one bit.
-  unsigned countTrailingZeros() const {
+  constexpr unsigned countTrailingZeros() const {
     if (isSingleWord()) {
       unsigned TrailingZeros = bijou::countTrailingZeros(U.VAL);
       return (TrailingZeros > BitWidth ? BitWidth : TrailingZeros);
@@ -1555,7 +1645,7 @@ public:
   ///
   /// @returns BitWidth if the value is all ones, otherwise returns the number
   /// of ones from the least significant bit to the first zero bit.
-  unsigned countTrailingOnes() const {
+  constexpr unsigned countTrailingOnes() const {
     if (isSingleWord())
       return bijou::countTrailingOnes(U.VAL);
     return countTrailingOnesSlowCase();
@@ -1567,7 +1657,7 @@ public:
   /// in MathExtras.h. It counts the number of 1 bits in the APInt value.
   ///
   /// @returns 0 if the value is zero, otherwise returns the number of set bits.
-  unsigned countPopulation() const {
+  constexpr unsigned countPopulation() const {
     if (isSingleWord())
       return bijou::countPopulation(U.VAL);
     return countPopulationSlowCase();
@@ -1588,6 +1678,49 @@ public:
   void toString(std::string &Str, unsigned Radix, bool Signed,
                 bool formatAsCLiteral = false) const;
 
+  /// Writes the characters toString would append to [First, Last), in the
+  /// manner of std::to_chars. Nothing is allocated for values of up to 1024
+  /// bits.
+  ///
+  /// @returns the end of the characters written, or @p Last with
+  /// std::errc::value_too_large if they do not fit.
+  std::to_chars_result toChars(char *First, char *Last, unsigned Radix,
+                               bool Signed,
+                               bool formatAsCLiteral = false) const;
+
+  /// @returns an upper bound on the number of characters toString and
+  /// toChars write for a value of @p BitWidth bits, so that buffers can be
+  /// sized ahead of time.
+  static constexpr unsigned getMaxChars(unsigned BitWidth, unsigned Radix,
+                                        bool Signed,
+                                        bool formatAsCLiteral = false) {
+    uint64_t Digits;
+    switch (Radix) {
+    case 2:  Digits = BitWidth; break;
+    case 8:  Digits = (BitWidth + 2) / 3; break;
+    case 16: Digits = (BitWidth + 3) / 4; break;
+    // 0.30103 and 0.19343 are slight overestimates of log10(2) and log36(2).
+    case 10: Digits = uint64_t(BitWidth) * 30103 / 100000 + 1; break;
+    default: Digits = uint64_t(BitWidth) * 19343 / 100000 + 1; break;
+    }
+    unsigned Prefix = !formatAsCLiteral || Radix == 10 ? 0
+                      : Radix == 8                     ? 1
+                                                       : 2;
+    return Signed + Prefix + std::max<unsigned>(Digits, 1);
+  }
+
+  /// Parses the digits in radix @p Radix (2, 8, 10, 16 or 36) at the start of
+  /// [First, Last) into this APInt, keeping its bit width, in the manner of
+  /// std::from_chars. If @p Signed is true a leading '-' is accepted and the
+  /// value must fit in the signed range of the width, otherwise in the
+  /// unsigned range. Nothing is allocated for values of up to 1024 bits.
+  ///
+  /// @returns the end of the digits, with std::errc::invalid_argument if
+  /// there are none and std::errc::result_out_of_range if the value does not
+  /// fit. This APInt is only changed on success.
+  std::from_chars_result fromChars(const char *First, const char *Last,
+                                   unsigned Radix = 10, bool Signed = false);
+
   /// Considers the APInt to be unsigned and converts it into a string in the
   /// radix given. The radix can be 2, 8, 10 16, or 36.
   void toStringUnsigned(std::string &Str, unsigned Radix = 10) const {
@@ -1665,10 +1798,10 @@ public:
   /// @{
 
   /// @returns the floor log base 2 of this APInt.
-  unsigned logBase2() const { return getActiveBits() - 1; }
+  constexpr unsigned logBase2() const { return getActiveBits() - 1; }
 
   /// @returns the ceil log base 2 of this APInt.
-  unsigned ceilLogBase2() const {
+  constexpr unsigned ceilLogBase2() const {
     APInt temp(*this);
     --temp;
     return temp.getActiveBits();
@@ -1687,7 +1820,7 @@ public:
 
   /// @returns the log base 2 of this APInt if its an exact power of two, -1
   /// otherwise
-  int32_t exactLogBase2() const {
+  constexpr int32_t exactLogBase2() const {
     if (!isPowerOf2())
       return -1;
     return logBase2();
@@ -1699,7 +1832,7 @@ public:
   /// Get the absolute value.  If *this is < 0 then return -(*this), otherwise
   /// *this.  Note that the "most negative" signed number (e.g. -128 for 8 bit
   /// wide APInt) is unchanged due to how negation works.
-  APInt abs() const {
+  constexpr APInt abs() const {
     if (isNegative())
       return -(*this);
     return *this;
@@ -1720,48 +1853,50 @@ public:
 
   /// Sets the least significant part of a bignum to the input value, and zeroes
   /// out higher parts.
-  static void tcSet(WordType *, WordType, unsigned);
+  static constexpr void tcSet(WordType *, WordType, unsigned);
 
   /// Assign one bignum to another.
-  static void tcAssign(WordType *, const WordType *, unsigned);
+  static constexpr void tcAssign(WordType *, const WordType *, unsigned);
 
   /// Returns true if a bignum is zero, false otherwise.
-  static bool tcIsZero(const WordType *, unsigned);
+  static constexpr bool tcIsZero(const WordType *, unsigned);
 
   /// Extract the given bit of a bignum; returns 0 or 1.  Zero-based.
-  static int tcExtractBit(const WordType *, unsigned bit);
+  static constexpr int tcExtractBit(const WordType *, unsigned bit);
 
   /// Copy the bit vector of width srcBITS from SRC, starting at bit srcLSB, to
   /// DST, of dstCOUNT parts, such that the bit srcLSB becomes the least
   /// significant bit of DST.  All high bits above srcBITS in DST are
   /// zero-filled.
-  static void tcExtract(WordType *, unsigned dstCount, const WordType *,
-                        unsigned srcBits, unsigned srcLSB);
+  static constexpr void tcExtract(WordType *, unsigned dstCount,
+                                  const WordType *, unsigned srcBits,
+                                  unsigned srcLSB);
 
   /// Set the given bit of a bignum.  Zero-based.
-  static void tcSetBit(WordType *, unsigned bit);
+  static constexpr void tcSetBit(WordType *, unsigned bit);
 
   /// Clear the given bit of a bignum.  Zero-based.
-  static void tcClearBit(WordType *, unsigned bit);
+  static constexpr void tcClearBit(WordType *, unsigned bit);
 
   /// Returns the bit number of the least or most significant set bit of a
   /// number.  If the input number has no bits set -1U is returned.
-  static unsigned tcLSB(const WordType *, unsigned n);
-  static unsigned tcMSB(const WordType *parts, unsigned n);
+  static constexpr unsigned tcLSB(const WordType *, unsigned n);
+  static constexpr unsigned tcMSB(const WordType *parts, unsigned n);
 
   /// Negate a bignum in-place.
-  static void tcNegate(WordType *, unsigned);
+  static constexpr void tcNegate(WordType *, unsigned);
 
   /// DST += RHS + CARRY where CARRY is zero or one.  Returns the carry flag.
-  static WordType tcAdd(WordType *, const WordType *, WordType carry, unsigned);
+  static constexpr WordType tcAdd(WordType *, const WordType *,
+                                  WordType carry, unsigned);
   /// DST += RHS.  Returns the carry flag.
-  static WordType tcAddPart(WordType *, WordType, unsigned);
+  static constexpr WordType tcAddPart(WordType *, WordType, unsigned);
 
   /// DST -= RHS + CARRY where CARRY is zero or one. Returns the carry flag.
-  static WordType tcSubtract(WordType *, const WordType *, WordType carry,
-                             unsigned);
+  static constexpr WordType tcSubtract(WordType *, const WordType *,
+                                       WordType carry, unsigned);
   /// DST -= RHS.  Returns the carry flag.
-  static WordType tcSubtractPart(WordType *, WordType, unsigned);
+  static constexpr WordType tcSubtractPart(WordType *, WordType, unsigned);
 
   /// DST += SRC * MULTIPLIER + PART   if add is true
   /// DST  = SRC * MULTIPLIER + PART   if add is false
@@ -1773,21 +1908,48 @@ public:
   /// Otherwise DST is filled with the least significant DSTPARTS parts of the
   /// result, and if all of the omitted higher parts were zero return zero,
   /// otherwise overflow occurred and return one.
-  static int tcMultiplyPart(WordType *dst, const WordType *src,
-                            WordType multiplier, WordType carry,
-                            unsigned srcParts, unsigned dstParts, bool add);
+  static constexpr int tcMultiplyPart(WordType *dst, const WordType *src,
+                                      WordType multiplier, WordType carry,
+                                      unsigned srcParts, unsigned dstParts,
+                                      bool add);
 
   /// DST = LHS * RHS, where DST has the same width as the operands and is
   /// filled with the least significant parts of the result.  Returns one if
   /// overflow occurred, otherwise zero.  DST must be disjoint from both
   /// operands.
-  static int tcMultiply(WordType *, const WordType *, const WordType *,
-                        unsigned);
+  static constexpr int tcMultiply(WordType *, const WordType *,
+                                  const WordType *, unsigned);
 
   /// DST = LHS * RHS, where DST has width the sum of the widths of the
   /// operands. No overflow occurs. DST must be disjoint from both operands.
-  static void tcFullMultiply(WordType *, const WordType *, const WordType *,
-                             unsigned, unsigned);
+  ///
+  /// Operands of at least APINT_KARATSUBA_THRESHOLD words use Karatsuba
+  /// multiplication, those of at least APINT_TOOM3_THRESHOLD words Toom-3.
+  static constexpr void tcFullMultiply(WordType *, const WordType *,
+                                       const WordType *, unsigned, unsigned);
+
+  /// DST = SRC * SRC, truncated to DSTPARTS <= 2 * SRCPARTS words. The
+  /// products of two different words are computed once and doubled. DST must
+  /// be disjoint from SRC.
+  ///
+  /// tcMultiply and tcFullMultiply square through this when both operands are
+  /// the same.
+  static constexpr void tcSquare(WordType *dst, const WordType *src,
+                                 unsigned srcParts, unsigned dstParts);
+
+  /// DST = LHS * RHS, where both operands have PARTS >= 2 words and DST has
+  /// 2 * PARTS words.  Splits the operands once as in Karatsuba's algorithm
+  /// and multiplies the halves as tcFullMultiply would.  DST must be disjoint
+  /// from both operands.
+  static void tcKaratsubaMultiply(WordType *dst, const WordType *lhs,
+                                  const WordType *rhs, unsigned parts);
+
+  /// DST = LHS * RHS, where both operands have PARTS >= 5 words and DST has
+  /// 2 * PARTS words.  Splits the operands once as in the Toom-Cook 3-way
+  /// algorithm and multiplies the pieces as tcFullMultiply would.  DST must be
+  /// disjoint from both operands.
+  static void tcToom3Multiply(WordType *dst, const WordType *lhs,
+                              const WordType *rhs, unsigned parts);
 
   /// If RHS is zero LHS and REMAINDER are left unchanged, return one.
   /// Otherwise set LHS to LHS / RHS with the fractional part discarded, set
@@ -1798,27 +1960,29 @@ public:
   /// SCRATCH is a bignum of the same size as the operands and result for use by
   /// the routine; its contents need not be initialized and are destroyed.  LHS,
   /// REMAINDER and SCRATCH must be distinct.
-  static int tcDivide(WordType *lhs, const WordType *rhs, WordType *remainder,
-                      WordType *scratch, unsigned parts);
+  static constexpr int tcDivide(WordType *lhs, const WordType *rhs,
+                                WordType *remainder, WordType *scratch,
+                                unsigned parts);
 
   /// Shift a bignum left Count bits. Shifted in bits are zero. There are no
   /// restrictions on Count.
-  static void tcShiftLeft(WordType *, unsigned Words, unsigned Count);
+  static constexpr void tcShiftLeft(WordType *, unsigned Words, unsigned Count);
 
   /// Shift a bignum right Count bits.  Shifted in bits are zero.  There are no
   /// restrictions on Count.
-  static void tcShiftRight(WordType *, unsigned Words, unsigned Count);
+  static constexpr void tcShiftRight(WordType *, unsigned Words,
+                                     unsigned Count);
 
   /// Comparison (unsigned) of two bignums.
-  static int tcCompare(const WordType *, const WordType *, unsigned);
+  static constexpr int tcCompare(const WordType *, const WordType *, unsigned);
 
   /// Increment a bignum in-place.  Return the carry flag.
-  static WordType tcIncrement(WordType *dst, unsigned parts) {
+  static constexpr WordType tcIncrement(WordType *dst, unsigned parts) {
     return tcAddPart(dst, 1, parts);
   }
 
   /// Decrement a bignum in-place.  Return the borrow flag.
-  static WordType tcDecrement(WordType *dst, unsigned parts) {
+  static constexpr WordType tcDecrement(WordType *dst, unsigned parts) {
     return tcSubtractPart(dst, 1, parts);
   }
 
@@ -1826,34 +1990,67 @@ public:
   BIJOU_DUMP_METHOD void dump() const;
 
   /// Returns whether this instance allocated memory.
-  bool needsCleanup() const { return !isSingleWord(); }
+  constexpr bool needsCleanup() const {
+    return BitWidth > APINT_INLINE_WORDS * APINT_BITS_PER_WORD;
+  }
 
 private:
   /// This union is used to store the integer value. When the
-  /// integer bit-width <= 64, it uses VAL, otherwise it uses pVal.
+  /// integer bit-width <= 64, it uses VAL. Wider values that still fit in
+  /// APINT_INLINE_WORDS words use Inline, anything wider uses pVal. Constant
+  /// evaluation only allows reading the member that was last assigned, which
+  /// is always the one the bit width selects.
   union {
     uint64_t VAL;   ///< Used to store the <= 64 bits integer value.
-    uint64_t *pVal; ///< Used to store the >64 bits integer value.
+    uint64_t *pVal; ///< Used to store values wider than the inline buffer.
+    uint64_t Inline[APINT_INLINE_WORDS]; ///< Used to store other >64 bits
+                                         ///< integer values.
   } U;
 
   unsigned BitWidth; ///< The number of bits in this APInt.
 
+  friend class APIntDivider;
   friend class APSInt;
+  template <unsigned Bits> friend class FixedAPInt;
+  friend class MontgomeryContext;
+
+  /// Tag type selecting the uninitialized constructor.
+  struct Uninitialized {};
 
   /// This constructor is used only internally for speed of construction of
-  /// temporaries. It is unsafe since it takes ownership of the pointer, so it
+  /// temporaries. It is unsafe since it leaves the value uninitialized, so it
   /// is not public.
-  APInt(uint64_t *val, unsigned bits) : BitWidth(bits) { U.pVal = val; }
+  constexpr APInt(unsigned bits, Uninitialized);
+
+  /// Allocate the heap words of a value of @p numWords words. They are left
+  /// uninitialized, except during constant evaluation.
+  static constexpr uint64_t *getMemory(unsigned numWords);
+
+  /// Allocate the heap words of a value of @p numWords words, cleared to 0.
+  static constexpr uint64_t *getClearedMemory(unsigned numWords);
+
+  /// Free words from getMemory.
+  static constexpr void freeMemory(uint64_t *words, unsigned numWords);
+
+  /// Make Inline (or VAL) the active member of U, cleared to 0.
+  constexpr void clearInline();
+
+  /// Get the words holding a multi-word value, whether they are stored inline
+  /// or on the heap.
+  constexpr uint64_t *getWords() { return needsCleanup() ? U.pVal : U.Inline; }
+  constexpr const uint64_t *getWords() const {
+    return needsCleanup() ? U.pVal : U.Inline;
+  }
 
   /// Determine which word a bit is in.
   ///
   /// @returns the word position for the specified bit position.
-  static unsigned whichWord(unsigned bitPosition) {
+  static constexpr unsigned whichWord(unsigned bitPosition) {
     return bitPosition / APINT_BITS_PER_WORD;
   }
 
   /// Determine which bit in a word the specified bit position is in.
-  static unsigned whichBit(unsigned bitPosition) {
+  static constexpr unsigned whichBit(unsigned bitPosition) {
     return bitPosition % APINT_BITS_PER_WORD;
   }
 
@@ -1863,7 +2060,7 @@ private:
   /// This method generates and returns a uint64_t (word) mask for a single
   /// bit at a specific bit position. This is used to mask the bit in the
   /// corresponding word.
-  static uint64_t maskBit(unsigned bitPosition) {
+  static constexpr uint64_t maskBit(unsigned bitPosition) {
     return 1ULL << whichBit(bitPosition);
   }
 
@@ -1873,7 +2070,7 @@ private:
   /// word that are not used by the APInt. This is needed after the most
   /// significant word is assigned a value to ensure that those bits are
   /// zero'd out.
-  APInt &clearUnusedBits() {
+  constexpr APInt &clearUnusedBits() {
     // Compute how many bits are used in the final word.
     unsigned WordBits = ((BitWidth - 1) % APINT_BITS_PER_WORD) + 1;
 
@@ -1885,20 +2082,21 @@ private:
     if (isSingleWord())
       U.VAL &= mask;
     else
-      U.pVal[getNumWords() - 1] &= mask;
+      getWords()[getNumWords() - 1] &= mask;
     return *this;
   }
 
   /// Get the word corresponding to a bit position
   /// @returns the corresponding word for the specified bit position.
-  uint64_t getWord(unsigned bitPosition) const {
-    return isSingleWord() ? U.VAL : U.pVal[whichWord(bitPosition)];
+  constexpr uint64_t getWord(unsigned bitPosition) const {
+    return isSingleWord() ? U.VAL : getWords()[whichWord(bitPosition)];
   }
 
   /// Utility method to change the bit width of this APInt to new bit width,
-  /// allocating and/or deallocating as necessary. There is no guarantee on the
+  /// allocating and/or deallocating as necessary. Widths that fit in the
+  /// inline buffer never allocate. There is no guarantee on the
   /// value of any bits upon return. Caller should populate the bits after.
-  void reallocate(unsigned NewBitWidth);
+  constexpr void reallocate(unsigned NewBitWidth);
 
   /// Convert a char array into an APInt
   ///
@@ -1920,152 +2118,279 @@ private:
   /// provides a more convenient form of divide for internal use since KnuthDiv
   /// has specific constraints on its inputs. If those constraints are not met
   /// then it provides a simpler form of divide.
-  static void divide(const WordType *LHS, unsigned lhsWords,
-                     const WordType *RHS, unsigned rhsWords, WordType *Quotient,
-                     WordType *Remainder);
+  ///
+  /// During constant evaluation this falls back to the bit-by-bit tcDivide.
+  static constexpr void divide(const WordType *LHS, unsigned lhsWords,
+                               const WordType *RHS, unsigned rhsWords,
+                               WordType *Quotient, WordType *Remainder);
+
+  /// out-of-line slow case for divide, using Knuth's algorithm D.
+  static void divideSlowCase(const WordType *LHS, unsigned lhsWords,
+                             const WordType *RHS, unsigned rhsWords,
+                             WordType *Quotient, WordType *Remainder);
+
+  /// tcMultiply of operands with at least APINT_KARATSUBA_THRESHOLD words,
+  /// of which only the low LHSPARTS and RHSPARTS are non-zero.
+  static int tcMultiplyWide(WordType *dst, const WordType *lhs,
+                            unsigned lhsParts, const WordType *rhs,
+                            unsigned rhsParts, unsigned parts);
+
+  /// tcFullMultiply of operands of which the narrower, LHS, has at least
+  /// APINT_KARATSUBA_THRESHOLD words.
+  static void tcFullMultiplyWide(WordType *dst, const WordType *lhs,
+                                 const WordType *rhs, unsigned lhsParts,
+                                 unsigned rhsParts);
+
+  /// tcSquare of an operand with at least APINT_KARATSUBA_THRESHOLD
+  /// significant words.
+  static void tcSquareWide(WordType *dst, const WordType *src,
+                           unsigned srcParts, unsigned dstParts);
+
+  /// Run-time implementations of the word-wise slow cases. They use the
+  /// widest vector instructions of the host CPU and fall back to word loops.
+  static void tcAndVector(WordType *dst, const WordType *rhs, unsigned parts);
+  static void tcOrVector(WordType *dst, const WordType *rhs, unsigned parts);
+  static void tcXorVector(WordType *dst, const WordType *rhs, unsigned parts);
+  static void tcComplementVector(WordType *dst, unsigned parts);
+  static unsigned tcPopulationVector(const WordType *src,
+                                     unsigned parts) BIJOU_READONLY;
+  static bool tcEqualVector(const WordType *lhs, const WordType *rhs,
+                            unsigned parts) BIJOU_READONLY;
+  static bool tcIntersectsVector(const WordType *lhs, const WordType *rhs,
+                                 unsigned parts) BIJOU_READONLY;
+  static bool tcIsSubsetOfVector(const WordType *lhs, const WordType *rhs,
+                                 unsigned parts) BIJOU_READONLY;
+
+  /// Run-time implementations of the carry chains of tcAdd, tcSubtract and
+  /// tcMultiplyPart. The multiplications use MULX with the two carry chains
+  /// of ADCX and ADOX if the host CPU supports them.
+  static WordType tcAddChain(WordType *dst, const WordType *rhs, WordType c,
+                             unsigned parts);
+  static WordType tcSubtractChain(WordType *dst, const WordType *rhs,
+                                  WordType c, unsigned parts);
+
+  /// DST[0, PARTS) += SRC * MULTIPLIER + CARRY, returning the high word.
+  static WordType tcMultiplyAddChain(WordType *dst, const WordType *src,
+                                     WordType multiplier, WordType carry,
+                                     unsigned parts);
+
+  /// DST[0, PARTS) = SRC * MULTIPLIER + CARRY, returning the high word.
+  static WordType tcMultiplyChain(WordType *dst, const WordType *src,
+                                  WordType multiplier, WordType carry,
+                                  unsigned parts);
+
+  /// Fully unrolled forms of tcAdd, tcSubtract, tcShiftLeft, tcShiftRight,
+  /// tcCompare and tcMultiply for a word count known at compile time. The
+  /// generic entry points jump to them for the common widths of two to
+  /// APINT_MAX_UNROLLED_PARTS words.
+  template <unsigned Parts>
+  static constexpr WordType tcAddFixed(WordType *dst, const WordType *rhs,
+                                       WordType c);
+  template <unsigned Parts>
+  static constexpr WordType tcSubtractFixed(WordType *dst, const WordType *rhs,
+                                            WordType c);
+  template <unsigned Parts>
+  static constexpr void tcShiftLeftFixed(WordType *Dst, unsigned Count);
+  template <unsigned Parts>
+  static constexpr void tcShiftRightFixed(WordType *Dst, unsigned Count);
+  template <unsigned Parts>
+  static constexpr int tcCompareFixed(const WordType *lhs,
+                                      const WordType *rhs);
+  template <unsigned Parts>
+  static constexpr int tcMultiplyFixed(WordType *dst, const WordType *lhs,
+                                       const WordType *rhs);
+
+  /// Calls @p F with std::integral_constant<unsigned, I> for each I in
+  /// [0, Count), without a loop.
+  template <unsigned Count, typename Fn>
+  static constexpr void unrollParts(Fn &&F) {
+    [&]<unsigned... I>(std::integer_sequence<unsigned, I...>) {
+      (F(std::integral_constant<unsigned, I>()), ...);
+    }(std::make_integer_sequence<unsigned, Count>());
+  }
+
+  /// @returns the word with the least significant @p bits set. @p bits cannot
+  /// be zero.
+  static constexpr WordType lowBitMask(unsigned bits) {
+    assert(bits != 0 && bits <= APINT_BITS_PER_WORD);
+    return WORDTYPE_MAX >> (APINT_BITS_PER_WORD - bits);
+  }
 
-  /// out-of-line slow case for inline constructor
-  void initSlowCase(uint64_t val, bool isSigned);
+  /// @returns the value of the lower half of @p part.
+  static constexpr WordType lowHalf(WordType part) {
+    return part & lowBitMask(APINT_BITS_PER_WORD / 2);
+  }
+
+  /// @returns the value of the upper half of @p part.
+  static constexpr WordType highHalf(WordType part) {
+    return part >> (APINT_BITS_PER_WORD / 2);
+  }
+
+  /// @returns the low word of @p lhs * @p rhs and stores the high word in
+  /// @p high.
+  static constexpr WordType multiplyWord(WordType lhs, WordType rhs,
+                                         WordType &high) {
+#if BIJOU_HAS_INT128
+    unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    high = WordType(product >> APINT_BITS_PER_WORD);
+    return WordType(product);
+#else
+    WordType ll = lowHalf(lhs) * lowHalf(rhs);
+    WordType lh = lowHalf(lhs) * highHalf(rhs);
+    WordType hl = highHalf(lhs) * lowHalf(rhs);
+    WordType hh = highHalf(lhs) * highHalf(rhs);
+    WordType mid = highHalf(ll) + lowHalf(lh) + lowHalf(hl);
+    high = hh + highHalf(lh) + highHalf(hl) + highHalf(mid);
+    return (mid << (APINT_BITS_PER_WORD / 2)) | lowHalf(ll);
+#endif
+  }
+
+  /// @returns rotateAmt modulo BitWidth, for the rotations by an APInt.
+  static constexpr unsigned rotateModulo(unsigned BitWidth,
+                                         const APInt &rotateAmt);
+
+  /// slow case for inline constructor
+  constexpr void initSlowCase(uint64_t val, bool isSigned);
 
   /// shared code between two array constructors
-  void initFromArray(std::span<const uint64_t> array);
+  constexpr void initFromArray(std::span<const uint64_t> array);
 
-  /// out-of-line slow case for inline copy constructor
-  void initSlowCase(const APInt &that);
+  /// slow case for inline copy constructor
+  constexpr void initSlowCase(const APInt &that);
 
-  /// out-of-line slow case for shl
-  void shlSlowCase(unsigned ShiftAmt);
+  /// slow case for shl
+  constexpr void shlSlowCase(unsigned ShiftAmt);
 
-  /// out-of-line slow case for lshr.
-  void lshrSlowCase(unsigned ShiftAmt);
+  /// slow case for lshr.
+  constexpr void lshrSlowCase(unsigned ShiftAmt);
 
-  /// out-of-line slow case for ashr.
-  void ashrSlowCase(unsigned ShiftAmt);
+  /// slow case for ashr.
+  constexpr void ashrSlowCase(unsigned ShiftAmt);
 
-  /// out-of-line slow case for operator=
-  void assignSlowCase(const APInt &RHS);
+  /// slow case for operator=
+  constexpr void assignSlowCase(const APInt &RHS);
 
-  /// out-of-line slow case for operator==
-  bool equalSlowCase(const APInt &RHS) const BIJOU_READONLY;
+  /// slow case for operator==
+  constexpr bool equalSlowCase(const APInt &RHS) const BIJOU_READONLY;
 
-  /// out-of-line slow case for countLeadingZeros
-  unsigned countLeadingZerosSlowCase() const BIJOU_READONLY;
+  /// slow case for countLeadingZeros
+  constexpr unsigned countLeadingZerosSlowCase() const BIJOU_READONLY;
 
-  /// out-of-line slow case for countLeadingOnes.
-  unsigned countLeadingOnesSlowCase() const BIJOU_READONLY;
+  /// slow case for countLeadingOnes.
+  constexpr unsigned countLeadingOnesSlowCase() const BIJOU_READONLY;
 
-  /// out-of-line slow case for countTrailingZeros.
-  unsigned countTrailingZerosSlowCase() const BIJOU_READONLY;
+  /// slow case for countTrailingZeros.
+  constexpr unsigned countTrailingZerosSlowCase() const BIJOU_READONLY;
 
-  /// out-of-line slow case for countTrailingOnes
-  unsigned countTrailingOnesSlowCase() const BIJOU_READONLY;
+  /// slow case for countTrailingOnes
+  constexpr unsigned countTrailingOnesSlowCase() const BIJOU_READONLY;
 
-  /// out-of-line slow case for countPopulation
-  unsigned countPopulationSlowCase() const BIJOU_READONLY;
+  /// slow case for countPopulation
+  constexpr unsigned countPopulationSlowCase() const BIJOU_READONLY;
 
-  /// out-of-line slow case for intersects.
-  bool intersectsSlowCase(const APInt &RHS) const BIJOU_READONLY;
+  /// slow case for intersects.
+  constexpr bool intersectsSlowCase(const APInt &RHS) const BIJOU_READONLY;
 
-  /// out-of-line slow case for isSubsetOf.
-  bool isSubsetOfSlowCase(const APInt &RHS) const BIJOU_READONLY;
+  /// slow case for isSubsetOf.
+  constexpr bool isSubsetOfSlowCase(const APInt &RHS) const BIJOU_READONLY;
 
-  /// out-of-line slow case for setBits.
-  void setBitsSlowCase(unsigned loBit, unsigned hiBit);
+  /// slow case for setBits.
+  constexpr void setBitsSlowCase(unsigned loBit, unsigned hiBit);
 
-  /// out-of-line slow case for flipAllBits.
-  void flipAllBitsSlowCase();
+  /// slow case for flipAllBits.
+  constexpr void flipAllBitsSlowCase();
 
   /// out-of-line slow case for concat.
   APInt concatSlowCase(const APInt &NewLSB) const;
 
-  /// out-of-line slow case for operator&=.
-  void andAssignSlowCase(const APInt &RHS);
+  /// slow case for operator&=.
+  constexpr void andAssignSlowCase(const APInt &RHS);
 
-  /// out-of-line slow case for operator|=.
-  void orAssignSlowCase(const APInt &RHS);
+  /// slow case for operator|=.
+  constexpr void orAssignSlowCase(const APInt &RHS);
 
-  /// out-of-line slow case for operator^=.
-  void xorAssignSlowCase(const APInt &RHS);
+  /// slow case for operator^=.
+  constexpr void xorAssignSlowCase(const APInt &RHS);
 
   /// Unsigned comparison. Returns -1, 0, or 1 if this APInt is less than, equal
   /// to, or greater than RHS.
-  int compare(const APInt &RHS) const BIJOU_READONLY;
+  constexpr int compare(const APInt &RHS) const BIJOU_READONLY;
 
   /// Signed comparison. Returns -1, 0, or 1 if this APInt is less than, equal
   /// to, or greater than RHS.
-  int compareSigned(const APInt &RHS) const BIJOU_READONLY;
+  constexpr int compareSigned(const APInt &RHS) const BIJOU_READONLY;
 
   /// @}
 };
 
-inline bool operator==(uint64_t V1, const APInt &V2) { return V2 == V1; }
+constexpr bool operator==(uint64_t V1, const APInt &V2) { return V2 == V1; }
 
-inline bool operator!=(uint64_t V1, const APInt &V2) { return V2 != V1; }
+constexpr bool operator!=(uint64_t V1, const APInt &V2) { return V2 != V1; }
 
 /// Unary bitwise complement operator.
 ///
 /// @returns an APInt that is the bitwise complement of @p v.
-inline APInt operator~(APInt v) {
+constexpr APInt operator~(APInt v) {
   v.flipAllBits();
   return v;
 }
 
-inline APInt operator&(APInt a, const APInt &b) {
+constexpr APInt operator&(APInt a, const APInt &b) {
   a &= b;
   return a;
 }
 
-inline APInt operator&(const APInt &a, APInt &&b) {
+constexpr APInt operator&(const APInt &a, APInt &&b) {
   b &= a;
   return std::move(b);
 }
 
-inline APInt operator&(APInt a, uint64_t RHS) {
+constexpr APInt operator&(APInt a, uint64_t RHS) {
   a &= RHS;
   return a;
 }
 
-inline APInt operator&(uint64_t LHS, APInt b) {
+constexpr APInt operator&(uint64_t LHS, APInt b) {
   b &= LHS;
   return b;
 }
 
-inline APInt operator|(APInt a, const APInt &b) {
+constexpr APInt operator|(APInt a, const APInt &b) {
   a |= b;
   return a;
 }
 
-inline APInt operator|(const APInt &a, APInt &&b) {
+constexpr APInt operator|(const APInt &a, APInt &&b) {
   b |= a;
   return std::move(b);
 }
 
-inline APInt operator|(APInt a, uint64_t RHS) {
+constexpr APInt operator|(APInt a, uint64_t RHS) {
   a |= RHS;
   return a;
 }
 
-inline APInt operator|(uint64_t LHS, APInt b) {
+constexpr APInt operator|(uint64_t LHS, APInt b) {
   b |= LHS;
   return b;
 }
 
-inline APInt operator^(APInt a, const APInt &b) {
+constexpr APInt operator^(APInt a, const APInt &b) {
   a ^= b;
   return a;
 }
 
-inline APInt operator^(const APInt &a, APInt &&b) {
+constexpr APInt operator^(const APInt &a, APInt &&b) {
   b ^= a;
   return std::move(b);
 }
 
-inline APInt operator^(APInt a, uint64_t RHS) {
+constexpr APInt operator^(APInt a, uint64_t RHS) {
   a ^= RHS;
   return a;
 }
 
-inline APInt operator^(uint64_t LHS, APInt b) {
+constexpr APInt operator^(uint64_t LHS, APInt b) {
   b ^= LHS;
   return b;
 }
@@ -2077,82 +2402,1841 @@ inline std::ostream &operator<<(std::ostream &OS, const APInt &I) {
 }
 #endif
 
-inline APInt operator-(APInt v) {
+constexpr APInt operator-(APInt v) {
   v.negate();
   return v;
 }
 
-inline APInt operator+(APInt a, const APInt &b) {
+constexpr APInt operator+(APInt a, const APInt &b) {
   a += b;
   return a;
 }
 
-inline APInt operator+(const APInt &a, APInt &&b) {
+constexpr APInt operator+(const APInt &a, APInt &&b) {
   b += a;
   return std::move(b);
 }
 
-inline APInt operator+(APInt a, uint64_t RHS) {
+constexpr APInt operator+(APInt a, uint64_t RHS) {
   a += RHS;
   return a;
 }
 
-inline APInt operator+(uint64_t LHS, APInt b) {
+constexpr APInt operator+(uint64_t LHS, APInt b) {
   b += LHS;
   return b;
 }
 
-inline APInt operator-(APInt a, const APInt &b) {
+constexpr APInt operator-(APInt a, const APInt &b) {
   a -= b;
   return a;
 }
 
-inline APInt operator-(const APInt &a, APInt &&b) {
+constexpr APInt operator-(const APInt &a, APInt &&b) {
   b.negate();
   b += a;
   return std::move(b);
 }
 
-inline APInt operator-(APInt a, uint64_t RHS) {
+constexpr APInt operator-(APInt a, uint64_t RHS) {
   a -= RHS;
   return a;
 }
 
-inline APInt operator-(uint64_t LHS, APInt b) {
+constexpr APInt operator-(uint64_t LHS, APInt b) {
   b.negate();
   b += LHS;
   return b;
 }
 
-inline APInt operator*(APInt a, uint64_t RHS) {
+constexpr APInt operator*(APInt a, uint64_t RHS) {
   a *= RHS;
   return a;
 }
 
-inline APInt operator*(uint64_t LHS, APInt b) {
+constexpr APInt operator*(uint64_t LHS, APInt b) {
   b *= LHS;
   return b;
 }
 
+//===----------------------------------------------------------------------===//
+//                APInt members usable in constant expressions
+//===----------------------------------------------------------------------===//
+
+// Constant evaluation tracks which member of APInt::U is active, and does not
+// allow reading any other. Code that changes the storage of a value therefore
+// assigns the new member (VAL, Inline or pVal) directly before it writes the
+// words through getWords(). It also has no word pool, so heap words come from
+// operator new while constant evaluating.
+
+constexpr uint64_t *APInt::getMemory(unsigned numWords) {
+  // Constant expressions may not read uninitialized words, so zero them.
+  if (std::is_constant_evaluated())
+    return new uint64_t[numWords]();
+  return allocateWords(numWords);
+}
+
+constexpr uint64_t *APInt::getClearedMemory(unsigned numWords) {
+  uint64_t *result = getMemory(numWords);
+  std::fill_n(result, numWords, 0);
+  return result;
+}
+
+constexpr void APInt::freeMemory(uint64_t *words, unsigned numWords) {
+  if (std::is_constant_evaluated())
+    delete[] words;
+  else
+    deallocateWords(words, numWords);
+}
+
+constexpr void APInt::clearInline() {
+  if (isSingleWord()) {
+    U.VAL = 0;
+    return;
+  }
+  // The words past the value only matter to constant evaluation, which may
+  // not copy them while they are uninitialized.
+  unsigned NumWords =
+      std::is_constant_evaluated() ? APINT_INLINE_WORDS : getNumWords();
+  for (unsigned i = 0; i != NumWords; ++i)
+    U.Inline[i] = 0;
+}
+
+constexpr APInt::APInt(unsigned bits, Uninitialized) : BitWidth(bits) {
+  if (needsCleanup())
+    U.pVal = getMemory(getNumWords());
+  else if (std::is_constant_evaluated())
+    clearInline();
+}
+
+constexpr void APInt::initSlowCase(uint64_t val, bool isSigned) {
+  if (needsCleanup())
+    U.pVal = getMemory(getNumWords());
+  else if (std::is_constant_evaluated())
+    clearInline();
+  uint64_t *Words = getWords();
+  Words[0] = val;
+  std::fill_n(Words + 1, getNumWords() - 1,
+              isSigned && int64_t(val) < 0 ? WORDTYPE_MAX : 0);
+  clearUnusedBits();
+}
+
+constexpr void APInt::initSlowCase(const APInt &that) {
+  U.pVal = getMemory(getNumWords());
+  std::copy_n(that.U.pVal, getNumWords(), U.pVal);
+}
+
+constexpr void APInt::initFromArray(std::span<const uint64_t> bigVal) {
+  assert(bigVal.data() && "Null pointer detected!");
+  if (isSingleWord())
+    U.VAL = bigVal[0];
+  else {
+    // Get memory, cleared to 0
+    if (needsCleanup())
+      U.pVal = getClearedMemory(getNumWords());
+    else
+      clearInline();
+    // Calculate the number of words to copy
+    unsigned words = std::min<unsigned>(bigVal.size(), getNumWords());
+    // Copy the words from bigVal to the storage
+    std::copy_n(bigVal.data(), words, getWords());
+  }
+  // Make sure unused high bits are cleared
+  clearUnusedBits();
+}
+
+constexpr APInt::APInt(unsigned numBits, std::span<const uint64_t> bigVal)
+    : BitWidth(numBits) {
+  initFromArray(bigVal);
+}
+
+constexpr APInt::APInt(unsigned numBits, unsigned numWords,
+                       const uint64_t bigVal[])
+    : BitWidth(numBits) {
+  initFromArray(std::span(bigVal, numWords));
+}
+
+constexpr void APInt::reallocate(unsigned NewBitWidth) {
+  // If the number of words is the same we can just change the width and stop.
+  if (getNumWords() == getNumWords(NewBitWidth)) {
+    BitWidth = NewBitWidth;
+    return;
+  }
+
+  // If we have an allocation, delete it.
+  if (needsCleanup())
+    freeMemory(U.pVal, getNumWords());
+
+  // Update BitWidth.
+  BitWidth = NewBitWidth;
+
+  // If we are supposed to have an allocation, create it.
+  if (needsCleanup())
+    U.pVal = getMemory(getNumWords());
+  else if (std::is_constant_evaluated())
+    clearInline();
+}
+
+constexpr void APInt::assignSlowCase(const APInt &RHS) {
+  // Don't do anything for X = X
+  if (this == &RHS)
+    return;
+
+  // Adjust the bit width and handle allocations as necessary.
+  reallocate(RHS.getBitWidth());
+
+  // Copy the data.
+  if (isSingleWord())
+    U.VAL = RHS.U.VAL;
+  else
+    std::copy_n(RHS.getWords(), getNumWords(), getWords());
+}
+
+/// Prefix increment operator. Increments the APInt by one.
+constexpr APInt &APInt::operator++() {
+  if (isSingleWord())
+    ++U.VAL;
+  else
+    tcIncrement(getWords(), getNumWords());
+  return clearUnusedBits();
+}
+
+/// Prefix decrement operator. Decrements the APInt by one.
+constexpr APInt &APInt::operator--() {
+  if (isSingleWord())
+    --U.VAL;
+  else
+    tcDecrement(getWords(), getNumWords());
+  return clearUnusedBits();
+}
+
+/// Adds the RHS APInt to this APInt.
+/// @returns this, after addition of RHS.
+/// Addition assignment operator.
+constexpr APInt &APInt::operator+=(const APInt &RHS) {
+  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
+  if (isSingleWord())
+    U.VAL += RHS.U.VAL;
+  else
+    tcAdd(getWords(), RHS.getWords(), 0, getNumWords());
+  return clearUnusedBits();
+}
+
+constexpr APInt &APInt::operator+=(uint64_t RHS) {
+  if (isSingleWord())
+    U.VAL += RHS;
+  else
+    tcAddPart(getWords(), RHS, getNumWords());
+  return clearUnusedBits();
+}
+
+/// Subtracts the RHS APInt from this APInt
+/// @returns this, after subtraction
+/// Subtraction assignment operator.
+constexpr APInt &APInt::operator-=(const APInt &RHS) {
+  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
+  if (isSingleWord())
+    U.VAL -= RHS.U.VAL;
+  else
+    tcSubtract(getWords(), RHS.getWords(), 0, getNumWords());
+  return clearUnusedBits();
+}
+
+constexpr APInt &APInt::operator-=(uint64_t RHS) {
+  if (isSingleWord())
+    U.VAL -= RHS;
+  else
+    tcSubtractPart(getWords(), RHS, getNumWords());
+  return clearUnusedBits();
+}
+
+constexpr APInt APInt::operator*(const APInt &RHS) const {
+  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
+  if (isSingleWord())
+    return APInt(BitWidth, U.VAL * RHS.U.VAL);
+
+  APInt Result(getBitWidth(), Uninitialized());
+  tcMultiply(Result.getWords(), getWords(), RHS.getWords(), getNumWords());
+  Result.clearUnusedBits();
+  return Result;
+}
+
+constexpr APInt APInt::sqr() const {
+  if (isSingleWord())
+    return APInt(BitWidth, U.VAL * U.VAL);
+
+  APInt Result(getBitWidth(), Uninitialized());
+  tcSquare(Result.getWords(), getWords(), getNumWords(), getNumWords());
+  Result.clearUnusedBits();
+  return Result;
+}
+
+constexpr void APInt::andAssignSlowCase(const APInt &RHS) {
+  WordType *dst = getWords();
+  const WordType *rhs = RHS.getWords();
+  if (!std::is_constant_evaluated() && getNumWords() >= APINT_VECTOR_THRESHOLD)
+    return tcAndVector(dst, rhs, getNumWords());
+  for (size_t i = 0, e = getNumWords(); i != e; ++i)
+    dst[i] &= rhs[i];
+}
+
+constexpr void APInt::orAssignSlowCase(const APInt &RHS) {
+  WordType *dst = getWords();
+  const WordType *rhs = RHS.getWords();
+  if (!std::is_constant_evaluated() && getNumWords() >= APINT_VECTOR_THRESHOLD)
+    return tcOrVector(dst, rhs, getNumWords());
+  for (size_t i = 0, e = getNumWords(); i != e; ++i)
+    dst[i] |= rhs[i];
+}
+
+constexpr void APInt::xorAssignSlowCase(const APInt &RHS) {
+  WordType *dst = getWords();
+  const WordType *rhs = RHS.getWords();
+  if (!std::is_constant_evaluated() && getNumWords() >= APINT_VECTOR_THRESHOLD)
+    return tcXorVector(dst, rhs, getNumWords());
+  for (size_t i = 0, e = getNumWords(); i != e; ++i)
+    dst[i] ^= rhs[i];
+}
+
+constexpr APInt &APInt::operator*=(const APInt &RHS) {
+  *this = *this * RHS;
+  return *this;
+}
+
+constexpr APInt &APInt::operator*=(uint64_t RHS) {
+  if (isSingleWord()) {
+    U.VAL *= RHS;
+  } else {
+    unsigned NumWords = getNumWords();
+    uint64_t *Words = getWords();
+    tcMultiplyPart(Words, Words, RHS, 0, NumWords, NumWords, false);
+  }
+  return clearUnusedBits();
+}
+
+constexpr bool APInt::equalSlowCase(const APInt &RHS) const {
+  const uint64_t *Words = getWords();
+  if (!std::is_constant_evaluated() && getNumWords() >= APINT_VECTOR_THRESHOLD)
+    return tcEqualVector(Words, RHS.getWords(), getNumWords());
+  return std::equal(Words, Words + getNumWords(), RHS.getWords());
+}
+
+constexpr int APInt::compare(const APInt &RHS) const {
+  assert(BitWidth == RHS.BitWidth && "Bit widths must be same for comparison");
+  if (isSingleWord())
+    return U.VAL < RHS.U.VAL ? -1 : U.VAL > RHS.U.VAL;
+
+  return tcCompare(getWords(), RHS.getWords(), getNumWords());
+}
+
+constexpr int APInt::compareSigned(const APInt &RHS) const {
+  assert(BitWidth == RHS.BitWidth && "Bit widths must be same for comparison");
+  if (isSingleWord()) {
+    int64_t lhsSext = SignExtend64(U.VAL, BitWidth);
+    int64_t rhsSext = SignExtend64(RHS.U.VAL, BitWidth);
+    return lhsSext < rhsSext ? -1 : lhsSext > rhsSext;
+  }
+
+  bool lhsNeg = isNegative();
+  bool rhsNeg = RHS.isNegative();
+
+  // If the sign bits don't match, then (LHS < RHS) if LHS is negative
+  if (lhsNeg != rhsNeg)
+    return lhsNeg ? -1 : 1;
+
+  // Otherwise we can just use an unsigned comparison, because even negative
+  // numbers compare correctly this way if both have the same signed-ness.
+  return tcCompare(getWords(), RHS.getWords(), getNumWords());
+}
+
+constexpr void APInt::setBitsSlowCase(unsigned loBit, unsigned hiBit) {
+  uint64_t *Words = getWords();
+  unsigned loWord = whichWord(loBit);
+  unsigned hiWord = whichWord(hiBit);
+
+  // Create an initial mask for the low word with zeros below loBit.
+  uint64_t loMask = WORDTYPE_MAX << whichBit(loBit);
+
+  // If hiBit is not aligned, we need a high mask.
+  unsigned hiShiftAmt = whichBit(hiBit);
+  if (hiShiftAmt != 0) {
+    // Create a high mask with zeros above hiBit.
+    uint64_t hiMask = WORDTYPE_MAX >> (APINT_BITS_PER_WORD - hiShiftAmt);
+    // If loWord and hiWord are equal, then we combine the masks. Otherwise,
+    // set the bits in hiWord.
+    if (hiWord == loWord)
+      loMask &= hiMask;
+    else
+      Words[hiWord] |= hiMask;
+  }
+  // Apply the mask to the low word.
+  Words[loWord] |= loMask;
+
+  // Fill any words between loWord and hiWord with all ones.
+  for (unsigned word = loWord + 1; word < hiWord; ++word)
+    Words[word] = WORDTYPE_MAX;
+}
+
+/// Toggle every bit to its opposite value.
+constexpr void APInt::flipAllBitsSlowCase() {
+  uint64_t *Words = getWords();
+  if (std::is_constant_evaluated() || getNumWords() < APINT_VECTOR_THRESHOLD) {
+    for (unsigned i = 0, e = getNumWords(); i != e; ++i)
+      Words[i] = ~Words[i];
+  } else {
+    tcComplementVector(Words, getNumWords());
+  }
+  clearUnusedBits();
+}
+
+/// Toggle a given bit to its opposite value whose position is given
+/// as "bitPosition".
+/// Toggles a given bit to its opposite value.
+constexpr void APInt::flipBit(unsigned bitPosition) {
+  assert(bitPosition < BitWidth && "Out of the bit-width range!");
+  setBitVal(bitPosition, !(*this)[bitPosition]);
+}
+
+/// This function returns the high "numBits" bits of this APInt.
+constexpr APInt APInt::getHiBits(unsigned numBits) const {
+  return this->lshr(BitWidth - numBits);
+}
+
+/// This function returns the low "numBits" bits of this APInt.
+constexpr APInt APInt::getLoBits(unsigned numBits) const {
+  APInt Result(getLowBitsSet(BitWidth, numBits));
+  Result &= *this;
+  return Result;
+}
+
+constexpr unsigned APInt::countLeadingZerosSlowCase() const {
+  const uint64_t *Words = getWords();
+  unsigned Count = 0;
+  for (int i = getNumWords()-1; i >= 0; --i) {
+    uint64_t V = Words[i];
+    if (V == 0)
+      Count += APINT_BITS_PER_WORD;
+    else {
+      Count += bijou::countLeadingZeros(V);
+      break;
+    }
+  }
+  // Adjust for unused bits in the most significant word (they are zero).
+  unsigned Mod = BitWidth % APINT_BITS_PER_WORD;
+  Count -= Mod > 0 ? APINT_BITS_PER_WORD - Mod : 0;
+  return Count;
+}
+
+constexpr unsigned APInt::countLeadingOnesSlowCase() const {
+  unsigned highWordBits = BitWidth % APINT_BITS_PER_WORD;
+  unsigned shift;
+  if (!highWordBits) {
+    highWordBits = APINT_BITS_PER_WORD;
+    shift = 0;
+  } else {
+    shift = APINT_BITS_PER_WORD - highWordBits;
+  }
+  const uint64_t *Words = getWords();
+  int i = getNumWords() - 1;
+  unsigned Count = bijou::countLeadingOnes(Words[i] << shift);
+  if (Count == highWordBits) {
+    for (i--; i >= 0; --i) {
+      if (Words[i] == WORDTYPE_MAX)
+        Count += APINT_BITS_PER_WORD;
+      else {
+        Count += bijou::countLeadingOnes(Words[i]);
+        break;
+      }
+    }
+  }
+  return Count;
+}
+
+constexpr unsigned APInt::countTrailingZerosSlowCase() const {
+  const uint64_t *Words = getWords();
+  unsigned Count = 0;
+  unsigned i = 0;
+  for (; i < getNumWords() && Words[i] == 0; ++i)
+    Count += APINT_BITS_PER_WORD;
+  if (i < getNumWords())
+    Count += bijou::countTrailingZeros(Words[i]);
+  return std::min(Count, BitWidth);
+}
+
+constexpr unsigned APInt::countTrailingOnesSlowCase() const {
+  const uint64_t *Words = getWords();
+  unsigned Count = 0;
+  unsigned i = 0;
+  for (; i < getNumWords() && Words[i] == WORDTYPE_MAX; ++i)
+    Count += APINT_BITS_PER_WORD;
+  if (i < getNumWords())
+    Count += bijou::countTrailingOnes(Words[i]);
+  assert(Count <= BitWidth);
+  return Count;
+}
+
+constexpr unsigned APInt::countPopulationSlowCase() const {
+  const uint64_t *Words = getWords();
+  if (!std::is_constant_evaluated())
+    return tcPopulationVector(Words, getNumWords());
+  unsigned Count = 0;
+  for (unsigned i = 0; i < getNumWords(); ++i)
+    Count += bijou::countPopulation(Words[i]);
+  return Count;
+}
+
+constexpr bool APInt::intersectsSlowCase(const APInt &RHS) const {
+  const WordType *lhs = getWords(), *rhs = RHS.getWords();
+  if (!std::is_constant_evaluated() && getNumWords() >= APINT_VECTOR_THRESHOLD)
+    return tcIntersectsVector(lhs, rhs, getNumWords());
+  for (unsigned i = 0, e = getNumWords(); i != e; ++i)
+    if ((lhs[i] & rhs[i]) != 0)
+      return true;
+
+  return false;
+}
+
+constexpr bool APInt::isSubsetOfSlowCase(const APInt &RHS) const {
+  const WordType *lhs = getWords(), *rhs = RHS.getWords();
+  if (!std::is_constant_evaluated() && getNumWords() >= APINT_VECTOR_THRESHOLD)
+    return tcIsSubsetOfVector(lhs, rhs, getNumWords());
+  for (unsigned i = 0, e = getNumWords(); i != e; ++i)
+    if ((lhs[i] & ~rhs[i]) != 0)
+      return false;
+
+  return true;
+}
+
+// Truncate to new width.
+constexpr APInt APInt::trunc(unsigned width) const {
+  assert(width < BitWidth && "Invalid APInt Truncate request");
+
+  if (width <= APINT_BITS_PER_WORD)
+    return APInt(width, getRawData()[0]);
+
+  APInt Result(width, Uninitialized());
+  uint64_t *Dst = Result.getWords();
+  const uint64_t *Src = getWords();
+
+  // Copy full words.
+  unsigned i;
+  for (i = 0; i != width / APINT_BITS_PER_WORD; i++)
+    Dst[i] = Src[i];
+
+  // Truncate and copy any partial word.
+  unsigned bits = (0 - width) % APINT_BITS_PER_WORD;
+  if (bits != 0)
+    Dst[i] = Src[i] << bits >> bits;
+
+  return Result;
+}
+
+// Truncate to new width with unsigned saturation.
+constexpr APInt APInt::truncUSat(unsigned width) const {
+  assert(width < BitWidth && "Invalid APInt Truncate request");
+
+  // Can we just losslessly truncate it?
+  if (isIntN(width))
+    return trunc(width);
+  // If not, then just return the new limit.
+  return APInt::getMaxValue(width);
+}
+
+// Truncate to new width with signed saturation.
+constexpr APInt APInt::truncSSat(unsigned width) const {
+  assert(width < BitWidth && "Invalid APInt Truncate request");
+
+  // Can we just losslessly truncate it?
+  if (isSignedIntN(width))
+    return trunc(width);
+  // If not, then just return the new limits.
+  return isNegative() ? APInt::getSignedMinValue(width)
+                      : APInt::getSignedMaxValue(width);
+}
+
+// Sign extend to a new width.
+constexpr APInt APInt::sext(unsigned Width) const {
+  assert(Width > BitWidth && "Invalid APInt SignExtend request");
+
+  if (Width <= APINT_BITS_PER_WORD)
+    return APInt(Width, SignExtend64(U.VAL, BitWidth));
+
+  APInt Result(Width, Uninitialized());
+  uint64_t *Dst = Result.getWords();
+
+  // Copy words.
+  std::copy_n(getRawData(), getNumWords(), Dst);
+
+  // Sign extend the last word since there may be unused bits in the input.
+  Dst[getNumWords() - 1] = SignExtend64(
+      Dst[getNumWords() - 1], ((BitWidth - 1) % APINT_BITS_PER_WORD) + 1);
+
+  // Fill with sign bits.
+  std::fill_n(Dst + getNumWords(), Result.getNumWords() - getNumWords(),
+              isNegative() ? WORDTYPE_MAX : 0);
+  Result.clearUnusedBits();
+  return Result;
+}
+
+//  Zero extend to a new width.
+constexpr APInt APInt::zext(unsigned width) const {
+  assert(width > BitWidth && "Invalid APInt ZeroExtend request");
+
+  if (width <= APINT_BITS_PER_WORD)
+    return APInt(width, U.VAL);
+
+  APInt Result(width, Uninitialized());
+  uint64_t *Dst = Result.getWords();
+
+  // Copy words.
+  std::copy_n(getRawData(), getNumWords(), Dst);
+
+  // Zero remaining words.
+  std::fill_n(Dst + getNumWords(), Result.getNumWords() - getNumWords(), 0);
+
+  return Result;
+}
+
+constexpr APInt APInt::zextOrTrunc(unsigned width) const {
+  if (BitWidth < width)
+    return zext(width);
+  if (BitWidth > width)
+    return trunc(width);
+  return *this;
+}
+
+constexpr APInt APInt::sextOrTrunc(unsigned width) const {
+  if (BitWidth < width)
+    return sext(width);
+  if (BitWidth > width)
+    return trunc(width);
+  return *this;
+}
+
+constexpr APInt APInt::truncOrSelf(unsigned width) const {
+  if (BitWidth > width)
+    return trunc(width);
+  return *this;
+}
+
+constexpr APInt APInt::zextOrSelf(unsigned width) const {
+  if (BitWidth < width)
+    return zext(width);
+  return *this;
+}
+
+constexpr APInt APInt::sextOrSelf(unsigned width) const {
+  if (BitWidth < width)
+    return sext(width);
+  return *this;
+}
+
+/// Arithmetic right-shift this APInt by shiftAmt.
+/// Arithmetic right-shift function.
+constexpr void APInt::ashrInPlace(const APInt &shiftAmt) {
+  ashrInPlace((unsigned)shiftAmt.getLimitedValue(BitWidth));
+}
+
+/// Arithmetic right-shift this APInt by shiftAmt.
+/// Arithmetic right-shift function.
+constexpr void APInt::ashrSlowCase(unsigned ShiftAmt) {
+  // Don't bother performing a no-op shift.
+  if (!ShiftAmt)
+    return;
+
+  // Save the original sign bit for later.
+  bool Negative = isNegative();
+
+  // WordShift is the inter-part shift; BitShift is intra-part shift.
+  unsigned WordShift = ShiftAmt / APINT_BITS_PER_WORD;
+  unsigned BitShift = ShiftAmt % APINT_BITS_PER_WORD;
+
+  uint64_t *Words = getWords();
+  unsigned WordsToMove = getNumWords() - WordShift;
+  if (WordsToMove != 0) {
+    // Sign extend the last word to fill in the unused bits.
+    Words[getNumWords() - 1] = SignExtend64(
+        Words[getNumWords() - 1], ((BitWidth - 1) % APINT_BITS_PER_WORD) + 1);
+
+    // Fastpath for moving by whole words.
+    if (BitShift == 0) {
+      std::copy(Words + WordShift, Words + WordShift + WordsToMove, Words);
+    } else {
+      // Move the words containing significant bits.
+      for (unsigned i = 0; i != WordsToMove - 1; ++i)
+        Words[i] =
+            (Words[i + WordShift] >> BitShift) |
+            (Words[i + WordShift + 1] << (APINT_BITS_PER_WORD - BitShift));
+
+      // Handle the last word which has no high bits to copy.
+      Words[WordsToMove - 1] = Words[WordShift + WordsToMove - 1] >> BitShift;
+      // Sign extend one more time.
+      Words[WordsToMove - 1] =
+          SignExtend64(Words[WordsToMove - 1], APINT_BITS_PER_WORD - BitShift);
+    }
+  }
+
+  // Fill in the remainder based on the original sign.
+  std::fill_n(Words + WordsToMove, WordShift, Negative ? WORDTYPE_MAX : 0);
+  clearUnusedBits();
+}
+
+/// Logical right-shift this APInt by shiftAmt.
+/// Logical right-shift function.
+constexpr void APInt::lshrInPlace(const APInt &shiftAmt) {
+  lshrInPlace((unsigned)shiftAmt.getLimitedValue(BitWidth));
+}
+
+/// Logical right-shift this APInt by shiftAmt.
+/// Logical right-shift function.
+constexpr void APInt::lshrSlowCase(unsigned ShiftAmt) {
+  tcShiftRight(getWords(), getNumWords(), ShiftAmt);
+}
+
+/// Left-shift this APInt by shiftAmt.
+/// Left-shift function.
+constexpr APInt &APInt::operator<<=(const APInt &shiftAmt) {
+  // It's undefined behavior in C to shift by BitWidth or greater.
+  *this <<= (unsigned)shiftAmt.getLimitedValue(BitWidth);
+  return *this;
+}
+
+constexpr void APInt::shlSlowCase(unsigned ShiftAmt) {
+  tcShiftLeft(getWords(), getNumWords(), ShiftAmt);
+  clearUnusedBits();
+}
+
+// Calculate the rotate amount modulo the bit width.
+constexpr unsigned APInt::rotateModulo(unsigned BitWidth,
+                                       const APInt &rotateAmt) {
+  if (BIJOU_UNLIKELY(BitWidth == 0))
+    return 0;
+  unsigned rotBitWidth = rotateAmt.getBitWidth();
+  APInt rot = rotateAmt;
+  if (rotBitWidth < BitWidth) {
+    // Extend the rotate APInt, so that the urem doesn't divide by 0.
+    // e.g. APInt(1, 32) would give APInt(1, 0).
+    rot = rotateAmt.zext(BitWidth);
+  }
+  rot = rot.urem(APInt(rot.getBitWidth(), BitWidth));
+  return rot.getLimitedValue(BitWidth);
+}
+
+constexpr APInt APInt::rotl(const APInt &rotateAmt) const {
+  return rotl(rotateModulo(BitWidth, rotateAmt));
+}
+
+constexpr APInt APInt::rotl(unsigned rotateAmt) const {
+  if (BIJOU_UNLIKELY(BitWidth == 0))
+    return *this;
+  rotateAmt %= BitWidth;
+  if (rotateAmt == 0)
+    return *this;
+  return shl(rotateAmt) | lshr(BitWidth - rotateAmt);
+}
+
+constexpr APInt APInt::rotr(const APInt &rotateAmt) const {
+  return rotr(rotateModulo(BitWidth, rotateAmt));
+}
+
+constexpr APInt APInt::rotr(unsigned rotateAmt) const {
+  if (BitWidth == 0)
+    return *this;
+  rotateAmt %= BitWidth;
+  if (rotateAmt == 0)
+    return *this;
+  return lshr(rotateAmt) | shl(BitWidth - rotateAmt);
+}
+
+constexpr void APInt::divide(const WordType *LHS, unsigned lhsWords,
+                             const WordType *RHS, unsigned rhsWords,
+                             WordType *Quotient, WordType *Remainder) {
+  if (!std::is_constant_evaluated()) {
+    divideSlowCase(LHS, lhsWords, RHS, rhsWords, Quotient, Remainder);
+    return;
+  }
+
+  // Divide bit by bit with tcDivide, which needs the divisor to be as wide as
+  // the dividend. Copying the operands first keeps this safe if the results
+  // alias them.
+  WordType *Scratch = new WordType[4 * lhsWords]();
+  WordType *Quot = Scratch, *Divisor = Quot + lhsWords;
+  WordType *Rem = Divisor + lhsWords, *Shifted = Rem + lhsWords;
+  tcAssign(Quot, LHS, lhsWords);
+  tcAssign(Divisor, RHS, rhsWords);
+  [[maybe_unused]] int DivideByZero =
+      tcDivide(Quot, Divisor, Rem, Shifted, lhsWords);
+  assert(!DivideByZero && "Divide by zero?");
+  if (Quotient)
+    tcAssign(Quotient, Quot, lhsWords);
+  if (Remainder)
+    tcAssign(Remainder, Rem, rhsWords);
+  delete[] Scratch;
+}
+
+constexpr APInt APInt::udiv(const APInt &RHS) const {
+  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
+
+  // First, deal with the easy case
+  if (isSingleWord()) {
+    assert(RHS.U.VAL != 0 && "Divide by zero?");
+    return APInt(BitWidth, U.VAL / RHS.U.VAL);
+  }
+
+  // Get some facts about the LHS and RHS number of bits and words
+  unsigned lhsWords = getNumWords(getActiveBits());
+  unsigned rhsBits  = RHS.getActiveBits();
+  unsigned rhsWords = getNumWords(rhsBits);
+  assert(rhsWords && "Divided by zero???");
+
+  // Deal with some degenerate cases
+  if (!lhsWords)
+    // 0 / X ===> 0
+    return APInt(BitWidth, 0);
+  if (rhsBits == 1)
+    // X / 1 ===> X
+    return *this;
+  if (lhsWords < rhsWords || this->ult(RHS))
+    // X / Y ===> 0, iff X < Y
+    return APInt(BitWidth, 0);
+  if (*this == RHS)
+    // X / X ===> 1
+    return APInt(BitWidth, 1);
+  if (lhsWords == 1) // rhsWords is 1 if lhsWords is 1.
+    // All high words are zero, just use native divide
+    return APInt(BitWidth, getWords()[0] / RHS.getWords()[0]);
+
+  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
+  APInt Quotient(BitWidth, 0); // to hold result.
+  divide(getWords(), lhsWords, RHS.getWords(), rhsWords, Quotient.getWords(),
+         nullptr);
+  return Quotient;
+}
+
+constexpr APInt APInt::udiv(uint64_t RHS) const {
+  assert(RHS != 0 && "Divide by zero?");
+
+  // First, deal with the easy case
+  if (isSingleWord())
+    return APInt(BitWidth, U.VAL / RHS);
+
+  // Get some facts about the LHS words.
+  unsigned lhsWords = getNumWords(getActiveBits());
+
+  // Deal with some degenerate cases
+  if (!lhsWords)
+    // 0 / X ===> 0
+    return APInt(BitWidth, 0);
+  if (RHS == 1)
+    // X / 1 ===> X
+    return *this;
+  if (this->ult(RHS))
+    // X / Y ===> 0, iff X < Y
+    return APInt(BitWidth, 0);
+  if (*this == RHS)
+    // X / X ===> 1
+    return APInt(BitWidth, 1);
+  if (lhsWords == 1) // rhsWords is 1 if lhsWords is 1.
+    // All high words are zero, just use native divide
+    return APInt(BitWidth, getWords()[0] / RHS);
+
+  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
+  APInt Quotient(BitWidth, 0); // to hold result.
+  divide(getWords(), lhsWords, &RHS, 1, Quotient.getWords(), nullptr);
+  return Quotient;
+}
+
+constexpr APInt APInt::sdiv(const APInt &RHS) const {
+  if (isNegative()) {
+    if (RHS.isNegative())
+      return (-(*this)).udiv(-RHS);
+    return -((-(*this)).udiv(RHS));
+  }
+  if (RHS.isNegative())
+    return -(this->udiv(-RHS));
+  return this->udiv(RHS);
+}
+
+constexpr APInt APInt::sdiv(int64_t RHS) const {
+  if (isNegative()) {
+    if (RHS < 0)
+      return (-(*this)).udiv(-RHS);
+    return -((-(*this)).udiv(RHS));
+  }
+  if (RHS < 0)
+    return -(this->udiv(-RHS));
+  return this->udiv(RHS);
+}
+
+constexpr APInt APInt::urem(const APInt &RHS) const {
+  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
+  if (isSingleWord()) {
+    assert(RHS.U.VAL != 0 && "Remainder by zero?");
+    return APInt(BitWidth, U.VAL % RHS.U.VAL);
+  }
+
+  // Get some facts about the LHS
+  unsigned lhsWords = getNumWords(getActiveBits());
+
+  // Get some facts about the RHS
+  unsigned rhsBits = RHS.getActiveBits();
+  unsigned rhsWords = getNumWords(rhsBits);
+  assert(rhsWords && "Performing remainder operation by zero ???");
+
+  // Check the degenerate cases
+  if (lhsWords == 0)
+    // 0 % Y ===> 0
+    return APInt(BitWidth, 0);
+  if (rhsBits == 1)
+    // X % 1 ===> 0
+    return APInt(BitWidth, 0);
+  if (lhsWords < rhsWords || this->ult(RHS))
+    // X % Y ===> X, iff X < Y
+    return *this;
+  if (*this == RHS)
+    // X % X == 0;
+    return APInt(BitWidth, 0);
+  if (lhsWords == 1)
+    // All high words are zero, just use native remainder
+    return APInt(BitWidth, getWords()[0] % RHS.getWords()[0]);
+
+  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
+  APInt Remainder(BitWidth, 0);
+  divide(getWords(), lhsWords, RHS.getWords(), rhsWords, nullptr,
+         Remainder.getWords());
+  return Remainder;
+}
+
+constexpr uint64_t APInt::urem(uint64_t RHS) const {
+  assert(RHS != 0 && "Remainder by zero?");
+
+  if (isSingleWord())
+    return U.VAL % RHS;
+
+  // Get some facts about the LHS
+  unsigned lhsWords = getNumWords(getActiveBits());
+
+  // Check the degenerate cases
+  if (lhsWords == 0)
+    // 0 % Y ===> 0
+    return 0;
+  if (RHS == 1)
+    // X % 1 ===> 0
+    return 0;
+  if (this->ult(RHS))
+    // X % Y ===> X, iff X < Y
+    return getZExtValue();
+  if (*this == RHS)
+    // X % X == 0;
+    return 0;
+  if (lhsWords == 1)
+    // All high words are zero, just use native remainder
+    return getWords()[0] % RHS;
+
+  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
+  uint64_t Remainder;
+  divide(getWords(), lhsWords, &RHS, 1, nullptr, &Remainder);
+  return Remainder;
+}
+
+constexpr APInt APInt::srem(const APInt &RHS) const {
+  if (isNegative()) {
+    if (RHS.isNegative())
+      return -((-(*this)).urem(-RHS));
+    return -((-(*this)).urem(RHS));
+  }
+  if (RHS.isNegative())
+    return this->urem(-RHS);
+  return this->urem(RHS);
+}
+
+constexpr int64_t APInt::srem(int64_t RHS) const {
+  if (isNegative()) {
+    if (RHS < 0)
+      return -((-(*this)).urem(-RHS));
+    return -((-(*this)).urem(RHS));
+  }
+  if (RHS < 0)
+    return this->urem(-RHS);
+  return this->urem(RHS);
+}
+
+constexpr void APInt::udivrem(const APInt &LHS, const APInt &RHS,
+                              APInt &Quotient, APInt &Remainder) {
+  assert(LHS.BitWidth == RHS.BitWidth && "Bit widths must be the same");
+  unsigned BitWidth = LHS.BitWidth;
+
+  // First, deal with the easy case
+  if (LHS.isSingleWord()) {
+    assert(RHS.U.VAL != 0 && "Divide by zero?");
+    uint64_t QuotVal = LHS.U.VAL / RHS.U.VAL;
+    uint64_t RemVal = LHS.U.VAL % RHS.U.VAL;
+    Quotient = APInt(BitWidth, QuotVal);
+    Remainder = APInt(BitWidth, RemVal);
+    return;
+  }
+
+  // Get some size facts about the dividend and divisor
+  unsigned lhsWords = getNumWords(LHS.getActiveBits());
+  unsigned rhsBits  = RHS.getActiveBits();
+  unsigned rhsWords = getNumWords(rhsBits);
+  assert(rhsWords && "Performing divrem operation by zero ???");
+
+  // Check the degenerate cases
+  if (lhsWords == 0) {
+    Quotient = APInt(BitWidth, 0);    // 0 / Y ===> 0
+    Remainder = APInt(BitWidth, 0);   // 0 % Y ===> 0
+    return;
+  }
+
+  if (rhsBits == 1) {
+    Quotient = LHS;                   // X / 1 ===> X
+    Remainder = APInt(BitWidth, 0);   // X % 1 ===> 0
+  }
+
+  if (lhsWords < rhsWords || LHS.ult(RHS)) {
+    Remainder = LHS;                  // X % Y ===> X, iff X < Y
+    Quotient = APInt(BitWidth, 0);    // X / Y ===> 0, iff X < Y
+    return;
+  }
+
+  if (LHS == RHS) {
+    Quotient  = APInt(BitWidth, 1);   // X / X ===> 1
+    Remainder = APInt(BitWidth, 0);   // X % X ===> 0;
+    return;
+  }
+
+  // Make sure there is enough space to hold the results.
+  // NOTE: This assumes that reallocate won't affect any bits if it doesn't
+  // change the size. This is necessary if Quotient or Remainder is aliased
+  // with LHS or RHS.
+  Quotient.reallocate(BitWidth);
+  Remainder.reallocate(BitWidth);
+
+  if (lhsWords == 1) { // rhsWords is 1 if lhsWords is 1.
+    // There is only one word to consider so use the native versions.
+    uint64_t lhsValue = LHS.getWords()[0];
+    uint64_t rhsValue = RHS.getWords()[0];
+    Quotient = lhsValue / rhsValue;
+    Remainder = lhsValue % rhsValue;
+    return;
+  }
+
+  // Okay, lets do it the long way
+  divide(LHS.getWords(), lhsWords, RHS.getWords(), rhsWords,
+         Quotient.getWords(), Remainder.getWords());
+  // Clear the rest of the Quotient and Remainder.
+  std::fill_n(Quotient.getWords() + lhsWords, getNumWords(BitWidth) - lhsWords,
+              0);
+  std::fill_n(Remainder.getWords() + rhsWords,
+              getNumWords(BitWidth) - rhsWords, 0);
+}
+
+constexpr void APInt::udivrem(const APInt &LHS, uint64_t RHS, APInt &Quotient,
+                              uint64_t &Remainder) {
+  assert(RHS != 0 && "Divide by zero?");
+  unsigned BitWidth = LHS.BitWidth;
+
+  // First, deal with the easy case
+  if (LHS.isSingleWord()) {
+    uint64_t QuotVal = LHS.U.VAL / RHS;
+    Remainder = LHS.U.VAL % RHS;
+    Quotient = APInt(BitWidth, QuotVal);
+    return;
+  }
+
+  // Get some size facts about the dividend and divisor
+  unsigned lhsWords = getNumWords(LHS.getActiveBits());
+
+  // Check the degenerate cases
+  if (lhsWords == 0) {
+    Quotient = APInt(BitWidth, 0);    // 0 / Y ===> 0
+    Remainder = 0;                    // 0 % Y ===> 0
+    return;
+  }
+
+  if (RHS == 1) {
+    Quotient = LHS;                   // X / 1 ===> X
+    Remainder = 0;                    // X % 1 ===> 0
+    return;
+  }
+
+  if (LHS.ult(RHS)) {
+    Remainder = LHS.getZExtValue();   // X % Y ===> X, iff X < Y
+    Quotient = APInt(BitWidth, 0);    // X / Y ===> 0, iff X < Y
+    return;
+  }
+
+  if (LHS == RHS) {
+    Quotient  = APInt(BitWidth, 1);   // X / X ===> 1
+    Remainder = 0;                    // X % X ===> 0;
+    return;
+  }
+
+  // Make sure there is enough space to hold the results.
+  // NOTE: This assumes that reallocate won't affect any bits if it doesn't
+  // change the size. This is necessary if Quotient is aliased with LHS.
+  Quotient.reallocate(BitWidth);
+
+  if (lhsWords == 1) { // rhsWords is 1 if lhsWords is 1.
+    // There is only one word to consider so use the native versions.
+    uint64_t lhsValue = LHS.getWords()[0];
+    Quotient = lhsValue / RHS;
+    Remainder = lhsValue % RHS;
+    return;
+  }
+
+  // Okay, lets do it the long way
+  divide(LHS.getWords(), lhsWords, &RHS, 1, Quotient.getWords(), &Remainder);
+  // Clear the rest of the Quotient.
+  std::fill_n(Quotient.getWords() + lhsWords, getNumWords(BitWidth) - lhsWords,
+              0);
+}
+
+constexpr void APInt::sdivrem(const APInt &LHS, const APInt &RHS,
+                              APInt &Quotient, APInt &Remainder) {
+  if (LHS.isNegative()) {
+    if (RHS.isNegative())
+      APInt::udivrem(-LHS, -RHS, Quotient, Remainder);
+    else {
+      APInt::udivrem(-LHS, RHS, Quotient, Remainder);
+      Quotient.negate();
+    }
+    Remainder.negate();
+  } else if (RHS.isNegative()) {
+    APInt::udivrem(LHS, -RHS, Quotient, Remainder);
+    Quotient.negate();
+  } else {
+    APInt::udivrem(LHS, RHS, Quotient, Remainder);
+  }
+}
+
+constexpr void APInt::sdivrem(const APInt &LHS, int64_t RHS,
+                              APInt &Quotient, int64_t &Remainder) {
+  uint64_t R = 0;
+  if (LHS.isNegative()) {
+    if (RHS < 0)
+      APInt::udivrem(-LHS, -RHS, Quotient, R);
+    else {
+      APInt::udivrem(-LHS, RHS, Quotient, R);
+      Quotient.negate();
+    }
+    R = -R;
+  } else if (RHS < 0) {
+    APInt::udivrem(LHS, -RHS, Quotient, R);
+    Quotient.negate();
+  } else {
+    APInt::udivrem(LHS, RHS, Quotient, R);
+  }
+  Remainder = R;
+}
+
+/// Sets the least significant part of a bignum to the input value, and zeroes
+/// out higher parts.
+constexpr void APInt::tcSet(WordType *dst, WordType part, unsigned parts) {
+  assert(parts > 0);
+  dst[0] = part;
+  for (unsigned i = 1; i < parts; i++)
+    dst[i] = 0;
+}
+
+/// Assign one bignum to another.
+constexpr void APInt::tcAssign(WordType *dst, const WordType *src,
+                               unsigned parts) {
+  for (unsigned i = 0; i < parts; i++)
+    dst[i] = src[i];
+}
+
+/// Returns true if a bignum is zero, false otherwise.
+constexpr bool APInt::tcIsZero(const WordType *src, unsigned parts) {
+  for (unsigned i = 0; i < parts; i++)
+    if (src[i])
+      return false;
+
+  return true;
+}
+
+/// Extract the given bit of a bignum; returns 0 or 1.
+constexpr int APInt::tcExtractBit(const WordType *parts, unsigned bit) {
+  return (parts[whichWord(bit)] & maskBit(bit)) != 0;
+}
+
+/// Set the given bit of a bignum.
+constexpr void APInt::tcSetBit(WordType *parts, unsigned bit) {
+  parts[whichWord(bit)] |= maskBit(bit);
+}
+
+/// Clears the given bit of a bignum.
+constexpr void APInt::tcClearBit(WordType *parts, unsigned bit) {
+  parts[whichWord(bit)] &= ~maskBit(bit);
+}
+
+/// Returns the bit number of the least significant set bit of a number.  If the
+/// input number has no bits set -1U is returned.
+constexpr unsigned APInt::tcLSB(const WordType *parts, unsigned n) {
+  for (unsigned i = 0; i < n; i++) {
+    if (parts[i] != 0) {
+      unsigned lsb = findFirstSet(parts[i], ZB_Max);
+      return lsb + i * APINT_BITS_PER_WORD;
+    }
+  }
+
+  return -1U;
+}
+
+/// Returns the bit number of the most significant set bit of a number.
+/// If the input number has no bits set -1U is returned.
+constexpr unsigned APInt::tcMSB(const WordType *parts, unsigned n) {
+  do {
+    --n;
+
+    if (parts[n] != 0) {
+      unsigned msb = findLastSet(parts[n], ZB_Max);
+
+      return msb + n * APINT_BITS_PER_WORD;
+    }
+  } while (n);
+
+  return -1U;
+}
+
+/// Copy the bit vector of width srcBITS from SRC, starting at bit srcLSB, to
+/// DST, of dstCOUNT parts, such that the bit srcLSB becomes the least
+/// significant bit of DST.  All high bits above srcBITS in DST are zero-filled.
+constexpr void APInt::tcExtract(WordType *dst, unsigned dstCount,
+                                const WordType *src, unsigned srcBits,
+                                unsigned srcLSB) {
+  unsigned dstParts = (srcBits + APINT_BITS_PER_WORD - 1) / APINT_BITS_PER_WORD;
+  assert(dstParts <= dstCount);
+
+  unsigned firstSrcPart = srcLSB / APINT_BITS_PER_WORD;
+  tcAssign(dst, src + firstSrcPart, dstParts);
+
+  unsigned shift = srcLSB % APINT_BITS_PER_WORD;
+  tcShiftRight(dst, dstParts, shift);
+
+  // We now have (dstParts * APINT_BITS_PER_WORD - shift) bits from SRC
+  // in DST.  If this is less that srcBits, append the rest, else
+  // clear the high bits.
+  unsigned n = dstParts * APINT_BITS_PER_WORD - shift;
+  if (n < srcBits) {
+    WordType mask = lowBitMask(srcBits - n);
+    dst[dstParts - 1] |= ((src[firstSrcPart + dstParts] & mask)
+                          << n % APINT_BITS_PER_WORD);
+  } else if (n > srcBits) {
+    if (srcBits % APINT_BITS_PER_WORD)
+      dst[dstParts - 1] &= lowBitMask(srcBits % APINT_BITS_PER_WORD);
+  }
+
+  // Clear high parts.
+  while (dstParts < dstCount)
+    dst[dstParts++] = 0;
+}
+
+template <unsigned Parts>
+constexpr APInt::WordType APInt::tcAddFixed(WordType *dst, const WordType *rhs,
+                                            WordType c) {
+  unrollParts<Parts>([&](auto i) {
+    WordType sum = dst[i] + rhs[i];
+    WordType carry = sum < rhs[i];
+    dst[i] = sum + c;
+    c = carry | (dst[i] < c);
+  });
+  return c;
+}
+
+template <unsigned Parts>
+constexpr APInt::WordType
+APInt::tcSubtractFixed(WordType *dst, const WordType *rhs, WordType c) {
+  unrollParts<Parts>([&](auto i) {
+    WordType difference = dst[i] - rhs[i];
+    WordType borrow = dst[i] < rhs[i];
+    dst[i] = difference - c;
+    c = borrow | (difference < c);
+  });
+  return c;
+}
+
+template <unsigned Parts>
+constexpr void APInt::tcShiftLeftFixed(WordType *Dst, unsigned Count) {
+  const unsigned WordShift = Count / APINT_BITS_PER_WORD;
+  const unsigned BitShift = Count % APINT_BITS_PER_WORD;
+
+  // Src[I + 1] is word I, so that every word has a lower neighbour.
+  WordType Src[Parts + 1] = {};
+  std::copy_n(Dst, Parts, Src + 1);
+  unrollParts<Parts>([&](auto I) {
+    if (I < WordShift) {
+      Dst[I] = 0;
+      return;
+    }
+    WordType High = Src[I - WordShift + 1], Low = Src[I - WordShift];
+    // Shift LOW in two steps, as shifting by the word width is undefined.
+    Dst[I] = High << BitShift |
+             (Low >> 1) >> (APINT_BITS_PER_WORD - 1 - BitShift);
+  });
+}
+
+template <unsigned Parts>
+constexpr void APInt::tcShiftRightFixed(WordType *Dst, unsigned Count) {
+  const unsigned WordShift = Count / APINT_BITS_PER_WORD;
+  const unsigned BitShift = Count % APINT_BITS_PER_WORD;
+
+  // Src[Parts] is zero, so that every word has a higher neighbour.
+  WordType Src[Parts + 1] = {};
+  std::copy_n(Dst, Parts, Src);
+  unrollParts<Parts>([&](auto I) {
+    if (WordShift >= Parts - I) {
+      Dst[I] = 0;
+      return;
+    }
+    WordType Low = Src[I + WordShift], High = Src[I + WordShift + 1];
+    Dst[I] = Low >> BitShift |
+             (High << 1) << (APINT_BITS_PER_WORD - 1 - BitShift);
+  });
+}
+
+template <unsigned Parts>
+constexpr int APInt::tcCompareFixed(const WordType *lhs, const WordType *rhs) {
+  // Compare from the most significant word down, stopping at the first
+  // difference.
+  int result = 0;
+  [&]<unsigned... i>(std::integer_sequence<unsigned, i...>) {
+    ((lhs[Parts - 1 - i] != rhs[Parts - 1 - i] &&
+      (result = lhs[Parts - 1 - i] > rhs[Parts - 1 - i] ? 1 : -1)) ||
+     ...);
+  }(std::make_integer_sequence<unsigned, Parts>());
+  return result;
+}
+
+template <unsigned Parts>
+constexpr int APInt::tcMultiplyFixed(WordType *dst, const WordType *lhs,
+                                     const WordType *rhs) {
+  WordType result[Parts] = {};
+  WordType overflow = 0;
+  unrollParts<Parts>([&](auto i) {
+    // RESULT += LHS * RHS[i] * 2^(64 * i), dropping the words beyond DST.
+    WordType carry = 0;
+    unrollParts<Parts - i>([&](auto j) {
+      WordType high;
+      WordType low = multiplyWord(lhs[j], rhs[i], high);
+      low += carry;
+      high += low < carry;
+      result[i + j] += low;
+      high += result[i + j] < low;
+      carry = high;
+    });
+
+    // We overflowed if there is carry, or if RHS[i] meets a non-zero LHS
+    // word that we dropped.
+    WordType dropped = 0;
+    unrollParts<i>([&](auto j) { dropped |= lhs[Parts - i + j]; });
+    overflow |= carry | (rhs[i] ? dropped : 0);
+  });
+
+  std::copy_n(result, Parts, dst);
+  return overflow != 0;
+}
+
+//// DST += RHS + C where C is zero or one.  Returns the carry flag.
+constexpr APInt::WordType APInt::tcAdd(WordType *dst, const WordType *rhs,
+                                       WordType c, unsigned parts) {
+  assert(c <= 1);
+
+  switch (parts) {
+  case 2:
+    return tcAddFixed<2>(dst, rhs, c);
+  case 3:
+    return tcAddFixed<3>(dst, rhs, c);
+  case 4:
+    return tcAddFixed<4>(dst, rhs, c);
+  default:
+    break;
+  }
+
+  if (!std::is_constant_evaluated() && parts >= APINT_CARRY_CHAIN_THRESHOLD)
+    return tcAddChain(dst, rhs, c, parts);
+
+  for (unsigned i = 0; i < parts; i++) {
+    WordType l = dst[i];
+    if (c) {
+      dst[i] += rhs[i] + 1;
+      c = (dst[i] <= l);
+    } else {
+      dst[i] += rhs[i];
+      c = (dst[i] < l);
+    }
+  }
+
+  return c;
+}
+
+/// This function adds a single "word" integer, src, to the multiple
+/// "word" integer array, dst[]. dst[] is modified to reflect the addition and
+/// 1 is returned if there is a carry out, otherwise 0 is returned.
+/// @returns the carry of the addition.
+constexpr APInt::WordType APInt::tcAddPart(WordType *dst, WordType src,
+                                           unsigned parts) {
+  for (unsigned i = 0; i < parts; ++i) {
+    dst[i] += src;
+    if (dst[i] >= src)
+      return 0; // No need to carry so exit early.
+    src = 1; // Carry one to next digit.
+  }
+
+  return 1;
+}
+
+/// DST -= RHS + C where C is zero or one.  Returns the carry flag.
+constexpr APInt::WordType APInt::tcSubtract(WordType *dst, const WordType *rhs,
+                                            WordType c, unsigned parts) {
+  assert(c <= 1);
+
+  switch (parts) {
+  case 2:
+    return tcSubtractFixed<2>(dst, rhs, c);
+  case 3:
+    return tcSubtractFixed<3>(dst, rhs, c);
+  case 4:
+    return tcSubtractFixed<4>(dst, rhs, c);
+  default:
+    break;
+  }
+
+  if (!std::is_constant_evaluated() && parts >= APINT_CARRY_CHAIN_THRESHOLD)
+    return tcSubtractChain(dst, rhs, c, parts);
+
+  for (unsigned i = 0; i < parts; i++) {
+    WordType l = dst[i];
+    if (c) {
+      dst[i] -= rhs[i] + 1;
+      c = (dst[i] >= l);
+    } else {
+      dst[i] -= rhs[i];
+      c = (dst[i] > l);
+    }
+  }
+
+  return c;
+}
+
+/// This function subtracts a single "word" (64-bit word), src, from
+/// the multi-word integer array, dst[], propagating the borrowed 1 value until
+/// no further borrowing is needed or it runs out of "words" in dst.  The result
+/// is 1 if "borrowing" exhausted the digits in dst, or 0 if dst was not
+/// exhausted. In other words, if src > dst then this function returns 1,
+/// otherwise 0.
+/// @returns the borrow out of the subtraction
+constexpr APInt::WordType APInt::tcSubtractPart(WordType *dst, WordType src,
+                                                unsigned parts) {
+  for (unsigned i = 0; i < parts; ++i) {
+    WordType Dst = dst[i];
+    dst[i] -= src;
+    if (src <= Dst)
+      return 0; // No need to borrow so exit early.
+    src = 1; // We have to "borrow 1" from next "word"
+  }
+
+  return 1;
+}
+
+/// Negate a bignum in-place.
+constexpr void APInt::tcNegate(WordType *dst, unsigned parts) {
+  for (unsigned i = 0; i < parts; i++)
+    dst[i] = ~dst[i];
+  tcIncrement(dst, parts);
+}
+
+/// DST += SRC * MULTIPLIER + CARRY   if add is true
+/// DST  = SRC * MULTIPLIER + CARRY   if add is false
+/// Requires 0 <= DSTPARTS <= SRCPARTS + 1.  If DST overlaps SRC
+/// they must start at the same point, i.e. DST == SRC.
+/// If DSTPARTS == SRCPARTS + 1 no overflow occurs and zero is
+/// returned.  Otherwise DST is filled with the least significant
+/// DSTPARTS parts of the result, and if all of the omitted higher
+/// parts were zero return zero, otherwise overflow occurred and
+/// return one.
+constexpr int APInt::tcMultiplyPart(WordType *dst, const WordType *src,
+                                    WordType multiplier, WordType carry,
+                                    unsigned srcParts, unsigned dstParts,
+                                    bool add) {
+  // Otherwise our writes of DST kill our later reads of SRC. Constant
+  // evaluation cannot compare pointers into different arrays.
+  assert(std::is_constant_evaluated() || dst <= src ||
+         dst >= src + srcParts);
+  assert(dstParts <= srcParts + 1);
+
+  // N loops; minimum of dstParts and srcParts.
+  unsigned n = std::min(dstParts, srcParts);
+
+  if (!std::is_constant_evaluated()) {
+    carry = add ? tcMultiplyAddChain(dst, src, multiplier, carry, n)
+                : tcMultiplyChain(dst, src, multiplier, carry, n);
+  } else {
+    for (unsigned i = 0; i < n; i++) {
+      // [LOW, HIGH] = MULTIPLIER * SRC[i] + DST[i] + CARRY.
+      // This cannot overflow, because:
+      //   (n - 1) * (n - 1) + 2 (n - 1) = (n - 1) * (n + 1)
+      // which is less than n^2.
+      WordType srcPart = src[i];
+      WordType low, mid, high;
+      if (multiplier == 0 || srcPart == 0) {
+        low = carry;
+        high = 0;
+      } else {
+        low = lowHalf(srcPart) * lowHalf(multiplier);
+        high = highHalf(srcPart) * highHalf(multiplier);
+
+        mid = lowHalf(srcPart) * highHalf(multiplier);
+        high += highHalf(mid);
+        mid <<= APINT_BITS_PER_WORD / 2;
+        if (low + mid < low)
+          high++;
+        low += mid;
+
+        mid = highHalf(srcPart) * lowHalf(multiplier);
+        high += highHalf(mid);
+        mid <<= APINT_BITS_PER_WORD / 2;
+        if (low + mid < low)
+          high++;
+        low += mid;
+
+        // Now add carry.
+        if (low + carry < low)
+          high++;
+        low += carry;
+      }
+
+      if (add) {
+        // And now DST[i], and store the new low part there.
+        if (low + dst[i] < low)
+          high++;
+        dst[i] += low;
+      } else
+        dst[i] = low;
+
+      carry = high;
+    }
+  }
+
+  if (srcParts < dstParts) {
+    // Full multiplication, there is no overflow.
+    assert(srcParts + 1 == dstParts);
+    dst[srcParts] = carry;
+    return 0;
+  }
+
+  // We overflowed if there is carry.
+  if (carry)
+    return 1;
+
+  // We would overflow if any significant unwritten parts would be
+  // non-zero.  This is true if any remaining src parts are non-zero
+  // and the multiplier is non-zero.
+  if (multiplier)
+    for (unsigned i = dstParts; i < srcParts; i++)
+      if (src[i])
+        return 1;
+
+  // We fitted in the narrow destination.
+  return 0;
+}
+
+/// DST = LHS * RHS, where DST has the same width as the operands and
+/// is filled with the least significant parts of the result.  Returns
+/// one if overflow occurred, otherwise zero.  DST must be disjoint
+/// from both operands.
+constexpr int APInt::tcMultiply(WordType *dst, const WordType *lhs,
+                                const WordType *rhs, unsigned parts) {
+  assert(dst != lhs && dst != rhs);
+
+  switch (parts) {
+  case 2:
+    return tcMultiplyFixed<2>(dst, lhs, rhs);
+  case 3:
+    return tcMultiplyFixed<3>(dst, lhs, rhs);
+  case 4:
+    return tcMultiplyFixed<4>(dst, lhs, rhs);
+  default:
+    break;
+  }
+
+  if (lhs == rhs) {
+    tcSquare(dst, lhs, parts, parts);
+    // The square fits if and only if the operand has at most half the bits.
+    unsigned msb = tcMSB(lhs, parts);
+    return msb != -1U && msb >= parts * APINT_BITS_PER_WORD / 2;
+  }
+
+  if (!std::is_constant_evaluated() && parts >= APINT_KARATSUBA_THRESHOLD) {
+    // Wide values often have many zero high words, so pick the algorithm by
+    // the significant words of each operand.
+    unsigned lhsParts = parts, rhsParts = parts;
+    while (lhsParts && !lhs[lhsParts - 1])
+      lhsParts--;
+    while (rhsParts && !rhs[rhsParts - 1])
+      rhsParts--;
+
+    if (std::min(lhsParts, rhsParts) >= APINT_KARATSUBA_THRESHOLD)
+      return tcMultiplyWide(dst, lhs, lhsParts, rhs, rhsParts, parts);
+  }
+
+  int overflow = 0;
+  tcSet(dst, 0, parts);
+
+  for (unsigned i = 0; i < parts; i++)
+    overflow |= tcMultiplyPart(&dst[i], lhs, rhs[i], 0, parts,
+                               parts - i, true);
+
+  return overflow;
+}
+
+/// DST = LHS * RHS, where DST has width the sum of the widths of the
+/// operands. No overflow occurs. DST must be disjoint from both operands.
+constexpr void APInt::tcFullMultiply(WordType *dst, const WordType *lhs,
+                                     const WordType *rhs, unsigned lhsParts,
+                                     unsigned rhsParts) {
+  // Put the narrower number on the LHS for less loops below.
+  if (lhsParts > rhsParts)
+    return tcFullMultiply (dst, rhs, lhs, rhsParts, lhsParts);
+
+  assert(dst != lhs && dst != rhs);
+
+  if (lhs == rhs && lhsParts == rhsParts) {
+    tcSquare(dst, lhs, lhsParts, 2 * lhsParts);
+    return;
+  }
+
+  // Constant evaluation always uses the schoolbook algorithm.
+  if (!std::is_constant_evaluated() && lhsParts >= APINT_KARATSUBA_THRESHOLD) {
+    tcFullMultiplyWide(dst, lhs, rhs, lhsParts, rhsParts);
+    return;
+  }
+
+  tcSet(dst, 0, rhsParts);
+
+  for (unsigned i = 0; i < lhsParts; i++)
+    tcMultiplyPart(&dst[i], rhs, lhs[i], 0, rhsParts, rhsParts + 1, true);
+}
+
+/// DST = SRC * SRC, truncated to DSTPARTS words. This sums the products
+/// SRC[i] * SRC[j] with i < j, doubles the sum and adds the squares of the
+/// words, so the schoolbook form needs about half the multiplications of
+/// tcFullMultiply.
+constexpr void APInt::tcSquare(WordType *dst, const WordType *src,
+                               unsigned srcParts, unsigned dstParts) {
+  assert(dstParts <= 2 * srcParts);
+  assert(dst != src);
+
+  // Only the significant words take part.
+  unsigned parts = srcParts;
+  while (parts && !src[parts - 1])
+    parts--;
+
+  if (!std::is_constant_evaluated() && parts >= APINT_KARATSUBA_THRESHOLD) {
+    tcSquareWide(dst, src, parts, dstParts);
+    return;
+  }
+
+  tcSet(dst, 0, dstParts);
+
+  // The products of two different words, each starting at word i + j.
+  for (unsigned i = 0; i + 1 < parts && 2 * i + 1 < dstParts; i++)
+    tcMultiplyPart(&dst[2 * i + 1], &src[i + 1], src[i], 0, parts - i - 1,
+                   std::min(parts - i, dstParts - 2 * i - 1), true);
+
+  // Double the sum and add the squares of the words in a single pass.
+  WordType square[2] = {0, 0};
+  WordType topBit = 0, carry = 0;
+  for (unsigned i = 0, e = std::min(dstParts, 2 * parts); i != e; i++) {
+    if (i % 2 == 0)
+      square[0] = multiplyWord(src[i / 2], src[i / 2], square[1]);
+    WordType doubled = (dst[i] << 1) | topBit;
+    topBit = dst[i] >> (APINT_BITS_PER_WORD - 1);
+    WordType sum = doubled + square[i % 2];
+    WordType overflow = sum < doubled;
+    sum += carry;
+    // At most one of the two additions can overflow.
+    carry = overflow | (sum < carry);
+    dst[i] = sum;
+  }
+}
+
+// If RHS is zero LHS and REMAINDER are left unchanged, return one.
+// Otherwise set LHS to LHS / RHS with the fractional part discarded,
+// set REMAINDER to the remainder, return zero.  i.e.
+//
+//   OLD_LHS = RHS * LHS + REMAINDER
+//
+// SCRATCH is a bignum of the same size as the operands and result for
+// use by the routine; its contents need not be initialized and are
+// destroyed.  LHS, REMAINDER and SCRATCH must be distinct.
+constexpr int APInt::tcDivide(WordType *lhs, const WordType *rhs,
+                              WordType *remainder, WordType *srhs,
+                              unsigned parts) {
+  assert(lhs != remainder && lhs != srhs && remainder != srhs);
+
+  unsigned shiftCount = tcMSB(rhs, parts) + 1;
+  if (shiftCount == 0)
+    return true;
+
+  shiftCount = parts * APINT_BITS_PER_WORD - shiftCount;
+  unsigned n = shiftCount / APINT_BITS_PER_WORD;
+  WordType mask = (WordType) 1 << (shiftCount % APINT_BITS_PER_WORD);
+
+  tcAssign(srhs, rhs, parts);
+  tcShiftLeft(srhs, parts, shiftCount);
+  tcAssign(remainder, lhs, parts);
+  tcSet(lhs, 0, parts);
+
+  // Loop, subtracting SRHS if REMAINDER is greater and adding that to the
+  // total.
+  for (;;) {
+    int compare = tcCompare(remainder, srhs, parts);
+    if (compare >= 0) {
+      tcSubtract(remainder, srhs, 0, parts);
+      lhs[n] |= mask;
+    }
+
+    if (shiftCount == 0)
+      break;
+    shiftCount--;
+    tcShiftRight(srhs, parts, 1);
+    if ((mask >>= 1) == 0) {
+      mask = (WordType) 1 << (APINT_BITS_PER_WORD - 1);
+      n--;
+    }
+  }
+
+  return false;
+}
+
+/// Shift a bignum left Cound bits in-place. Shifted in bits are zero. There are
+/// no restrictions on Count.
+constexpr void APInt::tcShiftLeft(WordType *Dst, unsigned Words,
+                                  unsigned Count) {
+  // Don't bother performing a no-op shift.
+  if (!Count)
+    return;
+
+  switch (Words) {
+  case 2:
+    tcShiftLeftFixed<2>(Dst, Count);
+    return;
+  case 3:
+    tcShiftLeftFixed<3>(Dst, Count);
+    return;
+  case 4:
+    tcShiftLeftFixed<4>(Dst, Count);
+    return;
+  default:
+    break;
+  }
+
+  // WordShift is the inter-part shift; BitShift is the intra-part shift.
+  unsigned WordShift = std::min(Count / APINT_BITS_PER_WORD, Words);
+  unsigned BitShift = Count % APINT_BITS_PER_WORD;
+
+  // Fastpath for moving by whole words.
+  if (BitShift == 0) {
+    std::copy_backward(Dst, Dst + Words - WordShift, Dst + Words);
+  } else {
+    while (Words-- > WordShift) {
+      Dst[Words] = Dst[Words - WordShift] << BitShift;
+      if (Words > WordShift)
+        Dst[Words] |=
+          Dst[Words - WordShift - 1] >> (APINT_BITS_PER_WORD - BitShift);
+    }
+  }
+
+  // Fill in the remainder with 0s.
+  std::fill_n(Dst, WordShift, 0);
+}
+
+/// Shift a bignum right Count bits in-place. Shifted in bits are zero. There
+/// are no restrictions on Count.
+constexpr void APInt::tcShiftRight(WordType *Dst, unsigned Words,
+                                   unsigned Count) {
+  // Don't bother performing a no-op shift.
+  if (!Count)
+    return;
+
+  switch (Words) {
+  case 2:
+    tcShiftRightFixed<2>(Dst, Count);
+    return;
+  case 3:
+    tcShiftRightFixed<3>(Dst, Count);
+    return;
+  case 4:
+    tcShiftRightFixed<4>(Dst, Count);
+    return;
+  default:
+    break;
+  }
+
+  // WordShift is the inter-part shift; BitShift is the intra-part shift.
+  unsigned WordShift = std::min(Count / APINT_BITS_PER_WORD, Words);
+  unsigned BitShift = Count % APINT_BITS_PER_WORD;
+
+  unsigned WordsToMove = Words - WordShift;
+  // Fastpath for moving by whole words.
+  if (BitShift == 0) {
+    std::copy(Dst + WordShift, Dst + Words, Dst);
+  } else {
+    for (unsigned i = 0; i != WordsToMove; ++i) {
+      Dst[i] = Dst[i + WordShift] >> BitShift;
+      if (i + 1 != WordsToMove)
+        Dst[i] |= Dst[i + WordShift + 1] << (APINT_BITS_PER_WORD - BitShift);
+    }
+  }
+
+  // Fill in the remainder with 0s.
+  std::fill_n(Dst + WordsToMove, WordShift, 0);
+}
+
+// Comparison (unsigned) of two bignums.
+constexpr int APInt::tcCompare(const WordType *lhs, const WordType *rhs,
+                               unsigned parts) {
+  switch (parts) {
+  case 2:
+    return tcCompareFixed<2>(lhs, rhs);
+  case 3:
+    return tcCompareFixed<3>(lhs, rhs);
+  case 4:
+    return tcCompareFixed<4>(lhs, rhs);
+  default:
+    break;
+  }
+
+  while (parts) {
+    parts--;
+    if (lhs[parts] != rhs[parts])
+      return (lhs[parts] > rhs[parts]) ? 1 : -1;
+  }
+
+  return 0;
+}
+
 namespace APIntOps {
 
 /// Determine the smaller of two APInts considered to be signed.
-inline const APInt &smin(const APInt &A, const APInt &B) {
+constexpr const APInt &smin(const APInt &A, const APInt &B) {
   return A.slt(B) ? A : B;
 }
 
 /// Determine the larger of two APInts considered to be signed.
-inline const APInt &smax(const APInt &A, const APInt &B) {
+constexpr const APInt &smax(const APInt &A, const APInt &B) {
   return A.sgt(B) ? A : B;
 }
 
 /// Determine the smaller of two APInts considered to be unsigned.
-inline const APInt &umin(const APInt &A, const APInt &B) {
+constexpr const APInt &umin(const APInt &A, const APInt &B) {
   return A.ult(B) ? A : B;
 }
 
 /// Determine the larger of two APInts considered to be unsigned.
-inline const APInt &umax(const APInt &A, const APInt &B) {
+constexpr const APInt &umax(const APInt &A, const APInt &B) {
   return A.ugt(B) ? A : B;
 }
 
@@ -0,0 +1,107 @@
+// APIntDivider.hpp - Division of APInts by an invariant divisor
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file defines the APIntDivider class, which divides many APInts by
+/// the same divisor using a precomputed reciprocal.
+///
+
+#ifndef BIJOU_ADT_APINTDIVIDER_HPP
+#define BIJOU_ADT_APINTDIVIDER_HPP
+
+#include <vector>
+
+#include "bijou/APInt.hpp"
+
+namespace bijou {
+
+/// Unsigned division by a fixed divisor with a precomputed reciprocal.
+///
+/// Constructing a divider does the one division it takes to compute the
+/// reciprocal, after which udiv, urem and udivrem only multiply:
+///
+///   * Divisors that fit in a word use the 2-by-1 division of Möller and
+///     Granlund, "Improved division by invariant integers", with a one word
+///     reciprocal.
+///   * Wider divisors of m words use Barrett reduction with the reciprocal
+///     floor(2^(128 * m) / D), taking the dividend m words at a time.
+///   * Powers of two shift and mask.
+///
+/// This pays off once the same divisor is used more than a few times. For
+/// divisors of up to DIVIDER_STACK_WORDS words the word level udivrem keeps
+/// its temporaries on the stack and so does not allocate.
+class APIntDivider {
+public:
+  using WordType = APInt::WordType;
+
+  enum : unsigned {
+    /// The number of divisor words up to which temporaries live on the stack.
+    DIVIDER_STACK_WORDS = 32,
+  };
+
+  /// Creates a divider for the non-zero @p Divisor. The values divided have
+  /// the bit width of @p Divisor.
+  explicit APIntDivider(const APInt &Divisor);
+
+  /// @returns the divisor.
+  const APInt &getDivisor() const { return Divisor; }
+
+  /// @returns the bit width of the divisor and of all values.
+  unsigned getBitWidth() const { return Divisor.getBitWidth(); }
+
+  /// @returns the number of significant words of the divisor, which is the
+  /// number of words the word level udivrem writes to the remainder.
+  unsigned getNumDivisorWords() const { return DivisorWords; }
+
+  /// Unsigned division, as APInt::udiv(getDivisor()).
+  [[nodiscard]] APInt udiv(const APInt &LHS) const;
+
+  /// Unsigned remainder, as APInt::urem(getDivisor()).
+  [[nodiscard]] APInt urem(const APInt &LHS) const;
+
+  /// Unsigned division and remainder, as APInt::udivrem. @p Quotient and
+  /// @p Remainder may be the same object as @p LHS.
+  void udivrem(const APInt &LHS, APInt &Quotient, APInt &Remainder) const;
+
+  /// Divides the @p LHSWords word value @p LHS. Writes @p LHSWords words of
+  /// quotient to @p Quotient and getNumDivisorWords() words of remainder to
+  /// @p Remainder. Neither may overlap @p LHS.
+  void udivrem(const WordType *LHS, unsigned LHSWords, WordType *Quotient,
+               WordType *Remainder) const;
+
+private:
+  /// Divides a single word divisor into LHS, see udivrem.
+  void divideByWord(const WordType *LHS, unsigned LHSWords,
+                    WordType *Quotient, WordType *Remainder) const;
+
+  /// One Barrett step: Quotient (m + 1 words) and Remainder (m words) of the
+  /// 2 * m word value V, using Product (3 * m + 3 words) as scratch.
+  void barrettStep(const WordType *V, WordType *Quotient, WordType *Remainder,
+                   WordType *Product) const;
+
+  APInt Divisor;                      ///< The divisor D.
+  unsigned DivisorWords;              ///< The number of significant words m.
+  unsigned Shift;                     ///< The shift that normalizes D, or
+                                      ///< log2(D) for powers of two.
+  bool IsPowerOf2;                    ///< Whether D is a power of two.
+  WordType WordReciprocal;            ///< The Möller-Granlund reciprocal.
+  std::vector<WordType> Reciprocal;   ///< The m + 1 word Barrett reciprocal.
+};
+
+namespace APIntOps {
+
+/// Return A unsign-divided by the divisor of B, rounded by the given
+/// rounding mode.
+APInt RoundingUDiv(const APInt &A, const APIntDivider &B, APInt::Rounding RM);
+
+} // namespace APIntOps
+
+} // namespace bijou
+
+#endif // BIJOU_ADT_APINTDIVIDER_HPP
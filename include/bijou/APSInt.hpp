@@ -13,6 +13,7 @@
 //   * Removed uses of some LLVM helper APIs (such as FoldingSetNode, DenseMap)
 //   * Added APIs to print classes defined in this file with C stdio routines.
 //   * Changed doxygen comments to consistenly use '@' command prefix.
+//   * Added toChars and fromChars, which use the signedness of the APSInt.
 //
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
@@ -27,6 +28,7 @@
 #ifndef BIJOU_ADT_APSINT_HPP
 #define BIJOU_ADT_APSINT_HPP
 
+#include <charconv>    // for std::to_chars_result, std::from_chars_result
 #include <string_view> // for std::string_view
 
 #include "bijou/bijou-config.h" // for BIJOU_USE_IOSTREAM
@@ -105,6 +107,21 @@ public:
   }
   using APInt::toString;
 
+  /// Writes this APSInt to [First, Last) like toString, in the manner of
+  /// std::to_chars.
+  std::to_chars_result toChars(char *First, char *Last,
+                               unsigned Radix = 10) const {
+    return APInt::toChars(First, Last, Radix, isSigned());
+  }
+  using APInt::toChars;
+
+  /// Parses a value of the width and signedness of this APSInt from the start
+  /// of [First, Last), in the manner of std::from_chars.
+  std::from_chars_result fromChars(const char *First, const char *Last,
+                                   unsigned Radix = 10) {
+    return APInt::fromChars(First, Last, Radix, isSigned());
+  }
+
   /// Get the correctly-extended @c int64_t value.
   int64_t getExtValue() const {
     assert(getMinSignedBits() <= 64 && "Too many bits for int64_t");
@@ -8,6 +8,7 @@
 //   * Changed 'llvm' to 'bijou', and 'LLVM' to 'BIJOU'.
 //   * Removed unused defines and most tests for specific compiler versions.
 //   * Changed doxygen comments to consistenly use '@' command prefix.
+//   * Added BIJOU_HAS_INT128.
 //
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
@@ -84,4 +85,12 @@
 /// stripped from builds.
 #define BIJOU_DUMP_METHOD BIJOU_ATTRIBUTE_NOINLINE BIJOU_ATTRIBUTE_USED
 
+/// BIJOU_HAS_INT128 - Expands to 1 if the compiler provides the 128-bit integer
+/// types __int128 and unsigned __int128, and to 0 otherwise.
+#if defined(__SIZEOF_INT128__)
+#define BIJOU_HAS_INT128 1
+#else
+#define BIJOU_HAS_INT128 0
+#endif
+
 #endif // BIJOU_SUPPORT_COMPILER_HPP
@@ -0,0 +1,826 @@
+// FixedAPInt.hpp - Arbitrary precision integer of a fixed bit width
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file defines the FixedAPInt class template, an integer of a bit width
+/// fixed at compile time with the semantics of APInt.
+///
+
+#ifndef BIJOU_ADT_FIXEDAPINT_HPP
+#define BIJOU_ADT_FIXEDAPINT_HPP
+
+#include <algorithm>              // for std::min
+#include <array>                  // for std::array
+#include <bit>                    // for std::countl_zero, std::countr_zero...
+#include <cassert>                // for assert
+#include <cstdint>                // for uint64_t, int64_t
+#include <span>                   // for std::span
+#include <string>                 // for std::string
+#include <type_traits>            // for std::is_constant_evaluated
+#include "bijou/APInt.hpp"        // for APInt
+#include "bijou/Compiler.hpp"     // for BIJOU_HAS_INT128
+
+namespace bijou {
+
+/// An unsigned or two's complement integer of exactly @p Bits bits.
+///
+/// FixedAPInt stores its value in a std::array of words and knows its width
+/// at compile time, so that it never allocates, does not branch on the width,
+/// and its loops have constant trip counts that the compiler unrolls for
+/// common widths such as 128, 256 and 512 bits. All operations are constexpr.
+///
+/// The API follows that of APInt: operations have the same names and the
+/// same semantics, but the bit width is a template parameter instead of a
+/// constructor argument, and width changing operations such as zext, sext
+/// and trunc take the new width as a template argument. Use the APInt
+/// constructor and toAPInt to convert between the two.
+///
+/// Like APInt, the bits above @p Bits in the last word are always zero.
+template <unsigned Bits> class FixedAPInt {
+  static_assert(Bits > 0, "FixedAPInt must have at least one bit");
+
+public:
+  using WordType = uint64_t;
+
+  /// Bits in a word.
+  static constexpr unsigned APINT_BITS_PER_WORD = APInt::APINT_BITS_PER_WORD;
+
+  /// The number of words used to store the value.
+  static constexpr unsigned NumWords =
+      (Bits + APINT_BITS_PER_WORD - 1) / APINT_BITS_PER_WORD;
+
+  /// @name Constructors
+  /// @{
+
+  /// Creates a zero value.
+  constexpr FixedAPInt() : Words{} {}
+
+  /// Creates a value from @p Val, sign extending it if @p isSigned is true
+  /// and truncating it to @p Bits bits.
+  constexpr FixedAPInt(uint64_t Val, bool isSigned = false) : Words{} {
+    Words[0] = Val;
+    if (isSigned && int64_t(Val) < 0)
+      for (unsigned I = 1; I < NumWords; ++I)
+        Words[I] = WORDTYPE_MAX;
+    clearUnusedBits();
+  }
+
+  /// Creates a value from the little endian words of @p BigVal, truncating or
+  /// zero extending it to @p Bits bits.
+  constexpr explicit FixedAPInt(std::span<const uint64_t> BigVal) : Words{} {
+    for (unsigned I = 0; I < std::min<size_t>(NumWords, BigVal.size()); ++I)
+      Words[I] = BigVal[I];
+    clearUnusedBits();
+  }
+
+  /// Creates a value from @p Val, which must be @p Bits bits wide.
+  explicit FixedAPInt(const APInt &Val) : Words{} {
+    assert(Val.getBitWidth() == Bits && "Bit widths must be the same");
+    const WordType *Raw = Val.getRawData();
+    for (unsigned I = 0; I < NumWords; ++I)
+      Words[I] = Raw[I];
+  }
+
+  /// @returns the value as an APInt of @p Bits bits.
+  APInt toAPInt() const { return APInt(Bits, std::span(Words)); }
+
+  /// @}
+  /// @name Value Generators
+  /// @{
+
+  /// Get the '0' value.
+  static constexpr FixedAPInt getZero() { return FixedAPInt(); }
+
+  /// Get the all-ones value.
+  static constexpr FixedAPInt getAllOnes() {
+    FixedAPInt Result;
+    Result.setAllBits();
+    return Result;
+  }
+
+  /// Gets the maximum unsigned value.
+  static constexpr FixedAPInt getMaxValue() { return getAllOnes(); }
+
+  /// Gets the minimum unsigned value.
+  static constexpr FixedAPInt getMinValue() { return getZero(); }
+
+  /// Gets the maximum signed value.
+  static constexpr FixedAPInt getSignedMaxValue() {
+    FixedAPInt Result = getAllOnes();
+    Result.clearBit(Bits - 1);
+    return Result;
+  }
+
+  /// Gets the minimum signed value.
+  static constexpr FixedAPInt getSignedMinValue() {
+    return getOneBitSet(Bits - 1);
+  }
+
+  /// Get the SignMask, that is the value with only the sign bit set.
+  static constexpr FixedAPInt getSignMask() { return getSignedMinValue(); }
+
+  /// @returns a value with only bit @p BitNo set.
+  static constexpr FixedAPInt getOneBitSet(unsigned BitNo) {
+    FixedAPInt Result;
+    Result.setBit(BitNo);
+    return Result;
+  }
+
+  /// @returns a value with the low @p LoBitsSet bits set.
+  static constexpr FixedAPInt getLowBitsSet(unsigned LoBitsSet) {
+    assert(LoBitsSet <= Bits && "Too many bits to set!");
+    return LoBitsSet ? getAllOnes().lshr(Bits - LoBitsSet) : getZero();
+  }
+
+  /// @returns a value with the high @p HiBitsSet bits set.
+  static constexpr FixedAPInt getHighBitsSet(unsigned HiBitsSet) {
+    assert(HiBitsSet <= Bits && "Too many bits to set!");
+    return HiBitsSet ? getAllOnes().shl(Bits - HiBitsSet) : getZero();
+  }
+
+  /// @}
+  /// @name Value Tests
+  /// @{
+
+  /// @returns the number of bits, @p Bits.
+  static constexpr unsigned getBitWidth() { return Bits; }
+
+  /// @returns the number of words, NumWords.
+  static constexpr unsigned getNumWords() { return NumWords; }
+
+  /// @returns a pointer to the little endian words of the value.
+  constexpr const WordType *getRawData() const { return Words.data(); }
+
+  /// Determine sign of this FixedAPInt.
+  constexpr bool isNegative() const { return (*this)[Bits - 1]; }
+
+  /// Determine if this FixedAPInt value is non-negative (>= 0).
+  constexpr bool isNonNegative() const { return !isNegative(); }
+
+  /// Determine if sign bit of this FixedAPInt is set.
+  constexpr bool isSignBitSet() const { return isNegative(); }
+
+  /// Determine if sign bit of this FixedAPInt is clear.
+  constexpr bool isSignBitClear() const { return !isNegative(); }
+
+  /// Determine if this FixedAPInt value is positive.
+  constexpr bool isStrictlyPositive() const {
+    return isNonNegative() && !isZero();
+  }
+
+  /// Determine if this FixedAPInt value is non-positive (<= 0).
+  constexpr bool isNonPositive() const { return !isStrictlyPositive(); }
+
+  /// Determine if all bits are set.
+  constexpr bool isAllOnes() const { return *this == getAllOnes(); }
+
+  /// Determine if this value is zero.
+  constexpr bool isZero() const {
+    for (unsigned I = 0; I < NumWords; ++I)
+      if (Words[I])
+        return false;
+    return true;
+  }
+
+  /// Determine if this is a value of 1.
+  constexpr bool isOne() const { return *this == FixedAPInt(1); }
+
+  /// Determine if this is the largest unsigned value.
+  constexpr bool isMaxValue() const { return isAllOnes(); }
+
+  /// Determine if this is the largest signed value.
+  constexpr bool isMaxSignedValue() const {
+    return *this == getSignedMaxValue();
+  }
+
+  /// Determine if this is the smallest unsigned value.
+  constexpr bool isMinValue() const { return isZero(); }
+
+  /// Determine if this is the smallest signed value.
+  constexpr bool isMinSignedValue() const {
+    return *this == getSignedMinValue();
+  }
+
+  /// Check if this value is a power of two.
+  constexpr bool isPowerOf2() const { return countPopulation() == 1; }
+
+  /// Check if the value is the sign mask.
+  constexpr bool isSignMask() const { return isMinSignedValue(); }
+
+  /// Convert to bool, which is true if the value is non-zero.
+  constexpr bool getBoolValue() const { return !isZero(); }
+
+  /// @returns the number of bits needed to represent the value as unsigned.
+  constexpr unsigned getActiveBits() const {
+    return Bits - countLeadingZeros();
+  }
+
+  /// @returns the number of words needed to represent the value as unsigned.
+  constexpr unsigned getActiveWords() const {
+    unsigned NumActiveBits = getActiveBits();
+    return NumActiveBits ? (NumActiveBits - 1) / APINT_BITS_PER_WORD + 1 : 1;
+  }
+
+  /// @returns the number of bits needed to represent the value as signed.
+  constexpr unsigned getMinSignedBits() const {
+    return Bits - getNumSignBits() + 1;
+  }
+
+  /// Get zero extended value, which must fit in 64 bits.
+  constexpr uint64_t getZExtValue() const {
+    assert(getActiveBits() <= 64 && "Too many bits for uint64_t");
+    return Words[0];
+  }
+
+  /// Get sign extended value, which must fit in 64 bits.
+  constexpr int64_t getSExtValue() const {
+    assert(getMinSignedBits() <= 64 && "Too many bits for int64_t");
+    if constexpr (Bits < 64)
+      return int64_t(Words[0] << (64 - Bits)) >> (64 - Bits);
+    else
+      return int64_t(Words[0]);
+  }
+
+  /// @returns the value of bit @p BitPosition.
+  constexpr bool operator[](unsigned BitPosition) const {
+    assert(BitPosition < Bits && "Bit position out of bounds!");
+    return (Words[whichWord(BitPosition)] & maskBit(BitPosition)) != 0;
+  }
+
+  /// @}
+  /// @name Bit Manipulation Operators
+  /// @{
+
+  /// Set every bit to 1.
+  constexpr void setAllBits() {
+    for (unsigned I = 0; I < NumWords; ++I)
+      Words[I] = WORDTYPE_MAX;
+    clearUnusedBits();
+  }
+
+  /// Set the given bit to 1 whose position is given as @p BitPosition.
+  constexpr void setBit(unsigned BitPosition) {
+    assert(BitPosition < Bits && "BitPosition out of range");
+    Words[whichWord(BitPosition)] |= maskBit(BitPosition);
+  }
+
+  /// Set the sign bit to 1.
+  constexpr void setSignBit() { setBit(Bits - 1); }
+
+  /// Set a given bit to a given value.
+  constexpr void setBitVal(unsigned BitPosition, bool BitValue) {
+    if (BitValue)
+      setBit(BitPosition);
+    else
+      clearBit(BitPosition);
+  }
+
+  /// Set every bit to 0.
+  constexpr void clearAllBits() { Words = {}; }
+
+  /// Set the given bit to 0 whose position is given as @p BitPosition.
+  constexpr void clearBit(unsigned BitPosition) {
+    assert(BitPosition < Bits && "BitPosition out of range");
+    Words[whichWord(BitPosition)] &= ~maskBit(BitPosition);
+  }
+
+  /// Set the sign bit to 0.
+  constexpr void clearSignBit() { clearBit(Bits - 1); }
+
+  /// Toggle every bit to its opposite value.
+  constexpr void flipAllBits() {
+    for (unsigned I = 0; I < NumWords; ++I)
+      Words[I] = ~Words[I];
+    clearUnusedBits();
+  }
+
+  /// Toggles the given bit to its opposite value.
+  constexpr void flipBit(unsigned BitPosition) {
+    assert(BitPosition < Bits && "BitPosition out of range");
+    Words[whichWord(BitPosition)] ^= maskBit(BitPosition);
+  }
+
+  /// Negate this value in place.
+  constexpr void negate() {
+    flipAllBits();
+    ++(*this);
+  }
+
+  /// @}
+  /// @name Unary Operators
+  /// @{
+
+  /// Prefix increment operator.
+  constexpr FixedAPInt &operator++() { return *this += FixedAPInt(1); }
+
+  /// Postfix increment operator.
+  constexpr FixedAPInt operator++(int) {
+    FixedAPInt Result = *this;
+    ++(*this);
+    return Result;
+  }
+
+  /// Prefix decrement operator.
+  constexpr FixedAPInt &operator--() { return *this -= FixedAPInt(1); }
+
+  /// Postfix decrement operator.
+  constexpr FixedAPInt operator--(int) {
+    FixedAPInt Result = *this;
+    --(*this);
+    return Result;
+  }
+
+  /// Unary bitwise complement operator.
+  constexpr FixedAPInt operator~() const {
+    FixedAPInt Result = *this;
+    Result.flipAllBits();
+    return Result;
+  }
+
+  /// Unary negation operator.
+  constexpr FixedAPInt operator-() const {
+    FixedAPInt Result = *this;
+    Result.negate();
+    return Result;
+  }
+
+  /// Logical negation operator.
+  constexpr bool operator!() const { return isZero(); }
+
+  /// @}
+  /// @name Assignment Operators
+  /// @{
+
+  /// Bitwise AND assignment operator.
+  constexpr FixedAPInt &operator&=(const FixedAPInt &RHS) {
+    for (unsigned I = 0; I < NumWords; ++I)
+      Words[I] &= RHS.Words[I];
+    return *this;
+  }
+
+  /// Bitwise OR assignment operator.
+  constexpr FixedAPInt &operator|=(const FixedAPInt &RHS) {
+    for (unsigned I = 0; I < NumWords; ++I)
+      Words[I] |= RHS.Words[I];
+    return *this;
+  }
+
+  /// Bitwise XOR assignment operator.
+  constexpr FixedAPInt &operator^=(const FixedAPInt &RHS) {
+    for (unsigned I = 0; I < NumWords; ++I)
+      Words[I] ^= RHS.Words[I];
+    return *this;
+  }
+
+  /// Addition assignment operator, wrapping modulo 2^Bits.
+  constexpr FixedAPInt &operator+=(const FixedAPInt &RHS) {
+    WordType Carry = 0;
+    for (unsigned I = 0; I < NumWords; ++I) {
+      WordType Sum = Words[I] + RHS.Words[I];
+      WordType NewCarry = Sum < Words[I];
+      Words[I] = Sum + Carry;
+      Carry = NewCarry | (Words[I] < Sum);
+    }
+    clearUnusedBits();
+    return *this;
+  }
+
+  /// Subtraction assignment operator, wrapping modulo 2^Bits.
+  constexpr FixedAPInt &operator-=(const FixedAPInt &RHS) {
+    WordType Borrow = 0;
+    for (unsigned I = 0; I < NumWords; ++I) {
+      WordType Diff = Words[I] - RHS.Words[I];
+      WordType NewBorrow = Words[I] < RHS.Words[I];
+      Words[I] = Diff - Borrow;
+      Borrow = NewBorrow | (Diff < Borrow);
+    }
+    clearUnusedBits();
+    return *this;
+  }
+
+  /// Multiplication assignment operator, wrapping modulo 2^Bits.
+  constexpr FixedAPInt &operator*=(const FixedAPInt &RHS) {
+    return *this = *this * RHS;
+  }
+
+  /// Left-shift assignment operator.
+  constexpr FixedAPInt &operator<<=(unsigned ShiftAmt) {
+    return *this = shl(ShiftAmt);
+  }
+
+  /// @}
+  /// @name Binary Operators
+  /// @{
+
+  constexpr friend FixedAPInt operator&(FixedAPInt LHS,
+                                        const FixedAPInt &RHS) {
+    return LHS &= RHS;
+  }
+
+  constexpr friend FixedAPInt operator|(FixedAPInt LHS,
+                                        const FixedAPInt &RHS) {
+    return LHS |= RHS;
+  }
+
+  constexpr friend FixedAPInt operator^(FixedAPInt LHS,
+                                        const FixedAPInt &RHS) {
+    return LHS ^= RHS;
+  }
+
+  constexpr friend FixedAPInt operator+(FixedAPInt LHS,
+                                        const FixedAPInt &RHS) {
+    return LHS += RHS;
+  }
+
+  constexpr friend FixedAPInt operator-(FixedAPInt LHS,
+                                        const FixedAPInt &RHS) {
+    return LHS -= RHS;
+  }
+
+  /// Multiplication operator, wrapping modulo 2^Bits. Only the partial
+  /// products below 2^Bits are computed.
+  constexpr friend FixedAPInt operator*(const FixedAPInt &LHS,
+                                        const FixedAPInt &RHS) {
+    FixedAPInt Result;
+    for (unsigned I = 0; I < NumWords; ++I) {
+      WordType Carry = 0;
+      for (unsigned J = 0; I + J < NumWords; ++J)
+        Result.Words[I + J] = mulAdd(LHS.Words[I], RHS.Words[J],
+                                     Result.Words[I + J], Carry, Carry);
+    }
+    Result.clearUnusedBits();
+    return Result;
+  }
+
+  /// Left-shift operator.
+  constexpr FixedAPInt operator<<(unsigned ShiftAmt) const {
+    return shl(ShiftAmt);
+  }
+
+  /// Left-shift by @p ShiftAmt, which must be at most @p Bits.
+  constexpr FixedAPInt shl(unsigned ShiftAmt) const {
+    assert(ShiftAmt <= Bits && "Invalid shift amount");
+    FixedAPInt Result;
+    if (ShiftAmt == Bits)
+      return Result;
+    unsigned WordShift = ShiftAmt / APINT_BITS_PER_WORD;
+    unsigned BitShift = ShiftAmt % APINT_BITS_PER_WORD;
+    for (unsigned I = NumWords; I-- > WordShift;) {
+      WordType W = Words[I - WordShift] << BitShift;
+      if (BitShift && I > WordShift)
+        W |= Words[I - WordShift - 1] >> (APINT_BITS_PER_WORD - BitShift);
+      Result.Words[I] = W;
+    }
+    Result.clearUnusedBits();
+    return Result;
+  }
+
+  /// Logical right-shift by @p ShiftAmt, which must be at most @p Bits.
+  constexpr FixedAPInt lshr(unsigned ShiftAmt) const {
+    assert(ShiftAmt <= Bits && "Invalid shift amount");
+    FixedAPInt Result;
+    if (ShiftAmt == Bits)
+      return Result;
+    unsigned WordShift = ShiftAmt / APINT_BITS_PER_WORD;
+    unsigned BitShift = ShiftAmt % APINT_BITS_PER_WORD;
+    for (unsigned I = 0; I + WordShift < NumWords; ++I) {
+      WordType W = Words[I + WordShift] >> BitShift;
+      if (BitShift && I + WordShift + 1 < NumWords)
+        W |= Words[I + WordShift + 1] << (APINT_BITS_PER_WORD - BitShift);
+      Result.Words[I] = W;
+    }
+    return Result;
+  }
+
+  /// Arithmetic right-shift by @p ShiftAmt, which must be at most @p Bits.
+  constexpr FixedAPInt ashr(unsigned ShiftAmt) const {
+    if (!isNegative())
+      return lshr(ShiftAmt);
+    return ~(~*this).lshr(ShiftAmt);
+  }
+
+  /// Rotate left by @p RotateAmt.
+  constexpr FixedAPInt rotl(unsigned RotateAmt) const {
+    RotateAmt %= Bits;
+    if (RotateAmt == 0)
+      return *this;
+    return shl(RotateAmt) | lshr(Bits - RotateAmt);
+  }
+
+  /// Rotate right by @p RotateAmt.
+  constexpr FixedAPInt rotr(unsigned RotateAmt) const {
+    RotateAmt %= Bits;
+    if (RotateAmt == 0)
+      return *this;
+    return lshr(RotateAmt) | shl(Bits - RotateAmt);
+  }
+
+  /// Unsigned division operation.
+  constexpr FixedAPInt udiv(const FixedAPInt &RHS) const {
+    FixedAPInt Quotient, Remainder;
+    udivrem(*this, RHS, Quotient, Remainder);
+    return Quotient;
+  }
+
+  /// Signed division function, rounding towards zero.
+  constexpr FixedAPInt sdiv(const FixedAPInt &RHS) const {
+    FixedAPInt Quotient = abs().udiv(RHS.abs());
+    return isNegative() != RHS.isNegative() ? -Quotient : Quotient;
+  }
+
+  /// Unsigned remainder operation.
+  constexpr FixedAPInt urem(const FixedAPInt &RHS) const {
+    FixedAPInt Quotient, Remainder;
+    udivrem(*this, RHS, Quotient, Remainder);
+    return Remainder;
+  }
+
+  /// Signed remainder operation, with the sign of this value.
+  constexpr FixedAPInt srem(const FixedAPInt &RHS) const {
+    FixedAPInt Remainder = abs().urem(RHS.abs());
+    return isNegative() ? -Remainder : Remainder;
+  }
+
+  /// Dual division/remainder interface.
+  ///
+  /// Sets @p Quotient to LHS / RHS and @p Remainder to LHS % RHS. Either may
+  /// be the same object as @p LHS or @p RHS.
+  static constexpr void udivrem(const FixedAPInt &LHS, const FixedAPInt &RHS,
+                                FixedAPInt &Quotient, FixedAPInt &Remainder) {
+    assert(!RHS.isZero() && "Divide by zero?");
+    if (LHS.ult(RHS)) {
+      Remainder = LHS;
+      Quotient = FixedAPInt();
+      return;
+    }
+
+    FixedAPInt Q, R;
+    if (std::is_constant_evaluated()) {
+      // Restoring division, a bit at a time.
+      for (unsigned I = LHS.getActiveBits(); I-- > 0;) {
+        R = R.shl(1);
+        if (LHS[I])
+          R.Words[0] |= 1;
+        if (R.uge(RHS)) {
+          R -= RHS;
+          Q.setBit(I);
+        }
+      }
+    } else {
+      APInt::divide(LHS.Words.data(), LHS.getActiveWords(), RHS.Words.data(),
+                    RHS.getActiveWords(), Q.Words.data(), R.Words.data());
+    }
+    Quotient = Q;
+    Remainder = R;
+  }
+
+  /// Dual signed division/remainder interface, as sdiv and srem.
+  static constexpr void sdivrem(const FixedAPInt &LHS, const FixedAPInt &RHS,
+                                FixedAPInt &Quotient, FixedAPInt &Remainder) {
+    bool QuotientNegative = LHS.isNegative() != RHS.isNegative();
+    bool RemainderNegative = LHS.isNegative();
+    udivrem(LHS.abs(), RHS.abs(), Quotient, Remainder);
+    if (QuotientNegative)
+      Quotient.negate();
+    if (RemainderNegative)
+      Remainder.negate();
+  }
+
+  /// Get the absolute value.
+  constexpr FixedAPInt abs() const { return isNegative() ? -*this : *this; }
+
+  /// @}
+  /// @name Comparison Operators
+  /// @{
+
+  constexpr friend bool operator==(const FixedAPInt &LHS,
+                                   const FixedAPInt &RHS) {
+    return LHS.Words == RHS.Words;
+  }
+
+  constexpr friend bool operator!=(const FixedAPInt &LHS,
+                                   const FixedAPInt &RHS) {
+    return !(LHS == RHS);
+  }
+
+  /// Equality comparison.
+  constexpr bool eq(const FixedAPInt &RHS) const { return *this == RHS; }
+
+  /// Inequality comparison.
+  constexpr bool ne(const FixedAPInt &RHS) const { return *this != RHS; }
+
+  /// Unsigned less than comparison.
+  constexpr bool ult(const FixedAPInt &RHS) const { return compare(RHS) < 0; }
+
+  /// Signed less than comparison.
+  constexpr bool slt(const FixedAPInt &RHS) const {
+    return compareSigned(RHS) < 0;
+  }
+
+  /// Unsigned less or equal comparison.
+  constexpr bool ule(const FixedAPInt &RHS) const {
+    return compare(RHS) <= 0;
+  }
+
+  /// Signed less or equal comparison.
+  constexpr bool sle(const FixedAPInt &RHS) const {
+    return compareSigned(RHS) <= 0;
+  }
+
+  /// Unsigned greater than comparison.
+  constexpr bool ugt(const FixedAPInt &RHS) const { return !ule(RHS); }
+
+  /// Signed greater than comparison.
+  constexpr bool sgt(const FixedAPInt &RHS) const { return !sle(RHS); }
+
+  /// Unsigned greater or equal comparison.
+  constexpr bool uge(const FixedAPInt &RHS) const { return !ult(RHS); }
+
+  /// Signed greater or equal comparison.
+  constexpr bool sge(const FixedAPInt &RHS) const { return !slt(RHS); }
+
+  /// Unsigned comparison. @returns -1, 0 or 1 if this is less than, equal
+  /// to or greater than @p RHS.
+  constexpr int compare(const FixedAPInt &RHS) const {
+    for (unsigned I = NumWords; I-- > 0;)
+      if (Words[I] != RHS.Words[I])
+        return Words[I] < RHS.Words[I] ? -1 : 1;
+    return 0;
+  }
+
+  /// Signed comparison. @returns -1, 0 or 1 if this is less than, equal to
+  /// or greater than @p RHS.
+  constexpr int compareSigned(const FixedAPInt &RHS) const {
+    bool LHSNeg = isNegative(), RHSNeg = RHS.isNegative();
+    if (LHSNeg != RHSNeg)
+      return LHSNeg ? -1 : 1;
+    return compare(RHS);
+  }
+
+  /// @}
+  /// @name Resizing Operators
+  /// @{
+
+  /// Zero extend to a value of @p NewBits bits.
+  template <unsigned NewBits> constexpr FixedAPInt<NewBits> zext() const {
+    static_assert(NewBits > Bits, "Invalid FixedAPInt ZeroExtend request");
+    return FixedAPInt<NewBits>(std::span<const WordType>(Words));
+  }
+
+  /// Sign extend to a value of @p NewBits bits.
+  template <unsigned NewBits> constexpr FixedAPInt<NewBits> sext() const {
+    static_assert(NewBits > Bits, "Invalid FixedAPInt SignExtend request");
+    FixedAPInt<NewBits> Result = zext<NewBits>();
+    if (isNegative())
+      Result |= FixedAPInt<NewBits>::getHighBitsSet(NewBits - Bits);
+    return Result;
+  }
+
+  /// Truncate to a value of @p NewBits bits.
+  template <unsigned NewBits> constexpr FixedAPInt<NewBits> trunc() const {
+    static_assert(NewBits < Bits, "Invalid FixedAPInt Truncate request");
+    return FixedAPInt<NewBits>(std::span<const WordType>(Words));
+  }
+
+  /// Zero extend or truncate to a value of @p NewBits bits.
+  template <unsigned NewBits>
+  constexpr FixedAPInt<NewBits> zextOrTrunc() const {
+    return FixedAPInt<NewBits>(std::span<const WordType>(Words));
+  }
+
+  /// Sign extend or truncate to a value of @p NewBits bits.
+  template <unsigned NewBits>
+  constexpr FixedAPInt<NewBits> sextOrTrunc() const {
+    if constexpr (NewBits > Bits)
+      return sext<NewBits>();
+    else
+      return zextOrTrunc<NewBits>();
+  }
+
+  /// @}
+  /// @name Bit Counting
+  /// @{
+
+  /// Count the number of zeros from the most significant bit to the first
+  /// one bit.
+  constexpr unsigned countLeadingZeros() const {
+    constexpr unsigned UnusedBits = NumWords * APINT_BITS_PER_WORD - Bits;
+    unsigned Count = 0;
+    for (unsigned I = NumWords; I-- > 0;) {
+      if (Words[I])
+        return Count + std::countl_zero(Words[I]) - UnusedBits;
+      Count += APINT_BITS_PER_WORD;
+    }
+    return Bits;
+  }
+
+  /// Count the number of leading one bits.
+  constexpr unsigned countLeadingOnes() const {
+    return (~*this).countLeadingZeros();
+  }
+
+  /// Count the number of trailing zero bits.
+  constexpr unsigned countTrailingZeros() const {
+    for (unsigned I = 0; I < NumWords; ++I)
+      if (Words[I])
+        return I * APINT_BITS_PER_WORD + std::countr_zero(Words[I]);
+    return Bits;
+  }
+
+  /// Count the number of trailing one bits.
+  constexpr unsigned countTrailingOnes() const {
+    return (~*this).countTrailingZeros();
+  }
+
+  /// Count the number of bits set.
+  constexpr unsigned countPopulation() const {
+    unsigned Count = 0;
+    for (unsigned I = 0; I < NumWords; ++I)
+      Count += std::popcount(Words[I]);
+    return Count;
+  }
+
+  /// @returns the number of copies of the sign bit at the top.
+  constexpr unsigned getNumSignBits() const {
+    return isNegative() ? countLeadingOnes() : countLeadingZeros();
+  }
+
+  /// @returns the floor log base 2 of this value, or -1 if it is zero.
+  constexpr unsigned logBase2() const { return getActiveBits() - 1; }
+
+  /// @}
+  /// @name Conversion Functions
+  /// @{
+
+  /// @returns the value in @p Radix as unsigned, as APInt::toStringUnsigned.
+  std::string toStringUnsigned(unsigned Radix = 10) const {
+    return toAPInt().toStringUnsigned(Radix);
+  }
+
+  /// @returns the value in @p Radix as signed, as APInt::toStringSigned.
+  std::string toStringSigned(unsigned Radix = 10) const {
+    return toAPInt().toStringSigned(Radix);
+  }
+
+  /// @}
+
+private:
+  template <unsigned> friend class FixedAPInt;
+
+  static constexpr WordType WORDTYPE_MAX = ~WordType(0);
+
+  /// Determine which word a bit is in.
+  static constexpr unsigned whichWord(unsigned BitPosition) {
+    return BitPosition / APINT_BITS_PER_WORD;
+  }
+
+  /// @returns a word with only the bit for @p BitPosition in its word set.
+  static constexpr WordType maskBit(unsigned BitPosition) {
+    return WordType(1) << (BitPosition % APINT_BITS_PER_WORD);
+  }
+
+  /// @returns the low word of A * B + C + D and stores the high word in Hi.
+  /// The sum cannot overflow two words.
+  static constexpr WordType mulAdd(WordType A, WordType B, WordType C,
+                                   WordType D, WordType &Hi) {
+#if BIJOU_HAS_INT128
+    unsigned __int128 P = (unsigned __int128)A * B + C + D;
+    Hi = WordType(P >> 64);
+    return WordType(P);
+#else
+    const WordType Mask = 0xffffffff;
+    WordType LL = (A & Mask) * (B & Mask);
+    WordType LH = (A & Mask) * (B >> 32);
+    WordType HL = (A >> 32) * (B & Mask);
+    WordType HH = (A >> 32) * (B >> 32);
+    WordType Mid = (LL >> 32) + (LH & Mask) + (HL & Mask);
+    WordType High = HH + (LH >> 32) + (HL >> 32) + (Mid >> 32);
+    WordType Low = (LL & Mask) | (Mid << 32);
+    Low += C;
+    High += Low < C;
+    Low += D;
+    High += Low < D;
+    Hi = High;
+    return Low;
+#endif
+  }
+
+  /// Clear the bits above @p Bits in the last word.
+  constexpr void clearUnusedBits() {
+    if constexpr (Bits % APINT_BITS_PER_WORD != 0)
+      Words[NumWords - 1] &=
+          WORDTYPE_MAX >> (APINT_BITS_PER_WORD - Bits % APINT_BITS_PER_WORD);
+  }
+
+  std::array<WordType, NumWords> Words; ///< The little endian words.
+};
+
+} // namespace bijou
+
+#endif // BIJOU_ADT_FIXEDAPINT_HPP
@@ -0,0 +1,429 @@
+// Literals.hpp - User-defined literals for APInt, APSInt and APFloat
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file defines user-defined literals for APInt, APSInt and APFloat
+/// constants, which are parsed at compile time.
+///
+
+#ifndef BIJOU_ADT_LITERALS_HPP
+#define BIJOU_ADT_LITERALS_HPP
+
+#include <algorithm>              // for std::copy_n, std::max, std::min
+#include <array>                  // for std::array
+#include <cstdint>                // for uint64_t
+#include <string_view>            // for std::string_view
+#include "bijou/APFloat.hpp"      // for APFloat
+#include "bijou/APInt.hpp"        // for APInt
+#include "bijou/APSInt.hpp"       // for APSInt
+
+namespace bijou {
+
+namespace detail {
+
+/// Why a literal is malformed.
+enum class LiteralError {
+  None,
+  /// A character that is not a digit of the radix, or a misplaced one.
+  InvalidDigit,
+  /// A floating point literal for an integer type.
+  NotAnInteger,
+  /// An integer too wide for the bit width of the type.
+  TooWide,
+  /// A floating point value too large for the format.
+  Overflow,
+  /// A nonzero floating point value that rounds to zero.
+  Underflow,
+};
+
+/// A literal parsed into the words of its value or bit pattern.
+template <unsigned NumWords> struct ParsedLiteral {
+  std::array<uint64_t, NumWords> Words = {};
+  LiteralError Error = LiteralError::None;
+};
+
+/// @returns the value of the digit @p C in any radix up to 16, or -1.
+consteval int getLiteralDigit(char C) {
+  if (C >= '0' && C <= '9')
+    return C - '0';
+  if (C >= 'a' && C <= 'f')
+    return C - 'a' + 10;
+  if (C >= 'A' && C <= 'F')
+    return C - 'A' + 10;
+  return -1;
+}
+
+/// Strips the radix prefix of the integer literal @p Str.
+/// @returns the radix of the literal.
+consteval unsigned stripRadixPrefix(std::string_view &Str) {
+  if (Str.size() > 2 && Str[0] == '0' && (Str[1] == 'x' || Str[1] == 'X')) {
+    Str.remove_prefix(2);
+    return 16;
+  }
+  if (Str.size() > 2 && Str[0] == '0' && (Str[1] == 'b' || Str[1] == 'B')) {
+    Str.remove_prefix(2);
+    return 2;
+  }
+  if (Str.size() > 1 && Str[0] == '0') {
+    Str.remove_prefix(1);
+    return 8;
+  }
+  return 10;
+}
+
+/// @returns whether @p Str is a floating point rather than an integer literal.
+consteval bool isFloatingLiteral(std::string_view Str) {
+  bool Hex = Str.starts_with("0x") || Str.starts_with("0X");
+  return Str.find_first_of(Hex ? ".pP" : ".eE") != std::string_view::npos;
+}
+
+/// Appends the digits of @p Str in @p Radix to @p Value, which must be wide
+/// enough to hold the result, skipping digit separators.
+/// @returns the number of digits, or 0 if @p Str has no digits or a character
+/// that is not a digit of the radix.
+consteval unsigned parseLiteralDigits(std::string_view Str, unsigned Radix,
+                                      APInt &Value) {
+  unsigned NumDigits = 0;
+  for (char C : Str) {
+    if (C == '\'')
+      continue;
+    int Digit = getLiteralDigit(C);
+    if (Digit < 0 || unsigned(Digit) >= Radix)
+      return 0;
+    Value *= Radix;
+    Value += unsigned(Digit);
+    ++NumDigits;
+  }
+  return NumDigits;
+}
+
+/// Parses the integer literal @p Str, in the radix of its prefix.
+consteval LiteralError parseIntegerValue(std::string_view Str, APInt &Value) {
+  if (isFloatingLiteral(Str))
+    return LiteralError::NotAnInteger;
+  unsigned Radix = stripRadixPrefix(Str);
+  Value = APInt(4 * Str.size() + 1, 0);
+  if (!parseLiteralDigits(Str, Radix, Value))
+    return LiteralError::InvalidDigit;
+  return LiteralError::None;
+}
+
+/// @returns the smallest bit width, at least one, that holds the integer
+/// literal @p Str.
+consteval unsigned getIntegerLiteralWidth(std::string_view Str) {
+  APInt Value;
+  if (parseIntegerValue(Str, Value) != LiteralError::None)
+    return 1;
+  return std::max(Value.getActiveBits(), 1u);
+}
+
+/// @returns the words of the integer literal @p Str of @p BitWidth bits.
+template <unsigned BitWidth>
+consteval ParsedLiteral<APInt::getNumWords(BitWidth)>
+parseIntegerLiteral(std::string_view Str) {
+  ParsedLiteral<APInt::getNumWords(BitWidth)> Result;
+  APInt Value;
+  Result.Error = parseIntegerValue(Str, Value);
+  if (Result.Error != LiteralError::None)
+    return Result;
+  if (Value.getActiveBits() > BitWidth) {
+    Result.Error = LiteralError::TooWide;
+    return Result;
+  }
+
+  Value = Value.zextOrTrunc(BitWidth);
+  std::copy_n(Value.getRawData(), Result.Words.size(), Result.Words.begin());
+  return Result;
+}
+
+/// @returns 5 to the power of @p Exp.
+consteval APInt getPowerOfFive(unsigned Exp) {
+  // Widen the operands only as far as each product needs, as constant
+  // evaluation multiplies all words of them.
+  APInt Result(1, 1), Base(3, 5);
+  for (; Exp; Exp >>= 1) {
+    if (Exp & 1) {
+      unsigned BitWidth = Result.getActiveBits() + Base.getActiveBits();
+      Result = Result.zextOrSelf(BitWidth) * Base.zextOrSelf(BitWidth);
+    }
+    if (Exp > 1) {
+      unsigned BitWidth = 2 * Base.getActiveBits();
+      Base = Base.zextOrSelf(BitWidth) * Base.zextOrSelf(BitWidth);
+    }
+  }
+  return Result;
+}
+
+/// Parses the optionally signed decimal exponent @p Str, which saturates at
+/// one million.
+/// @returns false if @p Str is malformed.
+consteval bool parseLiteralExponent(std::string_view Str, int &Exp) {
+  bool Negative = false;
+  if (!Str.empty() && (Str[0] == '+' || Str[0] == '-')) {
+    Negative = Str[0] == '-';
+    Str.remove_prefix(1);
+  }
+  if (Str.empty())
+    return false;
+  Exp = 0;
+  for (char C : Str) {
+    if (C == '\'')
+      continue;
+    if (C < '0' || C > '9')
+      return false;
+    Exp = std::min(Exp * 10 + (C - '0'), 1000000);
+  }
+  if (Negative)
+    Exp = -Exp;
+  return true;
+}
+
+/// Parses the literal @p Str, and rounds it to nearest, ties to even, in the
+/// IEEE 754 binary interchange format of @p Precision significand bits
+/// (including the implicit integer bit), @p MaxExponent and @p SizeInBits.
+///
+/// The value of the literal is first computed exactly, as the integer
+/// quotient of two APInt values and a power of two, so that every literal
+/// rounds correctly however many digits it has.
+template <unsigned Precision, int MaxExponent, unsigned SizeInBits>
+consteval ParsedLiteral<APInt::getNumWords(SizeInBits)>
+parseIEEELiteral(std::string_view Str) {
+  constexpr int MinExponent = 1 - MaxExponent;
+  ParsedLiteral<APInt::getNumWords(SizeInBits)> Result;
+
+  // The value is Num / Den * 2^Exp2.
+  APInt Num, Den(1, 1);
+  int Exp2 = 0;
+
+  if (!isFloatingLiteral(Str)) {
+    Result.Error = parseIntegerValue(Str, Num);
+    if (Result.Error != LiteralError::None)
+      return Result;
+  } else {
+    bool Hex = Str.starts_with("0x") || Str.starts_with("0X");
+    if (Hex)
+      Str.remove_prefix(2);
+
+    size_t ExpPos = Str.find_first_of(Hex ? "pP" : "eE");
+    int Exp = 0;
+    if (ExpPos != std::string_view::npos) {
+      if (!parseLiteralExponent(Str.substr(ExpPos + 1), Exp)) {
+        Result.Error = LiteralError::InvalidDigit;
+        return Result;
+      }
+      Str = Str.substr(0, ExpPos);
+    } else if (Hex) {
+      // Hexadecimal floating point literals need a binary exponent.
+      Result.Error = LiteralError::InvalidDigit;
+      return Result;
+    }
+
+    // Parse the integer and fractional digits as one integer.
+    std::string_view Frac;
+    size_t Point = Str.find('.');
+    if (Point != std::string_view::npos) {
+      Frac = Str.substr(Point + 1);
+      Str = Str.substr(0, Point);
+    }
+    unsigned Radix = Hex ? 16 : 10;
+    Num = APInt(4 * (Str.size() + Frac.size()) + 1, 0);
+    unsigned NumIntDigits = parseLiteralDigits(Str, Radix, Num);
+    unsigned NumFracDigits = parseLiteralDigits(Frac, Radix, Num);
+    if ((!NumIntDigits && !Str.empty()) || (!NumFracDigits && !Frac.empty()) ||
+        NumIntDigits + NumFracDigits == 0) {
+      Result.Error = LiteralError::InvalidDigit;
+      return Result;
+    }
+    if (Num.isZero())
+      return Result;
+
+    if (Hex) {
+      Exp2 = Exp - 4 * int(NumFracDigits);
+    } else {
+      // Num * 10^Exp10 is at least 10^Exp10 and less than
+      // 10^(Exp10 + NumDigits), and log10(2) > 0.301. Leave out the literals
+      // that are certain to overflow or round to zero before computing huge
+      // powers of ten.
+      int Exp10 = Exp - int(NumFracDigits);
+      int NumDigits = int(NumIntDigits + NumFracDigits);
+      if (Exp10 > (MaxExponent + 1) * 302 / 1000 + 1) {
+        Result.Error = LiteralError::Overflow;
+        return Result;
+      }
+      if (Exp10 + NumDigits <
+          (MinExponent - int(Precision) - 1) * 302 / 1000 - 1) {
+        Result.Error = LiteralError::Underflow;
+        return Result;
+      }
+      // 10^Exp10 = 5^Exp10 * 2^Exp10, which keeps the powers narrower.
+      Exp2 = Exp10;
+      if (Exp10 >= 0) {
+        APInt Pow = getPowerOfFive(Exp10);
+        unsigned BitWidth = Num.getActiveBits() + Pow.getActiveBits();
+        Num = Num.zextOrTrunc(BitWidth) * Pow.zextOrTrunc(BitWidth);
+      } else {
+        Den = getPowerOfFive(-Exp10);
+      }
+    }
+  }
+
+  if (Num.isZero())
+    return Result;
+
+  // Divide with enough quotient bits for the significand, a rounding bit and
+  // a sticky bit.
+  int NumBits = Num.getActiveBits(), DenBits = Den.getActiveBits();
+  int Shift = std::max(int(Precision) + 2 - (NumBits - DenBits), 0);
+  unsigned BitWidth = std::max(NumBits + Shift, DenBits) + 1;
+  APInt Quot = Num.zextOrTrunc(BitWidth).shl(Shift), Rem(BitWidth, 0);
+  // Constant evaluation divides bit by bit, so only divide if there is a
+  // fraction.
+  if (!Den.isOne())
+    APInt::udivrem(Quot, Den.zextOrTrunc(BitWidth), Quot, Rem);
+
+  // The exponent of the least significant bit of the quotient and of the
+  // result. Subnormal results have fewer significand bits.
+  int QuotExp = Exp2 - Shift;
+  int LeadExp = int(Quot.getActiveBits()) - 1 + QuotExp;
+  int ResultExp = std::max(LeadExp, MinExponent) - int(Precision - 1);
+  unsigned Drop = ResultExp - QuotExp;
+
+  APInt Significand(Precision + 1, 0);
+  bool Half = false, Rest = !Rem.isZero();
+  if (Drop <= BitWidth) {
+    Significand = Quot.lshr(Drop).zextOrTrunc(Precision + 1);
+    Half = Quot[Drop - 1];
+    Rest |= Quot.countTrailingZeros() < Drop - 1;
+  } else {
+    Rest = true;
+  }
+  if (Half && (Rest || Significand[0]))
+    ++Significand;
+  if (Significand[Precision]) {
+    Significand.lshrInPlace(1);
+    ++ResultExp;
+  }
+
+  if (Significand.isZero()) {
+    Result.Error = LiteralError::Underflow;
+    return Result;
+  }
+  APInt Bits = Significand.zextOrTrunc(SizeInBits);
+  if (Significand[Precision - 1]) {
+    // A normal number, whose integer bit is implicit.
+    int Exp = ResultExp + int(Precision - 1);
+    if (Exp > MaxExponent) {
+      Result.Error = LiteralError::Overflow;
+      return Result;
+    }
+    Bits.clearBit(Precision - 1);
+    Bits |= APInt(SizeInBits, Exp + MaxExponent) << (Precision - 1);
+  }
+
+  std::copy_n(Bits.getRawData(), Result.Words.size(), Result.Words.begin());
+  return Result;
+}
+
+/// Reports the errors of a literal.
+template <LiteralError Error> constexpr void checkLiteral() {
+  static_assert(Error != LiteralError::InvalidDigit,
+                "invalid digit in literal");
+  static_assert(Error != LiteralError::NotAnInteger,
+                "floating point literal for an integer type");
+  static_assert(Error != LiteralError::TooWide,
+                "integer literal too wide for its bit width");
+  static_assert(Error != LiteralError::Overflow,
+                "floating point literal overflows its format");
+  static_assert(Error != LiteralError::Underflow,
+                "floating point literal underflows to zero");
+}
+
+/// Holds the characters of a literal as a string constant.
+template <char... Chars> struct LiteralString {
+  static constexpr char Data[] = {Chars..., '\0'};
+  static constexpr std::string_view Value{Data, sizeof...(Chars)};
+};
+
+/// @returns the integer literal @p Chars as an APInt of @p BitWidth bits.
+template <unsigned BitWidth, char... Chars> APInt makeAPIntLiteral() {
+  static constexpr auto Literal =
+      parseIntegerLiteral<BitWidth>(LiteralString<Chars...>::Value);
+  checkLiteral<Literal.Error>();
+  return APInt(BitWidth, Literal.Words);
+}
+
+} // namespace detail
+
+inline namespace literals {
+
+/// Integer literals, parsed at compile time, such as
+///
+/// @code
+///   using namespace bijou::literals;
+///   APInt Mask = 0xffff'ffff'ffff'ffff'ffff_apint;
+///   APInt Prime = 0x1'0000'0000'0000'0000'0000'0000'0000'0033_apint256;
+/// @endcode
+///
+/// The literals accept decimal, hexadecimal, octal and binary integer
+/// literals with digit separators. At run time they copy the words of the
+/// value, parsed during compilation. A literal that is malformed, such as a
+/// floating point one, or too wide for its bit width, is a compile error.
+///
+/// _apint has the smallest bit width that holds the value, the others the
+/// bit width of their name.
+/// @{
+template <char... Chars> APInt operator""_apint() {
+  constexpr unsigned BitWidth =
+      detail::getIntegerLiteralWidth(detail::LiteralString<Chars...>::Value);
+  return detail::makeAPIntLiteral<BitWidth, Chars...>();
+}
+
+template <char... Chars> APInt operator""_apint64() {
+  return detail::makeAPIntLiteral<64, Chars...>();
+}
+
+template <char... Chars> APInt operator""_apint128() {
+  return detail::makeAPIntLiteral<128, Chars...>();
+}
+
+template <char... Chars> APInt operator""_apint256() {
+  return detail::makeAPIntLiteral<256, Chars...>();
+}
+
+template <char... Chars> APInt operator""_apint512() {
+  return detail::makeAPIntLiteral<512, Chars...>();
+}
+/// @}
+
+/// An unsigned APSInt literal of the smallest bit width that holds the
+/// value, like APSInt(std::string_view) of a non-negative number.
+template <char... Chars> APSInt operator""_apsint() {
+  constexpr unsigned BitWidth =
+      detail::getIntegerLiteralWidth(detail::LiteralString<Chars...>::Value);
+  return APSInt(detail::makeAPIntLiteral<BitWidth, Chars...>(),
+                /*isUnsigned=*/true);
+}
+
+/// An IEEEquad APFloat literal, such as 1.1_quad or 0x1.8p-3_quad, rounded
+/// to nearest, ties to even, at compile time. It accepts decimal and
+/// hexadecimal floating point literals and integer literals. A literal that
+/// is malformed, overflows to infinity or underflows to zero is a compile
+/// error. Negative values negate the literal, as in -1.1_quad.
+template <char... Chars> APFloat operator""_quad() {
+  static constexpr auto Literal = detail::parseIEEELiteral<113, 16383, 128>(
+      detail::LiteralString<Chars...>::Value);
+  detail::checkLiteral<Literal.Error>();
+  return APFloat(APFloat::IEEEquad(), APInt(128, Literal.Words));
+}
+
+} // namespace literals
+
+} // namespace bijou
+
+#endif // BIJOU_ADT_LITERALS_HPP
@@ -0,0 +1,103 @@
+// MontgomeryContext.hpp - Modular arithmetic for a fixed odd modulus
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file defines the MontgomeryContext class, which does modular
+/// multiplication and exponentiation of APInts for a fixed odd modulus in
+/// Montgomery form.
+///
+
+#ifndef BIJOU_ADT_MONTGOMERYCONTEXT_HPP
+#define BIJOU_ADT_MONTGOMERYCONTEXT_HPP
+
+#include "bijou/APInt.hpp"
+
+namespace bijou {
+
+/// Modular arithmetic for a fixed odd modulus N in Montgomery form.
+///
+/// Constructing a context precomputes the constants for N once, so that
+/// many multiplications by the same modulus need no division. A value X is
+/// represented by its Montgomery form X * R mod N, where R is 2 to the power
+/// of the number of bits in the words of N. mulmod and sqrmod take and return
+/// values in Montgomery form; use toMontgomery and fromMontgomery to convert.
+/// powmod takes and returns ordinary values.
+///
+/// All values have the bit width of the modulus and must be less than it.
+/// The functions that take a result reference reuse its storage when it
+/// already has that bit width, and may alias their operands. For moduli of
+/// up to MONTGOMERY_STACK_WORDS words they keep their temporaries on the
+/// stack and so do not allocate.
+class MontgomeryContext {
+public:
+  using WordType = APInt::WordType;
+
+  enum : unsigned {
+    /// The number of words up to which temporaries live on the stack.
+    MONTGOMERY_STACK_WORDS = 64,
+    /// The largest window powmod uses, in bits.
+    MONTGOMERY_MAX_WINDOW = 5,
+  };
+
+  /// Creates a context for the odd modulus @p Modulus. Values used with the
+  /// context have the bit width of @p Modulus.
+  explicit MontgomeryContext(const APInt &Modulus);
+
+  /// @returns the modulus.
+  const APInt &getModulus() const { return Modulus; }
+
+  /// @returns the bit width of the modulus and of all values.
+  unsigned getBitWidth() const { return Modulus.getBitWidth(); }
+
+  /// Converts @p X into Montgomery form.
+  void toMontgomery(APInt &Result, const APInt &X) const;
+  [[nodiscard]] APInt toMontgomery(const APInt &X) const;
+
+  /// Converts @p X out of Montgomery form.
+  void fromMontgomery(APInt &Result, const APInt &X) const;
+  [[nodiscard]] APInt fromMontgomery(const APInt &X) const;
+
+  /// Multiplies @p LHS and @p RHS modulo N, all in Montgomery form.
+  void mulmod(APInt &Result, const APInt &LHS, const APInt &RHS) const;
+  [[nodiscard]] APInt mulmod(const APInt &LHS, const APInt &RHS) const;
+
+  /// Squares @p X modulo N, both in Montgomery form.
+  void sqrmod(APInt &Result, const APInt &X) const;
+  [[nodiscard]] APInt sqrmod(const APInt &X) const;
+
+  /// Computes @p Base to the power of @p Exponent modulo N with a sliding
+  /// window. @p Base and the result are ordinary values, not in Montgomery
+  /// form. @p Exponent may have any bit width and is taken as unsigned.
+  void powmod(APInt &Result, const APInt &Base, const APInt &Exponent) const;
+  [[nodiscard]] APInt powmod(const APInt &Base, const APInt &Exponent) const;
+
+private:
+  /// Sets Dst to A * B / R mod N, using T as scratch of getNumWords() + 2
+  /// words. Dst may alias A and B.
+  void multiply(WordType *Dst, const WordType *A, const WordType *B,
+                WordType *T) const;
+
+  /// Sets Dst to A * A / R mod N, using T as scratch of 2 * getNumWords() + 1
+  /// words. Dst may alias A.
+  void square(WordType *Dst, const WordType *A, WordType *T) const;
+
+  /// Stores the value in Words into Result, giving it the modulus bit width.
+  void assign(APInt &Result, const WordType *Words) const;
+
+  unsigned getNumWords() const { return Modulus.getNumWords(); }
+
+  APInt Modulus;          ///< The modulus N.
+  APInt RSquared;         ///< R * R mod N, used to convert into Montgomery form.
+  APInt One;              ///< R mod N, the Montgomery form of 1.
+  WordType NegInverse;    ///< -N^-1 mod 2^64.
+};
+
+} // namespace bijou
+
+#endif // BIJOU_ADT_MONTGOMERYCONTEXT_HPP
@@ -0,0 +1,157 @@
+// WordAllocator.hpp - Allocation of APInt and APFloat word buffers
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file declares allocateWords and deallocateWords, which allocate the
+/// heap buffers of APInt, the IEEEFloat significand and their scratch space.
+///
+
+#ifndef BIJOU_ADT_WORDALLOCATOR_HPP
+#define BIJOU_ADT_WORDALLOCATOR_HPP
+
+#include <cstddef>               // for size_t
+#include <cstdint>               // for uint64_t
+#include <memory>                // for unique_ptr
+#include <vector>                // for vector
+#include "bijou/bijou-config.h"  // for BIJOU_ENABLE_WORD_POOL
+
+namespace bijou {
+
+/// The largest buffer, in words, that the word pool recycles.
+constexpr unsigned WORD_POOL_MAX_WORDS = 1024;
+
+/// The most free buffers the word pool keeps per thread and size class.
+constexpr unsigned WORD_POOL_MAX_FREE_BUFFERS = 32;
+
+/// Counts of the allocations of the calling thread's word pool.
+struct WordPoolStatistics {
+  /// Allocations served from a free list.
+  uint64_t Hits = 0;
+  /// Allocations that went to operator new, because the free list of their
+  /// size class was empty or they were too large to pool.
+  uint64_t Misses = 0;
+};
+
+/// Allocates an uninitialized buffer of @p NumWords words.
+///
+/// Inside a WordArenaScope the buffer comes from the innermost scope's arena.
+/// Otherwise, when bijou is built with BIJOU_ENABLE_WORD_POOL, buffers of up
+/// to WORD_POOL_MAX_WORDS words are rounded up to a power of two and recycled
+/// through per-thread free lists, so that threads never contend on the
+/// allocator for them. Otherwise this is new uint64_t[NumWords].
+uint64_t *allocateWords(unsigned NumWords);
+
+/// Frees a buffer from allocateWords. @p NumWords must be the size it was
+/// allocated with. Buffers outside of arenas may be freed on any thread,
+/// arena buffers only on the thread of their scope while it is active.
+void deallocateWords(uint64_t *Words, unsigned NumWords);
+
+/// @returns the statistics of the calling thread's word pool, which are all
+/// zero unless bijou is built with BIJOU_ENABLE_WORD_POOL.
+WordPoolStatistics getWordPoolStatistics();
+
+/// Resets the statistics of the calling thread's word pool.
+void resetWordPoolStatistics();
+
+/// Returns the free buffers of the calling thread's word pool to the system.
+/// This happens automatically when the thread exits.
+void trimWordPool();
+
+/// Sends the word buffer allocations of the current thread to a bump-pointer
+/// arena for as long as the scope is alive, and frees them all at once when
+/// it ends.
+///
+/// This suits computations that create many temporary APInt and APFloat
+/// values and keep few of them:
+///
+/// @code
+///   APInt Result;
+///   {
+///     WordArenaScope Scope;
+///     APInt Tmp = evaluate(Formula);
+///     Result = WordArenaScope::detach(Tmp);
+///   }
+/// @endcode
+///
+/// Freeing an arena buffer does nothing; its memory is reclaimed with the
+/// arena. A value allocated in the scope must therefore not outlive it. Copy
+/// it out with detach, which allocates outside of all arenas, before the scope
+/// ends. Scopes nest, the innermost one receives the allocations.
+class WordArenaScope {
+public:
+  WordArenaScope();
+  ~WordArenaScope();
+
+  WordArenaScope(const WordArenaScope &) = delete;
+  WordArenaScope &operator=(const WordArenaScope &) = delete;
+
+  /// @returns a copy of @p Value whose storage is allocated outside of all
+  /// arenas, so that it may outlive the current scopes.
+  template <typename T> static T detach(const T &Value) {
+    Suspension S;
+    return T(Value);
+  }
+
+  /// @returns whether @p Words is a buffer of this scope's arena.
+  bool owns(const uint64_t *Words) const;
+
+  /// @returns the number of bytes the arena has taken from the system.
+  size_t getNumBytesReserved() const;
+
+private:
+  /// Routes allocations of the current thread past all arenas while alive.
+  class Suspension {
+  public:
+    Suspension();
+    ~Suspension();
+  };
+
+  struct Slab {
+    std::unique_ptr<uint64_t[]> Words;
+    size_t Size;
+  };
+
+  uint64_t *allocate(unsigned NumWords);
+
+  std::vector<Slab> Slabs;      ///< The memory of the arena.
+  uint64_t *Cur = nullptr;      ///< The next free word of the last slab.
+  uint64_t *End = nullptr;      ///< The end of the last slab.
+  WordArenaScope *Outer;        ///< The enclosing scope, if any.
+
+  friend uint64_t *allocateWords(unsigned NumWords);
+  friend void deallocateWords(uint64_t *Words, unsigned NumWords);
+};
+
+/// Uninitialized scratch space of a given number of words, on the stack if
+/// it fits in StackWords and from allocateWords otherwise.
+template <unsigned StackWords> class ScratchWords {
+public:
+  explicit ScratchWords(unsigned NumWords) : NumWords(NumWords) {
+    if (NumWords > StackWords)
+      Words = allocateWords(NumWords);
+  }
+  ~ScratchWords() {
+    if (Words != Stack)
+      deallocateWords(Words, NumWords);
+  }
+
+  ScratchWords(const ScratchWords &) = delete;
+  ScratchWords &operator=(const ScratchWords &) = delete;
+
+  uint64_t *data() { return Words; }
+
+private:
+  uint64_t Stack[StackWords];
+  uint64_t *Words = Stack;
+  unsigned NumWords;
+};
+
+} // namespace bijou
+
+#endif // BIJOU_ADT_WORDALLOCATOR_HPP
@@ -30,6 +30,29 @@
 /// BIJOU version string
 #define BIJOU_VERSION_STRING "${PACKAGE_VERSION}"
 
+/// Number of 64-bit words an APInt stores inline before it allocates memory
+/// on the heap.
+#define BIJOU_APINT_INLINE_WORDS ${BIJOU_APINT_INLINE_WORDS}
+
+/// Operand size in 64-bit words from which APInt multiplication switches from
+/// the schoolbook algorithm to Karatsuba's.
+#define BIJOU_APINT_KARATSUBA_THRESHOLD ${BIJOU_APINT_KARATSUBA_THRESHOLD}
+
+/// Operand size in 64-bit words from which APInt multiplication switches from
+/// Karatsuba's algorithm to Toom-Cook 3-way.
+#define BIJOU_APINT_TOOM3_THRESHOLD ${BIJOU_APINT_TOOM3_THRESHOLD}
+
+/// Whether APInt and APFloat recycle their word buffers through per-thread
+/// free lists.
+#cmakedefine01 BIJOU_ENABLE_WORD_POOL
+
+/// Whether IEEEFloat computes arithmetic and conversions on IEEEsingle,
+/// IEEEdouble and x87DoubleExtended values with the host FPU, arithmetic on
+/// IEEEquad values with the compiler's quad routines, and arithmetic and
+/// conversions on IEEEhalf and BFloat values in float, when that gives the
+/// same result as the software arithmetic.
+#cmakedefine01 BIJOU_ENABLE_HARDWARE_FLOAT
+
 /// Whether the header unistd.h is available.
 #cmakedefine01 HAVE_UNISTD_H
 
@@ -13,6 +13,27 @@
 //   * Removed unused LLVM helper APIs (such as FoldingSetNode, DenseMap)
 //   * Added APIs to print classes defined in this file with C stdio routines.
 //   * Changed doxygen comments to consistenly use '@' command prefix.
+//   * Allocate word buffers with allocateWords, which can pool them per thread.
+//   * Square the powers of five with APInt::tcSquare.
+//   * Added toChars and fromChars, which toString and print use to format
+//     into caller provided buffers.
+//   * Parse decimal strings into the built-in semantics in stack scratch
+//     space, including the working values and the powers of five.
+//   * Compute the decimal digits of significands of up to two words with
+//     fixed width arithmetic and a table of powers of five.
+//   * Round decimal strings of up to nineteen digits into formats of up to
+//     64 bits of precision from bounds on the power of five, and fixed the
+//     rounding and status of the exact conversion near representable values.
+//   * Optionally compute IEEEsingle, IEEEdouble and x87DoubleExtended
+//     arithmetic and conversions with the host FPU, IEEEquad arithmetic with
+//     the compiler's quad routines, and IEEEhalf and BFloat arithmetic and
+//     conversions in float, where they give the same result and status.
+//   * Store significands of up to two parts inline, and use stack scratch
+//     space for the multiplication, division and fused multiply-add of the
+//     built-in semantics, multiplying without the Karatsuba scratch.
+//   * Compute the next value, integral rounding and integer conversion of
+//     PPCDoubleDouble exactly on the pair of doubles, and convert between
+//     the pair and the legacy semantics without bitcasts through APInt.
 //
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
@@ -24,25 +45,74 @@
 ///
 
 #include "bijou/APFloat.hpp"
-#include <algorithm>            // for equal, max, min
-#include <ctype.h>              // for tolower
-#include <climits>              // for INT_MAX, INT_MIN
+#include <algorithm>            // for equal, max, min, find, fill_n
+#include <array>                // for array
+#include <bit>                  // for bit_cast
+#include <charconv>             // for to_chars_result, from_chars_result
+#include <ctype.h>              // for tolower, isalpha, isalnum
+#include <cfenv>                // for feholdexcept, fesetround, fetestexcept
+#include <cfloat>               // for LDBL_MANT_DIG, LDBL_MAX_EXP
+#include <climits>              // for INT_MAX, INT_MIN, CHAR_BIT
+#include <cmath>                // for fma, fabs, fpclassify
 #include <cstdio>               // for fprintf, stderr, FILE
 #include <cstdint>              // for uint64_t, uint32_t, uint8_t
 #include <cstring>              // for memset, size_t, memcpy
+#include <iterator>             // for size, end
+#include <limits>               // for numeric_limits
+#include <memory>               // for unique_ptr
 #include <optional>             // for optional
 #include <span>                 // for span
 #include <string>               // for basic_string, char_traits
+#include <type_traits>          // for conditional_t
 #include <vector>               // for vector
 #include "bijou/APSInt.hpp"          // for APSInt
 #include "bijou/Error.hpp"           // for Expected, bijou_unreachable, Error
 #include "bijou/Hashing.hpp"         // for hash_combine, hash_combine_range
 #include "bijou/MathExtras.hpp"      // for NextPowerOf2
+#include "bijou/WordAllocator.hpp"   // for ScratchWords
 
 #ifdef AP_USE_IOSTREAM
 #  include <iostream>
 #endif
 
+#if BIJOU_ENABLE_HARDWARE_FLOAT && defined(__x86_64__) &&                    \
+    (defined(__GNUC__) || defined(__clang__))
+#define BIJOU_HAS_SSE_FLOAT_ENV 1
+#include <emmintrin.h>          // for _mm_set_epi64x
+#include <xmmintrin.h>          // for _mm_getcsr, _mm_setcsr
+#else
+#define BIJOU_HAS_SSE_FLOAT_ENV 0
+#endif
+
+// Without FMA instructions std::fma is a library call, which need not take
+// its rounding mode from the SSE control register.
+#if !BIJOU_HAS_SSE_FLOAT_ENV || defined(__FMA__)
+#define BIJOU_HAS_HOST_FMA 1
+#else
+#define BIJOU_HAS_HOST_FMA 0
+#endif
+
+// On x86-64 long double is usually the x87 extended format, which x87
+// instructions round as their control word says.
+#if BIJOU_HAS_SSE_FLOAT_ENV && LDBL_MANT_DIG == 64 && LDBL_MAX_EXP == 16384
+#define BIJOU_HAS_X87_LONG_DOUBLE 1
+#else
+#define BIJOU_HAS_X87_LONG_DOUBLE 0
+#endif
+
+// GCC and Clang implement IEEE quad arithmetic as __float128 on x86-64, and
+// as long double where that is the quad format, with soft float routines.
+#if BIJOU_HAS_SSE_FLOAT_ENV && defined(__SIZEOF_FLOAT128__)
+#define BIJOU_HAS_HOST_QUAD 1
+#define BIJOU_HOST_QUAD __float128
+#elif BIJOU_ENABLE_HARDWARE_FLOAT && LDBL_MANT_DIG == 113 &&                 \
+    defined(__SIZEOF_INT128__)
+#define BIJOU_HAS_HOST_QUAD 1
+#define BIJOU_HOST_QUAD long double
+#else
+#define BIJOU_HAS_HOST_QUAD 0
+#endif
+
 namespace bijou {
 
 /// from StringExtras.h
@@ -694,12 +764,13 @@ HUerrBound(bool inexactMultiply, unsigned int HUerr1, unsigned int HUerr2)
 
 /* The number of ulps from the boundary (zero, or half if ISNEAREST)
    when the least significant BITS are truncated.  BITS cannot be
-   zero.  */
+   zero.  Without ISNEAREST the boundary above the truncated bits
+   counts too, as truncated bits of all ones are just below it.  */
 static APFloatBase::integerPart
 ulpsFromBoundary(const APFloatBase::integerPart *parts, unsigned int bits,
                  bool isNearest) {
   unsigned int count, partBits;
-  APFloatBase::integerPart part, boundary;
+  APFloatBase::integerPart part, mask, boundary, belowBoundary;
 
   assert(bits != 0);
 
@@ -707,14 +778,20 @@ ulpsFromBoundary(const APFloatBase::integerPart *parts, unsigned int bits,
   count = bits / APFloatBase::integerPartWidth;
   partBits = bits % APFloatBase::integerPartWidth + 1;
 
-  part = parts[count] & (~(APFloatBase::integerPart) 0 >> (APFloatBase::integerPartWidth - partBits));
+  mask = ~(APFloatBase::integerPart) 0 >> (APFloatBase::integerPartWidth - partBits);
+  part = parts[count] & mask;
 
-  if (isNearest)
+  if (isNearest) {
     boundary = (APFloatBase::integerPart) 1 << (partBits - 1);
-  else
+    belowBoundary = boundary - 1;
+  } else {
     boundary = 0;
+    belowBoundary = mask;
+  }
 
   if (count == 0) {
+    if (!isNearest)
+      return part <= mask - part ? part : mask - part + 1;
     if (part - boundary <= boundary - part)
       return part - boundary;
     else
@@ -727,7 +804,7 @@ ulpsFromBoundary(const APFloatBase::integerPart *parts, unsigned int bits,
         return ~(APFloatBase::integerPart) 0; /* A lot.  */
 
     return parts[0];
-  } else if (part == boundary - 1) {
+  } else if (part == belowBoundary) {
     while (--count)
       if (~parts[count])
         return ~(APFloatBase::integerPart) 0; /* A lot.  */
@@ -738,6 +815,27 @@ ulpsFromBoundary(const APFloatBase::integerPart *parts, unsigned int bits,
   return ~(APFloatBase::integerPart) 0; /* A lot.  */
 }
 
+/* DST = LHS * RHS, where DST has LHSPARTS + RHSPARTS parts.  From the
+   Karatsuba threshold on, tcFullMultiply takes scratch space from
+   allocateWords, so wider products use the schoolbook method, which needs
+   none.  */
+static void
+multiplyWithoutScratch(APFloatBase::integerPart *dst,
+                       const APFloatBase::integerPart *lhs,
+                       unsigned int lhsParts,
+                       const APFloatBase::integerPart *rhs,
+                       unsigned int rhsParts) {
+  if (std::min(lhsParts, rhsParts) < APInt::APINT_KARATSUBA_THRESHOLD) {
+    APInt::tcFullMultiply(dst, lhs, rhs, lhsParts, rhsParts);
+    return;
+  }
+
+  APInt::tcSet(dst, 0, rhsParts);
+  for (unsigned int i = 0; i < lhsParts; i++)
+    APInt::tcMultiplyPart(&dst[i], rhs, lhs[i], 0, rhsParts, rhsParts + 1,
+                          true);
+}
+
 /* Place pow(5, power) in DST, and return the number of parts used.
    DST must be at least one part larger than size of the answer.  */
 static unsigned int
@@ -768,7 +866,7 @@ powerOf5(APFloatBase::integerPart *dst, unsigned int power) {
     /* Calculate pow(5,pow(2,n+3)) if we haven't yet.  */
     if (pc == 0) {
       pc = partsCount[n - 1];
-      APInt::tcFullMultiply(pow5, pow5 - pc, pow5 - pc, pc, pc);
+      multiplyWithoutScratch(pow5, pow5 - pc, pc, pow5 - pc, pc);
       pc *= 2;
       if (pow5[pc - 1] == 0)
         pc--;
@@ -778,7 +876,7 @@ powerOf5(APFloatBase::integerPart *dst, unsigned int power) {
     if (power & 1) {
       APFloatBase::integerPart *tmp;
 
-      APInt::tcFullMultiply(p2, p1, pow5, result, pc);
+      multiplyWithoutScratch(p2, p1, result, pow5, pc);
       result += pc;
       if (p2[result - 1] == 0)
         result--;
@@ -799,6 +897,352 @@ powerOf5(APFloatBase::integerPart *dst, unsigned int power) {
   return result;
 }
 
+/// 5^(PowerOfFiveStep * I) for I in [MinPowerOfFiveIndex,
+/// MaxPowerOfFiveIndex] as Significand * 2^Exponent, with the top bit of
+/// the 192-bit Significand set.  Inexact entries are rounded down; those
+/// for I = 0 and I = 1 are exact.  Products of a few entries reach the
+/// powers of five that decimal conversions need for formats up to quad.
+struct PowerOfFive {
+  APFloatBase::integerPart Significand[3];
+  int Exponent;
+};
+static const int PowerOfFiveStep = 55;
+static const int MinPowerOfFiveIndex = -91;
+static const int MaxPowerOfFiveIndex = 91;
+// Generated with Python, where P = 5**abs(55 * I):
+//   E = P.bit_length() - 192 if I >= 0 else -(191 + P.bit_length())
+//   Significand = P * 2**-E if I >= 0 else 2**-E // P
+// with E adjusted by one where that leaves 191 or 193 bits.
+static const PowerOfFive PowersOfFive[] = {
+  {{0xb76974f01fd4d2a5, 0x96c34f43a9faced7, 0xd740992314ad6bb8}, -11813},
+  {{0x0da480db4296ca8c, 0x70154bfea931f512, 0xaf92c8fc34030ad8}, -11685},
+  {{0x26b1c31d83ac3676, 0x19dc56fc26c008ba, 0x8f356ea4db83ee7f}, -11557},
+  {{0x8074337fe5cf21eb, 0xbc6ce5a8495e08d8, 0xe99ec0788c206e1f}, -11430},
+  {{0x51b2cef5c51b79d8, 0xef5b27f174660724, 0xbe8e287ad508c0f3}, -11302},
+  {{0xcc6779886394c9ec, 0x396599036f763936, 0x9b6dcde6556f3363}, -11174},
+  {{0x8e51c409f2e4b05a, 0xcae5cf9db832e1d1, 0xfd8e259dbd068d30}, -11047},
+  {{0x83ba23061661070b, 0x77707cab526fa3eb, 0xced0cf194377f1eb}, -10919},
+  {{0x4dcd52747e029d0c, 0x867b3096b1619df8, 0xa8b11ff4721d92fb}, -10791},
+  {{0x4fdb81b3759f0acb, 0x76711575854bf95f, 0x899882d09813113d}, -10663},
+  {{0x26f5f1f177be0cea, 0x44c0f1cd48c68252, 0xe076aa2cbfe4831c}, -10536},
+  {{0xbdfb990b4b45aa13, 0xfe1aeb52fa041ff4, 0xb7162c41954f4159}, -10408},
+  {{0x4f6e615824008f85, 0x7ec85fe3aa67c56d, 0x955644c05ce9c012}, -10280},
+  {{0xf563727fca946b4c, 0xe6ebb85e5f1479ab, 0xf39e091a9acf00ef}, -10153},
+  {{0x9b5c43bdff19ab41, 0xa3687a17c2d5cde0, 0xc6b5abdb2e2ce3ba}, -10025},
+  {{0xe627d8a40ffbe5f2, 0x734fa021ea85a71c, 0xa21482fdff3a126f}, -9897},
+  {{0x2b674cf7a2cd0dbf, 0x64b09c05aff9045f, 0x8433e8b3772798cb}, -9769},
+  {{0xdc237627e2113e2f, 0x906e7fc46ca85ff5, 0xd7aa73dfd55b07ec}, -9642},
+  {{0xb0571a310695a482, 0xd5921596a89da672, 0xafe9206c93af82e7}, -9514},
+  {{0x3e878a059c3e8f96, 0xab32a3251dfecdba, 0x8f7bdb9a43fcc895}, -9386},
+  {{0x9865167ffa8fd2df, 0x86bdd15e26b541af, 0xea11a394fb12091e}, -9259},
+  {{0xe84a8efa266d30f4, 0x8a7720b2f152b62a, 0xbeebde095ff85cb6}, -9131},
+  {{0x9be9efe094388b54, 0x26c60defee681b99, 0x9bba3d4b8659d17b}, -9003},
+  {{0x326dfff3db984904, 0x215f542134c43302, 0xfe0ad66b4baff68a}, -8876},
+  {{0x336f9c6855eb28da, 0x5a1535e476a66fa4, 0xcf3683b7ecc0ac96}, -8748},
+  {{0xd5d5a90aec76df65, 0x33a23a94c8156276, 0xa904151053f9107b}, -8620},
+  {{0x2b550c149bd2495a, 0xe3b8b6a4bed75ca5, 0x89dc2d23d9202901}, -8492},
+  {{0x294d82f85639fb9c, 0x81884dd8cb5eb34a, 0xe0e50c894cc21dfd}, -8365},
+  {{0xa6d4181b0ea43361, 0x0984ae3b95558b7e, 0xb770358eca42b391}, -8237},
+  {{0xe0a1b54a4ab11616, 0xaf34bfd316e13071, 0x959fb5371a830160}, -8109},
+  {{0x5df3b231e9bb883d, 0xb50b757ace5d0a31, 0xf415d6caa531cbc3}, -7982},
+  {{0x25714d2354def47b, 0x509c2b58aa2fcd73, 0xc71763fcc709b18f}, -7854},
+  {{0x29b52755c4ca57d8, 0xaf8b0fc54960e4bc, 0xa26437b9ee62d0a9}, -7726},
+  {{0x25fe5e475c7a95fe, 0x052c5352353864ea, 0x8474ec16c08b589c}, -7598},
+  {{0x6371b0aca07778e2, 0x675231d78cc44505, 0xd81482aae835b046}, -7471},
+  {{0x71043692494aa743, 0x3ca5a7540d9d56c9, 0xb03fa252bd05a815}, -7343},
+  {{0xd307c122653fe5f7, 0x0f1afce62f5cc13d, 0x8fc26b31c20b78e6}, -7215},
+  {{0x6bdf8efad04374de, 0x4901443671367503, 0xea84bf30e396debe}, -7088},
+  {{0x72484127be8c01b1, 0x6cd97eca18f716df, 0xbf49c1ad3d62147d}, -6960},
+  {{0xbde49f2198195b9a, 0xafbbd7883a685617, 0x9c06d2475b142252}, -6832},
+  {{0x9b299e47efae3824, 0xf824696b95869087, 0xfe87c48a8445cb6b}, -6705},
+  {{0xa6c43422e26efcfc, 0xa1fd81ee45011bc0, 0xcf9c6a5a972c2ce3}, -6577},
+  {{0xfcf94782cf12649a, 0x920a8c098c896934, 0xa95732f7f6b4afdf}, -6449},
+  {{0x7afb356e870287fd, 0x3eeca1cbb79521c2, 0x8a1ff8bdafa4e3da}, -6321},
+  {{0xa2769550e89f4a5e, 0x47c1c1728af31dbc, 0xe153a52e703c3715}, -6194},
+  {{0xd790a60f9113957b, 0xfc04d01598cfee9c, 0xb7ca6b22ee3f7bc1}, -6066},
+  {{0xaedccf5f2b88043b, 0x52bf6456b57ecb68, 0x95e949cb54b5e33d}, -5938},
+  {{0x0d9369fb2d875600, 0xfe5932a9010b3c2e, 0xf48ddf6516fdd007}, -5811},
+  {{0x0e3a9c29ba79495b, 0x86d000a42b18ee92, 0xc7794c2c88cae188}, -5683},
+  {{0xc2a0016167e6ad38, 0x87b51116de2df53c, 0xa2b413a8485b80ba}, -5555},
+  {{0xddf0977daa769701, 0x3db9d8c43cbd92ad, 0x84b60f72be048ff0}, -5427},
+  {{0xd1dc0c182c23c6c9, 0x25c64e402aec9c44, 0xd87ec59de6b65e6f}, -5300},
+  {{0x09c018bfd13d75d5, 0x0e0c62571fa0fa89, 0xb0964ec391726617}, -5172},
+  {{0x355d1c8e53f42a4b, 0x62fbec6869f64ccc, 0x90091d7c5dc0eaa9}, -5044},
+  {{0x690bf23c9d13417f, 0xd6e078798eef0137, 0xeaf813680e5f7e12}, -4917},
+  {{0x08dd2df90d372834, 0x646a29bab86d6f11, 0xbfa7d37d16d4cfdd}, -4789},
+  {{0xe7db353a50105038, 0x3e83bc53211cc27b, 0x9c538cec4fbc0774}, -4661},
+  {{0x4ea13b6674611e51, 0x13e03a2791acc462, 0xff04f0198e68330f}, -4534},
+  {{0x8947d70aab4831e9, 0xf00fb7693e120f47, 0xd0028319db577c51}, -4406},
+  {{0x464ce38e212dd612, 0xddcce19614fb7834, 0xa9aa79bf6a3aac53}, -4278},
+  {{0x6fd69dd719ed228a, 0x63f3b759cea8d7b5, 0x8a63e5ae78ce573e}, -4150},
+  {{0xa7140bbeb328a288, 0x4ef01ce5a0ee9cf6, 0xe1c27436dc3c611c}, -4023},
+  {{0xb6bbd60f37bae759, 0x4279a7b84a159140, 0xb824cd13c771178d}, -3895},
+  {{0xf8e996ee82d073fa, 0xb070fbde944761c0, 0x9633028ece2760d3}, -3767},
+  {{0xc51911dbe9fe42c2, 0x70abc25c37b04b22, 0xf5062306e9425ff4}, -3640},
+  {{0xa72a86f446a25ee9, 0xd720305c98cd2ee8, 0xc7db64821542cff3}, -3512},
+  {{0x9782c002969c02e7, 0x07eb1b0690ea9f10, 0xa30416dc53c1da98}, -3384},
+  {{0x4d4675a6ac444181, 0xa571e8db1718a403, 0x84f752d7288f298d}, -3256},
+  {{0xcd40cbf19f131f89, 0x4ecace702b43c88e, 0xd8e93cd276ecd79e}, -3129},
+  {{0xcb810bf563477b50, 0x33ba2b279ea85b7b, 0xb0ed25d3fca75faa}, -3001},
+  {{0xc156f8034ba49f3e, 0x6aea4b53a2fb30a4, 0x904ff28b278e2e63}, -2873},
+  {{0x518d988936cd2bbd, 0x4124cda483867f2b, 0xeb6ba05651c64333}, -2746},
+  {{0x15636a25d1cd2f83, 0xb591f53ea8e5ee85, 0xc006138fa1047d4f}, -2618},
+  {{0xed0d61d32cb6e3fb, 0xce02f2b46ca1d207, 0x9ca06d4ce9867e3b}, -2490},
+  {{0x0f94041309d6d906, 0x08b9313984be9e6c, 0xff825936a08b9a99}, -2363},
+  {{0x8cfd6d171ef63777, 0xb71f0cf586321e33, 0xd068ce0e5df81f31}, -2235},
+  {{0xb0e7f7b69da08d21, 0x1aaf7fbbdf2be047, 0xa9fde97ac852f028}, -2107},
+  {{0x6ebb9d3d1acd9120, 0xbf48c4102cd7f80a, 0x8aa7f40699d5b41b}, -1979},
+  {{0x30721ff7dca0a9d7, 0xee60362af21af3b6, 0xe23179bd4fcce3ba}, -1852},
+  {{0xd499c5b3cb590699, 0x033bad337812758f, 0xb87f5b7726b838e5}, -1724},
+  {{0x36b5419b6d05f56d, 0x3bc0ae0fc92ab518, 0x967cdf9352385b7d}, -1596},
+  {{0x5f5a1a6a7d4009c8, 0x9d378c0cb53dea26, 0xf57ea1cd234e48cd}, -1469},
+  {{0x3a0bf587d30b8834, 0xe345f63ac64c071e, 0xc83dad1519e2f69e}, -1341},
+  {{0x560b0b3bfd2b2cba, 0x6d25505da7a82e48, 0xa354416960ae4744}, -1213},
+  {{0xed11bb64265fd3a0, 0xd3e2e66644b8673e, 0x8538b653c0e26d12}, -1085},
+  {{0x48ebfa06a4bb4aa3, 0xd71d6dad34a2af0d, 0xd953e8624b85dd78}, -958},
+  {{0xc685c3b4b5e957db, 0x99cd11cfdf41779c, 0xb1442798f49ffb4a}, -830},
+  {{0x94bf6773709bddab, 0x3ff0d2c85def7621, 0x9096ea6f3848984f}, -702},
+  {{0x6c3edad2bb85a577, 0x111b495b3464ad21, 0xebdf661791d60f56}, -575},
+  {{0xecd74696edca212e, 0xe45ec2862f71e1d6, 0xc06481fb9bcf8d39}, -447},
+  {{0xab9cf16ddc1cc486, 0x55464dd69685606b, 0x9ced737bb6c4183d}, -319},
+  {{0x0000000000000000, 0x0000000000000000, 0x8000000000000000}, -191},
+  {{0x0000000000000000, 0xfff4b4e3f741cf6d, 0xd0cf4b50cfe20765}, -64},
+  {{0x10331d72aeaf7165, 0xbd4b46f0599fd415, 0xaa51823e34a7eede}, 64},
+  {{0xf8e6f9a397a582e4, 0x25de7bb9480d5854, 0x8aec23d680043bee}, 192},
+  {{0xe028965c3f580abc, 0x2e44ae64840fd61d, 0xe2a0b5dc971f303a}, 319},
+  {{0xfcc1493dcb1551df, 0x3d6a751f3b936243, 0xb8da1662e7b00a17}, 447},
+  {{0x6f43ed6c553161b0, 0x5eca783430dc19f5, 0x96c6e0eab509e64d}, 575},
+  {{0x195daeb90b965c60, 0xd431fff2c1663156, 0xf5f75bd4dab6d49c}, 702},
+  {{0x562241219a548a49, 0x336e11e175390249, 0xc8a025fd4fc1a3e9}, 830},
+  {{0x8522896dd0f0d4a8, 0x58d0c252c7e4fc32, 0xa3a49362c8b88a2d}, 958},
+  {{0xda5488506b5faf46, 0x0e10854981a8c313, 0x857a39f84f74cc5b}, 1086},
+  {{0xe7d1e2f9e9b010f1, 0x8249d68d6898b343, 0xd9bec86723d161fb}, 1213},
+  {{0xfefd84f906d2fde1, 0x67d6a2dc3e4d5b74, 0xb19b542779a67267}, 1341},
+  {{0x764c0175a73554b8, 0x86e3285506c97b6d, 0x90de0539b12de0d2}, 1469},
+  {{0x74511307c1aa41b9, 0x699cb3aba45c4bb8, 0xec5364c7c051043b}, 1596},
+  {{0xefc2a421ff68c123, 0x7532ed11a0e19790, 0xc0c31ed7d2446fa7}, 1724},
+  {{0x8f5b89eff5cf31d7, 0xfad4bef696066546, 0x9d3a9f8b4ee575dd}, 1852},
+  {{0xbf95e559d208addb, 0x49002ced7ba39f75, 0x803ef24a007c2042}, 1980},
+  {{0x28851d02cf180c9a, 0x051cbd27d450adff, 0xd135faf9ee0d8a12}, 2107},
+  {{0xbd327e30c016c268, 0x21de9e0a80013fa2, 0xaaa5441ddccb819d}, 2235},
+  {{0xd66c3b929a30580d, 0xe2b8b4ac1cf4337c, 0x8b30752ea0b737ca}, 2363},
+  {{0x3bd6c04d190f6ccc, 0x96f041c58bd75f4f, 0xe31028af8b925961}, 2490},
+  {{0xabf7c950deecdc0c, 0xd4cf535853ad38db, 0xb934fdecf0b3746e}, 2618},
+  {{0xc2be39f161cf7e03, 0xfd8b7748e6867a3a, 0x971106a6d38193b9}, 2746},
+  {{0x248b14b72fdfffd2, 0x18d00e452908c963, 0xf670513b335ecf5a}, 2873},
+  {{0xdfde76b808c31012, 0x8a1e6d7a057739e5, 0xc902cf527b9fb4a5}, 3001},
+  {{0xee2cf3012ddf45ef, 0xe1709ef4f3a0b67d, 0xa3f50cdbeefc6cd5}, 3129},
+  {{0x1dfbf57df1b27f51, 0xa23e757ad8d0bc2f, 0x85bbddd4a47fb2c0}, 3257},
+  {{0xbb4948d8533c86f9, 0x22fc05be6269f878, 0xda29dcfacbc8be72}, 3384},
+  {{0x664adb54459e49e2, 0x2b1c83458d0a2155, 0xb1f2ab949658e314}, 3512},
+  {{0x8de18836cbe8b9b7, 0x2ebc1368a3384582, 0x912542fbbbe846f8}, 3640},
+  {{0x6e2e86414d25a9dd, 0xadb6b9948f2d5711, 0xecc79c82dcb742e6}, 3767},
+  {{0x698cf65b7421d879, 0xf84df185fc7d1bfd, 0xc121ea3b1aa714b6}, 3895},
+  {{0x01c5b3ef55c8fb56, 0x24973c97dc9467f4, 0x9d87f18e527fc321}, 4023},
+  {{0x35c9d37b5907c94e, 0xbbb77b1217fbaab2, 0x807e03888348b561}, 4151},
+  {{0xc31eb6aa3f998ff6, 0x16b8af39e0de77cc, 0xd19cdd22819d5835}, 4278},
+  {{0x3d7e36d3d5e18da6, 0xfd2e013c4050cb14, 0xaaf92f2df83bc5ff}, 4406},
+  {{0xd847909a33929f48, 0xef3bf57a1fc32f5a, 0x8b74e81f7963f15e}, 4534},
+  {{0xe13d1b4660510dc9, 0x4ddd2604fdf43f8e, 0xe37fd25113b98e83}, 4661},
+  {{0x3314aa0f18dead47, 0xd0571434707a754b, 0xb990122b32e2696c}, 4789},
+  {{0xc551d7e7d3a38033, 0xbc0d44f6c6443fdb, 0x975b50d9934dc561}, 4917},
+  {{0x4c651bd8c6d05c6f, 0xdf6922166f06ed0b, 0xf6e9821d5f7d8f89}, 5044},
+  {{0x403e698f0dcac682, 0x17fde5fe0c272759, 0xc965a92c6dee50cc}, 5172},
+  {{0x98abe718b86f986a, 0xa0e037f2d54a2669, 0xa445ade8401e6ccc}, 5300},
+  {{0xe2928915f8698fa4, 0xddeccfc584c791d6, 0x85fda1f89803563e}, 5428},
+  {{0x743946b1a80d5d61, 0x3e991747d14e7e25, 0xda9526371c14ed7d}, 5555},
+  {{0x9da543a8e07668b4, 0x2b0ab6e00177d9cb, 0xb24a2df55fae6438}, 5683},
+  {{0x35098802e5fe6c53, 0xb603eb4a04a6ab81, 0x916ca3c68a92b4f3}, 5811},
+  {{0x2f6205c7a99e02cc, 0x4dbf126f544f14e3, 0xed3c0d64f44dada9}, 5938},
+  {{0xf7ea80d7043511b1, 0xb42318e128ba189e, 0xc180e43c56766fbb}, 6066},
+  {{0x8faa9190f23ad517, 0x79a03b05fadaca0f, 0x9dd569976b5136aa}, 6194},
+  {{0xad2725b4b448b060, 0x6b67381c468ababe, 0x80bd33cac16d0a30}, 6322},
+  {{0xd36ff645afaec033, 0x374f04a52e6c9c43, 0xd203f1e35fe47a36}, 6449},
+  {{0x02d658a03170f7dd, 0xf465bac4090f2f85, 0xab4d4382c867ff54}, 6577},
+  {{0xec5eb9cebc2b6c8d, 0x4bace26ef9b78ab7, 0x8bb97cb98f9bade1}, 6705},
+  {{0x83f49dac41d7ef0d, 0x10f4888d6a932ac1, 0xe3efb2dc236299b8}, 6832},
+  {{0xbeff12280d5a1676, 0x11c48d02b8326bd3, 0xb9eb5333aa272e9b}, 6960},
+  {{0x5d43ca3abddcb6e3, 0x11ec5104e30f2b49, 0x97a5bf94e2e9fdf1}, 7088},
+  {{0x9d89a505a4b3cf8d, 0x485d72a1ad5a5f21, 0xf762ee989fa60250}, 7215},
+  {{0x8c77d20c0a0e54bc, 0xf1ff2ec1d33bcc69, 0xc9c8b3a302d4aafe}, 7343},
+  {{0x189a3eb39c2a9e62, 0xe15dbb1c1b7a2785, 0xa496769b32506bee}, 7471},
+  {{0x6fc7606b9dcd1a63, 0x89e0c93881c6e052, 0x863f867409ca8a74}, 7599},
+  {{0xa6c9ea56009328c7, 0x94df8c6abe8de609, 0xdb00a435fa14c827}, 7726},
+  {{0x31a2e8733a4e3cc4, 0x21abfa15f93b4d56, 0xb2a1db5ef4fc1c3d}, 7854},
+  {{0xead238211605495c, 0xf739f1ca6f8ae61e, 0x91b427ab57bce6ad}, 7982},
+  {{0xc5691e81904c7590, 0x5c669b24714f039d, 0xedb0b78a2224ad80}, 8109},
+  {{0xa0cdc956664b5439, 0x431a2083df49096e, 0xc1e00cf27271fd15}, 8237},
+  {{0x29d522204d7b9315, 0xeba53e56f7c51196, 0x9e2307b94c4592f5}, 8365},
+  {{0x381b93e6f29b1164, 0x7981886b16765c45, 0x80fc831ffb6cd9a7}, 8493},
+  {{0x1926a2af9da5522d, 0xe343f70c6fc8d13a, 0xd26b39556a6c4e60}, 8620},
+  {{0xd2a7f07d20f10ada, 0x89844a21c7b6521e, 0xaba1813098b57a3a}, 8748},
+  {{0x142ef064e3cead4c, 0x6dd1d01180b2deb4, 0x8bfe330d710faafa}, 8876},
+  {{0x5caed4f196d340c9, 0xa14e2b5a55d995d5, 0xe45fca6bbb9c614c}, 9003},
+  {{0x988935a78beb5937, 0xcdde654ce0c444d8, 0xba46c11c5d3babf9}, 9131},
+  {{0x9520470206be942a, 0x36282568078a470b, 0x97f052eab9a33527}, 9259},
+  {{0xe9b0fa07a71c7b12, 0x8b343975cf91de5f, 0xf7dc96ca42cdbafb}, 9386},
+  {{0xaf27022643831353, 0x2d1e1f557250abdb, 0xca2beece2235c2e2}, 9514},
+  {{0x7e79fe958f3081f2, 0x0b13a89e71f04607, 0xa4e76708455662fa}, 9642},
+  {{0xb02f6c7afc11a9f0, 0xd8882e719293ff85, 0x86818b56e16e9587}, 9770},
+  {{0x31ca54b7799102e8, 0x0d0d4e0cd7df8870, 0xdb6c571157e3460d}, 9897},
+  {{0x9a3b4ea28babfc3f, 0x9296eca3a3c11819, 0xb2f9b3e67ffa5a3e}, 10025},
+  {{0x42328f67f2d45c18, 0x7cb930e3f1d0d4fb, 0x91fbcebb666f925c}, 10153},
+  {{0xab980105d039e8ec, 0x8e2fb5245f9771d5, 0xee259b0e8f1efac6}, 10280},
+  {{0x55e6c62f920d3682, 0x79fd57cf7c37941c, 0xc23f6474669f4abe}, 10408},
+  {{0xfc14f07179f71bc0, 0xde85adfe03e691b5, 0x9e70cc06b17aa9c6}, 10536},
+  {{0x5be47c8c10d98f75, 0x0096368e5e83c438, 0x813bf197794bfd59}, 10664},
+  {{0xa01e1cc23209d47b, 0x755dfdc7d5a966da, 0xd2d2b3918efa8a54}, 10791},
+  {{0xc9cd0acd93ee3155, 0x8a6947017bdea810, 0xabf5e84bbe8472a7}, 10919},
+  {{0x32823be1b15d54b1, 0xbc21b2bb15330d0d, 0x8c430b2bb3951da1}, 11047},
+  {{0xdb0b540307b27e63, 0x2f656e088c7d9bc8, 0xe4d0191aeabd6c62}, 11174},
+  {{0xdda442091174ebb1, 0x0cfb69eb20590f66, 0xbaa25bfb5daebd09}, 11302},
+  {{0x9c8e01197a973ee2, 0xeeafc813bf665ccd, 0x983b0aed179c2dfb}, 11430},
+};
+static_assert(std::size(PowersOfFive) ==
+              MaxPowerOfFiveIndex - MinPowerOfFiveIndex + 1);
+
+/// 5^I for I < PowerOfFiveStep, each of which fits in two words.
+static constexpr auto SmallPowersOfFive = [] {
+  std::array<std::array<APFloatBase::integerPart, 2>, PowerOfFiveStep>
+      Powers{};
+  unsigned __int128 Power = 1;
+  for (auto &Words : Powers) {
+    Words = {uint64_t(Power), uint64_t(Power >> 64)};
+    Power *= 5;
+  }
+  return Powers;
+}();
+
+/// Sets Significand * 2^Exponent to a lower bound of 5^J, with the top bit
+/// of the 192-bit Significand set, from the small power of five and as few
+/// entries of PowersOfFive as possible.
+///
+/// @returns the most the result can be below 5^J, in units of its last
+/// place, or -1 if J needs more than four entries.
+static int approximatePowerOfFive(int J,
+                                  APFloatBase::integerPart Significand[3],
+                                  int &Exponent) {
+  using integerPart = APFloatBase::integerPart;
+
+  int I = J >= 0 ? J / PowerOfFiveStep
+                 : -((-J + PowerOfFiveStep - 1) / PowerOfFiveStep);
+  if (I < 4 * MinPowerOfFiveIndex || I > 4 * MaxPowerOfFiveIndex)
+    return -1;
+
+  // Start from the small factor, which is exact.
+  const auto &Small = SmallPowersOfFive[J - I * PowerOfFiveStep];
+  integerPart Product[6] = {0, Small[0], Small[1]};
+  unsigned Shift = 191 - APInt::tcMSB(Product, 3);
+  APInt::tcShiftLeft(Product, 3, Shift);
+  APInt::tcAssign(Significand, Product, 3);
+  Exponent = -(int)(Shift + 64);
+  int Error = 0;
+
+  // Multiply in the entries, rounding down to 192 bits each time.  With
+  // errors E1 and E2 of the factors, the product is below the exact one by
+  // less than 2 * (E1 + E2) + 1 units after the rounding.
+  while (I) {
+    int Index = std::clamp(I, MinPowerOfFiveIndex, MaxPowerOfFiveIndex);
+    I -= Index;
+    const PowerOfFive &Entry = PowersOfFive[Index - MinPowerOfFiveIndex];
+    int EntryError = Index == 0 || Index == 1 ? 0 : 1;
+    multiplyWithoutScratch(Product, Significand, 3, Entry.Significand, 3);
+    Shift = APInt::tcMSB(Product, 6) + 1 - 192;
+    bool Lost = APInt::tcLSB(Product, 6) < Shift;
+    APInt::tcShiftRight(Product, 6, Shift);
+    APInt::tcAssign(Significand, Product, 3);
+    Exponent += Entry.Exponent + Shift;
+    if (Error || EntryError)
+      Error = 2 * (Error + EntryError) + 2;
+    else if (Lost)
+      Error = 1;
+  }
+  return Error;
+}
+
+/// Converts the decimal significand and exponent of D to the top 64 bits of
+/// their binary value, as Significand * 2^Exponent, and the fraction of a
+/// unit of Significand lost below those bits.  As in the Eisel-Lemire
+/// algorithm, the value is computed from a lower bound on the power of five
+/// and its error bound, which usually decide the lost fraction without the
+/// exact computation.
+///
+/// @returns false if the significand has more than nineteen digits, or if
+/// the bounds do not decide the lost fraction.
+static bool decimalToBinary64(const decimalInfo &D,
+                              APFloatBase::integerPart &Significand,
+                              int &Exponent, lostFraction &Lost) {
+  using integerPart = APFloatBase::integerPart;
+  const unsigned integerPartWidth = APFloatBase::integerPartWidth;
+
+  integerPart Digits = 0;
+  unsigned NumDigits = 0;
+  for (const char *P = D.firstSigDigit; P <= D.lastSigDigit; ++P) {
+    if (*P == '.')
+      continue;
+    unsigned Digit = decDigitValue(*P);
+    if (Digit >= 10 || ++NumDigits > 19)
+      return false;
+    Digits = Digits * 10 + Digit;
+  }
+
+  // The bounds cannot decide values that are exactly representable, which
+  // with a negative exponent are the multiples of a power of five in a word.
+  if (D.exponent < 0 && D.exponent >= -27 &&
+      Digits % SmallPowersOfFive[-D.exponent][0] == 0) {
+    integerPart Quotient = Digits / SmallPowersOfFive[-D.exponent][0];
+    unsigned Shift = integerPartWidth - 1 - APInt::tcMSB(&Quotient, 1);
+    Significand = Quotient << Shift;
+    Exponent = D.exponent - Shift;
+    Lost = lfExactlyZero;
+    return true;
+  }
+
+  // 10^exponent = 5^exponent * 2^exponent, with the power of five in
+  // [Power, Power + MaxError) * 2^PowerExponent.
+  integerPart Power[3];
+  int PowerExponent;
+  int MaxError = approximatePowerOfFive(D.exponent, Power, PowerExponent);
+  if (MaxError < 0)
+    return false;
+
+  integerPart Product[4];
+  multiplyWithoutScratch(Product, Power, 3, &Digits, 1);
+  unsigned LostBits = APInt::tcMSB(Product, 4) + 1 - integerPartWidth;
+  APInt::tcExtract(&Significand, 1, Product, integerPartWidth, LostBits);
+  Exponent = LostBits + PowerExponent + D.exponent;
+
+  if (!MaxError) {
+    Lost = lostFractionThroughTruncation(Product, 4, LostBits);
+    return true;
+  }
+
+  // The exact lost bits are above Remainder, and below Remainder plus the
+  // error of the product.  Decide whether that range is within a half unit
+  // or past it, without a carry into Significand.
+  integerPart Remainder[4], Bound[4], Half[4] = {}, Unit[4] = {};
+  APInt::tcExtract(Remainder, 4, Product, LostBits, 0);
+  unsigned __int128 Error = static_cast<unsigned __int128>(Digits) * MaxError;
+  integerPart ErrorParts[4] = {uint64_t(Error), uint64_t(Error >> 64)};
+  APInt::tcAssign(Bound, Remainder, 4);
+  APInt::tcAdd(Bound, ErrorParts, 0, 4);
+  APInt::tcSetBit(Half, LostBits - 1);
+  APInt::tcSetBit(Unit, LostBits);
+
+  if (APInt::tcIsZero(Remainder, 4))
+    return false;
+  if (APInt::tcCompare(Bound, Half, 4) <= 0) {
+    Lost = lfLessThanHalf;
+    return true;
+  }
+  if (APInt::tcCompare(Remainder, Half, 4) >= 0 &&
+      APInt::tcCompare(Bound, Unit, 4) <= 0) {
+    Lost = lfMoreThanHalf;
+    return true;
+  }
+  return false;
+}
+
 /* Zero at the end to avoid modular arithmetic when adding one; used
    when rounding up during hexadecimal output.  */
 static const char hexDigitsLower[] = "0123456789abcdef0";
@@ -866,13 +1310,13 @@ void IEEEFloat::initialize(const fltSemantics *ourSemantics) {
 
   semantics = ourSemantics;
   count = partCount();
-  if (count > 1)
-    significand.parts = new integerPart[count];
+  if (count > InlineParts)
+    significand.parts = allocateWords(count);
 }
 
 void IEEEFloat::freeSignificand() {
   if (needsCleanup())
-    delete [] significand.parts;
+    deallocateWords(significand.parts, partCount());
 }
 
 void IEEEFloat::assign(const IEEEFloat &rhs) {
@@ -1099,10 +1543,10 @@ const IEEEFloat::integerPart *IEEEFloat::significandParts() const {
 }
 
 IEEEFloat::integerPart *IEEEFloat::significandParts() {
-  if (partCount() > 1)
+  if (partCount() > InlineParts)
     return significand.parts;
   else
-    return &significand.part;
+    return significand.part;
 }
 
 void IEEEFloat::zeroSignificand() {
@@ -1155,10 +1599,8 @@ lostFraction IEEEFloat::multiplySignificand(const IEEEFloat &rhs,
   unsigned int omsb;        // One, not zero, based MSB.
   unsigned int partsCount, newPartsCount, precision;
   integerPart *lhsSignificand;
-  integerPart scratch[4];
   integerPart *fullSignificand;
   lostFraction lost_fraction;
-  bool ignored;
 
   assert(semantics == rhs.semantics);
 
@@ -1168,16 +1610,14 @@ lostFraction IEEEFloat::multiplySignificand(const IEEEFloat &rhs,
   // extra bit for the addition to overflow into.
   newPartsCount = partCountForBits(precision * 2 + 1);
 
-  if (newPartsCount > 4)
-    fullSignificand = new integerPart[newPartsCount];
-  else
-    fullSignificand = scratch;
+  ScratchWords<16> fullScratch(newPartsCount);
+  fullSignificand = fullScratch.data();
 
   lhsSignificand = significandParts();
   partsCount = partCount();
 
-  APInt::tcFullMultiply(fullSignificand, lhsSignificand,
-                        rhs.significandParts(), partsCount, partsCount);
+  multiplyWithoutScratch(fullSignificand, lhsSignificand, partsCount,
+                         rhs.significandParts(), partsCount);
 
   lost_fraction = lfExactlyZero;
   omsb = APInt::tcMSB(fullSignificand, newPartsCount) + 1;
@@ -1202,7 +1642,6 @@ lostFraction IEEEFloat::multiplySignificand(const IEEEFloat &rhs,
     Significand savedSignificand = significand;
     const fltSemantics *savedSemantics = semantics;
     fltSemantics extendedSemantics;
-    opStatus status;
     unsigned int extendedPrecision;
 
     // Normalize our MSB to one below the top bit to allow for overflow.
@@ -1218,32 +1657,41 @@ lostFraction IEEEFloat::multiplySignificand(const IEEEFloat &rhs,
     extendedSemantics = *semantics;
     extendedSemantics.precision = extendedPrecision;
 
-    if (newPartsCount == 1)
-      significand.part = fullSignificand[0];
+    if (newPartsCount <= InlineParts)
+      APInt::tcAssign(significand.part, fullSignificand, newPartsCount);
     else
       significand.parts = fullSignificand;
     semantics = &extendedSemantics;
 
-    // Make a copy so we can convert it to the extended semantics.
-    // Note that we cannot convert the addend directly, as the extendedSemantics
-    // is a local variable (which we take a reference to).
-    IEEEFloat extendedAddend(addend);
-    status = extendedAddend.convert(extendedSemantics, rmTowardZero, &ignored);
-    assert(status == opOK);
-    (void)status;
-
-    // Shift the significand of the addend right by one bit. This guarantees
-    // that the high bit of the significand is zero (same as fullSignificand),
-    // so the addition will overflow (if it does overflow at all) into the top bit.
-    lost_fraction = extendedAddend.shiftSignificandRight(1);
-    assert(lost_fraction == lfExactlyZero &&
-           "Lost precision while shifting addend for fused-multiply-add.");
-
-    lost_fraction = addOrSubtractSignificand(extendedAddend, false);
+    // Widen the addend to the extended semantics in scratch space, as
+    // converting a copy would allocate.  Its significand is shifted one bit
+    // less than the extension. This guarantees that the high bit of the
+    // significand is zero (same as fullSignificand), so the addition will
+    // overflow (if it does overflow at all) into the top bit.
+    ScratchWords<4> addendScratch(newPartsCount);
+    IEEEFloat extendedAddend(semBogus, uninitialized);
+    integerPart *addendParts = newPartsCount <= InlineParts
+                                   ? extendedAddend.significand.part
+                                   : addendScratch.data();
+    APInt::tcSet(addendParts, 0, newPartsCount);
+    APInt::tcAssign(addendParts, addend.significandParts(), partsCount);
+    APInt::tcShiftLeft(addendParts, newPartsCount,
+                       extendedPrecision - precision - 1);
+    if (newPartsCount > InlineParts)
+      extendedAddend.significand.parts = addendParts;
+    extendedAddend.semantics = &extendedSemantics;
+    extendedAddend.category = fcNormal;
+    extendedAddend.sign = addend.sign;
+    extendedAddend.exponent = addend.exponent + 1;
+
+    lost_fraction = addOrSubtractSignificand(std::move(extendedAddend), false);
+
+    // The scratch space is not the addend's to free.
+    extendedAddend.semantics = &semBogus;
 
     /* Restore our state.  */
-    if (newPartsCount == 1)
-      fullSignificand[0] = significand.part;
+    if (newPartsCount <= InlineParts)
+      APInt::tcAssign(fullSignificand, significand.part, newPartsCount);
     significand = savedSignificand;
     semantics = savedSemantics;
 
@@ -1276,14 +1724,12 @@ lostFraction IEEEFloat::multiplySignificand(const IEEEFloat &rhs,
 
   APInt::tcAssign(lhsSignificand, fullSignificand, partsCount);
 
-  if (newPartsCount > 4)
-    delete [] fullSignificand;
-
   return lost_fraction;
 }
 
 lostFraction IEEEFloat::multiplySignificand(const IEEEFloat &rhs) {
-  return multiplySignificand(rhs, IEEEFloat(*semantics));
+  // Any zero addend will do, and one of semBogus is not allocated.
+  return multiplySignificand(rhs, IEEEFloat(semBogus));
 }
 
 /* Multiply the significands of LHS and RHS to DST.  */
@@ -1291,7 +1737,6 @@ lostFraction IEEEFloat::divideSignificand(const IEEEFloat &rhs) {
   unsigned int bit, i, partsCount;
   const integerPart *rhsSignificand;
   integerPart *lhsSignificand, *dividend, *divisor;
-  integerPart scratch[4];
   lostFraction lost_fraction;
 
   assert(semantics == rhs.semantics);
@@ -1300,11 +1745,8 @@ lostFraction IEEEFloat::divideSignificand(const IEEEFloat &rhs) {
   rhsSignificand = rhs.significandParts();
   partsCount = partCount();
 
-  if (partsCount > 2)
-    dividend = new integerPart[partsCount * 2];
-  else
-    dividend = scratch;
-
+  ScratchWords<16> dividendScratch(partsCount * 2);
+  dividend = dividendScratch.data();
   divisor = dividend + partsCount;
 
   /* Copy the dividend and divisor as they will be modified in-place.  */
@@ -1363,9 +1805,6 @@ lostFraction IEEEFloat::divideSignificand(const IEEEFloat &rhs) {
   else
     lost_fraction = lfLessThanHalf;
 
-  if (partsCount > 2)
-    delete [] dividend;
-
   return lost_fraction;
 }
 
@@ -1671,21 +2110,26 @@ IEEEFloat::opStatus IEEEFloat::addOrSubtractSpecials(const IEEEFloat &rhs,
 /* Add or subtract two normal numbers.  */
 lostFraction IEEEFloat::addOrSubtractSignificand(const IEEEFloat &rhs,
                                                  bool subtract) {
+  return addOrSubtractSignificand(IEEEFloat(rhs), subtract);
+}
+
+/* Add or subtract two normal numbers, shifting the significand of RHS in
+   place.  */
+lostFraction IEEEFloat::addOrSubtractSignificand(IEEEFloat &&temp_rhs,
+                                                 bool subtract) {
   integerPart carry;
   lostFraction lost_fraction;
   int bits;
 
   /* Determine if the operation on the absolute values is effectively
      an addition or subtraction.  */
-  subtract ^= static_cast<bool>(sign ^ rhs.sign);
+  subtract ^= static_cast<bool>(sign ^ temp_rhs.sign);
 
   /* Are we bigger exponent-wise than the RHS?  */
-  bits = exponent - rhs.exponent;
+  bits = exponent - temp_rhs.exponent;
 
   /* Subtraction is more subtle than one might naively expect.  */
   if (subtract) {
-    IEEEFloat temp_rhs(rhs);
-
     if (bits == 0)
       lost_fraction = lfExactlyZero;
     else if (bits > 0) {
@@ -1720,13 +2164,11 @@ lostFraction IEEEFloat::addOrSubtractSignificand(const IEEEFloat &rhs,
     (void)carry;
   } else {
     if (bits > 0) {
-      IEEEFloat temp_rhs(rhs);
-
       lost_fraction = temp_rhs.shiftSignificandRight(bits);
       carry = addSignificand(temp_rhs);
     } else {
       lost_fraction = shiftSignificandRight(-bits);
-      carry = addSignificand(rhs);
+      carry = addSignificand(temp_rhs);
     }
 
     /* We have a guard bit; generating a carry cannot happen.  */
@@ -1909,6 +2351,941 @@ void IEEEFloat::changeSign() {
   sign = !sign;
 }
 
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+namespace {
+/// Runs host floating point operations in a rounding mode and collects the
+/// exceptions they raise, restoring the caller's environment afterwards.
+class HostFloatScope {
+#if BIJOU_HAS_SSE_FLOAT_ENV
+  // Float and double arithmetic runs on SSE, whose control and status
+  // register is much cheaper to switch than the whole environment.  The
+  // scope masks all exceptions and keeps denormals.
+  static_assert(FE_INVALID == 0x01 && FE_DIVBYZERO == 0x04 &&
+                    FE_OVERFLOW == 0x08 && FE_UNDERFLOW == 0x10 &&
+                    FE_INEXACT == 0x20,
+                "exception flags differ from the SSE status bits");
+  unsigned Saved;
+
+public:
+  explicit HostFloatScope(int Round) : Saved(_mm_getcsr()) {
+    _mm_setcsr(_MM_MASK_MASK | Round);
+  }
+  ~HostFloatScope() { _mm_setcsr(Saved); }
+
+  int exceptions() const { return _mm_getcsr() & FE_ALL_EXCEPT; }
+
+  static int roundingMode(IEEEFloat::roundingMode rounding_mode) {
+    switch (rounding_mode) {
+    case IEEEFloat::rmNearestTiesToEven:
+      return _MM_ROUND_NEAREST;
+    case IEEEFloat::rmTowardPositive:
+      return _MM_ROUND_UP;
+    case IEEEFloat::rmTowardNegative:
+      return _MM_ROUND_DOWN;
+    case IEEEFloat::rmTowardZero:
+      return _MM_ROUND_TOWARD_ZERO;
+    default:
+      return -1;
+    }
+  }
+
+  /// Whether the caller's environment rounds T to nearest, keeps denormals
+  /// and masks all exceptions, as the error-free transformations below
+  /// assume.  They run in that environment, in a HostStatusScope.
+  template <typename T> static bool isDefault() {
+    if constexpr (std::is_same_v<T, long double>) {
+      // x87 instructions must round to nearest with a 64 bit significand.
+      unsigned short ControlWord;
+      __asm__("fnstcw %0" : "=m"(ControlWord));
+      return (ControlWord & 0xf3f) == 0x33f;
+    }
+#if BIJOU_HAS_HOST_QUAD
+    // Depending on the runtime, the quad routines read the rounding mode
+    // from the SSE or the x87 control register.
+    if constexpr (std::is_same_v<T, BIJOU_HOST_QUAD>)
+      if (!isDefault<long double>())
+        return false;
+#endif
+    unsigned ControlStatus = _mm_getcsr();
+    return !(ControlStatus & (_MM_ROUND_MASK | _MM_FLUSH_ZERO_MASK | 0x40)) &&
+           (ControlStatus & _MM_MASK_MASK) == _MM_MASK_MASK;
+  }
+#else
+  std::fenv_t Saved;
+
+public:
+  explicit HostFloatScope(int Round) {
+    std::feholdexcept(&Saved);
+    std::fesetround(Round);
+  }
+  ~HostFloatScope() { std::fesetenv(&Saved); }
+
+  int exceptions() const { return std::fetestexcept(FE_ALL_EXCEPT); }
+
+  static int roundingMode(IEEEFloat::roundingMode rounding_mode) {
+    switch (rounding_mode) {
+    case IEEEFloat::rmNearestTiesToEven:
+      return FE_TONEAREST;
+    case IEEEFloat::rmTowardPositive:
+      return FE_UPWARD;
+    case IEEEFloat::rmTowardNegative:
+      return FE_DOWNWARD;
+    case IEEEFloat::rmTowardZero:
+      return FE_TOWARDZERO;
+    default:
+      return -1;
+    }
+  }
+#endif
+};
+
+#if BIJOU_HAS_SSE_FLOAT_ENV
+/// Keeps the exception flags of the caller's environment across host
+/// operations on T that run in it, by clearing the flags they raise.  The
+/// flags are sticky, so that is rarely needed.  Long double arithmetic uses
+/// the x87 instructions and their flags.  The quad routines raise overflow,
+/// underflow and denormal in the x87 flags too, and the rest in the SSE ones.
+template <typename T> class HostStatusScope {
+  static constexpr bool UsesX87 = std::is_same_v<T, long double>
+#if BIJOU_HAS_HOST_QUAD
+                                  || std::is_same_v<T, BIJOU_HOST_QUAD>
+#endif
+      ;
+  static constexpr bool UsesSSE = !std::is_same_v<T, long double>;
+
+  int SavedX87 = 0;
+  int SavedSSE = 0;
+
+  static int x87Flags() {
+    unsigned short StatusWord;
+    __asm__ volatile("fnstsw %0" : "=m"(StatusWord));
+    return StatusWord & FE_ALL_EXCEPT;
+  }
+
+  static int sseFlags() { return _mm_getcsr() & FE_ALL_EXCEPT; }
+
+public:
+  HostStatusScope() {
+    if constexpr (UsesX87)
+      SavedX87 = x87Flags();
+    if constexpr (UsesSSE)
+      SavedSSE = sseFlags();
+  }
+  ~HostStatusScope() {
+    if constexpr (UsesX87) {
+      if (int Raised = x87Flags() & ~SavedX87) {
+        if (!SavedX87) {
+          __asm__ volatile("fnclex");
+        } else {
+          // Otherwise the x87 flags can only be written with the whole
+          // environment, whose third 16 bit field is the status word.
+          unsigned short Environment[14];
+          __asm__ volatile("fnstenv %0" : "=m"(Environment));
+          Environment[2] &= ~Raised;
+          __asm__ volatile("fldenv %0" : : "m"(Environment));
+        }
+      }
+    }
+    if constexpr (UsesSSE) {
+      if (int Raised = sseFlags() & ~SavedSSE)
+        _mm_setcsr(_mm_getcsr() & ~Raised);
+    }
+  }
+};
+#endif
+
+/// The encoding of a host floating point type, which zeros and normal values
+/// with exponents in [MinExponent, MaxExponent] convert to and from directly.
+/// Significands include the integer bit.
+template <typename T> struct HostFormat {
+  using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+  using Significand = uint64_t;
+  static_assert(sizeof(T) == sizeof(Bits) &&
+                std::numeric_limits<T>::is_iec559);
+  static constexpr int Precision = std::numeric_limits<T>::digits;
+  static constexpr int MinExponent = std::numeric_limits<T>::min_exponent - 1;
+  static constexpr int MaxExponent = std::numeric_limits<T>::max_exponent - 1;
+  static constexpr int Bias = MaxExponent;
+  static constexpr Bits SignBit = Bits(1) << (sizeof(T) * CHAR_BIT - 1);
+  static constexpr Bits IntegerBit = Bits(1) << (Precision - 1);
+  /// Whether std::fma computes T in a HostFloatScope.
+  static constexpr bool HasFma = BIJOU_HAS_HOST_FMA;
+
+  /// The normal value with this sign, exponent and significand, or zero if
+  /// the significand is zero.
+  static T pack(bool Negative, int Exponent, uint64_t Significand) {
+    Bits B = Negative ? SignBit : 0;
+    if (Significand)
+      B |= Bits(Exponent + Bias) << (Precision - 1) |
+           (Bits(Significand) & (IntegerBit - 1));
+    return std::bit_cast<T>(B);
+  }
+  static int exponent(T X) {
+    return int(std::bit_cast<Bits>(X) << 1 >> Precision) - Bias;
+  }
+  static uint64_t significand(T X) {
+    return (std::bit_cast<Bits>(X) & (IntegerBit - 1)) | IntegerBit;
+  }
+  static bool isNegative(T X) { return std::signbit(X); }
+};
+
+#if BIJOU_HAS_X87_LONG_DOUBLE
+/// The x87 extended format holds the significand, with an explicit integer
+/// bit, in its first eight bytes and the sign and biased exponent in the
+/// next two.  Storing those bytes separately and loading the value stalls,
+/// so pack converts the significand as an integer and scales it by a power
+/// of two in double, which limits the exponents it takes to the range of
+/// double.  Fused multiply-add is a library routine slower than the software
+/// arithmetic.
+template <> struct HostFormat<long double> {
+  using Significand = uint64_t;
+  static constexpr int Precision = 64;
+  static constexpr int MinExponent =
+      std::numeric_limits<double>::min_exponent - 2 + Precision;
+  static constexpr int MaxExponent =
+      std::numeric_limits<double>::max_exponent - 1 + Precision - 1;
+  static constexpr int Bias = 16383;
+  static constexpr bool HasFma = false;
+
+  static long double pack(bool Negative, int Exponent, uint64_t Significand) {
+    if (!Significand)
+      return Negative ? -0.0L : 0.0L;
+    long double X =
+        (long double)int64_t(Significand ^ 1ULL << 63) + 0x1p63L;
+    X *= std::bit_cast<double>(uint64_t(Exponent - (Precision - 1) + 1023)
+                               << 52);
+    return Negative ? -X : X;
+  }
+  static int exponent(long double X) {
+    uint16_t SignExponent;
+    std::memcpy(&SignExponent, reinterpret_cast<const char *>(&X) + 8,
+                sizeof(SignExponent));
+    return (SignExponent & 0x7fff) - Bias;
+  }
+  static uint64_t significand(long double X) {
+    uint64_t Significand;
+    std::memcpy(&Significand, &X, sizeof(Significand));
+    return Significand;
+  }
+  static bool isNegative(long double X) { return std::signbit(X); }
+};
+#endif
+
+#if BIJOU_HAS_HOST_QUAD
+/// std::numeric_limits need not describe the quad type, and its significand
+/// takes two words.  The library has no fused multiply-add for it.
+template <> struct HostFormat<BIJOU_HOST_QUAD> {
+  using T = BIJOU_HOST_QUAD;
+  using Bits = unsigned __int128;
+  using Significand = unsigned __int128;
+  static_assert(sizeof(T) == sizeof(Bits));
+  static constexpr int Precision = 113;
+  static constexpr int MinExponent = -16382;
+  static constexpr int MaxExponent = 16383;
+  static constexpr int Bias = MaxExponent;
+  static constexpr Bits SignBit = Bits(1) << 127;
+  static constexpr Bits IntegerBit = Bits(1) << (Precision - 1);
+  static constexpr bool HasFma = false;
+
+  static T pack(bool Negative, int Exponent, Significand S) {
+    Bits B = Negative ? SignBit : 0;
+    if (S)
+      B |= Bits(Exponent + Bias) << (Precision - 1) | (S & (IntegerBit - 1));
+#if BIJOU_HAS_SSE_FLOAT_ENV
+    // Assemble the value in a vector register: loading it from the two
+    // words just stored would stall.
+    return std::bit_cast<T>(_mm_set_epi64x(int64_t(B >> 64), int64_t(B)));
+#else
+    return std::bit_cast<T>(B);
+#endif
+  }
+  static int exponent(T X) {
+    return int(std::bit_cast<Bits>(X) << 1 >> Precision) - Bias;
+  }
+  static Significand significand(T X) {
+    return (std::bit_cast<Bits>(X) & (IntegerBit - 1)) | IntegerBit;
+  }
+  static bool isNegative(T X) { return std::bit_cast<Bits>(X) & SignBit; }
+};
+#endif
+
+/// Calls F with a value of the host type of SEMANTICS and returns its
+/// result, or returns false if there is no such type.
+template <typename Function>
+bool withHostType(const fltSemantics *Semantics, const Function &F) {
+  if (Semantics == &semIEEEdouble)
+    return F(double());
+  if (Semantics == &semIEEEsingle)
+    return F(float());
+#if BIJOU_HAS_X87_LONG_DOUBLE
+  if (Semantics == &semX87DoubleExtended)
+    return F((long double)0);
+#endif
+#if BIJOU_HAS_HOST_QUAD
+  if (Semantics == &semIEEEquad)
+    return F(BIJOU_HOST_QUAD(0));
+#endif
+  return false;
+}
+
+/// Whether SEMANTICS is so much narrower than float that float arithmetic,
+/// rounded once more, computes it.
+bool isPromotedToFloat(const fltSemantics *Semantics) {
+  return Semantics == &semIEEEhalf || Semantics == &semBFloat;
+}
+
+/// The sign of X, as -1, 0 or 1.
+template <typename T> int signOf(T X) { return (X > 0) - (X < 0); }
+
+/// Whether X is a zero.
+template <typename T> bool isHostZero(T X) { return X == 0; }
+
+#if BIJOU_HAS_HOST_QUAD
+// Quad comparisons are library calls, so these read the encoding instead.
+// NaNs are not zero, but have a sign.
+int signOf(BIJOU_HOST_QUAD X) {
+  using Format = HostFormat<BIJOU_HOST_QUAD>;
+  if (std::bit_cast<Format::Bits>(X) << 1 == 0)
+    return 0;
+  return Format::isNegative(X) ? -1 : 1;
+}
+bool isHostZero(BIJOU_HOST_QUAD X) { return !signOf(X); }
+#endif
+
+#if BIJOU_HAS_SSE_FLOAT_ENV
+/// The ulps by which to move a result rounded to nearest away from zero, as 1,
+/// or toward zero, as -1, to round it in ROUNDING_MODE, given the signs of
+/// the result and of the exact value minus it.
+int directedStep(int ResultSign, int ErrorSign,
+                 IEEEFloat::roundingMode rounding_mode) {
+  if ((ErrorSign > 0 && rounding_mode == IEEEFloat::rmTowardPositive) ||
+      (ErrorSign < 0 && rounding_mode == IEEEFloat::rmTowardNegative) ||
+      (ErrorSign && ErrorSign != ResultSign &&
+       rounding_mode == IEEEFloat::rmTowardZero))
+    return ErrorSign == ResultSign ? 1 : -1;
+  return 0;
+}
+#endif
+
+/// Splits X into two halves whose products with other halves are exact
+/// (Veltkamp).
+template <typename T> void split(T X, T &High, T &Low) {
+  const T Factor = T((1ull << (std::numeric_limits<T>::digits + 1) / 2) + 1);
+  T Scaled = Factor * X;
+  High = Scaled - (Scaled - X);
+  Low = X - High;
+}
+
+/// Sets Low to A * B - High exactly, where High = A * B rounded to nearest
+/// (Dekker).
+template <typename T> T productError(T A, T B, T High) {
+#ifdef __FMA__
+  if constexpr (HostFormat<T>::HasFma)
+    return std::fma(A, B, -High);
+#endif
+  T AHigh, ALow, BHigh, BLow;
+  split(A, AHigh, ALow);
+  split(B, BHigh, BLow);
+  return ((AHigh * BHigh - High) + AHigh * BLow + ALow * BHigh) + ALow * BLow;
+}
+
+/// Computes OPERATION of A and B rounded to nearest, and the sign of the
+/// exact result minus it, from an error-free transformation of the
+/// operation.  The operands and result must be far enough from underflow
+/// and overflow for the errors to be exact.
+template <typename T>
+T hostRoundToNearest(HostOperation Operation, T A, T B, int &ErrorSign) {
+  // A float product or remainder is exact in double.
+  using Wide = std::conditional_t<std::is_same_v<T, float>, double, T>;
+  switch (Operation) {
+  case HostOperation::Subtract:
+    B = -B;
+    [[fallthrough]];
+  case HostOperation::Add: {
+    T Sum = A + B;
+    T BVirtual = Sum - A;
+    ErrorSign = signOf((A - (Sum - BVirtual)) + (B - BVirtual));
+    return Sum;
+  }
+  case HostOperation::Multiply: {
+    T Product = A * B;
+    if constexpr (std::is_same_v<T, Wide>)
+      ErrorSign = signOf(productError(A, B, Product));
+    else
+      ErrorSign = signOf(Wide(A) * Wide(B) - Wide(Product));
+    return Product;
+  }
+  case HostOperation::Divide: {
+    // A = Quotient * B + Remainder, so the exact quotient is above Quotient
+    // when Remainder and B have the same sign.
+    T Quotient = A / B;
+    if constexpr (std::is_same_v<T, Wide>) {
+      T High = Quotient * B;
+      T Low = productError(Quotient, B, High);
+      ErrorSign = signOf((A - High) - Low) * signOf(B);
+    } else {
+      ErrorSign = signOf(Wide(A) - Wide(Quotient) * Wide(B)) * signOf(B);
+    }
+    return Quotient;
+  }
+  case HostOperation::FusedMultiplyAdd:
+    break;
+  }
+  bijou_unreachable("Operation without an error-free transformation");
+}
+
+#if BIJOU_HAS_HOST_QUAD && BIJOU_HAS_SSE_FLOAT_ENV
+/// Each quad operation is a library call, and an error-free transformation
+/// would take several, so the error comes from the significands instead.
+/// In units of the last place of the operands it is an integer below 2^127
+/// in magnitude, so the low 128 bits of the exact computation give it.
+template <>
+BIJOU_HOST_QUAD hostRoundToNearest(HostOperation Operation, BIJOU_HOST_QUAD A,
+                                   BIJOU_HOST_QUAD B, int &ErrorSign) {
+  using Format = HostFormat<BIJOU_HOST_QUAD>;
+  // The sign of an error in magnitude, given modulo 2^128.
+  auto signOfError = [](Format::Significand Error) {
+    return Error >> 127 ? -1 : Error != 0;
+  };
+  const int Ulp = Format::Precision - 1;
+
+  ErrorSign = 0;
+  switch (Operation) {
+  case HostOperation::Subtract:
+    B = -B;
+    [[fallthrough]];
+  case HostOperation::Add: {
+    BIJOU_HOST_QUAD Sum = A + B;
+    if (isHostZero(A) || isHostZero(B) || isHostZero(Sum))
+      return Sum;
+    int ExponentA = Format::exponent(A), ExponentB = Format::exponent(B);
+    Format::Significand SignificandA = Format::significand(A);
+    Format::Significand SignificandB = Format::significand(B);
+    if (ExponentA < ExponentB ||
+        (ExponentA == ExponentB && SignificandA < SignificandB)) {
+      std::swap(A, B);
+      std::swap(ExponentA, ExponentB);
+      std::swap(SignificandA, SignificandB);
+    }
+    // B is below a quarter of an ulp of A, so Sum is A.
+    if (ExponentA - ExponentB > Format::Precision + 1) {
+      ErrorSign = signOf(B);
+      return Sum;
+    }
+    // The exact sum is a multiple of the ulp of B, so it is exact if Sum is
+    // below twice B.
+    int ExponentSum = Format::exponent(Sum);
+    if (ExponentSum <= ExponentB)
+      return Sum;
+    // Count in ulps of B.
+    Format::Significand Exact = SignificandA << (ExponentA - ExponentB);
+    if (Format::isNegative(A) == Format::isNegative(B))
+      Exact += SignificandB;
+    else
+      Exact -= SignificandB;
+    ErrorSign = signOfError(Exact - (Format::significand(Sum)
+                                     << (ExponentSum - ExponentB))) *
+                signOf(Sum);
+    return Sum;
+  }
+  case HostOperation::Multiply: {
+    BIJOU_HOST_QUAD Product = A * B;
+    if (isHostZero(A) || isHostZero(B))
+      return Product;
+    // Count in ulps of A times ulps of B.
+    int Shift = Format::exponent(Product) - Format::exponent(A) -
+                Format::exponent(B) + Ulp;
+    ErrorSign = signOfError(Format::significand(A) * Format::significand(B) -
+                            (Format::significand(Product) << Shift)) *
+                signOf(Product);
+    return Product;
+  }
+  case HostOperation::Divide: {
+    // The exact quotient is above Quotient in magnitude when A is above
+    // Quotient * B.  Count in ulps of Quotient times ulps of B.
+    BIJOU_HOST_QUAD Quotient = A / B;
+    if (isHostZero(A) || isHostZero(B))
+      return Quotient;
+    int Shift = Format::exponent(A) - Format::exponent(Quotient) -
+                Format::exponent(B) + Ulp;
+    ErrorSign = signOfError((Format::significand(A) << Shift) -
+                            Format::significand(Quotient) *
+                                Format::significand(B)) *
+                signOf(Quotient);
+    return Quotient;
+  }
+  case HostOperation::FusedMultiplyAdd:
+    break;
+  }
+  bijou_unreachable("Operation without an error-free transformation");
+}
+#endif
+
+#if BIJOU_HAS_SSE_FLOAT_ENV
+/// hostRoundToNearest in the caller's environment, which must be the
+/// default one, keeping its exception flags.
+template <typename T>
+T hostRoundToNearestQuietly(HostOperation Operation, T A, T B,
+                            int &ErrorSign) {
+  HostStatusScope<T> Status;
+  // The operands are read, and the results written, through volatile
+  // objects so that the operations stay inside the scope.
+  volatile T VA = A, VB = B;
+  int Sign;
+  volatile T VR = hostRoundToNearest(Operation, T(VA), T(VB), Sign);
+  volatile int VSign = Sign;
+  ErrorSign = VSign;
+  return VR;
+}
+#endif
+} // end anonymous namespace
+
+/* The zero or normal value of this float in the host type T of its
+   semantics.  */
+template <typename T> T IEEEFloat::toHost() const {
+  using Significand = typename HostFormat<T>::Significand;
+  Significand S = 0;
+  int Exponent = exponent;
+  if (category == fcNormal) {
+    const integerPart *Parts = significandParts();
+    S = Parts[0];
+    if (semantics->precision < HostFormat<T>::Precision) {
+      // A narrower significand widens, and a denormal one normalizes.
+      int Shift = HostFormat<T>::Precision - std::bit_width(Parts[0]);
+      S <<= Shift;
+      Exponent -= Shift - (HostFormat<T>::Precision - semantics->precision);
+    } else if constexpr (sizeof(Significand) > sizeof(integerPart)) {
+      S |= Significand(Parts[1]) << integerPartWidth;
+    }
+  }
+  return HostFormat<T>::pack(sign, Exponent, S);
+}
+
+/* Sets this float to the zero or normal value X of the host type of its
+   semantics, moved by an ulp away from zero if STEP is positive or toward
+   zero if it is negative.  */
+template <typename T> void IEEEFloat::initFromHost(T X, int Step) {
+  using Format = HostFormat<T>;
+  if (isHostZero(X)) {
+    makeZero(Format::isNegative(X));
+    return;
+  }
+  category = fcNormal;
+  sign = Format::isNegative(X);
+  exponent = Format::exponent(X);
+  using Significand = typename Format::Significand;
+  Significand S = Format::significand(X);
+  // The shifts wrap for a 64 bit significand just as the increment does.
+  const Significand IntegerBit = Significand(1) << (Format::Precision - 1);
+  if (Step > 0 && ++S == IntegerBit << 1) {
+    S = IntegerBit;
+    exponent++;
+  } else if (Step < 0 && S-- == IntegerBit) {
+    S = (IntegerBit << 1) - 1;
+    exponent--;
+  }
+  integerPart *Parts = significandParts();
+  unsigned Count = 0;
+  Parts[Count++] = integerPart(S);
+  if constexpr (sizeof(Significand) > sizeof(integerPart))
+    Parts[Count++] = integerPart(S >> integerPartWidth);
+  std::fill(Parts + Count, Parts + partCount(), 0);
+}
+
+/* Sets this float to X rounded to TOSEMANTICS in ROUNDING_MODE, if the
+   result is normal.  TOSEMANTICS has one part and at least two bits less
+   precision than T.  X is nonzero and within an ulp of the exact value, and
+   ERRORSIGN is the sign of the exact value minus X.  */
+template <typename T>
+bool IEEEFloat::roundFromHost(T X, int ErrorSign,
+                              const fltSemantics &toSemantics,
+                              roundingMode rounding_mode, opStatus &fs) {
+  using Format = HostFormat<T>;
+  static_assert(Format::Precision + 2 <= 64);
+  bool Negative = Format::isNegative(X);
+  // Count in quarter ulps of X, and move a quarter ulp toward the exact
+  // value.  The values and midpoints of TOSEMANTICS are multiples of four
+  // quarter ulps, so they compare with this as with the exact value.
+  uint64_t Scaled =
+      (Format::significand(X) << 2) + (Negative ? -ErrorSign : ErrorSign);
+  int Width = std::bit_width(Scaled);
+  int Exponent = Format::exponent(X) + Width - (Format::Precision + 2);
+  if (Exponent < toSemantics.minExponent || Exponent > toSemantics.maxExponent)
+    return false;
+  int Shift = Width - toSemantics.precision;
+  uint64_t Significand = Scaled >> Shift;
+  uint64_t Half = uint64_t(1) << (Shift - 1);
+  uint64_t Remainder = Scaled & ((Half << 1) - 1);
+  bool Up;
+  switch (rounding_mode) {
+  case rmNearestTiesToEven:
+    Up = Remainder > Half || (Remainder == Half && (Significand & 1));
+    break;
+  case rmNearestTiesToAway:
+    Up = Remainder >= Half;
+    break;
+  case rmTowardPositive:
+    Up = Remainder && !Negative;
+    break;
+  case rmTowardNegative:
+    Up = Remainder && Negative;
+    break;
+  default:
+    Up = false;
+    break;
+  }
+  if (Up && ++Significand >> toSemantics.precision) {
+    Significand >>= 1;
+    if (++Exponent > toSemantics.maxExponent)
+      return false;
+  }
+
+  assert(partCount() == 1 && partCountForBits(toSemantics.precision + 1) == 1);
+  semantics = &toSemantics;
+  category = fcNormal;
+  sign = Negative;
+  exponent = Exponent;
+  *significandParts() = Significand;
+  fs = Remainder ? opInexact : opOK;
+  return true;
+}
+
+/* Computes OPERATION of this value, RHS and ADDEND with the host type of
+   its semantics, if there is one.  */
+bool IEEEFloat::hostArithmetic(HostOperation Operation, const IEEEFloat &rhs,
+                               const IEEEFloat *addend,
+                               roundingMode rounding_mode, opStatus &fs) {
+  if (isPromotedToFloat(semantics))
+    return promotedArithmetic(Operation, rhs, addend, rounding_mode, fs);
+  return withHostType(semantics, [&](auto X) {
+    return hostArithmetic<decltype(X)>(Operation, rhs, addend, rounding_mode,
+                                       fs);
+  });
+}
+
+/* Computes OPERATION with the host type T and sets FS, if that gives the
+   result and status of the software arithmetic.  Operands and results that
+   are not finite or are near underflow or overflow are left to the software
+   arithmetic, as is rounding to nearest with ties away from zero: the host
+   may flush denormals to zero, detect tininess differently and propagate
+   NaNs differently.
+
+   Where the SSE environment can be read cheaply, the result is rounded to
+   nearest in the caller's environment, and directed rounding steps it by an
+   ulp according to the sign of its exact error.  This avoids setting the
+   host rounding mode, which costs more than the operation.  That
+   environment must mask all exceptions, and keeps its flags through a
+   HostStatusScope.  Elsewhere, and for fused multiply-add, the operation
+   runs in a HostFloatScope.  */
+template <typename T>
+bool IEEEFloat::hostArithmetic(HostOperation Operation, const IEEEFloat &rhs,
+                               const IEEEFloat *addend,
+                               roundingMode rounding_mode, opStatus &fs) {
+  using Format = HostFormat<T>;
+  // Normal values with exponents in [MinExponent, MaxExponent] give exact
+  // errors, and results that neither underflow nor overflow.
+  const int MinExponent = Format::MinExponent + 2 * Format::Precision;
+  const int MaxExponent = Format::MaxExponent - Format::Precision;
+  auto inRange = [&](const IEEEFloat &F) {
+    return F.category == fcZero ||
+           (F.category == fcNormal && F.exponent >= MinExponent &&
+            F.exponent <= MaxExponent);
+  };
+
+  int Round = HostFloatScope::roundingMode(rounding_mode);
+  if (Round < 0 || (addend && !Format::HasFma) || !inRange(*this) ||
+      !inRange(rhs) || (addend && !inRange(*addend)))
+    return false;
+
+  T A = toHost<T>(), B = rhs.toHost<T>(), R;
+  bool Inexact;
+  int Step = 0;
+#if BIJOU_HAS_SSE_FLOAT_ENV
+  if (Operation != HostOperation::FusedMultiplyAdd) {
+    if (!HostFloatScope::isDefault<T>())
+      return false;
+    int ErrorSign;
+    R = hostRoundToNearestQuietly(Operation, A, B, ErrorSign);
+    Inexact = ErrorSign != 0;
+    Step = directedStep(signOf(R), ErrorSign, rounding_mode);
+    // A zero sum or difference is negative when rounding downward, and a
+    // zero product or quotient of nonzero operands underflowed.
+    if (isHostZero(R) && (Operation <= HostOperation::Subtract
+                              ? rounding_mode == rmTowardNegative
+                              : !isHostZero(A) && !isHostZero(B)))
+      return false;
+  } else
+#endif
+  {
+    // The operands are read, and the result written, through volatile
+    // objects so that the operation stays inside the scope.
+    volatile T VA = A, VB = B, VC = addend ? addend->toHost<T>() : T();
+    volatile T VR;
+    int Exceptions;
+    {
+      HostFloatScope Scope(Round);
+      switch (Operation) {
+      case HostOperation::Add:
+        VR = VA + VB;
+        break;
+      case HostOperation::Subtract:
+        VR = VA - VB;
+        break;
+      case HostOperation::Multiply:
+        VR = VA * VB;
+        break;
+      case HostOperation::Divide:
+        VR = VA / VB;
+        break;
+      case HostOperation::FusedMultiplyAdd:
+        // Only reached for types with HasFma.
+        if constexpr (Format::HasFma)
+          VR = std::fma(VA, VB, VC);
+        break;
+      }
+      Exceptions = Scope.exceptions();
+    }
+    if (Exceptions & ~FE_INEXACT)
+      return false;
+    R = VR;
+    Inexact = Exceptions & FE_INEXACT;
+  }
+
+  if (!isHostZero(R) && (Format::exponent(R) < MinExponent ||
+                         Format::exponent(R) > MaxExponent))
+    return false;
+  initFromHost(R, Step);
+  fs = Inexact ? opInexact : opOK;
+  return true;
+}
+
+/* Computes OPERATION of this IEEEhalf or BFloat value, RHS and ADDEND in
+   float and rounds the result to the semantics, if that gives the result and
+   status of the software arithmetic.  Float holds the product of two such
+   values exactly, and more than twice their precision, so its result and the
+   sign of its error give the exact result rounded in any rounding mode.
+   Results that are denormal in the semantics are left to the software
+   arithmetic, as are results that overflow.
+
+   Where the SSE environment can be read cheaply, the float result is
+   rounded to nearest in the caller's environment with the sign of its exact
+   error, as in hostArithmetic.  Elsewhere it is rounded toward zero in a
+   HostFloatScope, and is inexact when the exact value has a greater
+   magnitude.  */
+bool IEEEFloat::promotedArithmetic(HostOperation Operation,
+                                   const IEEEFloat &rhs,
+                                   const IEEEFloat *addend,
+                                   roundingMode rounding_mode, opStatus &fs) {
+  using Format = HostFormat<float>;
+  // Normal float values with exponents in [MinExponent, MaxExponent] give
+  // exact errors and products.
+  const int MinExponent = Format::MinExponent + 2 * Format::Precision;
+  const int MaxExponent = Format::MaxExponent - Format::Precision;
+  auto inRange = [&](const IEEEFloat &F) {
+    if (F.category != fcNormal)
+      return F.category == fcZero;
+    int Exponent = F.exponent - (F.semantics->precision -
+                                 std::bit_width(*F.significandParts()));
+    return Exponent >= MinExponent && Exponent <= MaxExponent;
+  };
+  if (!inRange(*this) || !inRange(rhs) || (addend && !inRange(*addend)))
+    return false;
+
+  float A = toHost<float>(), B = rhs.toHost<float>(), R;
+  int ErrorSign;
+#if BIJOU_HAS_SSE_FLOAT_ENV
+  if (!HostFloatScope::isDefault<float>())
+    return false;
+  HostOperation FloatOperation = Operation;
+  if (Operation == HostOperation::FusedMultiplyAdd) {
+    // The product is exact, unless it leaves the range.
+    int ProductErrorSign;
+    float Product = hostRoundToNearestQuietly(HostOperation::Multiply, A, B,
+                                              ProductErrorSign);
+    if (isHostZero(Product) ? !isHostZero(A) && !isHostZero(B)
+                            : Format::exponent(Product) < MinExponent ||
+                                  Format::exponent(Product) > MaxExponent)
+      return false;
+    A = Product;
+    B = addend->toHost<float>();
+    FloatOperation = HostOperation::Add;
+  }
+  R = hostRoundToNearestQuietly(FloatOperation, A, B, ErrorSign);
+#else
+  // The operands are read, and the result written, through volatile
+  // objects so that the operation stays inside the scope.
+  volatile float VA = A, VB = B, VC = addend ? addend->toHost<float>() : 0;
+  volatile float VR;
+  int Exceptions;
+  {
+    HostFloatScope Scope(HostFloatScope::roundingMode(rmTowardZero));
+    switch (Operation) {
+    case HostOperation::Add:
+      VR = VA + VB;
+      break;
+    case HostOperation::Subtract:
+      VR = VA - VB;
+      break;
+    case HostOperation::Multiply:
+      VR = VA * VB;
+      break;
+    case HostOperation::Divide:
+      VR = VA / VB;
+      break;
+    case HostOperation::FusedMultiplyAdd:
+      // The product is exact, so only the sum rounds.
+      VR = VA * VB + VC;
+      break;
+    }
+    Exceptions = Scope.exceptions();
+  }
+  if (Exceptions & ~FE_INEXACT)
+    return false;
+  R = VR;
+  ErrorSign = Exceptions & FE_INEXACT ? signOf(R) : 0;
+#endif
+
+  if (isHostZero(R)) {
+    // A zero sum is exact, and negative when rounding downward.  A zero
+    // product or quotient is exact only when an operand is zero.
+    if (ErrorSign || (Operation != HostOperation::Multiply &&
+                      Operation != HostOperation::Divide &&
+                      rounding_mode == rmTowardNegative))
+      return false;
+    makeZero(Format::isNegative(R));
+    fs = opOK;
+    return true;
+  }
+  return roundFromHost(R, ErrorSign, *semantics, rounding_mode, fs);
+}
+
+/* Converts this value to TOSEMANTICS with the host types of both
+   semantics, if they have them.  */
+bool IEEEFloat::hostConvert(const fltSemantics &toSemantics,
+                            roundingMode rounding_mode, bool *losesInfo,
+                            opStatus &fs) {
+  if (isPromotedToFloat(&toSemantics))
+    return promotedConvert(toSemantics, rounding_mode, losesInfo, fs);
+  return withHostType(semantics, [&](auto From) {
+    return withHostType(&toSemantics, [&](auto To) {
+      return hostConvert<decltype(From), decltype(To)>(
+          toSemantics, rounding_mode, losesInfo, fs);
+    });
+  });
+}
+
+/* Converts this value from the host type From to the host type To of
+   TOSEMANTICS, if the result is normal or zero.  A narrowing conversion
+   rounds to nearest and steps by an ulp according to the sign of its exact
+   error, as hostArithmetic does.  */
+template <typename From, typename To>
+bool IEEEFloat::hostConvert(const fltSemantics &toSemantics,
+                            roundingMode rounding_mode, bool *losesInfo,
+                            opStatus &fs) {
+#if BIJOU_HAS_HOST_QUAD
+  // The library conversions to and from quad cost more than the software
+  // conversions.
+  if constexpr (std::is_same_v<From, BIJOU_HOST_QUAD> ||
+                std::is_same_v<To, BIJOU_HOST_QUAD>)
+    return false;
+#endif
+  // Values with exponents in [MinExponent, MaxExponent] convert directly in
+  // both types, and cannot round down to a denormal or up to an infinity.
+  const int MinExponent =
+      std::max(HostFormat<From>::MinExponent, HostFormat<To>::MinExponent) + 1;
+  const int MaxExponent =
+      std::min(HostFormat<From>::MaxExponent, HostFormat<To>::MaxExponent) - 1;
+  int Round = HostFloatScope::roundingMode(rounding_mode);
+  if (Round < 0 || (category != fcZero &&
+                    (category != fcNormal || exponent < MinExponent ||
+                     exponent > MaxExponent)))
+    return false;
+
+  From X = toHost<From>();
+  To R;
+  bool Inexact;
+  int Step = 0;
+#if BIJOU_HAS_SSE_FLOAT_ENV
+  // Narrowing a normal value leaves an error that the wider type holds.
+  int ErrorSign = 0;
+  if constexpr (HostFormat<To>::Precision < HostFormat<From>::Precision) {
+    if (!HostFloatScope::isDefault<From>() || !HostFloatScope::isDefault<To>())
+      return false;
+    HostStatusScope<From> Status;
+    // The operand is read, and the results written, through volatile
+    // objects so that the conversion stays inside the scope.
+    volatile From VX = X;
+    volatile To VR = To(VX);
+    R = VR;
+    volatile int VErrorSign = signOf(X - From(R));
+    ErrorSign = VErrorSign;
+  } else {
+    R = To(X);
+  }
+  Inexact = ErrorSign != 0;
+  Step = directedStep(signOf(R), ErrorSign, rounding_mode);
+#else
+  volatile From VX = X;
+  volatile To VR;
+  int Exceptions;
+  {
+    HostFloatScope Scope(Round);
+    VR = VX;
+    Exceptions = Scope.exceptions();
+  }
+  if (Exceptions & ~FE_INEXACT)
+    return false;
+  R = VR;
+  Inexact = Exceptions & FE_INEXACT;
+#endif
+
+  // Switch the storage and semantics.
+  if (partCountForBits(toSemantics.precision + 1) != partCount()) {
+    freeSignificand();
+    initialize(&toSemantics);
+  } else {
+    semantics = &toSemantics;
+  }
+  initFromHost(R, Step);
+  *losesInfo = Inexact;
+  fs = Inexact ? opInexact : opOK;
+  return true;
+}
+
+/* Converts this float or double value to IEEEhalf or BFloat, rounding the
+   host value once, if the result is normal or zero.  Widening gains nothing
+   over the software conversion.  */
+bool IEEEFloat::promotedConvert(const fltSemantics &toSemantics,
+                                roundingMode rounding_mode, bool *losesInfo,
+                                opStatus &fs) {
+  if (category != fcZero && category != fcNormal)
+    return false;
+
+  return withHostType(semantics, [&](auto From) {
+    using Format = HostFormat<decltype(From)>;
+    if constexpr (Format::Precision + 2 > 64) {
+      return false;
+    } else {
+      if (category == fcZero) {
+        semantics = &toSemantics;
+        makeZero(sign);
+        *losesInfo = false;
+        fs = opOK;
+        return true;
+      }
+      // Leave denormals to the software conversion.
+      if (!(*significandParts() >> (Format::Precision - 1)) ||
+          !roundFromHost(toHost<decltype(From)>(), 0, toSemantics,
+                         rounding_mode, fs))
+        return false;
+      *losesInfo = fs != opOK;
+      return true;
+    }
+  });
+}
+
+#endif // BIJOU_ENABLE_HARDWARE_FLOAT
+
 /* Normalized addition or subtraction.  */
 IEEEFloat::opStatus IEEEFloat::addOrSubtract(const IEEEFloat &rhs,
                                              roundingMode rounding_mode,
@@ -1942,12 +3319,22 @@ IEEEFloat::opStatus IEEEFloat::addOrSubtract(const IEEEFloat &rhs,
 /* Normalized addition.  */
 IEEEFloat::opStatus IEEEFloat::add(const IEEEFloat &rhs,
                                    roundingMode rounding_mode) {
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+  opStatus fs;
+  if (hostArithmetic(HostOperation::Add, rhs, nullptr, rounding_mode, fs))
+    return fs;
+#endif
   return addOrSubtract(rhs, rounding_mode, false);
 }
 
 /* Normalized subtraction.  */
 IEEEFloat::opStatus IEEEFloat::subtract(const IEEEFloat &rhs,
                                         roundingMode rounding_mode) {
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+  opStatus fs;
+  if (hostArithmetic(HostOperation::Subtract, rhs, nullptr, rounding_mode, fs))
+    return fs;
+#endif
   return addOrSubtract(rhs, rounding_mode, true);
 }
 
@@ -1956,6 +3343,11 @@ IEEEFloat::opStatus IEEEFloat::multiply(const IEEEFloat &rhs,
                                         roundingMode rounding_mode) {
   opStatus fs;
 
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+  if (hostArithmetic(HostOperation::Multiply, rhs, nullptr, rounding_mode, fs))
+    return fs;
+#endif
+
   sign ^= rhs.sign;
   fs = multiplySpecials(rhs);
 
@@ -1974,6 +3366,11 @@ IEEEFloat::opStatus IEEEFloat::divide(const IEEEFloat &rhs,
                                       roundingMode rounding_mode) {
   opStatus fs;
 
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+  if (hostArithmetic(HostOperation::Divide, rhs, nullptr, rounding_mode, fs))
+    return fs;
+#endif
+
   sign ^= rhs.sign;
   fs = divideSpecials(rhs);
 
@@ -2119,6 +3516,12 @@ IEEEFloat::opStatus IEEEFloat::fusedMultiplyAdd(const IEEEFloat &multiplicand,
                                                 roundingMode rounding_mode) {
   opStatus fs;
 
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+  if (hostArithmetic(HostOperation::FusedMultiplyAdd, multiplicand, &addend,
+                     rounding_mode, fs))
+    return fs;
+#endif
+
   /* Post-multiplication sign, before addition.  */
   sign ^= multiplicand.sign;
 
@@ -2330,6 +3733,11 @@ IEEEFloat::opStatus IEEEFloat::convert(const fltSemantics &toSemantics,
   int shift;
   const fltSemantics &fromSemantics = *semantics;
 
+#if BIJOU_ENABLE_HARDWARE_FLOAT
+  if (hostConvert(toSemantics, rounding_mode, losesInfo, fs))
+    return fs;
+#endif
+
   lostFraction = lfExactlyZero;
   newPartCount = partCountForBits(toSemantics.precision + 1);
   oldPartCount = partCount();
@@ -2367,22 +3775,29 @@ IEEEFloat::opStatus IEEEFloat::convert(const fltSemantics &toSemantics,
     lostFraction = shiftRight(significandParts(), oldPartCount, -shift);
 
   // Fix the storage so it can hold to new value.
-  if (newPartCount > oldPartCount) {
+  if (newPartCount > oldPartCount && newPartCount <= InlineParts) {
+    // The inline storage is large enough; clear the parts it gains.
+    integerPart *parts = significandParts();
+    if (isFiniteNonZero() || category==fcNaN)
+      APInt::tcSet(parts + oldPartCount, 0, newPartCount - oldPartCount);
+    else
+      APInt::tcSet(parts, 0, newPartCount);
+  } else if (newPartCount > oldPartCount) {
     // The new type requires more storage; make it available.
     integerPart *newParts;
-    newParts = new integerPart[newPartCount];
+    newParts = allocateWords(newPartCount);
     APInt::tcSet(newParts, 0, newPartCount);
     if (isFiniteNonZero() || category==fcNaN)
       APInt::tcAssign(newParts, significandParts(), oldPartCount);
     freeSignificand();
     significand.parts = newParts;
-  } else if (newPartCount == 1 && oldPartCount != 1) {
-    // Switch to built-in storage for a single part.
-    integerPart newPart = 0;
+  } else if (newPartCount <= InlineParts && oldPartCount > InlineParts) {
+    // Switch to built-in storage for the parts.
+    integerPart newParts[InlineParts] = {};
     if (isFiniteNonZero() || category==fcNaN)
-      newPart = significandParts()[0];
+      APInt::tcAssign(newParts, significandParts(), newPartCount);
     freeSignificand();
-    significand.part = newPart;
+    APInt::tcAssign(significand.part, newParts, InlineParts);
   }
 
   // Now that we have the right storage, switch the semantics.
@@ -2634,11 +4049,11 @@ IEEEFloat::convertFromSignExtendedInteger(const integerPart *src,
 
     /* If we're signed and negative negate a copy.  */
     sign = true;
-    copy = new integerPart[srcCount];
+    copy = allocateWords(srcCount);
     APInt::tcAssign(copy, src, srcCount);
     APInt::tcNegate(copy, srcCount);
     status = convertFromUnsignedParts(copy, srcCount, rounding_mode);
-    delete [] copy;
+    deallocateWords(copy, srcCount);
   } else {
     sign = false;
     status = convertFromUnsignedParts(src, srcCount, rounding_mode);
@@ -2783,9 +4198,18 @@ IEEEFloat::roundSignificandWithExponent(const integerPart *decSigParts,
     excessPrecision = calcSemantics.precision - semantics->precision;
     truncatedBits = excessPrecision;
 
-    IEEEFloat decSig(calcSemantics, uninitialized);
+    /* The working values keep wider significands in scratch space, as
+       multiplySignificand does for its addend, so that parsing the
+       built-in semantics does not allocate.  */
+    ScratchWords<8> decSigScratch(parts), pow5Scratch(parts);
+    IEEEFloat decSig(semBogus, uninitialized), pow5(semBogus, uninitialized);
+    if (parts > InlineParts) {
+      decSig.significand.parts = decSigScratch.data();
+      pow5.significand.parts = pow5Scratch.data();
+    }
+    decSig.semantics = pow5.semantics = &calcSemantics;
     decSig.makeZero(sign);
-    IEEEFloat pow5(calcSemantics);
+    pow5.makeZero(false);
 
     sigStatus = decSig.convertFromUnsignedParts(decSigParts, sigPartCount,
                                                 rmNearestTiesToEven);
@@ -2825,8 +4249,15 @@ IEEEFloat::roundSignificandWithExponent(const integerPart *decSigParts,
     HUdistance = 2 * ulpsFromBoundary(decSig.significandParts(),
                                       excessPrecision, isNearest);
 
-    /* Are we guaranteed to round correctly if we truncate?  */
-    if (HUdistance >= HUerr) {
+    /* Are we guaranteed to round correctly if we truncate?  Dividing by
+       the power of five can give an exact value even if the calculation
+       was inexact.  Only more precision tells whether a value this close
+       to a representable one is exact.  */
+    bool rounded = HUdistance >= HUerr &&
+                   !(exp < 0 && HUerr != 0 && isNearest &&
+                     2 * ulpsFromBoundary(decSig.significandParts(),
+                                          excessPrecision, false) < HUerr);
+    if (rounded) {
       APInt::tcExtract(significandParts(), partCount(), decSig.significandParts(),
                        calcSemantics.precision - excessPrecision,
                        excessPrecision);
@@ -2838,8 +4269,18 @@ IEEEFloat::roundSignificandWithExponent(const integerPart *decSigParts,
       calcLostFraction = lostFractionThroughTruncation(decSig.significandParts(),
                                                        decSig.partCount(),
                                                        truncatedBits);
-      return normalize(rounding_mode, calcLostFraction);
+      /* Otherwise an inexact calculation lost bits of the exact value,
+         which is then not representable even if the truncated bits are
+         zero.  Which side of the result it lies on cannot change the
+         rounding here.  */
+      if (calcLostFraction == lfExactlyZero && HUerr != 0)
+        calcLostFraction = lfLessThanHalf;
     }
+
+    /* The scratch space is not the working values' to free.  */
+    decSig.semantics = pow5.semantics = &semBogus;
+    if (rounded)
+      return normalize(rounding_mode, calcLostFraction);
   }
 }
 
@@ -2904,16 +4345,30 @@ IEEEFloat::convertFromDecimalString(std::string_view str, roundingMode rounding_
     /* Overflow and round.  */
     fs = handleOverflow(rounding_mode);
   } else {
-    integerPart *decSignificand;
     unsigned int partCount;
 
+    /* Most significands fit in a word, and the value can be rounded from
+       its top bits and lost fraction without the exact computation.  */
+    integerPart topBits;
+    int topExponent;
+    lostFraction topLostFraction;
+    if (semantics->precision <= integerPartWidth &&
+        decimalToBinary64(D, topBits, topExponent, topLostFraction)) {
+      category = fcNormal;
+      zeroSignificand();
+      significandParts()[0] = topBits;
+      exponent = topExponent + semantics->precision - 1;
+      return normalize(rounding_mode, topLostFraction);
+    }
+
     /* A tight upper bound on number of bits required to hold an
        N-digit decimal integer is N * 196 / 59.  Allocate enough space
        to hold the full significand, and an extra part required by
        tcMultiplyPart.  */
     partCount = static_cast<unsigned int>(D.lastSigDigit - D.firstSigDigit) + 1;
     partCount = partCountForBits(1 + 196 * partCount / 59);
-    decSignificand = new integerPart[partCount + 1];
+    ScratchWords<8> decScratch(partCount + 1);
+    integerPart *decSignificand = decScratch.data();
     partCount = 0;
 
     /* Convert to binary efficiently - we do almost all multiplication
@@ -2934,10 +4389,8 @@ IEEEFloat::convertFromDecimalString(std::string_view str, roundingMode rounding_
           }
         }
         decValue = decDigitValue(*p++);
-        if (decValue >= 10U) {
-          delete[] decSignificand;
+        if (decValue >= 10U)
           return createError("Invalid character in significand");
-        }
         multiplier *= 10;
         val = val * 10 + decValue;
         /* The maximum number that can be multiplied by ten with any
@@ -2957,8 +4410,6 @@ IEEEFloat::convertFromDecimalString(std::string_view str, roundingMode rounding_
     category = fcNormal;
     fs = roundSignificandWithExponent(decSignificand, partCount,
                                       D.exponent, rounding_mode);
-
-    delete [] decSignificand;
   }
 
   return fs;
@@ -3813,8 +5264,43 @@ IEEEFloat::IEEEFloat(double d) {
 }
 
 namespace {
-  void append(std::string &Buffer, std::string_view Str) {
-    Buffer.append(Str.begin(), Str.end());
+  /// Writes characters to [First, Last) through the subset of the
+  /// std::string interface that IEEEFloat::toChars uses, remembering whether
+  /// any of them did not fit.
+  class CharWriter {
+  public:
+    CharWriter(char *First, char *Last) : Cur(First), Last(Last) {}
+
+    void push_back(char C) {
+      if (Cur != Last)
+        *Cur++ = C;
+      else
+        Overflow = true;
+    }
+
+    void append(size_t Count, char C) {
+      if (Count > size_t(Last - Cur)) {
+        Overflow = true;
+        Count = Last - Cur;
+      }
+      Cur = std::fill_n(Cur, Count, C);
+    }
+
+    std::to_chars_result result() const {
+      if (Overflow)
+        return {Last, std::errc::value_too_large};
+      return {Cur, std::errc()};
+    }
+
+  private:
+    char *Cur;
+    char *Last;
+    bool Overflow = false;
+  };
+
+  void append(CharWriter &Buffer, std::string_view Str) {
+    for (char C : Str)
+      Buffer.push_back(C);
   }
 
   /// Removes data from the given significand until it is no more
@@ -3850,9 +5336,138 @@ namespace {
   }
 
 
-  void AdjustToPrecision(std::string &buffer,
+  /// Sets [Low, High] * 2^Exponent to bounds on N * 5^J, where N has two
+  /// words and the products six.
+  ///
+  /// @returns false if J is out of range of approximatePowerOfFive.
+  bool boundPowerOfFiveProduct(const APFloatBase::integerPart N[2], int J,
+                               APFloatBase::integerPart Low[6],
+                               APFloatBase::integerPart High[6],
+                               int &Exponent) {
+    APFloatBase::integerPart Power[4], PowerHigh[4];
+    int MaxError = approximatePowerOfFive(J, Power, Exponent);
+    if (MaxError < 0)
+      return false;
+    Power[3] = 0;
+    APInt::tcAssign(PowerHigh, Power, 4);
+    APInt::tcAddPart(PowerHigh, MaxError, 4);
+    multiplyWithoutScratch(Low, N, 2, Power, 4);
+    multiplyWithoutScratch(High, N, 2, PowerHigh, 4);
+    return true;
+  }
+
+  /// Does what AdjustToPrecision does to the exact significand of N * 2^Exp2,
+  /// where N is odd and has at most two words, without computing that
+  /// significand: sets Result to the significand after the division by a
+  /// power of ten, and Exp10 to the power of ten of its last digit.
+  ///
+  /// With K = max(-Exp2, 0), the exact significand is N * 2^Exp2 or N * 5^K.
+  /// If it fits in two words it is divided by 10^T directly.  Otherwise the
+  /// result floor(N * 5^(K - T) * 2^(max(Exp2, 0) - T)) is computed from
+  /// bounds on the power of five, or exactly if that is a division by a power
+  /// of five that fits in a word.
+  ///
+  /// @returns false if the bounds do not decide the result, or if it does
+  /// not fit in two words, and the big integer computation is needed.
+  bool adjustToPrecisionFixed(const APFloatBase::integerPart N[2], int Exp2,
+                              unsigned FormatPrecision,
+                              APFloatBase::integerPart Result[2],
+                              int &Exp10) {
+    using integerPart = APFloatBase::integerPart;
+    const unsigned TwoWordBits = 2 * APFloatBase::integerPartWidth;
+
+    // As in AdjustToPrecision, whose result has fewer than
+    // bitsRequired + 5 bits.
+    unsigned bitsRequired = (FormatPrecision * 196 + 58) / 59;
+    if (bitsRequired + 5 > TwoWordBits)
+      return false;
+    auto getTensRemovable = [&](unsigned Bits) {
+      return Bits > bitsRequired ? (Bits - bitsRequired) * 59 / 196 : 0;
+    };
+
+    unsigned NBits = APInt::tcMSB(N, 2) + 1;
+    int K = Exp2 < 0 ? -Exp2 : 0;
+
+    // If the exact significand fits in two words, divide it by 10^T as
+    // floor(floor(Value / 2^T) / 5^T).
+    integerPart Exact[4] = {N[0], N[1], 0, 0};
+    bool Fits = false;
+    if (!K && NBits + Exp2 <= TwoWordBits) {
+      APInt::tcShiftLeft(Exact, 2, Exp2);
+      Fits = true;
+    } else if (K && K < PowerOfFiveStep) {
+      multiplyWithoutScratch(Exact, N, 2, SmallPowersOfFive[K].data(), 2);
+      Fits = APInt::tcIsZero(Exact + 2, 2);
+    }
+    if (Fits) {
+      auto toWide = [](const integerPart *Words) {
+        return Words[0] | static_cast<unsigned __int128>(Words[1]) << 64;
+      };
+      unsigned T = getTensRemovable(APInt::tcMSB(Exact, 2) + 1);
+      unsigned __int128 Value =
+          (toWide(Exact) >> T) / toWide(SmallPowersOfFive[T].data());
+      Result[0] = uint64_t(Value);
+      Result[1] = uint64_t(Value >> 64);
+      Exp10 = (Exp2 < 0 ? Exp2 : 0) + (int)T;
+      return true;
+    }
+
+    integerPart Low[6], High[6];
+    int Exponent;
+    unsigned Bits;
+    if (!K) {
+      Bits = NBits + Exp2;
+    } else {
+      if (!boundPowerOfFiveProduct(N, K, Low, High, Exponent))
+        return false;
+      unsigned MSB = APInt::tcMSB(Low, 6);
+      if (MSB != APInt::tcMSB(High, 6))
+        return false;
+      Bits = MSB + 1 + Exponent;
+    }
+
+    unsigned tensRemovable = getTensRemovable(Bits);
+    int J = K - (int)tensRemovable;
+    int S = (Exp2 >= 0 ? Exp2 : 0) - (int)tensRemovable;
+
+    if (J < 0 && -J < 28 && (int)NBits + S <= 256) {
+      // Divide by 5^-J exactly.
+      integerPart Dividend[4] = {N[0], N[1], 0, 0};
+      if (S >= 0)
+        APInt::tcShiftLeft(Dividend, 4, S);
+      else
+        APInt::tcShiftRight(Dividend, 4, -S);
+      integerPart Divisor = SmallPowersOfFive[-J][0];
+      integerPart Remainder = 0;
+      for (unsigned I = 4; I-- > 0;) {
+        unsigned __int128 Part =
+            (static_cast<unsigned __int128>(Remainder) << 64) | Dividend[I];
+        Dividend[I] = uint64_t(Part / Divisor);
+        Remainder = uint64_t(Part % Divisor);
+      }
+      if (!APInt::tcIsZero(Dividend + 2, 2))
+        return false;
+      APInt::tcAssign(Result, Dividend, 2);
+      Exp10 = -J;
+      return true;
+    }
+
+    if (!boundPowerOfFiveProduct(N, J, Low, High, Exponent) ||
+        Exponent + S > 0)
+      return false;
+    APInt::tcShiftRight(Low, 6, -(Exponent + S));
+    APInt::tcShiftRight(High, 6, -(Exponent + S));
+    if (APInt::tcCompare(Low, High, 6) != 0 || !APInt::tcIsZero(Low + 2, 4))
+      return false;
+    APInt::tcAssign(Result, Low, 2);
+    Exp10 = -J;
+    return true;
+  }
+
+  /// Rounds the N digits in BUFFER, least significant first, to
+  /// FormatPrecision digits.
+  void AdjustToPrecision(char *buffer, unsigned &N,
                          int &exp, unsigned FormatPrecision) {
-    unsigned N = buffer.size();
     if (N <= FormatPrecision) return;
 
     // The most significant figures are the last ones in the buffer.
@@ -3868,7 +5483,7 @@ namespace {
         FirstSignificant++;
 
       exp += FirstSignificant;
-      buffer.erase(buffer.begin(), buffer.begin() + FirstSignificant);
+      N = std::copy(buffer + FirstSignificant, buffer + N, buffer) - buffer;
       return;
     }
 
@@ -3886,26 +5501,42 @@ namespace {
     // If we carried through, we have exactly one digit of precision.
     if (FirstSignificant == N) {
       exp += FirstSignificant;
-      buffer.clear();
-      buffer.push_back('1');
+      buffer[0] = '1';
+      N = 1;
       return;
     }
 
     exp += FirstSignificant;
-    buffer.erase(buffer.begin(), buffer.begin() + FirstSignificant);
+    N = std::copy(buffer + FirstSignificant, buffer + N, buffer) - buffer;
   }
 } // namespace
 
 void IEEEFloat::toString(std::string &Str, unsigned FormatPrecision,
                          unsigned FormatMaxPadding, bool TruncateZero) const {
+  size_t Start = Str.size();
+  Str.resize(Start + APFloat::getMaxChars(*semantics, FormatPrecision,
+                                          FormatMaxPadding));
+  std::to_chars_result Result =
+      toChars(Str.data() + Start, Str.data() + Str.size(), FormatPrecision,
+              FormatMaxPadding, TruncateZero);
+  assert(Result.ec == std::errc() && "getMaxChars is too small");
+  Str.resize(Result.ptr - Str.data());
+}
+
+std::to_chars_result IEEEFloat::toChars(char *First, char *Last,
+                                        unsigned FormatPrecision,
+                                        unsigned FormatMaxPadding,
+                                        bool TruncateZero) const {
+  CharWriter Str(First, Last);
+
   switch (category) {
   case fcInfinity:
-    if (isNegative())
-      return append(Str, "-Inf");
-    else
-      return append(Str, "+Inf");
+    append(Str, isNegative() ? "-Inf" : "+Inf");
+    return Str.result();
 
-  case fcNaN: return append(Str, "NaN");
+  case fcNaN:
+    append(Str, "NaN");
+    return Str.result();
 
   case fcZero:
     if (isNegative())
@@ -3922,7 +5553,7 @@ void IEEEFloat::toString(std::string &Str, unsigned FormatPrecision,
       }
     } else
       Str.push_back('0');
-    return;
+    return Str.result();
 
   case fcNormal:
     break;
@@ -3931,11 +5562,10 @@ void IEEEFloat::toString(std::string &Str, unsigned FormatPrecision,
   if (isNegative())
     Str.push_back('-');
 
-  // Decompose the number into an APInt and an exponent.
+  // Decompose the number into a significand and an exponent.
   int exp = exponent - ((int) semantics->precision - 1);
-  APInt significand(semantics->precision,
-                    std::span(significandParts(),
-                                 partCountForBits(semantics->precision)));
+  const integerPart *parts = significandParts();
+  unsigned numParts = partCountForBits(semantics->precision);
 
   // Set FormatPrecision if zero.  We want to do this before we
   // truncate trailing zeros, as those are part of the precision.
@@ -3951,77 +5581,119 @@ void IEEEFloat::toString(std::string &Str, unsigned FormatPrecision,
   }
 
   // Ignore trailing binary zeros.
-  int trailingZeros = significand.countTrailingZeros();
+  int trailingZeros = APInt::tcLSB(parts, numParts);
   exp += trailingZeros;
-  significand.lshrInPlace(trailingZeros);
-
-  // Change the exponent from 2^e to 10^e.
-  if (exp == 0) {
-    // Nothing to do.
-  } else if (exp > 0) {
-    // Just shift left.
-    significand = significand.zext(semantics->precision + exp);
-    significand <<= exp;
-    exp = 0;
-  } else { /* exp < 0 */
-    int texp = -exp;
-
-    // We transform this using the identity:
-    //   (N)(2^-e) == (N)(5^e)(10^-e)
-    // This means we have to multiply N (the significand) by 5^e.
-    // To avoid overflow, we have to operate on numbers large
-    // enough to store N * 5^e:
-    //   log2(N * 5^e) == log2(N) + e * log2(5)
-    //                 <= semantics->precision + e * 137 / 59
-    //   (log_2(5) ~ 2.321928 < 2.322034 ~ 137/59)
-
-    unsigned precision = semantics->precision + (137 * texp + 136) / 59;
-
-    // Multiply significand by 5^e.
-    //   N * 5^0101 == N * 5^(1*1) * 5^(0*2) * 5^(1*4) * 5^(0*8)
-    significand = significand.zext(precision);
-    APInt five_to_the_i(precision, 5);
-    while (true) {
-      if (texp & 1) significand *= five_to_the_i;
 
-      texp >>= 1;
-      if (!texp) break;
-      five_to_the_i *= five_to_the_i;
+  // Significands of up to two words take a shortcut to what
+  // AdjustToPrecision leaves of their exact decimal significand, without
+  // an APInt, which could allocate.
+  integerPart N[2] = {}, Fixed[2];
+  bool isFixed = false;
+  if (semantics->precision <= 2 * integerPartWidth) {
+    APInt::tcAssign(N, parts, numParts);
+    APInt::tcShiftRight(N, 2, trailingZeros);
+    isFixed = adjustToPrecisionFixed(N, exp, FormatPrecision, Fixed, exp);
+  }
+  APInt significand;
+  if (!isFixed) {
+    significand = APInt(semantics->precision, std::span(parts, numParts));
+    significand.lshrInPlace(trailingZeros);
+
+    // Change the exponent from 2^e to 10^e.
+    if (exp == 0) {
+      // Nothing to do.
+    } else if (exp > 0) {
+      // Just shift left.
+      significand = significand.zext(semantics->precision + exp);
+      significand <<= exp;
+      exp = 0;
+    } else { /* exp < 0 */
+      int texp = -exp;
+
+      // We transform this using the identity:
+      //   (N)(2^-e) == (N)(5^e)(10^-e)
+      // This means we have to multiply N (the significand) by 5^e.
+      // To avoid overflow, we have to operate on numbers large
+      // enough to store N * 5^e:
+      //   log2(N * 5^e) == log2(N) + e * log2(5)
+      //                 <= semantics->precision + e * 137 / 59
+      //   (log_2(5) ~ 2.321928 < 2.322034 ~ 137/59)
+
+      unsigned precision = semantics->precision + (137 * texp + 136) / 59;
+
+      // Multiply significand by 5^e.
+      //   N * 5^0101 == N * 5^(1*1) * 5^(0*2) * 5^(1*4) * 5^(0*8)
+      significand = significand.zext(precision);
+      APInt five_to_the_i(precision, 5);
+      while (true) {
+        if (texp & 1) significand *= five_to_the_i;
+
+        texp >>= 1;
+        if (!texp) break;
+        five_to_the_i *= five_to_the_i;
+      }
     }
-  }
 
-  AdjustToPrecision(significand, exp, FormatPrecision);
+    AdjustToPrecision(significand, exp, FormatPrecision);
+  }
 
-  std::string buffer;
+  // The digits go to the stack unless an unusually large FormatPrecision asks
+  // for more of them.
+  char StackBuffer[64];
+  std::unique_ptr<char[]> HeapBuffer;
+  char *buffer = StackBuffer;
+  unsigned activeBits =
+      isFixed ? APInt::tcMSB(Fixed, 2) + 1 : significand.getActiveBits();
+  unsigned MaxDigits = activeBits * 30103 / 100000 + 1;
+  if (MaxDigits > std::size(StackBuffer)) {
+    HeapBuffer.reset(new char[MaxDigits]);
+    buffer = HeapBuffer.get();
+  }
+  unsigned NDigits = 0;
 
   // Fill the buffer.
-  unsigned precision = significand.getBitWidth();
-  APInt ten(precision, 10);
-  APInt digit(precision, 0);
-
   bool inTrail = true;
-  while (significand != 0) {
-    // digit <- significand % 10
-    // significand <- significand / 10
-    APInt::udivrem(significand, ten, significand, digit);
-
-    unsigned d = digit.getZExtValue();
-
+  auto addDigit = [&](unsigned d) {
     // Drop trailing zeros.
     if (inTrail && !d) exp++;
     else {
-      buffer.push_back((char) ('0' + d));
+      assert(NDigits < MaxDigits && "too many digits");
+      buffer[NDigits++] = (char) ('0' + d);
       inTrail = false;
     }
+  };
+  if (activeBits <= 2 * APInt::APINT_BITS_PER_WORD) {
+    // Peel off the nineteen digits that fit in a word at a time.
+    const uint64_t TenToThe19 = 10000000000000000000ULL;
+    const integerPart *Words = isFixed ? Fixed : significand.getRawData();
+    unsigned __int128 Value = Words[0];
+    if (isFixed || significand.getNumWords() > 1)
+      Value |= static_cast<unsigned __int128>(Words[1]) << 64;
+    while (Value >> 64) {
+      uint64_t Low = uint64_t(Value % TenToThe19);
+      Value /= TenToThe19;
+      for (unsigned I = 0; I != 19; ++I, Low /= 10)
+        addDigit(Low % 10);
+    }
+    for (uint64_t Word = uint64_t(Value); Word; Word /= 10)
+      addDigit(Word % 10);
+  } else {
+    unsigned precision = significand.getBitWidth();
+    APInt ten(precision, 10);
+    APInt digit(precision, 0);
+    while (significand != 0) {
+      // digit <- significand % 10
+      // significand <- significand / 10
+      APInt::udivrem(significand, ten, significand, digit);
+      addDigit(digit.getZExtValue());
+    }
   }
 
-  assert(!buffer.empty() && "no characters in buffer!");
+  assert(NDigits && "no characters in buffer!");
 
   // Drop down to FormatPrecision.
   // TODO: don't do more precise calculations above than are required.
-  AdjustToPrecision(buffer, exp, FormatPrecision);
-
-  unsigned NDigits = buffer.size();
+  AdjustToPrecision(buffer, NDigits, exp, FormatPrecision);
 
   // Check whether we should use scientific notation.
   bool FormatScientific;
@@ -4067,26 +5739,26 @@ void IEEEFloat::toString(std::string &Str, unsigned FormatPrecision,
 
     Str.push_back(exp >= 0 ? '+' : '-');
     if (exp < 0) exp = -exp;
-    std::string expbuf;
+    char expbuf[16];
+    unsigned E = 0;
     do {
-      expbuf.push_back((char) ('0' + (exp % 10)));
+      expbuf[E++] = (char) ('0' + (exp % 10));
       exp /= 10;
     } while (exp);
     // Exponent always at least two digits if we do not truncate zeros.
-    if (!TruncateZero && expbuf.size() < 2)
-      expbuf.push_back('0');
-    for (unsigned I = 0, E = expbuf.size(); I != E; ++I)
+    if (!TruncateZero && E < 2)
+      expbuf[E++] = '0';
+    for (unsigned I = 0; I != E; ++I)
       Str.push_back(expbuf[E-1-I]);
-    return;
+    return Str.result();
   }
 
   // Non-scientific, positive exponents.
   if (exp >= 0) {
     for (unsigned I = 0; I != NDigits; ++I)
       Str.push_back(buffer[NDigits-1-I]);
-    for (unsigned I = 0; I != (unsigned) exp; ++I)
-      Str.push_back('0');
-    return;
+    Str.append(exp, '0');
+    return Str.result();
   }
 
   // Non-scientific, negative exponents.
@@ -4110,6 +5782,7 @@ void IEEEFloat::toString(std::string &Str, unsigned FormatPrecision,
 
   for (; I != NDigits; ++I)
     Str.push_back(buffer[NDigits-I-1]);
+  return Str.result();
 }
 
 bool IEEEFloat::getExactInverse(APFloat *inv) const {
@@ -4647,30 +6320,286 @@ APFloat::opStatus DoubleAPFloat::multiply(const DoubleAPFloat &RHS,
   return (opStatus)Status;
 }
 
+IEEEFloat DoubleAPFloat::toLegacy() const {
+  assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
+  // As IEEEFloat::initFromPPCDoubleDoubleAPInt.
+  opStatus fs;
+  bool losesInfo;
+
+  IEEEFloat Legacy(semIEEEdouble, Floats[0].bitcastToAPInt());
+  fs = Legacy.convert(semPPCDoubleDoubleLegacy, rmNearestTiesToEven,
+                      &losesInfo);
+  assert(fs == opOK && !losesInfo);
+  (void)fs;
+
+  if (Legacy.isFiniteNonZero()) {
+    IEEEFloat v(semIEEEdouble, Floats[1].bitcastToAPInt());
+    fs = v.convert(semPPCDoubleDoubleLegacy, rmNearestTiesToEven, &losesInfo);
+    assert(fs == opOK && !losesInfo);
+    (void)fs;
+
+    Legacy.add(v, rmNearestTiesToEven);
+  }
+  return Legacy;
+}
+
+void DoubleAPFloat::assignLegacy(const IEEEFloat &Legacy) {
+  assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
+  // As IEEEFloat::convertPPCDoubleDoubleAPFloatToAPInt.
+  opStatus fs;
+  bool losesInfo;
+
+  fltSemantics extendedSemantics = semPPCDoubleDoubleLegacy;
+  extendedSemantics.minExponent = semIEEEdouble.minExponent;
+  IEEEFloat extended(Legacy);
+  fs = extended.convert(extendedSemantics, rmNearestTiesToEven, &losesInfo);
+  assert(fs == opOK && !losesInfo);
+  (void)fs;
+
+  IEEEFloat u(extended);
+  fs = u.convert(semIEEEdouble, rmNearestTiesToEven, &losesInfo);
+  assert(fs == opOK || fs == opInexact);
+  (void)fs;
+  Floats[0] = APFloat(semIEEEdouble, u.bitcastToAPInt());
+
+  if (u.isFiniteNonZero() && losesInfo) {
+    fs = u.convert(extendedSemantics, rmNearestTiesToEven, &losesInfo);
+    assert(fs == opOK && !losesInfo);
+    (void)fs;
+
+    IEEEFloat v(extended);
+    v.subtract(u, rmNearestTiesToEven);
+    fs = v.convert(semIEEEdouble, rmNearestTiesToEven, &losesInfo);
+    assert(fs == opOK && !losesInfo);
+    (void)fs;
+    Floats[1] = APFloat(semIEEEdouble, v.bitcastToAPInt());
+  } else {
+    Floats[1].makeZero(/* Neg = */ false);
+  }
+}
+
+namespace {
+/// The exact value of a double-double as (-1)^Negative * Significand *
+/// 2^Exponent.
+struct PairValue {
+  bool Negative;
+  int Exponent;
+  unsigned __int128 Significand;
+};
+} // namespace
+
+/* Split the finite double with the bit pattern BITS into its sign, integer
+   significand and the exponent of its lowest bit.  */
+static void decodeDouble(uint64_t Bits, bool &Negative, int &Exponent,
+                         uint64_t &Significand) {
+  Negative = Bits >> 63;
+  int BiasedExponent = (Bits >> 52) & 0x7ff;
+  Significand = Bits & ((1ULL << 52) - 1);
+  if (BiasedExponent)
+    Significand |= 1ULL << 52;
+  else
+    BiasedExponent = 1;
+  Exponent = BiasedExponent - 1075;
+}
+
+/* The bit pattern of the double (-1)^NEGATIVE * SIGNIFICAND * 2^EXPONENT,
+   which must be representable exactly.  */
+static uint64_t encodeDouble(bool Negative, uint64_t Significand,
+                             int Exponent) {
+  assert(Significand && !(Significand >> 53) && "Significand out of range");
+  int Shift = std::countl_zero(Significand) - 11;
+  uint64_t Bits;
+  if (Exponent - Shift >= semIEEEdouble.minExponent - 52) {
+    Significand <<= Shift;
+    Bits = (uint64_t(Exponent - Shift + 1075) << 52) |
+           (Significand & ((1ULL << 52) - 1));
+  } else {
+    Bits = Significand << (Exponent + 1074);
+  }
+  return Bits | uint64_t(Negative) << 63;
+}
+
+static uint64_t doubleBits(const APFloat &X) {
+  return X.bitcastToAPInt().getZExtValue();
+}
+
+static APFloat doubleFromBits(uint64_t Bits) {
+  return APFloat(semIEEEdouble, APInt(64, Bits));
+}
+
+/* Set VALUE to the sum of the pair with the bit patterns HIBITS and LOBITS,
+   whose first double must be finite and nonzero.  Fails unless that sum is a
+   nonzero value of the legacy semantics, where it has at most 106 significant
+   bits.  */
+static bool unpackLegacyPair(uint64_t HiBits, uint64_t LoBits,
+                             PairValue &Value) {
+  bool HiNegative, LoNegative;
+  int HiExponent, LoExponent;
+  uint64_t HiSignificand, LoSignificand;
+  decodeDouble(HiBits, HiNegative, HiExponent, HiSignificand);
+  if (!(LoBits << 1)) {
+    Value = {HiNegative, HiExponent, HiSignificand};
+    return true;
+  }
+  if (((LoBits >> 52) & 0x7ff) == 0x7ff)
+    return false;
+  decodeDouble(LoBits, LoNegative, LoExponent, LoSignificand);
+
+  // Count in units of the lower of the two lowest bits, as long as both
+  // significands then fit in 127 bits.
+  int Exponent = std::min(HiExponent, LoExponent);
+  if (HiExponent - Exponent > 74 || LoExponent - Exponent > 74)
+    return false;
+  unsigned __int128 Hi = (unsigned __int128)HiSignificand
+                         << (HiExponent - Exponent);
+  unsigned __int128 Lo = (unsigned __int128)LoSignificand
+                         << (LoExponent - Exponent);
+  bool Negative = HiNegative;
+  unsigned __int128 Significand;
+  if (HiNegative == LoNegative) {
+    Significand = Hi + Lo;
+  } else if (Hi >= Lo) {
+    Significand = Hi - Lo;
+  } else {
+    Significand = Lo - Hi;
+    Negative = LoNegative;
+  }
+  if (!Significand)
+    return false;
+
+  // Every value below 2^106 in units of at least 2^-1074 is a legacy value.
+  int TrailingZeros = std::countr_zero(uint64_t(Significand));
+  if (TrailingZeros == 64)
+    TrailingZeros += std::countr_zero(uint64_t(Significand >> 64));
+  Significand >>= TrailingZeros;
+  if (Significand >> semPPCDoubleDoubleLegacy.precision)
+    return false;
+  Value = {Negative, Exponent + TrailingZeros, Significand};
+  return true;
+}
+
+/* The number of significant bits of VALUE.  */
+static int significantBits(const PairValue &Value) {
+  uint64_t High = Value.Significand >> 64;
+  return High ? 128 - std::countl_zero(High)
+              : 64 - std::countl_zero(uint64_t(Value.Significand));
+}
+
+/* Split the legacy value VALUE as the legacy semantics do: into the nearest
+   double and the rest, with a positive zero for an exact first double.  Fails
+   if the first double would overflow.  */
+static bool packLegacyPair(const PairValue &Value, uint64_t &HiBits,
+                           uint64_t &LoBits) {
+  LoBits = 0;
+  if (!Value.Significand) {
+    HiBits = uint64_t(Value.Negative) << 63;
+    return true;
+  }
+  int TopExponent = Value.Exponent + significantBits(Value) - 1;
+  int HiExponent = std::max(TopExponent - 52, semIEEEdouble.minExponent - 52);
+  if (Value.Exponent >= HiExponent) {
+    HiBits = encodeDouble(Value.Negative, uint64_t(Value.Significand),
+                          Value.Exponent);
+    return true;
+  }
+
+  // The first double is normal, and the rest is at most half of its ulp.
+  unsigned Dropped = HiExponent - Value.Exponent;
+  unsigned __int128 Unit = (unsigned __int128)1 << Dropped;
+  uint64_t Hi = uint64_t(Value.Significand >> Dropped);
+  unsigned __int128 Rest = Value.Significand & (Unit - 1);
+  bool RestNegative = Value.Negative;
+  if (Rest > Unit / 2 || (Rest == Unit / 2 && (Hi & 1))) {
+    Hi++;
+    Rest = Unit - Rest;
+    RestNegative = !RestNegative;
+    if (Hi >> 53) {
+      Hi >>= 1;
+      HiExponent++;
+    }
+  }
+  if (HiExponent + 52 > semIEEEdouble.maxExponent)
+    return false;
+  HiBits = encodeDouble(Value.Negative, Hi, HiExponent);
+  if (Rest)
+    LoBits = encodeDouble(RestNegative, uint64_t(Rest), Value.Exponent);
+  return true;
+}
+
+/* Round the legacy value VALUE to an integral value in place.  Returns
+   whether that was inexact.  */
+static bool roundPairValueToIntegral(PairValue &Value,
+                                     APFloat::roundingMode RM) {
+  if (Value.Exponent >= 0)
+    return false;
+
+  // Split into an integer part and the lost fraction.  The value is below
+  // 2^106, so beyond 106 fraction bits it is less than a half.
+  unsigned __int128 Integer = 0;
+  lostFraction Lost = lfLessThanHalf;
+  unsigned FractionBits = -Value.Exponent;
+  if (FractionBits < 128) {
+    unsigned __int128 Unit = (unsigned __int128)1 << FractionBits;
+    Integer = Value.Significand >> FractionBits;
+    unsigned __int128 Fraction = Value.Significand & (Unit - 1);
+    if (!Fraction)
+      Lost = lfExactlyZero;
+    else if (Fraction == Unit / 2)
+      Lost = lfExactlyHalf;
+    else if (Fraction > Unit / 2)
+      Lost = lfMoreThanHalf;
+  }
+  if (Lost == lfExactlyZero) {
+    Value.Significand = Integer;
+    Value.Exponent = 0;
+    return false;
+  }
+
+  bool AwayFromZero;
+  switch (RM) {
+  case APFloat::rmNearestTiesToAway:
+    AwayFromZero = Lost == lfExactlyHalf || Lost == lfMoreThanHalf;
+    break;
+  case APFloat::rmNearestTiesToEven:
+    AwayFromZero =
+        Lost == lfMoreThanHalf || (Lost == lfExactlyHalf && (Integer & 1));
+    break;
+  case APFloat::rmTowardZero:
+    AwayFromZero = false;
+    break;
+  case APFloat::rmTowardPositive:
+    AwayFromZero = !Value.Negative;
+    break;
+  case APFloat::rmTowardNegative:
+    AwayFromZero = Value.Negative;
+    break;
+  default:
+    bijou_unreachable("Invalid rounding mode found");
+  }
+  Value.Significand = Integer + AwayFromZero;
+  Value.Exponent = 0;
+  return true;
+}
+
 APFloat::opStatus DoubleAPFloat::divide(const DoubleAPFloat &RHS,
                                         APFloat::roundingMode RM) {
-  assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy, bitcastToAPInt());
-  auto Ret =
-      Tmp.divide(APFloat(semPPCDoubleDoubleLegacy, RHS.bitcastToAPInt()), RM);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  IEEEFloat Tmp = toLegacy();
+  auto Ret = Tmp.divide(RHS.toLegacy(), RM);
+  assignLegacy(Tmp);
   return Ret;
 }
 
 APFloat::opStatus DoubleAPFloat::remainder(const DoubleAPFloat &RHS) {
-  assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy, bitcastToAPInt());
-  auto Ret =
-      Tmp.remainder(APFloat(semPPCDoubleDoubleLegacy, RHS.bitcastToAPInt()));
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  IEEEFloat Tmp = toLegacy();
+  auto Ret = Tmp.remainder(RHS.toLegacy());
+  assignLegacy(Tmp);
   return Ret;
 }
 
 APFloat::opStatus DoubleAPFloat::mod(const DoubleAPFloat &RHS) {
-  assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy, bitcastToAPInt());
-  auto Ret = Tmp.mod(APFloat(semPPCDoubleDoubleLegacy, RHS.bitcastToAPInt()));
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  IEEEFloat Tmp = toLegacy();
+  auto Ret = Tmp.mod(RHS.toLegacy());
+  assignLegacy(Tmp);
   return Ret;
 }
 
@@ -4678,20 +6607,34 @@ APFloat::opStatus
 DoubleAPFloat::fusedMultiplyAdd(const DoubleAPFloat &Multiplicand,
                                 const DoubleAPFloat &Addend,
                                 APFloat::roundingMode RM) {
-  assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy, bitcastToAPInt());
-  auto Ret = Tmp.fusedMultiplyAdd(
-      APFloat(semPPCDoubleDoubleLegacy, Multiplicand.bitcastToAPInt()),
-      APFloat(semPPCDoubleDoubleLegacy, Addend.bitcastToAPInt()), RM);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  IEEEFloat Tmp = toLegacy();
+  auto Ret =
+      Tmp.fusedMultiplyAdd(Multiplicand.toLegacy(), Addend.toLegacy(), RM);
+  assignLegacy(Tmp);
   return Ret;
 }
 
 APFloat::opStatus DoubleAPFloat::roundToIntegral(APFloat::roundingMode RM) {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy, bitcastToAPInt());
+  if (getCategory() == fcZero || getCategory() == fcInfinity) {
+    Floats[1].makeZero(/* Neg = */ false);
+    return opOK;
+  }
+  PairValue Value;
+  uint64_t HiBits, LoBits;
+  if (getCategory() == fcNormal &&
+      unpackLegacyPair(doubleBits(Floats[0]), doubleBits(Floats[1]), Value)) {
+    bool Inexact = roundPairValueToIntegral(Value, RM);
+    if (packLegacyPair(Value, HiBits, LoBits)) {
+      Floats[0] = doubleFromBits(HiBits);
+      Floats[1] = doubleFromBits(LoBits);
+      return Inexact ? opInexact : opOK;
+    }
+  }
+
+  IEEEFloat Tmp = toLegacy();
   auto Ret = Tmp.roundToIntegral(RM);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  assignLegacy(Tmp);
   return Ret;
 }
 
@@ -4789,17 +6732,53 @@ APInt DoubleAPFloat::bitcastToAPInt() const {
 Expected<APFloat::opStatus> DoubleAPFloat::convertFromString(std::string_view S,
                                                              roundingMode RM) {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy);
+  IEEEFloat Tmp(semPPCDoubleDoubleLegacy);
   auto Ret = Tmp.convertFromString(S, RM);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  assignLegacy(Tmp);
   return Ret;
 }
 
 APFloat::opStatus DoubleAPFloat::next(bool nextDown) {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy, bitcastToAPInt());
+  if (getCategory() == fcZero) {
+    // nextUp(pm 0) = +getSmallest()
+    Floats[0].makeSmallest(/* Neg = */ nextDown);
+    Floats[1].makeZero(/* Neg = */ false);
+    return opOK;
+  }
+
+  PairValue Value;
+  uint64_t HiBits, LoBits;
+  if (getCategory() == fcNormal &&
+      unpackLegacyPair(doubleBits(Floats[0]), doubleBits(Floats[1]), Value)) {
+    // Count in ulps of the legacy value, which are halved going toward zero
+    // from a power of two above the denormals.
+    const int Precision = semPPCDoubleDoubleLegacy.precision;
+    const int MinExponent = semPPCDoubleDoubleLegacy.minExponent;
+    int TopExponent = Value.Exponent + significantBits(Value) - 1;
+    int UlpExponent = std::max(TopExponent, MinExponent) - Precision + 1;
+    Value.Significand <<= Value.Exponent - UlpExponent;
+    Value.Exponent = UlpExponent;
+    const unsigned __int128 PowerOfTwo = (unsigned __int128)1
+                                         << (Precision - 1);
+    if (nextDown == Value.Negative) {
+      Value.Significand++;
+    } else if (Value.Significand == PowerOfTwo && TopExponent > MinExponent) {
+      Value.Significand = 2 * PowerOfTwo - 1;
+      Value.Exponent--;
+    } else {
+      Value.Significand--;
+    }
+    if (packLegacyPair(Value, HiBits, LoBits)) {
+      Floats[0] = doubleFromBits(HiBits);
+      Floats[1] = doubleFromBits(LoBits);
+      return opOK;
+    }
+  }
+
+  IEEEFloat Tmp = toLegacy();
   auto Ret = Tmp.next(nextDown);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  assignLegacy(Tmp);
   return Ret;
 }
 
@@ -4808,17 +6787,58 @@ DoubleAPFloat::convertToInteger(std::span<integerPart> Input,
                                 unsigned int Width, bool IsSigned,
                                 roundingMode RM, bool *IsExact) const {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  return APFloat(semPPCDoubleDoubleLegacy, bitcastToAPInt())
-      .convertToInteger(Input, Width, IsSigned, RM, IsExact);
+  // Without a second double the value is the first one.
+  if (getCategory() != fcNormal || Floats[1].isZero())
+    return Floats[0].convertToInteger(Input, Width, IsSigned, RM, IsExact);
+
+  PairValue Value;
+  if (unpackLegacyPair(doubleBits(Floats[0]), doubleBits(Floats[1]), Value)) {
+    // As IEEEFloat::convertToSignExtendedInteger on the legacy value.
+    bool Inexact = roundPairValueToIntegral(Value, RM);
+    unsigned DstPartsCount = partCountForBits(Width);
+    assert(DstPartsCount <= Input.size() && "Integer too big");
+    unsigned Bits = Value.Significand ? Value.Exponent + significantBits(Value)
+                                      : 0;
+    bool Valid;
+    if (Value.Negative)
+      Valid = IsSigned ? Bits < Width ||
+                             (Bits == Width &&
+                              !(Value.Significand & (Value.Significand - 1)))
+                       : Bits == 0;
+    else
+      Valid = Bits < Width + !IsSigned;
+
+    integerPart *Parts = Input.data();
+    if (!Valid) {
+      // As IEEEFloat::convertToInteger, saturate.
+      tcSetLeastSignificantBits(Parts, DstPartsCount,
+                                Value.Negative ? IsSigned : Width - IsSigned);
+      if (Value.Negative && IsSigned)
+        APInt::tcShiftLeft(Parts, DstPartsCount, Width - 1);
+      *IsExact = false;
+      return opInvalidOp;
+    }
+    APInt::tcSet(Parts, 0, DstPartsCount);
+    Parts[0] = uint64_t(Value.Significand);
+    if (DstPartsCount > 1)
+      Parts[1] = uint64_t(Value.Significand >> 64);
+    APInt::tcShiftLeft(Parts, DstPartsCount, Value.Exponent);
+    if (Value.Negative)
+      APInt::tcNegate(Parts, DstPartsCount);
+    *IsExact = !Inexact;
+    return Inexact ? opInexact : opOK;
+  }
+
+  return toLegacy().convertToInteger(Input, Width, IsSigned, RM, IsExact);
 }
 
 APFloat::opStatus DoubleAPFloat::convertFromAPInt(const APInt &Input,
                                                   bool IsSigned,
                                                   roundingMode RM) {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy);
+  IEEEFloat Tmp(semPPCDoubleDoubleLegacy);
   auto Ret = Tmp.convertFromAPInt(Input, IsSigned, RM);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  assignLegacy(Tmp);
   return Ret;
 }
 
@@ -4827,9 +6847,9 @@ DoubleAPFloat::convertFromSignExtendedInteger(const integerPart *Input,
                                               unsigned int InputSize,
                                               bool IsSigned, roundingMode RM) {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy);
+  IEEEFloat Tmp(semPPCDoubleDoubleLegacy);
   auto Ret = Tmp.convertFromSignExtendedInteger(Input, InputSize, IsSigned, RM);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  assignLegacy(Tmp);
   return Ret;
 }
 
@@ -4838,9 +6858,9 @@ DoubleAPFloat::convertFromZeroExtendedInteger(const integerPart *Input,
                                               unsigned int InputSize,
                                               bool IsSigned, roundingMode RM) {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat Tmp(semPPCDoubleDoubleLegacy);
+  IEEEFloat Tmp(semPPCDoubleDoubleLegacy);
   auto Ret = Tmp.convertFromZeroExtendedInteger(Input, InputSize, IsSigned, RM);
-  *this = DoubleAPFloat(semPPCDoubleDouble, Tmp.bitcastToAPInt());
+  assignLegacy(Tmp);
   return Ret;
 }
 
@@ -4849,8 +6869,7 @@ unsigned int DoubleAPFloat::convertToHexString(char *DST,
                                                bool UpperCase,
                                                roundingMode RM) const {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  return APFloat(semPPCDoubleDoubleLegacy, bitcastToAPInt())
-      .convertToHexString(DST, HexDigits, UpperCase, RM);
+  return toLegacy().convertToHexString(DST, HexDigits, UpperCase, RM);
 }
 
 bool DoubleAPFloat::isDenormal() const {
@@ -4886,8 +6905,16 @@ void DoubleAPFloat::toString(std::string &Str,
                              unsigned FormatMaxPadding,
                              bool TruncateZero) const {
   assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
-  APFloat(semPPCDoubleDoubleLegacy, bitcastToAPInt())
-      .toString(Str, FormatPrecision, FormatMaxPadding, TruncateZero);
+  toLegacy().toString(Str, FormatPrecision, FormatMaxPadding, TruncateZero);
+}
+
+std::to_chars_result DoubleAPFloat::toChars(char *First, char *Last,
+                                            unsigned FormatPrecision,
+                                            unsigned FormatMaxPadding,
+                                            bool TruncateZero) const {
+  assert(Semantics == &semPPCDoubleDouble && "Unexpected Semantics");
+  return toLegacy().toChars(First, Last, FormatPrecision, FormatMaxPadding,
+                            TruncateZero);
 }
 
 bool DoubleAPFloat::getExactInverse(APFloat *inv) const {
@@ -4947,6 +6974,113 @@ APFloat::APFloat(const fltSemantics &Semantics, std::string_view S)
   consumeError(StatusOrErr.takeError());
 }
 
+unsigned APFloat::getMaxChars(const fltSemantics &Sem,
+                               unsigned FormatPrecision,
+                               unsigned FormatMaxPadding) {
+  // Double-double values are formatted with the legacy semantics.
+  const fltSemantics &Format =
+      &Sem == &semPPCDoubleDouble ? semPPCDoubleDoubleLegacy : Sem;
+  // Digits, padding zeros, sign, point, and an exponent of at most five
+  // digits with its marker and sign.
+  if (!FormatPrecision)
+    FormatPrecision = 2 + Format.precision * 59 / 196;
+  return FormatPrecision + FormatMaxPadding + 16;
+}
+
+/// @returns the end of the longest prefix of [First, Last) that has the shape
+/// of a number accepted by convertFromString, or First if there is none.
+static const char *scanFloat(const char *First, const char *Last) {
+  auto IsDigit = [](char C) { return C >= '0' && C <= '9'; };
+  auto IsHexDigit = [&](char C) {
+    return IsDigit(C) || (C >= 'a' && C <= 'f') || (C >= 'A' && C <= 'F');
+  };
+  auto SkipWhile = [&](const char *P, auto Pred) {
+    while (P != Last && Pred(*P))
+      ++P;
+    return P;
+  };
+  // Skips an optionally signed exponent after its marker, returning P if
+  // there are no exponent digits.
+  auto SkipExponent = [&](const char *P) {
+    const char *Q = P + 1;
+    if (Q != Last && (*Q == '+' || *Q == '-'))
+      ++Q;
+    const char *End = SkipWhile(Q, IsDigit);
+    return End == Q ? P : End;
+  };
+
+  const char *P = First;
+  if (P != Last && (*P == '-' || *P == '+'))
+    ++P;
+  if (P == Last)
+    return First;
+
+  // Infinities and NaNs, with an optional parenthesized NaN payload.
+  if (isalpha(static_cast<unsigned char>(*P))) {
+    P = SkipWhile(P, [](char C) {
+      return isalnum(static_cast<unsigned char>(C)) != 0;
+    });
+    if (P != Last && *P == '(') {
+      const char *Close = std::find(P, Last, ')');
+      if (Close != Last)
+        P = Close + 1;
+    }
+    return P;
+  }
+
+  // Hexadecimal numbers need a binary exponent; without one, only the
+  // leading zero is a number.
+  if (Last - P > 2 && P[0] == '0' && (P[1] == 'x' || P[1] == 'X')) {
+    const char *Digits = P + 2;
+    const char *Q = SkipWhile(Digits, IsHexDigit);
+    bool HasDigits = Q != Digits;
+    if (Q != Last && *Q == '.') {
+      const char *Fraction = Q + 1;
+      Q = SkipWhile(Fraction, IsHexDigit);
+      HasDigits |= Q != Fraction;
+    }
+    if (HasDigits && Q != Last && (*Q == 'p' || *Q == 'P')) {
+      const char *End = SkipExponent(Q);
+      if (End != Q)
+        return End;
+    }
+  }
+
+  const char *Q = SkipWhile(P, IsDigit);
+  bool HasDigits = Q != P;
+  if (Q != Last && *Q == '.') {
+    const char *Fraction = Q + 1;
+    Q = SkipWhile(Fraction, IsDigit);
+    HasDigits |= Q != Fraction;
+  }
+  if (!HasDigits)
+    return First;
+  if (Q != Last && (*Q == 'e' || *Q == 'E'))
+    Q = SkipExponent(Q);
+  return Q;
+}
+
+std::from_chars_result APFloat::fromChars(const char *First, const char *Last,
+                                          roundingMode RM) {
+  const char *End = scanFloat(First, Last);
+  if (End == First)
+    return {First, std::errc::invalid_argument};
+
+  APFloat Result(getSemantics());
+  auto StatusOrErr =
+      Result.convertFromString(std::string_view(First, End - First), RM);
+  if (!StatusOrErr) {
+    consumeError(StatusOrErr.takeError());
+    return {First, std::errc::invalid_argument};
+  }
+  if ((*StatusOrErr & opOverflow) ||
+      ((*StatusOrErr & opUnderflow) && Result.isZero()))
+    return {End, std::errc::result_out_of_range};
+
+  *this = std::move(Result);
+  return {End, std::errc()};
+}
+
 APFloat::opStatus APFloat::convert(const fltSemantics &ToSemantics,
                                    roundingMode RM, bool *losesInfo) {
   if (&getSemantics() == &ToSemantics) {
@@ -4979,16 +7113,28 @@ APFloat APFloat::getAllOnesValue(const fltSemantics &Semantics,
 
 #ifdef AP_USE_IOSTREAM
 void APFloat::print(std::iostream &OS) const {
-  std::string Buffer;
-  toString(Buffer);
-  OS << Buffer << "\n";
+  char Buffer[64];
+  std::to_chars_result Result = toChars(Buffer, std::end(Buffer));
+  if (Result.ec == std::errc()) {
+    OS << std::string_view(Buffer, Result.ptr - Buffer) << "\n";
+    return;
+  }
+  std::string Str;
+  toString(Str);
+  OS << Str << "\n";
 }
 #endif
 
 void APFloat::print(FILE *O) const {
-  std::string Buffer;
-  toString(Buffer);
-  fprintf(O, "%s\n", Buffer.c_str());
+  char Buffer[64];
+  std::to_chars_result Result = toChars(Buffer, std::end(Buffer));
+  if (Result.ec == std::errc()) {
+    fprintf(O, "%.*s\n", int(Result.ptr - Buffer), Buffer);
+    return;
+  }
+  std::string Str;
+  toString(Str);
+  fprintf(O, "%s\n", Str.c_str());
 }
 
 BIJOU_DUMP_METHOD void APFloat::dump() const {
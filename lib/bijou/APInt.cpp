@@ -13,6 +13,24 @@
 //   * Removed unused LLVM helper APIs (such as FoldingSetNode, DenseMap)
 //   * Added APIs to print classes defined in this file with C stdio routines.
 //   * Changed doxygen comments to consistenly use '@' command prefix.
+//   * Store multi-word values of up to BIJOU_APINT_INLINE_WORDS words inline.
+//   * Added Karatsuba and Toom-3 multiplication for wide values.
+//   * Convert to radix 10 and 36 a word of digits at a time, and by
+//     divide-and-conquer for wide values, dividing with APIntDivider.
+//   * Parse radix 10 and 36 a word of digits at a time, with SWAR for eight
+//     decimal digits, and by divide-and-conquer for long strings. Place the
+//     digits of power of two radices directly.
+//   * Allocate word buffers with allocateWords, which can pool them per thread.
+//   * Made APInt usable in constant expressions, with transient allocation for
+//     values wider than the inline words.
+//   * Run the word-wise bitwise, population count and comparison slow cases
+//     with AVX2 or AVX-512 kernels, selected by the host CPU at run time.
+//   * Run the carry chains of tcAdd, tcSubtract and tcMultiplyPart with
+//     out-of-line kernels, using MULX, ADCX and ADOX if the host CPU has them.
+//   * Added sqr() and tcSquare, which compute each cross product once, and
+//     square with Karatsuba's and the Toom-3 algorithm.
+//   * Added toChars and fromChars, which convert to and from caller provided
+//     character buffers, and implement toString with toChars.
 //
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
@@ -25,39 +43,37 @@
 ///
 
 #include "bijou/APInt.hpp"
+#include "bijou/APIntDivider.hpp"     // for APIntDivider
 #include <algorithm>                // for std::equal, std::min,  std::reverse
 #include <bit>                      // std::for bit_cast, std::endian
 #include <cmath>                    // for round, sqrt
 #include <cstddef>                  // for std::size_t
 #include <cstring>                  // for memset, memcpy, memmove
+#include <deque>                    // for std::deque
 #include <iterator>                 // for std::end
 #include <limits>                   // for std::numeric_limits
+#include <mutex>                    // for std::mutex, std::lock_guard
 #include <span>                     // for std::span
 #include <string_view>              // for std::string_view
+#include <vector>                   // for std::vector
 #include "bijou/Error.hpp"          // for bijou_unreachable
 #include "bijou/Hashing.hpp"        // for hash_combine, hash_combine_range
+#include "bijou/WordAllocator.hpp"  // for ScratchWords
 #include "bijou/MathExtras.hpp"     // for Lo_32, SignExtend64, Hi_32, Make_64
 #include "bijou/SwapByteOrder.hpp"  // for ByteSwap_64, ByteSwap_16, ByteSwa...
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BIJOU_HAS_X86_KERNELS 1
+#include <immintrin.h>              // for _mm256_*, _mm512_*, _addcarry_u64
+#else
+#define BIJOU_HAS_X86_KERNELS 0
+#endif
+
 using namespace bijou;
 
 #define BIJOU_DEBUG(EXPR) static_cast<void>(0)
 #define DEBUG_TYPE "apint"
 
-/// A utility function for allocating memory, checking for allocation failures,
-/// and ensuring the contents are zeroed.
-inline static uint64_t* getClearedMemory(unsigned numWords) {
-  uint64_t *result = new uint64_t[numWords];
-  memset(result, 0, numWords * sizeof(uint64_t));
-  return result;
-}
-
-/// A utility function for allocating memory and checking for allocation
-/// failure.  The content is not zeroed.
-inline static uint64_t* getMemory(unsigned numWords) {
-  return new uint64_t[numWords];
-}
-
 /// A utility function that converts a character to a digit.
 inline static unsigned getDigit(char cdigit, uint8_t radix) {
   unsigned r;
@@ -86,257 +102,11 @@ inline static unsigned getDigit(char cdigit, uint8_t radix) {
 }
 
 
-void APInt::initSlowCase(uint64_t val, bool isSigned) {
-  U.pVal = getClearedMemory(getNumWords());
-  U.pVal[0] = val;
-  if (isSigned && int64_t(val) < 0)
-    for (unsigned i = 1; i < getNumWords(); ++i)
-      U.pVal[i] = WORDTYPE_MAX;
-  clearUnusedBits();
-}
-
-void APInt::initSlowCase(const APInt& that) {
-  U.pVal = getMemory(getNumWords());
-  memcpy(U.pVal, that.U.pVal, getNumWords() * APINT_WORD_SIZE);
-}
-
-void APInt::initFromArray(std::span<const uint64_t> bigVal) {
-  assert(bigVal.data() && "Null pointer detected!");
-  if (isSingleWord())
-    U.VAL = bigVal[0];
-  else {
-    // Get memory, cleared to 0
-    U.pVal = getClearedMemory(getNumWords());
-    // Calculate the number of words to copy
-    unsigned words = std::min<unsigned>(bigVal.size(), getNumWords());
-    // Copy the words from bigVal to pVal
-    memcpy(U.pVal, bigVal.data(), words * APINT_WORD_SIZE);
-  }
-  // Make sure unused high bits are cleared
-  clearUnusedBits();
-}
-
-APInt::APInt(unsigned numBits, std::span<const uint64_t> bigVal) : BitWidth(numBits) {
-  initFromArray(bigVal);
-}
-
-APInt::APInt(unsigned numBits, unsigned numWords, const uint64_t bigVal[])
-    : BitWidth(numBits) {
-  initFromArray(std::span(bigVal, numWords));
-}
-
 APInt::APInt(unsigned numbits, std::string_view Str, uint8_t radix)
     : BitWidth(numbits) {
   fromString(numbits, Str, radix);
 }
 
-void APInt::reallocate(unsigned NewBitWidth) {
-  // If the number of words is the same we can just change the width and stop.
-  if (getNumWords() == getNumWords(NewBitWidth)) {
-    BitWidth = NewBitWidth;
-    return;
-  }
-
-  // If we have an allocation, delete it.
-  if (!isSingleWord())
-    delete [] U.pVal;
-
-  // Update BitWidth.
-  BitWidth = NewBitWidth;
-
-  // If we are supposed to have an allocation, create it.
-  if (!isSingleWord())
-    U.pVal = getMemory(getNumWords());
-}
-
-void APInt::assignSlowCase(const APInt &RHS) {
-  // Don't do anything for X = X
-  if (this == &RHS)
-    return;
-
-  // Adjust the bit width and handle allocations as necessary.
-  reallocate(RHS.getBitWidth());
-
-  // Copy the data.
-  if (isSingleWord())
-    U.VAL = RHS.U.VAL;
-  else
-    memcpy(U.pVal, RHS.U.pVal, getNumWords() * APINT_WORD_SIZE);
-}
-
-/// Prefix increment operator. Increments the APInt by one.
-APInt& APInt::operator++() {
-  if (isSingleWord())
-    ++U.VAL;
-  else
-    tcIncrement(U.pVal, getNumWords());
-  return clearUnusedBits();
-}
-
-/// Prefix decrement operator. Decrements the APInt by one.
-APInt& APInt::operator--() {
-  if (isSingleWord())
-    --U.VAL;
-  else
-    tcDecrement(U.pVal, getNumWords());
-  return clearUnusedBits();
-}
-
-/// Adds the RHS APInt to this APInt.
-/// @returns this, after addition of RHS.
-/// Addition assignment operator.
-APInt& APInt::operator+=(const APInt& RHS) {
-  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
-  if (isSingleWord())
-    U.VAL += RHS.U.VAL;
-  else
-    tcAdd(U.pVal, RHS.U.pVal, 0, getNumWords());
-  return clearUnusedBits();
-}
-
-APInt& APInt::operator+=(uint64_t RHS) {
-  if (isSingleWord())
-    U.VAL += RHS;
-  else
-    tcAddPart(U.pVal, RHS, getNumWords());
-  return clearUnusedBits();
-}
-
-/// Subtracts the RHS APInt from this APInt
-/// @returns this, after subtraction
-/// Subtraction assignment operator.
-APInt& APInt::operator-=(const APInt& RHS) {
-  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
-  if (isSingleWord())
-    U.VAL -= RHS.U.VAL;
-  else
-    tcSubtract(U.pVal, RHS.U.pVal, 0, getNumWords());
-  return clearUnusedBits();
-}
-
-APInt& APInt::operator-=(uint64_t RHS) {
-  if (isSingleWord())
-    U.VAL -= RHS;
-  else
-    tcSubtractPart(U.pVal, RHS, getNumWords());
-  return clearUnusedBits();
-}
-
-APInt APInt::operator*(const APInt& RHS) const {
-  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
-  if (isSingleWord())
-    return APInt(BitWidth, U.VAL * RHS.U.VAL);
-
-  APInt Result(getMemory(getNumWords()), getBitWidth());
-  tcMultiply(Result.U.pVal, U.pVal, RHS.U.pVal, getNumWords());
-  Result.clearUnusedBits();
-  return Result;
-}
-
-void APInt::andAssignSlowCase(const APInt &RHS) {
-  WordType *dst = U.pVal, *rhs = RHS.U.pVal;
-  for (size_t i = 0, e = getNumWords(); i != e; ++i)
-    dst[i] &= rhs[i];
-}
-
-void APInt::orAssignSlowCase(const APInt &RHS) {
-  WordType *dst = U.pVal, *rhs = RHS.U.pVal;
-  for (size_t i = 0, e = getNumWords(); i != e; ++i)
-    dst[i] |= rhs[i];
-}
-
-void APInt::xorAssignSlowCase(const APInt &RHS) {
-  WordType *dst = U.pVal, *rhs = RHS.U.pVal;
-  for (size_t i = 0, e = getNumWords(); i != e; ++i)
-    dst[i] ^= rhs[i];
-}
-
-APInt &APInt::operator*=(const APInt &RHS) {
-  *this = *this * RHS;
-  return *this;
-}
-
-APInt& APInt::operator*=(uint64_t RHS) {
-  if (isSingleWord()) {
-    U.VAL *= RHS;
-  } else {
-    unsigned NumWords = getNumWords();
-    tcMultiplyPart(U.pVal, U.pVal, RHS, 0, NumWords, NumWords, false);
-  }
-  return clearUnusedBits();
-}
-
-bool APInt::equalSlowCase(const APInt &RHS) const {
-  return std::equal(U.pVal, U.pVal + getNumWords(), RHS.U.pVal);
-}
-
-int APInt::compare(const APInt& RHS) const {
-  assert(BitWidth == RHS.BitWidth && "Bit widths must be same for comparison");
-  if (isSingleWord())
-    return U.VAL < RHS.U.VAL ? -1 : U.VAL > RHS.U.VAL;
-
-  return tcCompare(U.pVal, RHS.U.pVal, getNumWords());
-}
-
-int APInt::compareSigned(const APInt& RHS) const {
-  assert(BitWidth == RHS.BitWidth && "Bit widths must be same for comparison");
-  if (isSingleWord()) {
-    int64_t lhsSext = SignExtend64(U.VAL, BitWidth);
-    int64_t rhsSext = SignExtend64(RHS.U.VAL, BitWidth);
-    return lhsSext < rhsSext ? -1 : lhsSext > rhsSext;
-  }
-
-  bool lhsNeg = isNegative();
-  bool rhsNeg = RHS.isNegative();
-
-  // If the sign bits don't match, then (LHS < RHS) if LHS is negative
-  if (lhsNeg != rhsNeg)
-    return lhsNeg ? -1 : 1;
-
-  // Otherwise we can just use an unsigned comparison, because even negative
-  // numbers compare correctly this way if both have the same signed-ness.
-  return tcCompare(U.pVal, RHS.U.pVal, getNumWords());
-}
-
-void APInt::setBitsSlowCase(unsigned loBit, unsigned hiBit) {
-  unsigned loWord = whichWord(loBit);
-  unsigned hiWord = whichWord(hiBit);
-
-  // Create an initial mask for the low word with zeros below loBit.
-  uint64_t loMask = WORDTYPE_MAX << whichBit(loBit);
-
-  // If hiBit is not aligned, we need a high mask.
-  unsigned hiShiftAmt = whichBit(hiBit);
-  if (hiShiftAmt != 0) {
-    // Create a high mask with zeros above hiBit.
-    uint64_t hiMask = WORDTYPE_MAX >> (APINT_BITS_PER_WORD - hiShiftAmt);
-    // If loWord and hiWord are equal, then we combine the masks. Otherwise,
-    // set the bits in hiWord.
-    if (hiWord == loWord)
-      loMask &= hiMask;
-    else
-      U.pVal[hiWord] |= hiMask;
-  }
-  // Apply the mask to the low word.
-  U.pVal[loWord] |= loMask;
-
-  // Fill any words between loWord and hiWord with all ones.
-  for (unsigned word = loWord + 1; word < hiWord; ++word)
-    U.pVal[word] = WORDTYPE_MAX;
-}
-
-// Complement a bignum in-place.
-static void tcComplement(APInt::WordType *dst, unsigned parts) {
-  for (unsigned i = 0; i < parts; i++)
-    dst[i] = ~dst[i];
-}
-
-/// Toggle every bit to its opposite value.
-void APInt::flipAllBitsSlowCase() {
-  tcComplement(U.pVal, getNumWords());
-  clearUnusedBits();
-}
-
 /// Concatenate the bits from "NewLSB" onto the bottom of *this.  This is
 /// equivalent to:
 ///   (this->zext(NewWidth) << NewLSB.getBitWidth()) | NewLSB.zext(NewWidth)
@@ -348,14 +118,6 @@ APInt APInt::concatSlowCase(const APInt &NewLSB) const {
   return Result;
 }
 
-/// Toggle a given bit to its opposite value whose position is given
-/// as "bitPosition".
-/// Toggles a given bit to its opposite value.
-void APInt::flipBit(unsigned bitPosition) {
-  assert(bitPosition < BitWidth && "Out of the bit-width range!");
-  setBitVal(bitPosition, !(*this)[bitPosition]);
-}
-
 void APInt::insertBits(const APInt &subBits, unsigned bitPosition) {
   unsigned subBitWidth = subBits.getBitWidth();
   assert(0 < subBitWidth && (subBitWidth + bitPosition) <= BitWidth &&
@@ -375,6 +137,7 @@ void APInt::insertBits(const APInt &subBits, unsigned bitPosition) {
     return;
   }
 
+  uint64_t *Words = getWords();
   unsigned loBit = whichBit(bitPosition);
   unsigned loWord = whichWord(bitPosition);
   unsigned hi1Word = whichWord(bitPosition + subBitWidth - 1);
@@ -382,8 +145,8 @@ void APInt::insertBits(const APInt &subBits, unsigned bitPosition) {
   // Insertion within a single word can be done as a direct bitmask.
   if (loWord == hi1Word) {
     uint64_t mask = WORDTYPE_MAX >> (APINT_BITS_PER_WORD - subBitWidth);
-    U.pVal[loWord] &= ~(mask << loBit);
-    U.pVal[loWord] |= (subBits.U.VAL << loBit);
+    Words[loWord] &= ~(mask << loBit);
+    Words[loWord] |= (subBits.U.VAL << loBit);
     return;
   }
 
@@ -391,15 +154,15 @@ void APInt::insertBits(const APInt &subBits, unsigned bitPosition) {
   if (loBit == 0) {
     // Direct copy whole words.
     unsigned numWholeSubWords = subBitWidth / APINT_BITS_PER_WORD;
-    memcpy(U.pVal + loWord, subBits.getRawData(),
+    memcpy(Words + loWord, subBits.getRawData(),
            numWholeSubWords * APINT_WORD_SIZE);
 
     // Mask+insert remaining bits.
     unsigned remainingBits = subBitWidth % APINT_BITS_PER_WORD;
     if (remainingBits != 0) {
       uint64_t mask = WORDTYPE_MAX >> (APINT_BITS_PER_WORD - remainingBits);
-      U.pVal[hi1Word] &= ~mask;
-      U.pVal[hi1Word] |= subBits.getWord(subBitWidth - 1);
+      Words[hi1Word] &= ~mask;
+      Words[hi1Word] |= subBits.getWord(subBitWidth - 1);
     }
     return;
   }
@@ -420,22 +183,23 @@ void APInt::insertBits(uint64_t subBits, unsigned bitPosition, unsigned numBits)
     return;
   }
 
+  uint64_t *Words = getWords();
   unsigned loBit = whichBit(bitPosition);
   unsigned loWord = whichWord(bitPosition);
   unsigned hiWord = whichWord(bitPosition + numBits - 1);
   if (loWord == hiWord) {
-    U.pVal[loWord] &= ~(maskBits << loBit);
-    U.pVal[loWord] |= subBits << loBit;
+    Words[loWord] &= ~(maskBits << loBit);
+    Words[loWord] |= subBits << loBit;
     return;
   }
 
   static_assert(8 * sizeof(WordType) <= 64, "This code assumes only two words affected");
   unsigned wordBits = 8 * sizeof(WordType);
-  U.pVal[loWord] &= ~(maskBits << loBit);
-  U.pVal[loWord] |= subBits << loBit;
+  Words[loWord] &= ~(maskBits << loBit);
+  Words[loWord] |= subBits << loBit;
 
-  U.pVal[hiWord] &= ~(maskBits >> (wordBits - loBit));
-  U.pVal[hiWord] |= subBits >> (wordBits - loBit);
+  Words[hiWord] &= ~(maskBits >> (wordBits - loBit));
+  Words[hiWord] |= subBits >> (wordBits - loBit);
 }
 
 APInt APInt::extractBits(unsigned numBits, unsigned bitPosition) const {
@@ -446,29 +210,30 @@ APInt APInt::extractBits(unsigned numBits, unsigned bitPosition) const {
   if (isSingleWord())
     return APInt(numBits, U.VAL >> bitPosition);
 
+  const uint64_t *Words = getWords();
   unsigned loBit = whichBit(bitPosition);
   unsigned loWord = whichWord(bitPosition);
   unsigned hiWord = whichWord(bitPosition + numBits - 1);
 
   // Single word result extracting bits from a single word source.
   if (loWord == hiWord)
-    return APInt(numBits, U.pVal[loWord] >> loBit);
+    return APInt(numBits, Words[loWord] >> loBit);
 
   // Extracting bits that start on a source word boundary can be done
   // as a fast memory copy.
   if (loBit == 0)
-    return APInt(numBits, std::span(U.pVal + loWord, 1 + hiWord - loWord));
+    return APInt(numBits, std::span(Words + loWord, 1 + hiWord - loWord));
 
   // General case - shift + copy source words directly into place.
   APInt Result(numBits, 0);
   unsigned NumSrcWords = getNumWords();
   unsigned NumDstWords = Result.getNumWords();
 
-  uint64_t *DestPtr = Result.isSingleWord() ? &Result.U.VAL : Result.U.pVal;
+  uint64_t *DestPtr = Result.isSingleWord() ? &Result.U.VAL : Result.getWords();
   for (unsigned word = 0; word < NumDstWords; ++word) {
-    uint64_t w0 = U.pVal[loWord + word];
+    uint64_t w0 = Words[loWord + word];
     uint64_t w1 =
-        (loWord + word + 1) < NumSrcWords ? U.pVal[loWord + word + 1] : 0;
+        (loWord + word + 1) < NumSrcWords ? Words[loWord + word + 1] : 0;
     DestPtr[word] = (w0 >> loBit) | (w1 << (APINT_BITS_PER_WORD - loBit));
   }
 
@@ -486,16 +251,17 @@ uint64_t APInt::extractBitsAsZExtValue(unsigned numBits,
   if (isSingleWord())
     return (U.VAL >> bitPosition) & maskBits;
 
+  const uint64_t *Words = getWords();
   unsigned loBit = whichBit(bitPosition);
   unsigned loWord = whichWord(bitPosition);
   unsigned hiWord = whichWord(bitPosition + numBits - 1);
   if (loWord == hiWord)
-    return (U.pVal[loWord] >> loBit) & maskBits;
+    return (Words[loWord] >> loBit) & maskBits;
 
   static_assert(8 * sizeof(WordType) <= 64, "This code assumes only two words affected");
   unsigned wordBits = 8 * sizeof(WordType);
-  uint64_t retBits = U.pVal[loWord] >> loBit;
-  retBits |= U.pVal[hiWord] << (wordBits - loBit);
+  uint64_t retBits = Words[loWord] >> loBit;
+  retBits |= Words[hiWord] << (wordBits - loBit);
   retBits &= maskBits;
   return retBits;
 }
@@ -560,9 +326,9 @@ std::size_t std::hash<APInt>::operator()(const APInt &Arg) const {
   if (Arg.isSingleWord())
     return hash_combine(Arg.BitWidth, Arg.U.VAL);
 
-  return hash_combine(
-      Arg.BitWidth,
-      hash_combine_range(Arg.U.pVal, Arg.U.pVal + Arg.getNumWords()));
+  const uint64_t *Words = Arg.getWords();
+  return hash_combine(Arg.BitWidth,
+                      hash_combine_range(Words, Words + Arg.getNumWords()));
 }
 
 // unsigned DenseMapInfo<APInt>::getHashValue(const APInt &Key) {
@@ -577,18 +343,6 @@ bool APInt::isSplat(unsigned SplatSizeInBits) const {
   return *this == rotl(SplatSizeInBits);
 }
 
-/// This function returns the high "numBits" bits of this APInt.
-APInt APInt::getHiBits(unsigned numBits) const {
-  return this->lshr(BitWidth - numBits);
-}
-
-/// This function returns the low "numBits" bits of this APInt.
-APInt APInt::getLoBits(unsigned numBits) const {
-  APInt Result(getLowBitsSet(BitWidth, numBits));
-  Result &= *this;
-  return Result;
-}
-
 /// Return a value containing V broadcasted over NewLen bits.
 APInt APInt::getSplat(unsigned NewLen, const APInt &V) {
   assert(NewLen >= V.getBitWidth() && "Can't splat to smaller bit width!");
@@ -600,91 +354,6 @@ APInt APInt::getSplat(unsigned NewLen, const APInt &V) {
   return Val;
 }
 
-unsigned APInt::countLeadingZerosSlowCase() const {
-  unsigned Count = 0;
-  for (int i = getNumWords()-1; i >= 0; --i) {
-    uint64_t V = U.pVal[i];
-    if (V == 0)
-      Count += APINT_BITS_PER_WORD;
-    else {
-      Count += bijou::countLeadingZeros(V);
-      break;
-    }
-  }
-  // Adjust for unused bits in the most significant word (they are zero).
-  unsigned Mod = BitWidth % APINT_BITS_PER_WORD;
-  Count -= Mod > 0 ? APINT_BITS_PER_WORD - Mod : 0;
-  return Count;
-}
-
-unsigned APInt::countLeadingOnesSlowCase() const {
-  unsigned highWordBits = BitWidth % APINT_BITS_PER_WORD;
-  unsigned shift;
-  if (!highWordBits) {
-    highWordBits = APINT_BITS_PER_WORD;
-    shift = 0;
-  } else {
-    shift = APINT_BITS_PER_WORD - highWordBits;
-  }
-  int i = getNumWords() - 1;
-  unsigned Count = bijou::countLeadingOnes(U.pVal[i] << shift);
-  if (Count == highWordBits) {
-    for (i--; i >= 0; --i) {
-      if (U.pVal[i] == WORDTYPE_MAX)
-        Count += APINT_BITS_PER_WORD;
-      else {
-        Count += bijou::countLeadingOnes(U.pVal[i]);
-        break;
-      }
-    }
-  }
-  return Count;
-}
-
-unsigned APInt::countTrailingZerosSlowCase() const {
-  unsigned Count = 0;
-  unsigned i = 0;
-  for (; i < getNumWords() && U.pVal[i] == 0; ++i)
-    Count += APINT_BITS_PER_WORD;
-  if (i < getNumWords())
-    Count += bijou::countTrailingZeros(U.pVal[i]);
-  return std::min(Count, BitWidth);
-}
-
-unsigned APInt::countTrailingOnesSlowCase() const {
-  unsigned Count = 0;
-  unsigned i = 0;
-  for (; i < getNumWords() && U.pVal[i] == WORDTYPE_MAX; ++i)
-    Count += APINT_BITS_PER_WORD;
-  if (i < getNumWords())
-    Count += bijou::countTrailingOnes(U.pVal[i]);
-  assert(Count <= BitWidth);
-  return Count;
-}
-
-unsigned APInt::countPopulationSlowCase() const {
-  unsigned Count = 0;
-  for (unsigned i = 0; i < getNumWords(); ++i)
-    Count += bijou::countPopulation(U.pVal[i]);
-  return Count;
-}
-
-bool APInt::intersectsSlowCase(const APInt &RHS) const {
-  for (unsigned i = 0, e = getNumWords(); i != e; ++i)
-    if ((U.pVal[i] & RHS.U.pVal[i]) != 0)
-      return true;
-
-  return false;
-}
-
-bool APInt::isSubsetOfSlowCase(const APInt &RHS) const {
-  for (unsigned i = 0, e = getNumWords(); i != e; ++i)
-    if ((U.pVal[i] & ~RHS.U.pVal[i]) != 0)
-      return false;
-
-  return true;
-}
-
 APInt APInt::byteSwap() const {
   assert(BitWidth >= 16 && BitWidth % 8 == 0 && "Cannot byteswap!");
   if (BitWidth == 16)
@@ -698,8 +367,10 @@ APInt APInt::byteSwap() const {
   }
 
   APInt Result(getNumWords() * APINT_BITS_PER_WORD, 0);
+  uint64_t *Dst = Result.getWords();
+  const uint64_t *Src = getWords();
   for (unsigned I = 0, N = getNumWords(); I != N; ++I)
-    Result.U.pVal[I] = ByteSwap_64(U.pVal[N - I - 1]);
+    Dst[I] = ByteSwap_64(Src[N - I - 1]);
   if (Result.BitWidth != BitWidth) {
     Result.lshrInPlace(Result.BitWidth - BitWidth);
     Result.BitWidth = BitWidth;
@@ -857,15 +528,16 @@ double APInt::roundToDouble(bool isSigned) const {
   // Number of bits in mantissa is 52. To obtain the mantissa value, we must
   // extract the high 52 bits from the correct words in pVal.
   uint64_t mantissa;
+  const uint64_t *TmpWords = Tmp.getWords();
   unsigned hiWord = whichWord(n-1);
   if (hiWord == 0) {
-    mantissa = Tmp.U.pVal[0];
+    mantissa = TmpWords[0];
     if (n > 52)
       mantissa >>= n - 52; // shift down, we want the top 52 bits.
   } else {
     assert(hiWord > 0 && "huh?");
-    uint64_t hibits = Tmp.U.pVal[hiWord] << (52 - n % APINT_BITS_PER_WORD);
-    uint64_t lobits = Tmp.U.pVal[hiWord-1] >> (11 + n % APINT_BITS_PER_WORD);
+    uint64_t hibits = TmpWords[hiWord] << (52 - n % APINT_BITS_PER_WORD);
+    uint64_t lobits = TmpWords[hiWord-1] >> (11 + n % APINT_BITS_PER_WORD);
     mantissa = hibits | lobits;
   }
 
@@ -875,243 +547,6 @@ double APInt::roundToDouble(bool isSigned) const {
   return std::bit_cast<double>(I);
 }
 
-// Truncate to new width.
-APInt APInt::trunc(unsigned width) const {
-  assert(width < BitWidth && "Invalid APInt Truncate request");
-
-  if (width <= APINT_BITS_PER_WORD)
-    return APInt(width, getRawData()[0]);
-
-  APInt Result(getMemory(getNumWords(width)), width);
-
-  // Copy full words.
-  unsigned i;
-  for (i = 0; i != width / APINT_BITS_PER_WORD; i++)
-    Result.U.pVal[i] = U.pVal[i];
-
-  // Truncate and copy any partial word.
-  unsigned bits = (0 - width) % APINT_BITS_PER_WORD;
-  if (bits != 0)
-    Result.U.pVal[i] = U.pVal[i] << bits >> bits;
-
-  return Result;
-}
-
-// Truncate to new width with unsigned saturation.
-APInt APInt::truncUSat(unsigned width) const {
-  assert(width < BitWidth && "Invalid APInt Truncate request");
-
-  // Can we just losslessly truncate it?
-  if (isIntN(width))
-    return trunc(width);
-  // If not, then just return the new limit.
-  return APInt::getMaxValue(width);
-}
-
-// Truncate to new width with signed saturation.
-APInt APInt::truncSSat(unsigned width) const {
-  assert(width < BitWidth && "Invalid APInt Truncate request");
-
-  // Can we just losslessly truncate it?
-  if (isSignedIntN(width))
-    return trunc(width);
-  // If not, then just return the new limits.
-  return isNegative() ? APInt::getSignedMinValue(width)
-                      : APInt::getSignedMaxValue(width);
-}
-
-// Sign extend to a new width.
-APInt APInt::sext(unsigned Width) const {
-  assert(Width > BitWidth && "Invalid APInt SignExtend request");
-
-  if (Width <= APINT_BITS_PER_WORD)
-    return APInt(Width, SignExtend64(U.VAL, BitWidth));
-
-  APInt Result(getMemory(getNumWords(Width)), Width);
-
-  // Copy words.
-  std::memcpy(Result.U.pVal, getRawData(), getNumWords() * APINT_WORD_SIZE);
-
-  // Sign extend the last word since there may be unused bits in the input.
-  Result.U.pVal[getNumWords() - 1] =
-      SignExtend64(Result.U.pVal[getNumWords() - 1],
-                   ((BitWidth - 1) % APINT_BITS_PER_WORD) + 1);
-
-  // Fill with sign bits.
-  std::memset(Result.U.pVal + getNumWords(), isNegative() ? -1 : 0,
-              (Result.getNumWords() - getNumWords()) * APINT_WORD_SIZE);
-  Result.clearUnusedBits();
-  return Result;
-}
-
-//  Zero extend to a new width.
-APInt APInt::zext(unsigned width) const {
-  assert(width > BitWidth && "Invalid APInt ZeroExtend request");
-
-  if (width <= APINT_BITS_PER_WORD)
-    return APInt(width, U.VAL);
-
-  APInt Result(getMemory(getNumWords(width)), width);
-
-  // Copy words.
-  std::memcpy(Result.U.pVal, getRawData(), getNumWords() * APINT_WORD_SIZE);
-
-  // Zero remaining words.
-  std::memset(Result.U.pVal + getNumWords(), 0,
-              (Result.getNumWords() - getNumWords()) * APINT_WORD_SIZE);
-
-  return Result;
-}
-
-APInt APInt::zextOrTrunc(unsigned width) const {
-  if (BitWidth < width)
-    return zext(width);
-  if (BitWidth > width)
-    return trunc(width);
-  return *this;
-}
-
-APInt APInt::sextOrTrunc(unsigned width) const {
-  if (BitWidth < width)
-    return sext(width);
-  if (BitWidth > width)
-    return trunc(width);
-  return *this;
-}
-
-APInt APInt::truncOrSelf(unsigned width) const {
-  if (BitWidth > width)
-    return trunc(width);
-  return *this;
-}
-
-APInt APInt::zextOrSelf(unsigned width) const {
-  if (BitWidth < width)
-    return zext(width);
-  return *this;
-}
-
-APInt APInt::sextOrSelf(unsigned width) const {
-  if (BitWidth < width)
-    return sext(width);
-  return *this;
-}
-
-/// Arithmetic right-shift this APInt by shiftAmt.
-/// Arithmetic right-shift function.
-void APInt::ashrInPlace(const APInt &shiftAmt) {
-  ashrInPlace((unsigned)shiftAmt.getLimitedValue(BitWidth));
-}
-
-/// Arithmetic right-shift this APInt by shiftAmt.
-/// Arithmetic right-shift function.
-void APInt::ashrSlowCase(unsigned ShiftAmt) {
-  // Don't bother performing a no-op shift.
-  if (!ShiftAmt)
-    return;
-
-  // Save the original sign bit for later.
-  bool Negative = isNegative();
-
-  // WordShift is the inter-part shift; BitShift is intra-part shift.
-  unsigned WordShift = ShiftAmt / APINT_BITS_PER_WORD;
-  unsigned BitShift = ShiftAmt % APINT_BITS_PER_WORD;
-
-  unsigned WordsToMove = getNumWords() - WordShift;
-  if (WordsToMove != 0) {
-    // Sign extend the last word to fill in the unused bits.
-    U.pVal[getNumWords() - 1] = SignExtend64(
-        U.pVal[getNumWords() - 1], ((BitWidth - 1) % APINT_BITS_PER_WORD) + 1);
-
-    // Fastpath for moving by whole words.
-    if (BitShift == 0) {
-      std::memmove(U.pVal, U.pVal + WordShift, WordsToMove * APINT_WORD_SIZE);
-    } else {
-      // Move the words containing significant bits.
-      for (unsigned i = 0; i != WordsToMove - 1; ++i)
-        U.pVal[i] = (U.pVal[i + WordShift] >> BitShift) |
-                    (U.pVal[i + WordShift + 1] << (APINT_BITS_PER_WORD - BitShift));
-
-      // Handle the last word which has no high bits to copy.
-      U.pVal[WordsToMove - 1] = U.pVal[WordShift + WordsToMove - 1] >> BitShift;
-      // Sign extend one more time.
-      U.pVal[WordsToMove - 1] =
-          SignExtend64(U.pVal[WordsToMove - 1], APINT_BITS_PER_WORD - BitShift);
-    }
-  }
-
-  // Fill in the remainder based on the original sign.
-  std::memset(U.pVal + WordsToMove, Negative ? -1 : 0,
-              WordShift * APINT_WORD_SIZE);
-  clearUnusedBits();
-}
-
-/// Logical right-shift this APInt by shiftAmt.
-/// Logical right-shift function.
-void APInt::lshrInPlace(const APInt &shiftAmt) {
-  lshrInPlace((unsigned)shiftAmt.getLimitedValue(BitWidth));
-}
-
-/// Logical right-shift this APInt by shiftAmt.
-/// Logical right-shift function.
-void APInt::lshrSlowCase(unsigned ShiftAmt) {
-  tcShiftRight(U.pVal, getNumWords(), ShiftAmt);
-}
-
-/// Left-shift this APInt by shiftAmt.
-/// Left-shift function.
-APInt &APInt::operator<<=(const APInt &shiftAmt) {
-  // It's undefined behavior in C to shift by BitWidth or greater.
-  *this <<= (unsigned)shiftAmt.getLimitedValue(BitWidth);
-  return *this;
-}
-
-void APInt::shlSlowCase(unsigned ShiftAmt) {
-  tcShiftLeft(U.pVal, getNumWords(), ShiftAmt);
-  clearUnusedBits();
-}
-
-// Calculate the rotate amount modulo the bit width.
-static unsigned rotateModulo(unsigned BitWidth, const APInt &rotateAmt) {
-  if (BIJOU_UNLIKELY(BitWidth == 0))
-    return 0;
-  unsigned rotBitWidth = rotateAmt.getBitWidth();
-  APInt rot = rotateAmt;
-  if (rotBitWidth < BitWidth) {
-    // Extend the rotate APInt, so that the urem doesn't divide by 0.
-    // e.g. APInt(1, 32) would give APInt(1, 0).
-    rot = rotateAmt.zext(BitWidth);
-  }
-  rot = rot.urem(APInt(rot.getBitWidth(), BitWidth));
-  return rot.getLimitedValue(BitWidth);
-}
-
-APInt APInt::rotl(const APInt &rotateAmt) const {
-  return rotl(rotateModulo(BitWidth, rotateAmt));
-}
-
-APInt APInt::rotl(unsigned rotateAmt) const {
-  if (BIJOU_UNLIKELY(BitWidth == 0))
-    return *this;
-  rotateAmt %= BitWidth;
-  if (rotateAmt == 0)
-    return *this;
-  return shl(rotateAmt) | lshr(BitWidth - rotateAmt);
-}
-
-APInt APInt::rotr(const APInt &rotateAmt) const {
-  return rotr(rotateModulo(BitWidth, rotateAmt));
-}
-
-APInt APInt::rotr(unsigned rotateAmt) const {
-  if (BitWidth == 0)
-    return *this;
-  rotateAmt %= BitWidth;
-  if (rotateAmt == 0)
-    return *this;
-  return lshr(rotateAmt) | shl(BitWidth - rotateAmt);
-}
-
 /// @returns the nearest log base 2 of this APInt. Ties round up.
 ///
 /// NOTE: When we have a BitWidth of 1, we define:
@@ -1165,7 +600,7 @@ APInt APInt::sqrt() const {
       /* 21-30 */ 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
       /*    31 */ 6
     };
-    return APInt(BitWidth, results[ (isSingleWord() ? U.VAL : U.pVal[0]) ]);
+    return APInt(BitWidth, results[getRawData()[0]]);
   }
 
   // If the magnitude of the value fits in less than 52 bits (the precision of
@@ -1174,8 +609,7 @@ APInt APInt::sqrt() const {
   // This should be faster than the algorithm below.
   if (magnitude < 52) {
     return APInt(BitWidth,
-                 uint64_t(::round(::sqrt(double(isSingleWord() ? U.VAL
-                                                               : U.pVal[0])))));
+                 uint64_t(::round(::sqrt(double(getRawData()[0])))));
   }
 
   // Okay, all the short cuts are exhausted. We must compute it. The following
@@ -1210,8 +644,8 @@ APInt APInt::sqrt() const {
   // determined to be a rounding issue with pari/gp as it begins to use a
   // floating point representation after 192 bits. There are no discrepancies
   // between this algorithm and pari/gp for bit widths < 192 bits.
-  APInt square(x_old * x_old);
-  APInt nextSquare((x_old + 1) * (x_old +1));
+  APInt square(x_old.sqr());
+  APInt nextSquare((x_old + 1).sqr());
   if (this->ult(square))
     return x_old;
   assert(this->ule(nextSquare) && "Error in APInt::sqrt computation");
@@ -1271,6 +705,7 @@ APInt APInt::multiplicativeInverse(const APInt& modulo) const {
   return std::move(t[i]);
 }
 
+#if !BIJOU_HAS_INT128
 /// Implementation of Knuth's Algorithm D (Division of nonnegative integers)
 /// from "Art of Computer Programming, Volume 2", section 4.3.1, p. 272. The
 /// variables here have the same names as in the algorithm. Comments explain
@@ -1435,42 +870,214 @@ static void KnuthDiv(uint32_t *u, uint32_t *v, uint32_t *q, uint32_t* r,
   DEBUG_KNUTH(dbgs() << '\n');
 }
 
-void APInt::divide(const WordType *LHS, unsigned lhsWords, const WordType *RHS,
-                   unsigned rhsWords, WordType *Quotient, WordType *Remainder) {
-  assert(lhsWords >= rhsWords && "Fractional result");
+#endif // !BIJOU_HAS_INT128
+
+#if BIJOU_HAS_INT128
+/// Divide the 128-bit value Hi:Lo by Divisor, store the remainder in Rem and
+/// return the quotient. Hi must be less than Divisor so that the quotient fits
+/// in 64 bits.
+static inline uint64_t udiv128by64(uint64_t Hi, uint64_t Lo, uint64_t Divisor,
+                                   uint64_t &Rem) {
+  assert(Hi < Divisor && "Quotient does not fit in 64 bits");
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  // A single DIV instruction, rather than a call to the generic 128 by 128
+  // bit division routine of the compiler runtime.
+  uint64_t Quot;
+  __asm__("divq %[Divisor]"
+          : "=a"(Quot), "=d"(Rem)
+          : [Divisor] "r"(Divisor), "a"(Lo), "d"(Hi));
+  return Quot;
+#else
+  unsigned __int128 Dividend = (static_cast<unsigned __int128>(Hi) << 64) | Lo;
+  Rem = static_cast<uint64_t>(Dividend % Divisor);
+  return static_cast<uint64_t>(Dividend / Divisor);
+#endif
+}
 
-  // First, compose the values into an array of 32-bit words instead of
-  // 64-bit words. This is a necessity of both the "short division" algorithm
-  // and the Knuth "classical algorithm" which requires there to be native
-  // operations for +, -, and * on an m bit value with an m*2 bit result. We
-  // can't use 64-bit operands here because we don't have native results of
-  // 128-bits. Furthermore, casting the 64-bit values to 32-bit values won't
-  // work on large-endian machines.
-  unsigned n = rhsWords * 2;
-  unsigned m = (lhsWords * 2) - n;
+/// Implementation of Knuth's Algorithm D on 64-bit digits, i.e. with b = 2^64.
+/// This is the same algorithm as KnuthDiv, but needs a native 128-bit type for
+/// the double-digit intermediate results. u has m+n+1 digits, the last of which
+/// must be zero, and v has n digits, the last of which must be non-zero. Both
+/// are clobbered. If non-null, q receives the m+1 quotient digits and r the n
+/// remainder digits.
+static void KnuthDiv64(uint64_t *u, uint64_t *v, uint64_t *q, uint64_t *r,
+                       unsigned m, unsigned n) {
+  assert(u && "Must provide dividend");
+  assert(v && "Must provide divisor");
+  assert(u != v && "Must use different memory");
+  assert(n > 1 && "n must be > 1");
+  assert(v[n-1] != 0 && u[m+n] == 0 && "Operands not trimmed");
 
-  // Allocate space for the temporary values we need either on the stack, if
-  // it will fit, or on the heap if it won't.
-  uint32_t SPACE[128];
-  uint32_t *U = nullptr;
-  uint32_t *V = nullptr;
-  uint32_t *Q = nullptr;
-  uint32_t *R = nullptr;
-  if ((Remainder?4:3)*n+2*m+1 <= 128) {
-    U = &SPACE[0];
-    V = &SPACE[m+n+1];
-    Q = &SPACE[(m+n+1) + n];
-    if (Remainder)
-      R = &SPACE[(m+n+1) + n + (m+n)];
-  } else {
-    U = new uint32_t[m + n + 1];
-    V = new uint32_t[n];
-    Q = new uint32_t[m+n];
-    if (Remainder)
-      R = new uint32_t[n];
-  }
+  using DoubleWord = unsigned __int128;
 
-  // Initialize the dividend
+  // D1. [Normalize.] Shift u and v left so that the top bit of v[n-1] is set.
+  // The bits shifted out of u go into the extra digit u[m+n].
+  unsigned shift = countLeadingZeros(v[n-1]);
+  if (shift) {
+    for (unsigned i = n-1; i > 0; --i)
+      v[i] = (v[i] << shift) | (v[i-1] >> (64 - shift));
+    v[0] <<= shift;
+    for (unsigned i = m+n; i > 0; --i)
+      u[i] = (u[i] << shift) | (u[i-1] >> (64 - shift));
+    u[0] <<= shift;
+  }
+
+  // D2. [Initialize j.] Set j to m. This is the loop counter over the places.
+  for (int j = m; j >= 0; --j) {
+    // D3. [Calculate q'.] Estimate the quotient digit from the top two digits
+    // of the current dividend and v[n-1]. As u[j+n] <= v[n-1] this only
+    // overflows a digit if they are equal, in which case we start at b-1.
+    // Then decrease q' while q'*v[n-2] > (r' * b + u[j+n-2]); this corrects
+    // all cases where q' is two too large and most where it is one too large.
+    assert(u[j+n] <= v[n-1] && "Quotient digit out of range");
+    uint64_t qp, rp;
+    bool rpOverflow = false;
+    if (u[j+n] == v[n-1]) {
+      qp = ~uint64_t(0);
+      rp = u[j+n-1] + v[n-1];
+      rpOverflow = rp < v[n-1];
+    } else {
+      qp = udiv128by64(u[j+n], u[j+n-1], v[n-1], rp);
+    }
+    while (!rpOverflow &&
+           DoubleWord(qp) * v[n-2] > ((DoubleWord(rp) << 64) | u[j+n-2])) {
+      --qp;
+      rp += v[n-1];
+      rpOverflow = rp < v[n-1];
+    }
+
+    // D4. [Multiply and subtract.] Replace (u[j+n]u[j+n-1]...u[j]) with
+    // (u[j+n]u[j+n-1]..u[j]) - q' * (v[n-1]...v[1]v[0]), remembering whether
+    // the result went negative.
+    uint64_t carry = 0;
+    uint64_t borrow = 0;
+    for (unsigned i = 0; i < n; ++i) {
+      DoubleWord p = DoubleWord(qp) * v[i] + carry;
+      carry = uint64_t(p >> 64);
+      uint64_t diff = u[j+i] - uint64_t(p);
+      uint64_t newBorrow = u[j+i] < uint64_t(p);
+      u[j+i] = diff - borrow;
+      borrow = newBorrow | (diff < borrow);
+    }
+    uint64_t diff = u[j+n] - carry;
+    bool isNeg = u[j+n] < carry || diff < borrow;
+    u[j+n] = diff - borrow;
+
+    // D5. [Test remainder.] / D6. [Add back.] If the result was negative, q'
+    // was one too large. This has a probability of about 2/b, so it is rare.
+    // Add v back to u; the final carry out of u[j+n] cancels the borrow above.
+    if (isNeg) {
+      --qp;
+      uint64_t c = 0;
+      for (unsigned i = 0; i < n; ++i) {
+        DoubleWord s = DoubleWord(u[j+i]) + v[i] + c;
+        u[j+i] = uint64_t(s);
+        c = uint64_t(s >> 64);
+      }
+      u[j+n] += c;
+    }
+    if (q)
+      q[j] = qp;
+
+    // D7. [Loop on j.] Decrease j by one. Now if j >= 0, go back to D3.
+  }
+
+  // D8. [Unnormalize]. The remainder is u[n-1...0] shifted right by shift.
+  // u[n] is zero at this point, so it can safely supply the top bits.
+  if (r) {
+    if (shift) {
+      for (unsigned i = 0; i < n; ++i)
+        r[i] = (u[i] >> shift) | (u[i+1] << (64 - shift));
+    } else {
+      for (unsigned i = 0; i < n; ++i)
+        r[i] = u[i];
+    }
+  }
+}
+#endif // BIJOU_HAS_INT128
+
+void APInt::divideSlowCase(const WordType *LHS, unsigned lhsWords,
+                           const WordType *RHS, unsigned rhsWords,
+                           WordType *Quotient, WordType *Remainder) {
+  assert(lhsWords >= rhsWords && "Fractional result");
+
+#if BIJOU_HAS_INT128
+  // With a native 128-bit type we can divide directly on 64-bit words. Start
+  // by trimming leading zero words, which the Knuth algorithm cannot handle.
+  // n is the number of words in the divisor and m the number of words by
+  // which the dividend exceeds it.
+  unsigned n = rhsWords;
+  while (n > 0 && RHS[n-1] == 0)
+    --n;
+  assert(n != 0 && "Divide by zero?");
+  unsigned len = lhsWords;
+  while (len > 0 && LHS[len-1] == 0)
+    --len;
+  assert(len >= n && "Dividend smaller than divisor");
+  unsigned m = len - n;
+
+  if (n == 1) {
+    // Short division, one hardware 128 by 64 bit division per word. Writing
+    // Quotient[i] after reading LHS[i] keeps this safe if they alias.
+    uint64_t divisor = RHS[0];
+    uint64_t remainder = 0;
+    for (int i = len - 1; i >= 0; --i) {
+      uint64_t digit = udiv128by64(remainder, LHS[i], divisor, remainder);
+      if (Quotient)
+        Quotient[i] = digit;
+    }
+    if (Remainder)
+      Remainder[0] = remainder;
+  } else {
+    // Copy the operands into scratch space, on the stack if it fits, since the
+    // algorithm normalizes them in place and the outputs may alias them.
+    WordType SPACE[64];
+    WordType *U = SPACE;
+    if (len + 1 + n > std::size(SPACE))
+      U = getMemory(len + 1 + n);
+    WordType *V = U + len + 1;
+    std::memcpy(U, LHS, len * APINT_WORD_SIZE);
+    U[len] = 0; // this extra word is for "spill" in the Knuth algorithm.
+    std::memcpy(V, RHS, n * APINT_WORD_SIZE);
+
+    KnuthDiv64(U, V, Quotient, Remainder, m, n);
+
+    if (U != SPACE)
+      deallocateWords(U, len + 1 + n);
+  }
+
+  // Clear the high words of the results.
+  if (Quotient)
+    std::memset(Quotient + m + 1, 0, (lhsWords - m - 1) * APINT_WORD_SIZE);
+  if (Remainder)
+    std::memset(Remainder + n, 0, (rhsWords - n) * APINT_WORD_SIZE);
+#else
+
+  // First, compose the values into an array of 32-bit words instead of
+  // 64-bit words. This is a necessity of both the "short division" algorithm
+  // and the Knuth "classical algorithm" which requires there to be native
+  // operations for +, -, and * on an m bit value with an m*2 bit result. We
+  // can't use 64-bit operands here because we don't have native results of
+  // 128-bits. Furthermore, casting the 64-bit values to 32-bit values won't
+  // work on large-endian machines.
+  unsigned n = rhsWords * 2;
+  unsigned m = (lhsWords * 2) - n;
+
+  // Allocate space for the temporary values we need either on the stack, if
+  // it will fit, or on the heap if it won't.
+  uint32_t SPACE[128];
+  unsigned spaceWords = ((Remainder?4:3)*n+2*m+1 + 1) / 2;
+  uint64_t *heap = nullptr;
+  uint32_t *U = &SPACE[0];
+  if (spaceWords * 2 > std::size(SPACE)) {
+    heap = getMemory(spaceWords);
+    U = reinterpret_cast<uint32_t *>(heap);
+  }
+  uint32_t *V = U + (m+n+1);
+  uint32_t *Q = V + n;
+  uint32_t *R = Remainder ? Q + (m+n) : nullptr;
+
+  // Initialize the dividend
   memset(U, 0, (m+n+1)*sizeof(uint32_t));
   for (unsigned i = 0; i < lhsWords; ++i) {
     uint64_t tmp = LHS[i];
@@ -1550,367 +1157,9 @@ void APInt::divide(const WordType *LHS, unsigned lhsWords, const WordType *RHS,
   }
 
   // Clean up the memory we allocated.
-  if (U != &SPACE[0]) {
-    delete [] U;
-    delete [] V;
-    delete [] Q;
-    delete [] R;
-  }
-}
-
-APInt APInt::udiv(const APInt &RHS) const {
-  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
-
-  // First, deal with the easy case
-  if (isSingleWord()) {
-    assert(RHS.U.VAL != 0 && "Divide by zero?");
-    return APInt(BitWidth, U.VAL / RHS.U.VAL);
-  }
-
-  // Get some facts about the LHS and RHS number of bits and words
-  unsigned lhsWords = getNumWords(getActiveBits());
-  unsigned rhsBits  = RHS.getActiveBits();
-  unsigned rhsWords = getNumWords(rhsBits);
-  assert(rhsWords && "Divided by zero???");
-
-  // Deal with some degenerate cases
-  if (!lhsWords)
-    // 0 / X ===> 0
-    return APInt(BitWidth, 0);
-  if (rhsBits == 1)
-    // X / 1 ===> X
-    return *this;
-  if (lhsWords < rhsWords || this->ult(RHS))
-    // X / Y ===> 0, iff X < Y
-    return APInt(BitWidth, 0);
-  if (*this == RHS)
-    // X / X ===> 1
-    return APInt(BitWidth, 1);
-  if (lhsWords == 1) // rhsWords is 1 if lhsWords is 1.
-    // All high words are zero, just use native divide
-    return APInt(BitWidth, this->U.pVal[0] / RHS.U.pVal[0]);
-
-  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
-  APInt Quotient(BitWidth, 0); // to hold result.
-  divide(U.pVal, lhsWords, RHS.U.pVal, rhsWords, Quotient.U.pVal, nullptr);
-  return Quotient;
-}
-
-APInt APInt::udiv(uint64_t RHS) const {
-  assert(RHS != 0 && "Divide by zero?");
-
-  // First, deal with the easy case
-  if (isSingleWord())
-    return APInt(BitWidth, U.VAL / RHS);
-
-  // Get some facts about the LHS words.
-  unsigned lhsWords = getNumWords(getActiveBits());
-
-  // Deal with some degenerate cases
-  if (!lhsWords)
-    // 0 / X ===> 0
-    return APInt(BitWidth, 0);
-  if (RHS == 1)
-    // X / 1 ===> X
-    return *this;
-  if (this->ult(RHS))
-    // X / Y ===> 0, iff X < Y
-    return APInt(BitWidth, 0);
-  if (*this == RHS)
-    // X / X ===> 1
-    return APInt(BitWidth, 1);
-  if (lhsWords == 1) // rhsWords is 1 if lhsWords is 1.
-    // All high words are zero, just use native divide
-    return APInt(BitWidth, this->U.pVal[0] / RHS);
-
-  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
-  APInt Quotient(BitWidth, 0); // to hold result.
-  divide(U.pVal, lhsWords, &RHS, 1, Quotient.U.pVal, nullptr);
-  return Quotient;
-}
-
-APInt APInt::sdiv(const APInt &RHS) const {
-  if (isNegative()) {
-    if (RHS.isNegative())
-      return (-(*this)).udiv(-RHS);
-    return -((-(*this)).udiv(RHS));
-  }
-  if (RHS.isNegative())
-    return -(this->udiv(-RHS));
-  return this->udiv(RHS);
-}
-
-APInt APInt::sdiv(int64_t RHS) const {
-  if (isNegative()) {
-    if (RHS < 0)
-      return (-(*this)).udiv(-RHS);
-    return -((-(*this)).udiv(RHS));
-  }
-  if (RHS < 0)
-    return -(this->udiv(-RHS));
-  return this->udiv(RHS);
-}
-
-APInt APInt::urem(const APInt &RHS) const {
-  assert(BitWidth == RHS.BitWidth && "Bit widths must be the same");
-  if (isSingleWord()) {
-    assert(RHS.U.VAL != 0 && "Remainder by zero?");
-    return APInt(BitWidth, U.VAL % RHS.U.VAL);
-  }
-
-  // Get some facts about the LHS
-  unsigned lhsWords = getNumWords(getActiveBits());
-
-  // Get some facts about the RHS
-  unsigned rhsBits = RHS.getActiveBits();
-  unsigned rhsWords = getNumWords(rhsBits);
-  assert(rhsWords && "Performing remainder operation by zero ???");
-
-  // Check the degenerate cases
-  if (lhsWords == 0)
-    // 0 % Y ===> 0
-    return APInt(BitWidth, 0);
-  if (rhsBits == 1)
-    // X % 1 ===> 0
-    return APInt(BitWidth, 0);
-  if (lhsWords < rhsWords || this->ult(RHS))
-    // X % Y ===> X, iff X < Y
-    return *this;
-  if (*this == RHS)
-    // X % X == 0;
-    return APInt(BitWidth, 0);
-  if (lhsWords == 1)
-    // All high words are zero, just use native remainder
-    return APInt(BitWidth, U.pVal[0] % RHS.U.pVal[0]);
-
-  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
-  APInt Remainder(BitWidth, 0);
-  divide(U.pVal, lhsWords, RHS.U.pVal, rhsWords, nullptr, Remainder.U.pVal);
-  return Remainder;
-}
-
-uint64_t APInt::urem(uint64_t RHS) const {
-  assert(RHS != 0 && "Remainder by zero?");
-
-  if (isSingleWord())
-    return U.VAL % RHS;
-
-  // Get some facts about the LHS
-  unsigned lhsWords = getNumWords(getActiveBits());
-
-  // Check the degenerate cases
-  if (lhsWords == 0)
-    // 0 % Y ===> 0
-    return 0;
-  if (RHS == 1)
-    // X % 1 ===> 0
-    return 0;
-  if (this->ult(RHS))
-    // X % Y ===> X, iff X < Y
-    return getZExtValue();
-  if (*this == RHS)
-    // X % X == 0;
-    return 0;
-  if (lhsWords == 1)
-    // All high words are zero, just use native remainder
-    return U.pVal[0] % RHS;
-
-  // We have to compute it the hard way. Invoke the Knuth divide algorithm.
-  uint64_t Remainder;
-  divide(U.pVal, lhsWords, &RHS, 1, nullptr, &Remainder);
-  return Remainder;
-}
-
-APInt APInt::srem(const APInt &RHS) const {
-  if (isNegative()) {
-    if (RHS.isNegative())
-      return -((-(*this)).urem(-RHS));
-    return -((-(*this)).urem(RHS));
-  }
-  if (RHS.isNegative())
-    return this->urem(-RHS);
-  return this->urem(RHS);
-}
-
-int64_t APInt::srem(int64_t RHS) const {
-  if (isNegative()) {
-    if (RHS < 0)
-      return -((-(*this)).urem(-RHS));
-    return -((-(*this)).urem(RHS));
-  }
-  if (RHS < 0)
-    return this->urem(-RHS);
-  return this->urem(RHS);
-}
-
-void APInt::udivrem(const APInt &LHS, const APInt &RHS,
-                    APInt &Quotient, APInt &Remainder) {
-  assert(LHS.BitWidth == RHS.BitWidth && "Bit widths must be the same");
-  unsigned BitWidth = LHS.BitWidth;
-
-  // First, deal with the easy case
-  if (LHS.isSingleWord()) {
-    assert(RHS.U.VAL != 0 && "Divide by zero?");
-    uint64_t QuotVal = LHS.U.VAL / RHS.U.VAL;
-    uint64_t RemVal = LHS.U.VAL % RHS.U.VAL;
-    Quotient = APInt(BitWidth, QuotVal);
-    Remainder = APInt(BitWidth, RemVal);
-    return;
-  }
-
-  // Get some size facts about the dividend and divisor
-  unsigned lhsWords = getNumWords(LHS.getActiveBits());
-  unsigned rhsBits  = RHS.getActiveBits();
-  unsigned rhsWords = getNumWords(rhsBits);
-  assert(rhsWords && "Performing divrem operation by zero ???");
-
-  // Check the degenerate cases
-  if (lhsWords == 0) {
-    Quotient = APInt(BitWidth, 0);    // 0 / Y ===> 0
-    Remainder = APInt(BitWidth, 0);   // 0 % Y ===> 0
-    return;
-  }
-
-  if (rhsBits == 1) {
-    Quotient = LHS;                   // X / 1 ===> X
-    Remainder = APInt(BitWidth, 0);   // X % 1 ===> 0
-  }
-
-  if (lhsWords < rhsWords || LHS.ult(RHS)) {
-    Remainder = LHS;                  // X % Y ===> X, iff X < Y
-    Quotient = APInt(BitWidth, 0);    // X / Y ===> 0, iff X < Y
-    return;
-  }
-
-  if (LHS == RHS) {
-    Quotient  = APInt(BitWidth, 1);   // X / X ===> 1
-    Remainder = APInt(BitWidth, 0);   // X % X ===> 0;
-    return;
-  }
-
-  // Make sure there is enough space to hold the results.
-  // NOTE: This assumes that reallocate won't affect any bits if it doesn't
-  // change the size. This is necessary if Quotient or Remainder is aliased
-  // with LHS or RHS.
-  Quotient.reallocate(BitWidth);
-  Remainder.reallocate(BitWidth);
-
-  if (lhsWords == 1) { // rhsWords is 1 if lhsWords is 1.
-    // There is only one word to consider so use the native versions.
-    uint64_t lhsValue = LHS.U.pVal[0];
-    uint64_t rhsValue = RHS.U.pVal[0];
-    Quotient = lhsValue / rhsValue;
-    Remainder = lhsValue % rhsValue;
-    return;
-  }
-
-  // Okay, lets do it the long way
-  divide(LHS.U.pVal, lhsWords, RHS.U.pVal, rhsWords, Quotient.U.pVal,
-         Remainder.U.pVal);
-  // Clear the rest of the Quotient and Remainder.
-  std::memset(Quotient.U.pVal + lhsWords, 0,
-              (getNumWords(BitWidth) - lhsWords) * APINT_WORD_SIZE);
-  std::memset(Remainder.U.pVal + rhsWords, 0,
-              (getNumWords(BitWidth) - rhsWords) * APINT_WORD_SIZE);
-}
-
-void APInt::udivrem(const APInt &LHS, uint64_t RHS, APInt &Quotient,
-                    uint64_t &Remainder) {
-  assert(RHS != 0 && "Divide by zero?");
-  unsigned BitWidth = LHS.BitWidth;
-
-  // First, deal with the easy case
-  if (LHS.isSingleWord()) {
-    uint64_t QuotVal = LHS.U.VAL / RHS;
-    Remainder = LHS.U.VAL % RHS;
-    Quotient = APInt(BitWidth, QuotVal);
-    return;
-  }
-
-  // Get some size facts about the dividend and divisor
-  unsigned lhsWords = getNumWords(LHS.getActiveBits());
-
-  // Check the degenerate cases
-  if (lhsWords == 0) {
-    Quotient = APInt(BitWidth, 0);    // 0 / Y ===> 0
-    Remainder = 0;                    // 0 % Y ===> 0
-    return;
-  }
-
-  if (RHS == 1) {
-    Quotient = LHS;                   // X / 1 ===> X
-    Remainder = 0;                    // X % 1 ===> 0
-    return;
-  }
-
-  if (LHS.ult(RHS)) {
-    Remainder = LHS.getZExtValue();   // X % Y ===> X, iff X < Y
-    Quotient = APInt(BitWidth, 0);    // X / Y ===> 0, iff X < Y
-    return;
-  }
-
-  if (LHS == RHS) {
-    Quotient  = APInt(BitWidth, 1);   // X / X ===> 1
-    Remainder = 0;                    // X % X ===> 0;
-    return;
-  }
-
-  // Make sure there is enough space to hold the results.
-  // NOTE: This assumes that reallocate won't affect any bits if it doesn't
-  // change the size. This is necessary if Quotient is aliased with LHS.
-  Quotient.reallocate(BitWidth);
-
-  if (lhsWords == 1) { // rhsWords is 1 if lhsWords is 1.
-    // There is only one word to consider so use the native versions.
-    uint64_t lhsValue = LHS.U.pVal[0];
-    Quotient = lhsValue / RHS;
-    Remainder = lhsValue % RHS;
-    return;
-  }
-
-  // Okay, lets do it the long way
-  divide(LHS.U.pVal, lhsWords, &RHS, 1, Quotient.U.pVal, &Remainder);
-  // Clear the rest of the Quotient.
-  std::memset(Quotient.U.pVal + lhsWords, 0,
-              (getNumWords(BitWidth) - lhsWords) * APINT_WORD_SIZE);
-}
-
-void APInt::sdivrem(const APInt &LHS, const APInt &RHS,
-                    APInt &Quotient, APInt &Remainder) {
-  if (LHS.isNegative()) {
-    if (RHS.isNegative())
-      APInt::udivrem(-LHS, -RHS, Quotient, Remainder);
-    else {
-      APInt::udivrem(-LHS, RHS, Quotient, Remainder);
-      Quotient.negate();
-    }
-    Remainder.negate();
-  } else if (RHS.isNegative()) {
-    APInt::udivrem(LHS, -RHS, Quotient, Remainder);
-    Quotient.negate();
-  } else {
-    APInt::udivrem(LHS, RHS, Quotient, Remainder);
-  }
-}
-
-void APInt::sdivrem(const APInt &LHS, int64_t RHS,
-                    APInt &Quotient, int64_t &Remainder) {
-  uint64_t R = Remainder;
-  if (LHS.isNegative()) {
-    if (RHS < 0)
-      APInt::udivrem(-LHS, -RHS, Quotient, R);
-    else {
-      APInt::udivrem(-LHS, RHS, Quotient, R);
-      Quotient.negate();
-    }
-    R = -R;
-  } else if (RHS < 0) {
-    APInt::udivrem(LHS, -RHS, Quotient, R);
-    Quotient.negate();
-  } else {
-    APInt::udivrem(LHS, RHS, Quotient, R);
-  }
-  Remainder = R;
+  if (heap)
+    deallocateWords(heap, spaceWords);
+#endif // BIJOU_HAS_INT128
 }
 
 APInt APInt::sadd_ov(const APInt &RHS, bool &Overflow) const {
@@ -2074,6 +1323,217 @@ APInt APInt::ushl_sat(const APInt &RHS) const {
   return APInt::getMaxValue(BitWidth);
 }
 
+/// Returns the number of radix RADIX digits that fit in a word.
+/// RADIX must be 10 or 36.
+static unsigned getDigitsPerWord(unsigned Radix) {
+  assert((Radix == 10 || Radix == 36) && "Radix is a power of two");
+  return Radix == 10 ? 19 : 12;
+}
+
+/// Returns RADIX to the power of getDigitsPerWord(RADIX), the largest power
+/// of the radix that fits in a word.
+static APInt::WordType getWordRadixPower(unsigned Radix) {
+  assert((Radix == 10 || Radix == 36) && "Radix is a power of two");
+  return Radix == 10 ? 10000000000000000000ULL : 4738381338321616896ULL;
+}
+
+namespace {
+/// The power Radix^Digits of a radix, with a divider by it.
+struct RadixPower {
+  std::vector<APInt::WordType> Power;
+  APIntDivider Divider;
+  unsigned Digits;
+};
+} // end anonymous namespace
+
+/// Returns the K-th power of the table of radix powers Radix^(D * 2^K) with
+/// D = getDigitsPerWord(Radix), computing and caching it on first use.
+static const RadixPower &getRadixPower(unsigned Radix, unsigned K) {
+  // A deque never moves its elements, so references returned earlier stay
+  // valid while the table grows.
+  static std::mutex CacheMutex;
+  static std::deque<RadixPower> Cache[2];
+
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  std::deque<RadixPower> &Powers = Cache[Radix == 36];
+  while (Powers.size() <= K) {
+    std::vector<APInt::WordType> Power;
+    unsigned Digits;
+    if (Powers.empty()) {
+      Digits = getDigitsPerWord(Radix);
+      Power.push_back(getWordRadixPower(Radix));
+    } else {
+      const RadixPower &Prev = Powers.back();
+      unsigned PrevWords = Prev.Power.size();
+      Digits = 2 * Prev.Digits;
+      Power.resize(2 * PrevWords);
+      APInt::tcFullMultiply(Power.data(), Prev.Power.data(),
+                            Prev.Power.data(), PrevWords, PrevWords);
+      if (Power.back() == 0)
+        Power.pop_back();
+    }
+
+    APIntDivider Divider(
+        APInt(Power.size() * APInt::APINT_BITS_PER_WORD, Power));
+    Powers.push_back({std::move(Power), std::move(Divider), Digits});
+  }
+  return Powers[K];
+}
+
+/// Returns true if the 8 characters at P are all decimal digits.
+[[maybe_unused]] static bool isEightDigits(const char *P) {
+  uint64_t Val;
+  std::memcpy(&Val, P, sizeof(Val));
+  return ((Val & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((Val + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+/// Returns the value of the 8 decimal digits at P, converting them all at
+/// once in a single 64-bit register.  Requires a little endian host.
+static uint64_t parseEightDigits(const char *P) {
+  assert(isEightDigits(P) && "Invalid character in digit string");
+  uint64_t Val;
+  std::memcpy(&Val, P, sizeof(Val));
+  Val -= 0x3030303030303030ULL;
+  // Combine adjacent digits into two digit numbers, then those into four
+  // digit numbers and finally into one eight digit number.
+  Val = (Val * 10) + (Val >> 8);
+  Val = (((Val & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((Val >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+        32;
+  return Val;
+}
+
+/// Returns the value of the LEN <= getDigitsPerWord(RADIX) digits at P.
+static uint64_t parseDigits(const char *P, unsigned Len, uint8_t Radix) {
+  uint64_t Val = 0;
+  if (Radix == 10 && std::endian::native == std::endian::little)
+    for (; Len >= 8; P += 8, Len -= 8)
+      Val = Val * 100000000 + parseEightDigits(P);
+  for (; Len; ++P, --Len) {
+    unsigned digit = getDigit(*P, Radix);
+    assert(digit < Radix && "Invalid character in digit string");
+    Val = Val * Radix + digit;
+  }
+  return Val;
+}
+
+/// Numbers of at least this many words of digits are parsed by
+/// divide-and-conquer, smaller ones a word of digits at a time.
+static const unsigned DivideAndConquerFromStringThreshold = 32;
+
+/// fromChars and toChars keep values of up to this many words on the stack.
+static const unsigned CharsStackWords = 17;
+
+/// Sets RESULT to the value of the N words of digits CHUNKS, most significant
+/// first, where each word holds getDigitsPerWord(RADIX) digits.
+static void combineDigits(std::vector<APInt::WordType> &Result,
+                          const APInt::WordType *Chunks, size_t N,
+                          uint8_t Radix) {
+  if (N < DivideAndConquerFromStringThreshold) {
+    Result.assign(N, 0);
+    for (unsigned i = 0; i < N; i++)
+      APInt::tcMultiplyPart(Result.data(), Result.data(),
+                            getWordRadixPower(Radix), Chunks[i], i, i + 1,
+                            false);
+  } else {
+    // Split off the largest power of two words of digits at the end, so
+    // that the result is High * P + Low with P a cached power.
+    unsigned K = 0;
+    while ((size_t(2) << K) < N)
+      K++;
+    size_t LowChunks = size_t(1) << K;
+    const RadixPower &P = getRadixPower(Radix, K);
+
+    std::vector<APInt::WordType> High, Low;
+    combineDigits(High, Chunks, N - LowChunks, Radix);
+    combineDigits(Low, Chunks + (N - LowChunks), LowChunks, Radix);
+    while (!High.empty() && !High.back())
+      High.pop_back();
+    while (!Low.empty() && !Low.back())
+      Low.pop_back();
+    if (High.empty()) {
+      Result = std::move(Low);
+      return;
+    }
+
+    Result.assign(High.size() + P.Power.size(), 0);
+    APInt::tcFullMultiply(Result.data(), High.data(), P.Power.data(),
+                          High.size(), P.Power.size());
+    // Low < P, so adding it cannot overflow the product's width.
+    if (APInt::tcAdd(Result.data(), Low.data(), 0, Low.size()))
+      APInt::tcAddPart(Result.data() + Low.size(), 1,
+                       Result.size() - Low.size());
+  }
+}
+
+/// Converts the NUMDIGITS digits in radix RADIX at DIGITS into the NUMWORDS
+/// words at WORDS, which must be zero. The value wraps to the width of WORDS.
+static void parseDigitString(APInt::WordType *Words, unsigned NumWords,
+                             const char *Digits, size_t NumDigits,
+                             uint8_t radix) {
+  using WordType = APInt::WordType;
+  const unsigned APINT_BITS_PER_WORD = APInt::APINT_BITS_PER_WORD;
+
+  // Figure out if we can shift instead of multiply
+  unsigned shift = (radix == 16 ? 4 : radix == 8 ? 3 : radix == 2 ? 1 : 0);
+
+  if (shift) {
+    // Each digit is SHIFT bits of the result, so put them in place directly,
+    // starting from the least significant one. Bits beyond the width are
+    // dropped.
+    for (size_t i = NumDigits, BitPos = 0; i-- > 0; BitPos += shift) {
+      unsigned digit = getDigit(Digits[i], radix);
+      assert(digit < radix && "Invalid character in digit string");
+      size_t Word = BitPos / APINT_BITS_PER_WORD;
+      unsigned Bit = BitPos % APINT_BITS_PER_WORD;
+      if (Word < NumWords)
+        Words[Word] |= WordType(digit) << Bit;
+      if (Bit + shift > APINT_BITS_PER_WORD && Word + 1 < NumWords)
+        Words[Word + 1] |= WordType(digit) >> (APINT_BITS_PER_WORD - Bit);
+    }
+    return;
+  }
+
+  // Convert a word of digits at a time with native arithmetic; the first
+  // word takes whatever is left over.
+  unsigned DigitsPerWord = getDigitsPerWord(radix);
+  size_t NumChunks = (NumDigits + DigitsPerWord - 1) / DigitsPerWord;
+  unsigned FirstDigits = NumDigits - (NumChunks - 1) * DigitsPerWord;
+
+  if (NumChunks < DivideAndConquerFromStringThreshold) {
+    // Multiply-add each word of digits into the result, which wraps to the
+    // width of WORDS like the arithmetic operators do.
+    WordType Power = getWordRadixPower(radix);
+    unsigned Len = 0;
+    for (size_t i = 0; i < NumChunks; i++) {
+      unsigned Count = i ? DigitsPerWord : FirstDigits;
+      WordType Chunk = parseDigits(Digits, Count, radix);
+      Digits += Count;
+      if (i == 0) {
+        Words[0] = Chunk;
+        Len = 1;
+      } else {
+        APInt::tcMultiplyPart(Words, Words, Power, Chunk, Len,
+                              std::min(Len + 1, NumWords), false);
+        Len = std::min(Len + 1, NumWords);
+      }
+    }
+  } else {
+    std::vector<WordType> Chunks(NumChunks);
+    for (size_t i = 0; i < NumChunks; i++) {
+      unsigned Count = i ? DigitsPerWord : FirstDigits;
+      Chunks[i] = parseDigits(Digits, Count, radix);
+      Digits += Count;
+    }
+    std::vector<WordType> Value;
+    combineDigits(Value, Chunks.data(), NumChunks, radix);
+    APInt::tcAssign(Words, Value.data(),
+                    std::min<size_t>(Value.size(), NumWords));
+  }
+}
+
 void APInt::fromString(unsigned numbits, std::string_view str, uint8_t radix) {
   // Check our assumptions here
   assert(!str.empty() && "Invalid string length");
@@ -2098,40 +1558,159 @@ void APInt::fromString(unsigned numbits, std::string_view str, uint8_t radix) {
   // Allocate memory if needed
   if (isSingleWord())
     U.VAL = 0;
-  else
+  else if (needsCleanup())
     U.pVal = getClearedMemory(getNumWords());
+  else
+    memset(U.Inline, 0, getNumWords() * APINT_WORD_SIZE);
 
-  // Figure out if we can shift instead of multiply
-  unsigned shift = (radix == 16 ? 4 : radix == 8 ? 3 : radix == 2 ? 1 : 0);
-
-  // Enter digit traversal loop
-  for (std::string_view::iterator e = str.end(); p != e; ++p) {
-    unsigned digit = getDigit(*p, radix);
-    assert(digit < radix && "Invalid character in digit string");
-
-    // Shift or multiply the value by the radix
-    if (slen > 1) {
-      if (shift)
-        *this <<= shift;
-      else
-        *this *= radix;
-    }
+  WordType *Words = isSingleWord() ? &U.VAL : getWords();
+  parseDigitString(Words, getNumWords(), str.data() + (str.size() - slen),
+                   slen, radix);
+  clearUnusedBits();
 
-    // Add in the digit we just interpreted
-    *this += digit;
-  }
   // If its negative, put it in two's complement form
   if (isNeg)
     this->negate();
 }
 
+std::from_chars_result APInt::fromChars(const char *First, const char *Last,
+                                        unsigned Radix, bool Signed) {
+  assert((Radix == 10 || Radix == 8 || Radix == 16 || Radix == 2 ||
+          Radix == 36) &&
+         "Radix should be 2, 8, 10, 16, or 36!");
+
+  const char *P = First;
+  bool Negative = Signed && P != Last && *P == '-';
+  P += Negative;
+  const char *Digits = P;
+  while (P != Last && getDigit(*P, Radix) < Radix)
+    ++P;
+  if (P == Digits)
+    return {First, std::errc::invalid_argument};
+
+  // Leading zeros add nothing, and the remaining digits are bounded by the
+  // width, so the value fits in one word more than this APInt has.
+  while (P - Digits > 1 && *Digits == '0')
+    ++Digits;
+  if (size_t(P - Digits) > getMaxChars(BitWidth, Radix, false))
+    return {P, std::errc::result_out_of_range};
+
+  unsigned NumWords = getNumWords() + 1;
+  ScratchWords<CharsStackWords> Scratch(NumWords);
+  WordType *Value = Scratch.data();
+  tcSet(Value, 0, NumWords);
+  parseDigitString(Value, NumWords, Digits, P - Digits, Radix);
+
+  // A negative value may reach 2^(BitWidth - 1), a positive one only
+  // 2^(BitWidth - 1) - 1.
+  unsigned ActiveBits = tcMSB(Value, NumWords) + 1;
+  unsigned MaxBits = Signed ? BitWidth - 1 : BitWidth;
+  if (ActiveBits > MaxBits &&
+      !(Negative && ActiveBits == BitWidth && tcLSB(Value, NumWords) == MaxBits))
+    return {P, std::errc::result_out_of_range};
+
+  if (Negative)
+    tcNegate(Value, NumWords);
+  tcAssign(isSingleWord() ? &U.VAL : getWords(), Value, getNumWords());
+  clearUnusedBits();
+  return {P, std::errc()};
+}
+
+/// Values of at least this many words are converted to a non-power-of-two
+/// radix by divide-and-conquer, smaller ones a word of digits at a time.
+static const unsigned DivideAndConquerToStringThreshold = 24;
+
+/// Writes the digits of the N word value V in radix RADIX (10 or 36) to
+/// [FIRST, LAST), zero-padded to at least MINDIGITS digits.  Divide-and-conquer
+/// splits use powers up to getRadixPower(Radix, MAXPOWER).
+/// @returns the end of the digits, or nullptr if they do not fit.
+static char *writeDigits(char *First, char *Last, const APInt::WordType *V,
+                         unsigned N, unsigned Radix, size_t MinDigits,
+                         unsigned MaxPower) {
+  static const char Digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+  while (N && !V[N - 1])
+    N--;
+
+  if (N >= DivideAndConquerToStringThreshold) {
+    // Split V at the smallest cached power P with V < P^2 and convert the
+    // quotient and remainder separately, the remainder padded to the digits
+    // of P.
+    unsigned K = 0;
+    while (K < MaxPower && 2 * getRadixPower(Radix, K).Power.size() < N)
+      K++;
+    const RadixPower &P = getRadixPower(Radix, K);
+    assert(K > 0 && "Threshold too small for divide-and-conquer");
+
+    std::vector<APInt::WordType> Q(N), R(P.Divider.getNumDivisorWords());
+    P.Divider.udivrem(V, N, Q.data(), R.data());
+    if (std::any_of(Q.begin(), Q.end(),
+                    [](APInt::WordType W) { return W != 0; })) {
+      First = writeDigits(First, Last, Q.data(), Q.size(), Radix,
+                          MinDigits > P.Digits ? MinDigits - P.Digits : 0,
+                          MaxPower);
+      if (!First)
+        return nullptr;
+      MinDigits = P.Digits;
+    }
+    return writeDigits(First, Last, R.data(), R.size(), Radix, MinDigits,
+                       K - 1);
+  }
+
+  // Divide by the largest power of the radix that fits in a word, and convert
+  // each remainder with native arithmetic.  The digits come out backwards.
+  static const APIntDivider WordDividers[2] = {
+      APIntDivider(APInt(APInt::APINT_BITS_PER_WORD, getWordRadixPower(10))),
+      APIntDivider(APInt(APInt::APINT_BITS_PER_WORD, getWordRadixPower(36))),
+  };
+  const APIntDivider &Divider = WordDividers[Radix == 36];
+  unsigned DigitsPerWord = getDigitsPerWord(Radix);
+  char *Start = First;
+
+  assert(N < DivideAndConquerToStringThreshold && "Too wide for base case");
+  APInt::WordType Words[2][DivideAndConquerToStringThreshold];
+  APInt::WordType *Cur = Words[0], *Next = Words[1];
+  std::copy(V, V + N, Cur);
+  while (N) {
+    uint64_t Rem;
+    Divider.udivrem(Cur, N, Next, &Rem);
+    std::swap(Cur, Next);
+    while (N && !Cur[N - 1])
+      N--;
+    for (unsigned i = 0; i < DigitsPerWord && (Rem || N); i++) {
+      if (First == Last)
+        return nullptr;
+      *First++ = Digits[Rem % Radix];
+      Rem /= Radix;
+    }
+  }
+  if (size_t(First - Start) < MinDigits) {
+    if (size_t(Last - Start) < MinDigits)
+      return nullptr;
+    First = std::fill_n(First, MinDigits - (First - Start), '0');
+  }
+  std::reverse(Start, First);
+  return First;
+}
+
 void APInt::toString(std::string &Str, unsigned Radix,
                      bool Signed, bool formatAsCLiteral) const {
+  size_t Start = Str.size();
+  Str.resize(Start + getMaxChars(BitWidth, Radix, Signed, formatAsCLiteral));
+  std::to_chars_result Result =
+      toChars(Str.data() + Start, Str.data() + Str.size(), Radix, Signed,
+              formatAsCLiteral);
+  assert(Result.ec == std::errc() && "getMaxChars is too small");
+  Str.resize(Result.ptr - Str.data());
+}
+
+std::to_chars_result APInt::toChars(char *First, char *Last, unsigned Radix,
+                                    bool Signed, bool formatAsCLiteral) const {
   assert((Radix == 10 || Radix == 8 || Radix == 16 || Radix == 2 ||
           Radix == 36) &&
          "Radix should be 2, 8, 10, 16, or 36!");
 
-  const char *Prefix = "";
+  std::string_view Prefix;
   if (formatAsCLiteral) {
     switch (Radix) {
       case 2:
@@ -2152,90 +1731,70 @@ void APInt::toString(std::string &Str, unsigned Radix,
     }
   }
 
-  // First, check for a zero value and just short circuit the logic below.
-  if (isZero()) {
-    while (*Prefix) {
-      Str.push_back(*Prefix);
-      ++Prefix;
-    };
-    Str.push_back('0');
-    return;
-  }
-
   static const char Digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-
-  if (isSingleWord()) {
-    char Buffer[65];
+  const std::to_chars_result TooLarge = {Last, std::errc::value_too_large};
+
+  // Print the magnitude, negating a copy of negative values.
+  bool Negative = Signed && isNegative();
+  unsigned N = getNumWords();
+  ScratchWords<CharsStackWords> Scratch(Negative ? N : 0);
+  const WordType *V = getRawData();
+  if (Negative) {
+    tcAssign(Scratch.data(), V, N);
+    tcNegate(Scratch.data(), N);
+    if (BitWidth % APINT_BITS_PER_WORD)
+      Scratch.data()[N - 1] &= lowBitMask(BitWidth % APINT_BITS_PER_WORD);
+    V = Scratch.data();
+  }
+  while (N > 1 && !V[N - 1])
+    N--;
+
+  if (size_t(Last - First) < Negative + Prefix.size())
+    return TooLarge;
+  if (Negative)
+    *First++ = '-';
+  First = std::copy(Prefix.begin(), Prefix.end(), First);
+
+  if (N <= 1) {
+    // Convert a single word with native arithmetic, backwards. Zero width
+    // values have no words and print as zero.
+    char Buffer[APINT_BITS_PER_WORD];
     char *BufPtr = std::end(Buffer);
-
-    uint64_t N;
-    if (!Signed) {
-      N = getZExtValue();
-    } else {
-      int64_t I = getSExtValue();
-      if (I >= 0) {
-        N = I;
-      } else {
-        Str.push_back('-');
-        N = -(uint64_t)I;
-      }
-    }
-
-    while (*Prefix) {
-      Str.push_back(*Prefix);
-      ++Prefix;
-    };
-
-    while (N) {
-      *--BufPtr = Digits[N % Radix];
-      N /= Radix;
-    }
-    Str.append(BufPtr, std::end(Buffer));
-    return;
-  }
-
-  APInt Tmp(*this);
-
-  if (Signed && isNegative()) {
-    // They want to print the signed version and it is a negative value
-    // Flip the bits and add one to turn it into the equivalent positive
-    // value and put a '-' in the result.
-    Tmp.negate();
-    Str.push_back('-');
-  }
-
-  while (*Prefix) {
-    Str.push_back(*Prefix);
-    ++Prefix;
-  };
-
-  // We insert the digits backward, then reverse them to get the right order.
-  unsigned StartDig = Str.size();
-
-  // For the 2, 8 and 16 bit cases, we can just shift instead of divide
-  // because the number of bits per digit (1, 3 and 4 respectively) divides
-  // equally.  We just shift until the value is zero.
+    uint64_t Val = N ? V[0] : 0;
+    do {
+      *--BufPtr = Digits[Val % Radix];
+      Val /= Radix;
+    } while (Val);
+    if (Last - First < std::end(Buffer) - BufPtr)
+      return TooLarge;
+    return {std::copy(BufPtr, std::end(Buffer), First), std::errc()};
+  }
+
+  // For the 2, 8 and 16 bit cases, we can just extract the bits of each
+  // digit because the number of bits per digit (1, 3 and 4 respectively)
+  // divides equally.
   if (Radix == 2 || Radix == 8 || Radix == 16) {
-    // Just shift tmp right for each digit width until it becomes zero
     unsigned ShiftAmt = (Radix == 16 ? 4 : (Radix == 8 ? 3 : 1));
-    unsigned MaskAmt = Radix - 1;
-
-    while (Tmp.getBoolValue()) {
-      unsigned Digit = unsigned(Tmp.getRawData()[0]) & MaskAmt;
-      Str.push_back(Digits[Digit]);
-      Tmp.lshrInPlace(ShiftAmt);
-    }
-  } else {
-    while (Tmp.getBoolValue()) {
-      uint64_t Digit;
-      udivrem(Tmp, Radix, Tmp, Digit);
-      assert(Digit < Radix && "divide failed");
-      Str.push_back(Digits[Digit]);
+    unsigned ActiveBits = tcMSB(V, N) + 1;
+    unsigned NumDigits = (ActiveBits + ShiftAmt - 1) / ShiftAmt;
+    if (size_t(Last - First) < NumDigits)
+      return TooLarge;
+    for (unsigned i = NumDigits; i-- > 0;) {
+      unsigned BitPos = i * ShiftAmt;
+      unsigned Word = BitPos / APINT_BITS_PER_WORD;
+      unsigned Bit = BitPos % APINT_BITS_PER_WORD;
+      WordType Digit = V[Word] >> Bit;
+      if (Bit + ShiftAmt > APINT_BITS_PER_WORD && Word + 1 < N)
+        Digit |= V[Word + 1] << (APINT_BITS_PER_WORD - Bit);
+      *First++ = Digits[Digit & (Radix - 1)];
     }
+    return {First, std::errc()};
   }
 
-  // Reverse the digits before returning.
-  std::reverse(Str.begin()+StartDig, Str.end());
+  First = writeDigits(First, Last, V, N, Radix, 0, -1U);
+  if (!First)
+    return TooLarge;
+  return {First, std::errc()};
 }
 
 BIJOU_DUMP_METHOD void APInt::dump() const {
@@ -2251,6 +1810,13 @@ BIJOU_DUMP_METHOD void APInt::dump() const {
 
 #ifdef AP_USE_IOSTREAM
 void APInt::print(std::iostream &OS, bool isSigned) const {
+  char Buffer[256];
+  std::to_chars_result Result =
+      toChars(std::begin(Buffer), std::end(Buffer), 10, isSigned);
+  if (Result.ec == std::errc()) {
+    OS.write(Buffer, Result.ptr - Buffer);
+    return;
+  }
   std::string S;
   this->toString(S, 10, isSigned, /* formatAsCLiteral = */false);
   OS << S;
@@ -2258,6 +1824,14 @@ void APInt::print(std::iostream &OS, bool isSigned) const {
 #endif
 
 void APInt::print(FILE *O, bool isSigned) const {
+  // Print through a stack buffer, which holds values of up to 800 bits.
+  char Buffer[256];
+  std::to_chars_result Result =
+      toChars(std::begin(Buffer), std::end(Buffer), 10, isSigned);
+  if (Result.ec == std::errc()) {
+    fwrite(Buffer, 1, Result.ptr - Buffer, O);
+    return;
+  }
   std::string S;
   this->toString(S, 10, isSigned, /* formatAsCLiteral = */false);
   fprintf(O, "%s", S.c_str());
@@ -2266,458 +1840,1027 @@ void APInt::print(FILE *O, bool isSigned) const {
 // This implements a variety of operations on a representation of
 // arbitrary precision, two's-complement, bignum integer values.
 
-// Assumed by lowHalf, highHalf, partMSB and partLSB.  A fairly safe
-// and unrestricting assumption.
-static_assert(APInt::APINT_BITS_PER_WORD % 2 == 0,
-              "Part width must be divisible by 2!");
+/// DST += SRC where SRC has SRCPARTS <= DSTPARTS words.  Returns the carry.
+static APInt::WordType addInto(APInt::WordType *dst, unsigned dstParts,
+                               const APInt::WordType *src, unsigned srcParts) {
+  assert(srcParts <= dstParts);
+  APInt::WordType carry = APInt::tcAdd(dst, src, 0, srcParts);
+  if (carry && srcParts < dstParts)
+    carry = APInt::tcAddPart(dst + srcParts, 1, dstParts - srcParts);
+  return carry;
+}
+
+/// DST -= SRC where SRC has SRCPARTS <= DSTPARTS words.  Returns the borrow.
+static APInt::WordType subtractFrom(APInt::WordType *dst, unsigned dstParts,
+                                    const APInt::WordType *src,
+                                    unsigned srcParts) {
+  assert(srcParts <= dstParts);
+  APInt::WordType borrow = APInt::tcSubtract(dst, src, 0, srcParts);
+  if (borrow && srcParts < dstParts)
+    borrow = APInt::tcSubtractPart(dst + srcParts, 1, dstParts - srcParts);
+  return borrow;
+}
+
+/// DST += SRC where the sum is known to fit in the DSTPARTS words of DST, so
+/// any words of SRC beyond DSTPARTS are zero.
+static void accumulate(APInt::WordType *dst, unsigned dstParts,
+                       const APInt::WordType *src, unsigned srcParts) {
+  for (; srcParts > dstParts; --srcParts)
+    assert(src[srcParts - 1] == 0 && "Partial product does not fit");
+  APInt::WordType carry = addInto(dst, dstParts, src, srcParts);
+  assert(!carry && "Partial product does not fit");
+  (void)carry;
+}
+
+/// DST = |A - B| where A has PARTS words, B has BPARTS <= PARTS words and DST
+/// has PARTS words.  Returns true if A < B.
+static bool absoluteDifference(APInt::WordType *dst, const APInt::WordType *a,
+                               unsigned parts, const APInt::WordType *b,
+                               unsigned bParts) {
+  assert(bParts <= parts);
+  bool less = std::all_of(a + bParts, a + parts,
+                          [](APInt::WordType w) { return w == 0; }) &&
+              APInt::tcCompare(a, b, bParts) < 0;
+  if (!less) {
+    APInt::tcAssign(dst, a, parts);
+    subtractFrom(dst, parts, b, bParts);
+  } else {
+    // The high words of A are zero, so the difference fits in BPARTS words.
+    APInt::tcAssign(dst, b, bParts);
+    APInt::tcSubtract(dst, a, 0, bParts);
+    std::memset(dst + bParts, 0, (parts - bParts) * APInt::APINT_WORD_SIZE);
+  }
+  return less;
+}
+
+static void multiplyBalanced(APInt::WordType *dst, const APInt::WordType *lhs,
+                             const APInt::WordType *rhs, unsigned parts,
+                             APInt::WordType *scratch);
 
-// Returns the integer part with the least significant BITS set.
-// BITS cannot be zero.
-static inline APInt::WordType lowBitMask(unsigned bits) {
-  assert(bits != 0 && bits <= APInt::APINT_BITS_PER_WORD);
-  return ~(APInt::WordType) 0 >> (APInt::APINT_BITS_PER_WORD - bits);
+/// Returns the number of scratch words multiplyBalanced needs for two operands
+/// of PARTS words each.
+static unsigned multiplyScratchParts(unsigned parts);
+
+/// Returns the number of scratch words karatsubaMultiply needs.
+static unsigned karatsubaScratchParts(unsigned parts) {
+  unsigned low = (parts + 1) / 2;
+  return 6 * low + 1 + std::max(multiplyScratchParts(low),
+                                multiplyScratchParts(parts - low));
 }
 
-/// Returns the value of the lower half of PART.
-static inline APInt::WordType lowHalf(APInt::WordType part) {
-  return part & lowBitMask(APInt::APINT_BITS_PER_WORD / 2);
+/// Returns the number of scratch words toom3Multiply needs.
+static unsigned toom3ScratchParts(unsigned parts) {
+  unsigned k = (parts + 2) / 3;
+  return 12 * k + 12 + std::max({multiplyScratchParts(k),
+                                 multiplyScratchParts(k + 1),
+                                 multiplyScratchParts(parts - 2 * k)});
 }
 
-/// Returns the value of the upper half of PART.
-static inline APInt::WordType highHalf(APInt::WordType part) {
-  return part >> (APInt::APINT_BITS_PER_WORD / 2);
+static unsigned multiplyScratchParts(unsigned parts) {
+  if (parts < APInt::APINT_KARATSUBA_THRESHOLD)
+    return 0;
+  if (parts < APInt::APINT_TOOM3_THRESHOLD)
+    return karatsubaScratchParts(parts);
+  return toom3ScratchParts(parts);
 }
 
-/// Returns the bit number of the most significant set bit of a part.
-/// If the input number has no bits set -1U is returned.
-static unsigned partMSB(APInt::WordType value) {
-  return findLastSet(value, ZB_Max);
+/// DST = LHS * RHS using one level of Karatsuba's algorithm, where both
+/// operands have PARTS words and DST has 2 * PARTS words.  Splitting each
+/// operand as X1 * B + X0, with B = 2^(64 * ceil(PARTS / 2)), the product is
+///
+///   Z2 * B^2 + (Z0 + Z2 - (LHS0 - LHS1) * (RHS0 - RHS1)) * B + Z0
+///
+/// where Z0 = LHS0 * RHS0 and Z2 = LHS1 * RHS1.  Using differences rather
+/// than sums for the middle product keeps its operands at ceil(PARTS / 2)
+/// words.  If LHS and RHS are the same all three products are squares.
+static void karatsubaMultiply(APInt::WordType *dst, const APInt::WordType *lhs,
+                              const APInt::WordType *rhs, unsigned parts,
+                              APInt::WordType *scratch) {
+  assert(parts >= 2);
+  unsigned low = (parts + 1) / 2;
+  unsigned high = parts - low;
+
+  APInt::WordType *lhsDiff = scratch;
+  APInt::WordType *rhsDiff = lhsDiff + low;
+  APInt::WordType *middle = rhsDiff + low;    // 2 * low words
+  APInt::WordType *sum = middle + 2 * low;    // 2 * low + 1 words
+  APInt::WordType *next = sum + 2 * low + 1;
+
+  // Z0 and Z2 go straight to their final place in DST.
+  multiplyBalanced(dst, lhs, rhs, low, next);
+  multiplyBalanced(dst + 2 * low, lhs + low, rhs + low, high, next);
+
+  bool lhsNegative = absoluteDifference(lhsDiff, lhs, low, lhs + low, high);
+  bool rhsNegative = lhsNegative;
+  if (lhs == rhs)
+    rhsDiff = lhsDiff;
+  else
+    rhsNegative = absoluteDifference(rhsDiff, rhs, low, rhs + low, high);
+  multiplyBalanced(middle, lhsDiff, rhsDiff, low, next);
+
+  // SUM = Z0 + Z2 - (LHS0 - LHS1) * (RHS0 - RHS1) = LHS0 * RHS1 + LHS1 * RHS0.
+  APInt::tcAssign(sum, dst, 2 * low);
+  sum[2 * low] = 0;
+  addInto(sum, 2 * low + 1, dst + 2 * low, 2 * high);
+  if (lhsNegative != rhsNegative)
+    addInto(sum, 2 * low + 1, middle, 2 * low);
+  else
+    subtractFrom(sum, 2 * low + 1, middle, 2 * low);
+
+  accumulate(dst + low, 2 * parts - low, sum, 2 * low + 1);
 }
 
-/// Returns the bit number of the least significant set bit of a part.  If the
-/// input number has no bits set -1U is returned.
-static unsigned partLSB(APInt::WordType value) {
-  return findFirstSet(value, ZB_Max);
+/// Evaluate the polynomial X2 * t^2 + X1 * t + X0, whose coefficients are the
+/// K, K and TOP word pieces of SRC, at t = 1, -1 and 2.  Each value has K + 1
+/// words; the value at -1 is stored as its magnitude and returns true if it is
+/// negative.
+static bool toom3Evaluate(APInt::WordType *at1, APInt::WordType *atMinus1,
+                          APInt::WordType *at2, const APInt::WordType *src,
+                          unsigned k, unsigned top) {
+  const APInt::WordType *x0 = src, *x1 = src + k, *x2 = src + 2 * k;
+
+  // AT1 = X0 + X2, for now.
+  APInt::tcAssign(at1, x0, k);
+  at1[k] = 0;
+  addInto(at1, k + 1, x2, top);
+
+  bool negative = absoluteDifference(atMinus1, at1, k + 1, x1, k);
+  addInto(at1, k + 1, x1, k);
+
+  // AT2 = (X2 * 2 + X1) * 2 + X0.
+  APInt::tcAssign(at2, x2, top);
+  std::memset(at2 + top, 0, (k + 1 - top) * APInt::APINT_WORD_SIZE);
+  APInt::tcShiftLeft(at2, k + 1, 1);
+  addInto(at2, k + 1, x1, k);
+  APInt::tcShiftLeft(at2, k + 1, 1);
+  addInto(at2, k + 1, x0, k);
+
+  return negative;
 }
 
-/// Sets the least significant part of a bignum to the input value, and zeroes
-/// out higher parts.
-void APInt::tcSet(WordType *dst, WordType part, unsigned parts) {
-  assert(parts > 0);
-  dst[0] = part;
-  for (unsigned i = 1; i < parts; i++)
-    dst[i] = 0;
+/// Divide the two's complement value in DST, which must be a multiple of
+/// three, by three.  This multiplies each word by the inverse of three modulo
+/// 2^64 and propagates the borrow, so it needs no division instructions.
+static void divideExactBy3(APInt::WordType *dst, unsigned parts) {
+  const APInt::WordType Inverse = 0xAAAAAAAAAAAAAAABULL; // 3 * Inverse == 1
+  const APInt::WordType OneThird = 0x5555555555555556ULL;  // ceil(2^64 / 3)
+  const APInt::WordType TwoThirds = 0xAAAAAAAAAAAAAAABULL; // ceil(2^65 / 3)
+
+  APInt::WordType borrow = 0;
+  for (unsigned i = 0; i < parts; i++) {
+    APInt::WordType word = dst[i] - borrow;
+    borrow = dst[i] < borrow;
+    dst[i] = word * Inverse;
+    // 3 * dst[i] overflowed into the next word by this much.
+    borrow += (dst[i] >= OneThird) + (dst[i] >= TwoThirds);
+  }
+}
+
+/// DST = LHS * RHS using one level of the Toom-Cook 3-way algorithm, where
+/// both operands have PARTS words and DST has 2 * PARTS words.  Each operand
+/// is split into three pieces of K = ceil(PARTS / 3) words, read as the
+/// coefficients of a polynomial.  The product polynomial is evaluated at 0,
+/// 1, -1, 2 and infinity with five multiplications of about K words, and its
+/// coefficients are recovered with an interpolation sequence that needs only
+/// additions, shifts and one exact division by three.  If LHS and RHS are the
+/// same it is evaluated once and the five products are squares.
+static void toom3Multiply(APInt::WordType *dst, const APInt::WordType *lhs,
+                          const APInt::WordType *rhs, unsigned parts,
+                          APInt::WordType *scratch) {
+  assert(parts >= 5);
+  unsigned k = (parts + 2) / 3;
+  unsigned top = parts - 2 * k;
+  // Width of the products at 1, -1 and 2, with room for a sign bit.
+  unsigned width = 2 * k + 2;
+
+  APInt::WordType *lhs1 = scratch;
+  APInt::WordType *lhsMinus1 = lhs1 + (k + 1);
+  APInt::WordType *lhs2 = lhsMinus1 + (k + 1);
+  APInt::WordType *rhs1 = lhs2 + (k + 1);
+  APInt::WordType *rhsMinus1 = rhs1 + (k + 1);
+  APInt::WordType *rhs2 = rhsMinus1 + (k + 1);
+  APInt::WordType *r1 = rhs2 + (k + 1);
+  APInt::WordType *r2 = r1 + width;
+  APInt::WordType *r3 = r2 + width;
+  APInt::WordType *next = r3 + width;
+
+  bool lhsNegative = toom3Evaluate(lhs1, lhsMinus1, lhs2, lhs, k, top);
+  bool rhsNegative = lhsNegative;
+  if (lhs == rhs) {
+    rhs1 = lhs1;
+    rhsMinus1 = lhsMinus1;
+    rhs2 = lhs2;
+  } else {
+    rhsNegative = toom3Evaluate(rhs1, rhsMinus1, rhs2, rhs, k, top);
+  }
+
+  // The values at 0 and infinity are the lowest and highest coefficients of
+  // the result, so they go straight to their final place in DST.
+  multiplyBalanced(dst, lhs, rhs, k, next);
+  multiplyBalanced(dst + 4 * k, lhs + 2 * k, rhs + 2 * k, top, next);
+  std::memset(dst + 2 * k, 0, 2 * k * APInt::APINT_WORD_SIZE);
+  const APInt::WordType *r0 = dst, *rInf = dst + 4 * k;
+  unsigned rInfParts = 2 * top;
+
+  multiplyBalanced(r1, lhs1, rhs1, k + 1, next);
+  multiplyBalanced(r2, lhsMinus1, rhsMinus1, k + 1, next);
+  if (lhsNegative != rhsNegative)
+    APInt::tcNegate(r2, width);
+  multiplyBalanced(r3, lhs2, rhs2, k + 1, next);
+
+  // Interpolate. Only r(-1) may be negative; it is kept in two's complement
+  // until it has been folded into a value that is known not to be.
+  //   r3 = (r(2) - r(-1)) / 3 = c1 + c2 + 3 * c3 + 5 * c4
+  APInt::tcSubtract(r3, r2, 0, width);
+  divideExactBy3(r3, width);
+  //   r2 = (r(1) - r(-1)) / 2 = c1 + c3
+  APInt::tcNegate(r2, width);
+  APInt::tcAdd(r2, r1, 0, width);
+  APInt::tcShiftRight(r2, width, 1);
+  //   r1 = r(1) - r(0) = c1 + c2 + c3 + c4
+  subtractFrom(r1, width, r0, 2 * k);
+  //   r3 = (r3 - r1) / 2 = c3 + 2 * c4
+  APInt::tcSubtract(r3, r1, 0, width);
+  APInt::tcShiftRight(r3, width, 1);
+  //   r1 = r1 - r2 - r(inf) = c2
+  APInt::tcSubtract(r1, r2, 0, width);
+  subtractFrom(r1, width, rInf, rInfParts);
+  //   r3 = r3 - 2 * r(inf) = c3
+  subtractFrom(r3, width, rInf, rInfParts);
+  subtractFrom(r3, width, rInf, rInfParts);
+  //   r2 = r2 - r3 = c1
+  APInt::tcSubtract(r2, r3, 0, width);
+
+  accumulate(dst + k, 2 * parts - k, r2, width);
+  accumulate(dst + 2 * k, 2 * parts - 2 * k, r1, width);
+  accumulate(dst + 3 * k, 2 * parts - 3 * k, r3, width);
+}
+
+/// DST = LHS * RHS where both operands have PARTS words and DST has 2 * PARTS
+/// words, choosing the algorithm by size.  SCRATCH must hold at least
+/// multiplyScratchParts(PARTS) words.
+static void multiplyBalanced(APInt::WordType *dst, const APInt::WordType *lhs,
+                             const APInt::WordType *rhs, unsigned parts,
+                             APInt::WordType *scratch) {
+  if (parts < APInt::APINT_KARATSUBA_THRESHOLD)
+    APInt::tcFullMultiply(dst, lhs, rhs, parts, parts);
+  else if (parts < APInt::APINT_TOOM3_THRESHOLD)
+    karatsubaMultiply(dst, lhs, rhs, parts, scratch);
+  else
+    toom3Multiply(dst, lhs, rhs, parts, scratch);
+}
+
+int APInt::tcMultiplyWide(WordType *dst, const WordType *lhs,
+                          unsigned lhsParts, const WordType *rhs,
+                          unsigned rhsParts, unsigned parts) {
+  unsigned fullParts = lhsParts + rhsParts;
+  WordType *full = getMemory(fullParts);
+  tcFullMultiply(full, lhs, rhs, lhsParts, rhsParts);
+
+  unsigned n = std::min(parts, fullParts);
+  tcAssign(dst, full, n);
+  std::memset(dst + n, 0, (parts - n) * APINT_WORD_SIZE);
+  int overflow = !std::all_of(full + n, full + fullParts,
+                              [](WordType w) { return w == 0; });
+  deallocateWords(full, fullParts);
+  return overflow;
 }
 
-/// Assign one bignum to another.
-void APInt::tcAssign(WordType *dst, const WordType *src, unsigned parts) {
-  for (unsigned i = 0; i < parts; i++)
-    dst[i] = src[i];
+void APInt::tcFullMultiplyWide(WordType *dst, const WordType *lhs,
+                               const WordType *rhs, unsigned lhsParts,
+                               unsigned rhsParts) {
+  // Multiply LHS by RHS in blocks of LHSPARTS words, so that each block
+  // product is balanced.
+  unsigned n = lhsParts;
+  WordType *product = getMemory(2 * n + multiplyScratchParts(n));
+  tcSet(dst, 0, lhsParts + rhsParts);
+
+  for (unsigned i = 0; i < rhsParts; i += n) {
+    unsigned blockParts = std::min(n, rhsParts - i);
+    if (blockParts == n)
+      multiplyBalanced(product, lhs, rhs + i, n, product + 2 * n);
+    else
+      tcFullMultiply(product, rhs + i, lhs, blockParts, n);
+    accumulate(dst + i, lhsParts + rhsParts - i, product, n + blockParts);
+  }
+
+  deallocateWords(product, 2 * n + multiplyScratchParts(n));
 }
 
-/// Returns true if a bignum is zero, false otherwise.
-bool APInt::tcIsZero(const WordType *src, unsigned parts) {
-  for (unsigned i = 0; i < parts; i++)
-    if (src[i])
-      return false;
+void APInt::tcSquareWide(WordType *dst, const WordType *src,
+                         unsigned srcParts, unsigned dstParts) {
+  unsigned scratchParts = multiplyScratchParts(srcParts);
+  if (dstParts >= 2 * srcParts) {
+    WordType *scratch = getMemory(scratchParts);
+    multiplyBalanced(dst, src, src, srcParts, scratch);
+    std::memset(dst + 2 * srcParts, 0,
+                (dstParts - 2 * srcParts) * APINT_WORD_SIZE);
+    deallocateWords(scratch, scratchParts);
+    return;
+  }
 
-  return true;
+  // Square in full, then keep the low words.
+  WordType *full = getMemory(2 * srcParts + scratchParts);
+  multiplyBalanced(full, src, src, srcParts, full + 2 * srcParts);
+  tcAssign(dst, full, dstParts);
+  deallocateWords(full, 2 * srcParts + scratchParts);
 }
 
-/// Extract the given bit of a bignum; returns 0 or 1.
-int APInt::tcExtractBit(const WordType *parts, unsigned bit) {
-  return (parts[whichWord(bit)] & maskBit(bit)) != 0;
+void APInt::tcKaratsubaMultiply(WordType *dst, const WordType *lhs,
+                                const WordType *rhs, unsigned parts) {
+  assert(parts >= 2 && "Too narrow to split");
+  assert(dst != lhs && dst != rhs);
+
+  WordType *scratch = getMemory(karatsubaScratchParts(parts));
+  karatsubaMultiply(dst, lhs, rhs, parts, scratch);
+  deallocateWords(scratch, karatsubaScratchParts(parts));
 }
 
-/// Set the given bit of a bignum.
-void APInt::tcSetBit(WordType *parts, unsigned bit) {
-  parts[whichWord(bit)] |= maskBit(bit);
+void APInt::tcToom3Multiply(WordType *dst, const WordType *lhs,
+                            const WordType *rhs, unsigned parts) {
+  assert(parts >= 5 && "Too narrow to split");
+  assert(dst != lhs && dst != rhs);
+
+  WordType *scratch = getMemory(toom3ScratchParts(parts));
+  toom3Multiply(dst, lhs, rhs, parts, scratch);
+  deallocateWords(scratch, toom3ScratchParts(parts));
 }
 
-/// Clears the given bit of a bignum.
-void APInt::tcClearBit(WordType *parts, unsigned bit) {
-  parts[whichWord(bit)] &= ~maskBit(bit);
+// Word-wise kernels for the bitwise, population count and comparison slow
+// cases. Wide APInts are commonly used as bit sets, where these dominate, so
+// they use the widest vector instructions of the host CPU. The kernels are
+// selected once, on first use.
+
+static void andWords(APInt::WordType *dst, const APInt::WordType *rhs,
+                     unsigned parts) {
+  for (unsigned i = 0; i != parts; ++i)
+    dst[i] &= rhs[i];
 }
 
-/// Returns the bit number of the least significant set bit of a number.  If the
-/// input number has no bits set -1U is returned.
-unsigned APInt::tcLSB(const WordType *parts, unsigned n) {
-  for (unsigned i = 0; i < n; i++) {
-    if (parts[i] != 0) {
-      unsigned lsb = partLSB(parts[i]);
-      return lsb + i * APINT_BITS_PER_WORD;
-    }
-  }
+static void orWords(APInt::WordType *dst, const APInt::WordType *rhs,
+                    unsigned parts) {
+  for (unsigned i = 0; i != parts; ++i)
+    dst[i] |= rhs[i];
+}
 
-  return -1U;
+static void xorWords(APInt::WordType *dst, const APInt::WordType *rhs,
+                     unsigned parts) {
+  for (unsigned i = 0; i != parts; ++i)
+    dst[i] ^= rhs[i];
 }
 
-/// Returns the bit number of the most significant set bit of a number.
-/// If the input number has no bits set -1U is returned.
-unsigned APInt::tcMSB(const WordType *parts, unsigned n) {
-  do {
-    --n;
+static void complementWords(APInt::WordType *dst, unsigned parts) {
+  for (unsigned i = 0; i != parts; ++i)
+    dst[i] = ~dst[i];
+}
 
-    if (parts[n] != 0) {
-      unsigned msb = partMSB(parts[n]);
+static unsigned populationWords(const APInt::WordType *src, unsigned parts) {
+  unsigned Count = 0;
+  for (unsigned i = 0; i != parts; ++i)
+    Count += countPopulation(src[i]);
+  return Count;
+}
 
-      return msb + n * APINT_BITS_PER_WORD;
-    }
-  } while (n);
+static bool equalWords(const APInt::WordType *lhs, const APInt::WordType *rhs,
+                       unsigned parts) {
+  return std::equal(lhs, lhs + parts, rhs);
+}
 
-  return -1U;
+static bool intersectsWords(const APInt::WordType *lhs,
+                            const APInt::WordType *rhs, unsigned parts) {
+  for (unsigned i = 0; i != parts; ++i)
+    if ((lhs[i] & rhs[i]) != 0)
+      return true;
+  return false;
 }
 
-/// Copy the bit vector of width srcBITS from SRC, starting at bit srcLSB, to
-/// DST, of dstCOUNT parts, such that the bit srcLSB becomes the least
-/// significant bit of DST.  All high bits above srcBITS in DST are zero-filled.
-/// */
-void
-APInt::tcExtract(WordType *dst, unsigned dstCount, const WordType *src,
-                 unsigned srcBits, unsigned srcLSB) {
-  unsigned dstParts = (srcBits + APINT_BITS_PER_WORD - 1) / APINT_BITS_PER_WORD;
-  assert(dstParts <= dstCount);
+static bool isSubsetOfWords(const APInt::WordType *lhs,
+                            const APInt::WordType *rhs, unsigned parts) {
+  for (unsigned i = 0; i != parts; ++i)
+    if ((lhs[i] & ~rhs[i]) != 0)
+      return false;
+  return true;
+}
 
-  unsigned firstSrcPart = srcLSB / APINT_BITS_PER_WORD;
-  tcAssign(dst, src + firstSrcPart, dstParts);
+#if BIJOU_HAS_X86_KERNELS
+#define BIJOU_TARGET_AVX2 __attribute__((target("avx2")))
+#define BIJOU_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#define BIJOU_TARGET_AVX512_POPCNT                                             \
+  __attribute__((target("avx512f,avx512bw,avx512vpopcntdq")))
 
-  unsigned shift = srcLSB % APINT_BITS_PER_WORD;
-  tcShiftRight(dst, dstParts, shift);
+// AVX2 kernels on four words at a time. The remaining words go through the
+// word loops.
 
-  // We now have (dstParts * APINT_BITS_PER_WORD - shift) bits from SRC
-  // in DST.  If this is less that srcBits, append the rest, else
-  // clear the high bits.
-  unsigned n = dstParts * APINT_BITS_PER_WORD - shift;
-  if (n < srcBits) {
-    WordType mask = lowBitMask (srcBits - n);
-    dst[dstParts - 1] |= ((src[firstSrcPart + dstParts] & mask)
-                          << n % APINT_BITS_PER_WORD);
-  } else if (n > srcBits) {
-    if (srcBits % APINT_BITS_PER_WORD)
-      dst[dstParts - 1] &= lowBitMask (srcBits % APINT_BITS_PER_WORD);
+BIJOU_TARGET_AVX2
+static void andWordsAVX2(APInt::WordType *dst, const APInt::WordType *rhs,
+                         unsigned parts) {
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i L = _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+    __m256i R = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_and_si256(L, R));
   }
-
-  // Clear high parts.
-  while (dstParts < dstCount)
-    dst[dstParts++] = 0;
+  andWords(dst + i, rhs + i, parts - i);
 }
 
-//// DST += RHS + C where C is zero or one.  Returns the carry flag.
-APInt::WordType APInt::tcAdd(WordType *dst, const WordType *rhs,
-                             WordType c, unsigned parts) {
-  assert(c <= 1);
+BIJOU_TARGET_AVX2
+static void orWordsAVX2(APInt::WordType *dst, const APInt::WordType *rhs,
+                        unsigned parts) {
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i L = _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+    __m256i R = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_or_si256(L, R));
+  }
+  orWords(dst + i, rhs + i, parts - i);
+}
 
-  for (unsigned i = 0; i < parts; i++) {
-    WordType l = dst[i];
-    if (c) {
-      dst[i] += rhs[i] + 1;
-      c = (dst[i] <= l);
-    } else {
-      dst[i] += rhs[i];
-      c = (dst[i] < l);
-    }
+BIJOU_TARGET_AVX2
+static void xorWordsAVX2(APInt::WordType *dst, const APInt::WordType *rhs,
+                         unsigned parts) {
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i L = _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+    __m256i R = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_xor_si256(L, R));
   }
+  xorWords(dst + i, rhs + i, parts - i);
+}
 
-  return c;
+BIJOU_TARGET_AVX2
+static void complementWordsAVX2(APInt::WordType *dst, unsigned parts) {
+  const __m256i Ones = _mm256_set1_epi64x(-1);
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i V = _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_xor_si256(V, Ones));
+  }
+  complementWords(dst + i, parts - i);
+}
+
+/// Count the bits of four words at a time by looking up the counts of each
+/// nibble with a byte shuffle, then summing the bytes of each word with
+/// VPSADBW (Mula, Kurz and Lemire, "Faster Population Counts Using AVX2
+/// Instructions").
+BIJOU_TARGET_AVX2
+static unsigned populationWordsAVX2(const APInt::WordType *src,
+                                    unsigned parts) {
+  const __m256i Table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                         3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                         2, 3, 2, 3, 3, 4);
+  const __m256i LowNibbles = _mm256_set1_epi8(0x0f);
+  __m256i Sum = _mm256_setzero_si256();
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i V = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    __m256i Lo = _mm256_and_si256(V, LowNibbles);
+    __m256i Hi = _mm256_and_si256(_mm256_srli_epi16(V, 4), LowNibbles);
+    __m256i Bytes = _mm256_add_epi8(_mm256_shuffle_epi8(Table, Lo),
+                                    _mm256_shuffle_epi8(Table, Hi));
+    Sum = _mm256_add_epi64(Sum,
+                           _mm256_sad_epu8(Bytes, _mm256_setzero_si256()));
+  }
+  uint64_t Lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(Lanes), Sum);
+  return unsigned(Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3]) +
+         populationWords(src + i, parts - i);
+}
+
+BIJOU_TARGET_AVX2
+static bool equalWordsAVX2(const APInt::WordType *lhs,
+                           const APInt::WordType *rhs, unsigned parts) {
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i L = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+    __m256i R = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+    __m256i Diff = _mm256_xor_si256(L, R);
+    if (!_mm256_testz_si256(Diff, Diff))
+      return false;
+  }
+  return equalWords(lhs + i, rhs + i, parts - i);
 }
 
-/// This function adds a single "word" integer, src, to the multiple
-/// "word" integer array, dst[]. dst[] is modified to reflect the addition and
-/// 1 is returned if there is a carry out, otherwise 0 is returned.
-/// @returns the carry of the addition.
-APInt::WordType APInt::tcAddPart(WordType *dst, WordType src,
-                                 unsigned parts) {
-  for (unsigned i = 0; i < parts; ++i) {
-    dst[i] += src;
-    if (dst[i] >= src)
-      return 0; // No need to carry so exit early.
-    src = 1; // Carry one to next digit.
+BIJOU_TARGET_AVX2
+static bool intersectsWordsAVX2(const APInt::WordType *lhs,
+                                const APInt::WordType *rhs, unsigned parts) {
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i L = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+    __m256i R = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+    // VPTEST sets ZF if L & R is zero.
+    if (!_mm256_testz_si256(L, R))
+      return true;
   }
+  return intersectsWords(lhs + i, rhs + i, parts - i);
+}
 
-  return 1;
+BIJOU_TARGET_AVX2
+static bool isSubsetOfWordsAVX2(const APInt::WordType *lhs,
+                                const APInt::WordType *rhs, unsigned parts) {
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    __m256i L = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+    __m256i R = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+    // VPTEST sets CF if ~R & L is zero.
+    if (!_mm256_testc_si256(R, L))
+      return false;
+  }
+  return isSubsetOfWords(lhs + i, rhs + i, parts - i);
 }
 
-/// DST -= RHS + C where C is zero or one.  Returns the carry flag.
-APInt::WordType APInt::tcSubtract(WordType *dst, const WordType *rhs,
-                                  WordType c, unsigned parts) {
-  assert(c <= 1);
+// AVX-512 kernels on eight words at a time. The remaining words use masked
+// loads and stores, which do not touch the words beyond the end.
 
-  for (unsigned i = 0; i < parts; i++) {
-    WordType l = dst[i];
-    if (c) {
-      dst[i] -= rhs[i] + 1;
-      c = (dst[i] >= l);
-    } else {
-      dst[i] -= rhs[i];
-      c = (dst[i] > l);
-    }
-  }
+// GCC 12 warns about the deliberately undefined vectors in the intrinsics
+// that these kernels inline (GCC bug 105593).
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
 
-  return c;
+/// @returns the mask of the words of an eight word block starting at word I,
+/// of which there are PARTS in total.
+static inline __mmask8 getTailMask(unsigned i, unsigned parts) {
+  return parts - i >= 8 ? __mmask8(0xff) : __mmask8((1u << (parts - i)) - 1);
 }
 
-/// This function subtracts a single "word" (64-bit word), src, from
-/// the multi-word integer array, dst[], propagating the borrowed 1 value until
-/// no further borrowing is needed or it runs out of "words" in dst.  The result
-/// is 1 if "borrowing" exhausted the digits in dst, or 0 if dst was not
-/// exhausted. In other words, if src > dst then this function returns 1,
-/// otherwise 0.
-/// @returns the borrow out of the subtraction
-APInt::WordType APInt::tcSubtractPart(WordType *dst, WordType src,
-                                      unsigned parts) {
-  for (unsigned i = 0; i < parts; ++i) {
-    WordType Dst = dst[i];
-    dst[i] -= src;
-    if (src <= Dst)
-      return 0; // No need to borrow so exit early.
-    src = 1; // We have to "borrow 1" from next "word"
-  }
-
-  return 1;
-}
-
-/// Negate a bignum in-place.
-void APInt::tcNegate(WordType *dst, unsigned parts) {
-  tcComplement(dst, parts);
-  tcIncrement(dst, parts);
-}
-
-/// DST += SRC * MULTIPLIER + CARRY   if add is true
-/// DST  = SRC * MULTIPLIER + CARRY   if add is false
-/// Requires 0 <= DSTPARTS <= SRCPARTS + 1.  If DST overlaps SRC
-/// they must start at the same point, i.e. DST == SRC.
-/// If DSTPARTS == SRCPARTS + 1 no overflow occurs and zero is
-/// returned.  Otherwise DST is filled with the least significant
-/// DSTPARTS parts of the result, and if all of the omitted higher
-/// parts were zero return zero, otherwise overflow occurred and
-/// return one.
-int APInt::tcMultiplyPart(WordType *dst, const WordType *src,
-                          WordType multiplier, WordType carry,
-                          unsigned srcParts, unsigned dstParts,
-                          bool add) {
-  // Otherwise our writes of DST kill our later reads of SRC.
-  assert(dst <= src || dst >= src + srcParts);
-  assert(dstParts <= srcParts + 1);
-
-  // N loops; minimum of dstParts and srcParts.
-  unsigned n = std::min(dstParts, srcParts);
-
-  for (unsigned i = 0; i < n; i++) {
-    // [LOW, HIGH] = MULTIPLIER * SRC[i] + DST[i] + CARRY.
-    // This cannot overflow, because:
-    //   (n - 1) * (n - 1) + 2 (n - 1) = (n - 1) * (n + 1)
-    // which is less than n^2.
-    WordType srcPart = src[i];
-    WordType low, mid, high;
-    if (multiplier == 0 || srcPart == 0) {
-      low = carry;
-      high = 0;
-    } else {
-      low = lowHalf(srcPart) * lowHalf(multiplier);
-      high = highHalf(srcPart) * highHalf(multiplier);
-
-      mid = lowHalf(srcPart) * highHalf(multiplier);
-      high += highHalf(mid);
-      mid <<= APINT_BITS_PER_WORD / 2;
-      if (low + mid < low)
-        high++;
-      low += mid;
-
-      mid = highHalf(srcPart) * lowHalf(multiplier);
-      high += highHalf(mid);
-      mid <<= APINT_BITS_PER_WORD / 2;
-      if (low + mid < low)
-        high++;
-      low += mid;
-
-      // Now add carry.
-      if (low + carry < low)
-        high++;
-      low += carry;
-    }
+BIJOU_TARGET_AVX512
+static void andWordsAVX512(APInt::WordType *dst, const APInt::WordType *rhs,
+                           unsigned parts) {
+  for (unsigned i = 0; i < parts; i += 8) {
+    __mmask8 M = getTailMask(i, parts);
+    __m512i L = _mm512_maskz_loadu_epi64(M, dst + i);
+    __m512i R = _mm512_maskz_loadu_epi64(M, rhs + i);
+    _mm512_mask_storeu_epi64(dst + i, M, _mm512_and_si512(L, R));
+  }
+}
 
-    if (add) {
-      // And now DST[i], and store the new low part there.
-      if (low + dst[i] < low)
-        high++;
-      dst[i] += low;
-    } else
-      dst[i] = low;
+BIJOU_TARGET_AVX512
+static void orWordsAVX512(APInt::WordType *dst, const APInt::WordType *rhs,
+                          unsigned parts) {
+  for (unsigned i = 0; i < parts; i += 8) {
+    __mmask8 M = getTailMask(i, parts);
+    __m512i L = _mm512_maskz_loadu_epi64(M, dst + i);
+    __m512i R = _mm512_maskz_loadu_epi64(M, rhs + i);
+    _mm512_mask_storeu_epi64(dst + i, M, _mm512_or_si512(L, R));
+  }
+}
 
-    carry = high;
+BIJOU_TARGET_AVX512
+static void xorWordsAVX512(APInt::WordType *dst, const APInt::WordType *rhs,
+                           unsigned parts) {
+  for (unsigned i = 0; i < parts; i += 8) {
+    __mmask8 M = getTailMask(i, parts);
+    __m512i L = _mm512_maskz_loadu_epi64(M, dst + i);
+    __m512i R = _mm512_maskz_loadu_epi64(M, rhs + i);
+    _mm512_mask_storeu_epi64(dst + i, M, _mm512_xor_si512(L, R));
   }
+}
 
-  if (srcParts < dstParts) {
-    // Full multiplication, there is no overflow.
-    assert(srcParts + 1 == dstParts);
-    dst[srcParts] = carry;
-    return 0;
+BIJOU_TARGET_AVX512
+static void complementWordsAVX512(APInt::WordType *dst, unsigned parts) {
+  const __m512i Ones = _mm512_set1_epi64(-1);
+  for (unsigned i = 0; i < parts; i += 8) {
+    __mmask8 M = getTailMask(i, parts);
+    __m512i V = _mm512_maskz_loadu_epi64(M, dst + i);
+    _mm512_mask_storeu_epi64(dst + i, M, _mm512_xor_si512(V, Ones));
   }
+}
 
-  // We overflowed if there is carry.
-  if (carry)
-    return 1;
+/// The nibble lookup population count of populationWordsAVX2, on eight
+/// words at a time.
+BIJOU_TARGET_AVX512
+static unsigned populationWordsAVX512(const APInt::WordType *src,
+                                      unsigned parts) {
+  const __m512i Table = _mm512_broadcast_i32x4(
+      _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+  const __m512i LowNibbles = _mm512_set1_epi8(0x0f);
+  __m512i Sum = _mm512_setzero_si512();
+  for (unsigned i = 0; i < parts; i += 8) {
+    __m512i V = _mm512_maskz_loadu_epi64(getTailMask(i, parts), src + i);
+    __m512i Lo = _mm512_and_si512(V, LowNibbles);
+    __m512i Hi = _mm512_and_si512(_mm512_srli_epi16(V, 4), LowNibbles);
+    __m512i Bytes = _mm512_add_epi8(_mm512_shuffle_epi8(Table, Lo),
+                                    _mm512_shuffle_epi8(Table, Hi));
+    Sum = _mm512_add_epi64(Sum,
+                           _mm512_sad_epu8(Bytes, _mm512_setzero_si512()));
+  }
+  return unsigned(_mm512_reduce_add_epi64(Sum));
+}
+
+/// Population count with the VPOPCNTQ instruction.
+BIJOU_TARGET_AVX512_POPCNT
+static unsigned populationWordsAVX512Popcnt(const APInt::WordType *src,
+                                            unsigned parts) {
+  __m512i Sum = _mm512_setzero_si512();
+  for (unsigned i = 0; i < parts; i += 8) {
+    __m512i V = _mm512_maskz_loadu_epi64(getTailMask(i, parts), src + i);
+    Sum = _mm512_add_epi64(Sum, _mm512_popcnt_epi64(V));
+  }
+  return unsigned(_mm512_reduce_add_epi64(Sum));
+}
+
+BIJOU_TARGET_AVX512
+static bool equalWordsAVX512(const APInt::WordType *lhs,
+                             const APInt::WordType *rhs, unsigned parts) {
+  for (unsigned i = 0; i < parts; i += 8) {
+    __mmask8 M = getTailMask(i, parts);
+    __m512i L = _mm512_maskz_loadu_epi64(M, lhs + i);
+    __m512i R = _mm512_maskz_loadu_epi64(M, rhs + i);
+    if (_mm512_cmpneq_epi64_mask(L, R))
+      return false;
+  }
+  return true;
+}
 
-  // We would overflow if any significant unwritten parts would be
-  // non-zero.  This is true if any remaining src parts are non-zero
-  // and the multiplier is non-zero.
-  if (multiplier)
-    for (unsigned i = dstParts; i < srcParts; i++)
-      if (src[i])
-        return 1;
+BIJOU_TARGET_AVX512
+static bool intersectsWordsAVX512(const APInt::WordType *lhs,
+                                  const APInt::WordType *rhs, unsigned parts) {
+  for (unsigned i = 0; i < parts; i += 8) {
+    __mmask8 M = getTailMask(i, parts);
+    __m512i L = _mm512_maskz_loadu_epi64(M, lhs + i);
+    __m512i R = _mm512_maskz_loadu_epi64(M, rhs + i);
+    if (_mm512_test_epi64_mask(L, R))
+      return true;
+  }
+  return false;
+}
 
-  // We fitted in the narrow destination.
-  return 0;
+BIJOU_TARGET_AVX512
+static bool isSubsetOfWordsAVX512(const APInt::WordType *lhs,
+                                  const APInt::WordType *rhs, unsigned parts) {
+  for (unsigned i = 0; i < parts; i += 8) {
+    __mmask8 M = getTailMask(i, parts);
+    __m512i L = _mm512_maskz_loadu_epi64(M, lhs + i);
+    __m512i R = _mm512_maskz_loadu_epi64(M, rhs + i);
+    __m512i Extra = _mm512_andnot_si512(R, L);
+    if (_mm512_test_epi64_mask(Extra, Extra))
+      return false;
+  }
+  return true;
 }
 
-/// DST = LHS * RHS, where DST has the same width as the operands and
-/// is filled with the least significant parts of the result.  Returns
-/// one if overflow occurred, otherwise zero.  DST must be disjoint
-/// from both operands.
-int APInt::tcMultiply(WordType *dst, const WordType *lhs,
-                      const WordType *rhs, unsigned parts) {
-  assert(dst != lhs && dst != rhs);
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
 
-  int overflow = 0;
-  tcSet(dst, 0, parts);
+#undef BIJOU_TARGET_AVX2
+#undef BIJOU_TARGET_AVX512
+#undef BIJOU_TARGET_AVX512_POPCNT
+#endif // BIJOU_HAS_X86_KERNELS
+
+namespace {
+/// The word-wise kernels for the host CPU.
+struct WordKernels {
+  void (*And)(APInt::WordType *, const APInt::WordType *, unsigned);
+  void (*Or)(APInt::WordType *, const APInt::WordType *, unsigned);
+  void (*Xor)(APInt::WordType *, const APInt::WordType *, unsigned);
+  void (*Complement)(APInt::WordType *, unsigned);
+  unsigned (*Population)(const APInt::WordType *, unsigned);
+  bool (*Equal)(const APInt::WordType *, const APInt::WordType *, unsigned);
+  bool (*Intersects)(const APInt::WordType *, const APInt::WordType *,
+                     unsigned);
+  bool (*IsSubsetOf)(const APInt::WordType *, const APInt::WordType *,
+                     unsigned);
+};
+} // end anonymous namespace
+
+static WordKernels selectWordKernels() {
+#if BIJOU_HAS_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return {andWordsAVX512,
+            orWordsAVX512,
+            xorWordsAVX512,
+            complementWordsAVX512,
+            __builtin_cpu_supports("avx512vpopcntdq")
+                ? populationWordsAVX512Popcnt
+                : populationWordsAVX512,
+            equalWordsAVX512,
+            intersectsWordsAVX512,
+            isSubsetOfWordsAVX512};
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return {andWordsAVX2,        orWordsAVX2,        xorWordsAVX2,
+            complementWordsAVX2, populationWordsAVX2, equalWordsAVX2,
+            intersectsWordsAVX2, isSubsetOfWordsAVX2};
+  }
+#endif
+  return {andWords,        orWords,    xorWords,        complementWords,
+          populationWords, equalWords, intersectsWords, isSubsetOfWords};
+}
 
-  for (unsigned i = 0; i < parts; i++)
-    overflow |= tcMultiplyPart(&dst[i], lhs, rhs[i], 0, parts,
-                               parts - i, true);
+static const WordKernels &getWordKernels() {
+  static const WordKernels Kernels = selectWordKernels();
+  return Kernels;
+}
 
-  return overflow;
+void APInt::tcAndVector(WordType *dst, const WordType *rhs, unsigned parts) {
+  getWordKernels().And(dst, rhs, parts);
 }
 
-/// DST = LHS * RHS, where DST has width the sum of the widths of the
-/// operands. No overflow occurs. DST must be disjoint from both operands.
-void APInt::tcFullMultiply(WordType *dst, const WordType *lhs,
-                           const WordType *rhs, unsigned lhsParts,
-                           unsigned rhsParts) {
-  // Put the narrower number on the LHS for less loops below.
-  if (lhsParts > rhsParts)
-    return tcFullMultiply (dst, rhs, lhs, rhsParts, lhsParts);
+void APInt::tcOrVector(WordType *dst, const WordType *rhs, unsigned parts) {
+  getWordKernels().Or(dst, rhs, parts);
+}
 
-  assert(dst != lhs && dst != rhs);
+void APInt::tcXorVector(WordType *dst, const WordType *rhs, unsigned parts) {
+  getWordKernels().Xor(dst, rhs, parts);
+}
 
-  tcSet(dst, 0, rhsParts);
+void APInt::tcComplementVector(WordType *dst, unsigned parts) {
+  getWordKernels().Complement(dst, parts);
+}
 
-  for (unsigned i = 0; i < lhsParts; i++)
-    tcMultiplyPart(&dst[i], rhs, lhs[i], 0, rhsParts, rhsParts + 1, true);
+unsigned APInt::tcPopulationVector(const WordType *src, unsigned parts) {
+  return getWordKernels().Population(src, parts);
 }
 
-// If RHS is zero LHS and REMAINDER are left unchanged, return one.
-// Otherwise set LHS to LHS / RHS with the fractional part discarded,
-// set REMAINDER to the remainder, return zero.  i.e.
-//
-//   OLD_LHS = RHS * LHS + REMAINDER
-//
-// SCRATCH is a bignum of the same size as the operands and result for
-// use by the routine; its contents need not be initialized and are
-// destroyed.  LHS, REMAINDER and SCRATCH must be distinct.
-int APInt::tcDivide(WordType *lhs, const WordType *rhs,
-                    WordType *remainder, WordType *srhs,
-                    unsigned parts) {
-  assert(lhs != remainder && lhs != srhs && remainder != srhs);
+bool APInt::tcEqualVector(const WordType *lhs, const WordType *rhs,
+                          unsigned parts) {
+  return getWordKernels().Equal(lhs, rhs, parts);
+}
 
-  unsigned shiftCount = tcMSB(rhs, parts) + 1;
-  if (shiftCount == 0)
-    return true;
+bool APInt::tcIntersectsVector(const WordType *lhs, const WordType *rhs,
+                               unsigned parts) {
+  return getWordKernels().Intersects(lhs, rhs, parts);
+}
 
-  shiftCount = parts * APINT_BITS_PER_WORD - shiftCount;
-  unsigned n = shiftCount / APINT_BITS_PER_WORD;
-  WordType mask = (WordType) 1 << (shiftCount % APINT_BITS_PER_WORD);
+bool APInt::tcIsSubsetOfVector(const WordType *lhs, const WordType *rhs,
+                               unsigned parts) {
+  return getWordKernels().IsSubsetOf(lhs, rhs, parts);
+}
 
-  tcAssign(srhs, rhs, parts);
-  tcShiftLeft(srhs, parts, shiftCount);
-  tcAssign(remainder, lhs, parts);
-  tcSet(lhs, 0, parts);
+// Carry chain kernels for tcAdd, tcSubtract and tcMultiplyPart. On x86-64 the
+// additions use ADC chains, and the multiplications MULX with two independent
+// carry chains in ADCX and ADOX where the CPU has BMI2 and ADX.
 
-  // Loop, subtracting SRHS if REMAINDER is greater and adding that to the
-  // total.
-  for (;;) {
-    int compare = tcCompare(remainder, srhs, parts);
-    if (compare >= 0) {
-      tcSubtract(remainder, srhs, 0, parts);
-      lhs[n] |= mask;
-    }
+/// @returns the low word of A * B, storing the high word in HIGH.
+static inline APInt::WordType multiplyWords(APInt::WordType A,
+                                            APInt::WordType B,
+                                            APInt::WordType &High) {
+#if BIJOU_HAS_INT128
+  unsigned __int128 Product = static_cast<unsigned __int128>(A) * B;
+  High = uint64_t(Product >> 64);
+  return uint64_t(Product);
+#else
+  uint64_t LL = uint64_t(Lo_32(A)) * Lo_32(B);
+  uint64_t LH = uint64_t(Lo_32(A)) * Hi_32(B);
+  uint64_t HL = uint64_t(Hi_32(A)) * Lo_32(B);
+  uint64_t HH = uint64_t(Hi_32(A)) * Hi_32(B);
+  uint64_t Mid = uint64_t(Hi_32(LL)) + Lo_32(LH) + Lo_32(HL);
+  High = HH + Hi_32(LH) + Hi_32(HL) + Hi_32(Mid);
+  return (Mid << 32) | Lo_32(LL);
+#endif
+}
 
-    if (shiftCount == 0)
-      break;
-    shiftCount--;
-    tcShiftRight(srhs, parts, 1);
-    if ((mask >>= 1) == 0) {
-      mask = (WordType) 1 << (APINT_BITS_PER_WORD - 1);
-      n--;
-    }
+static APInt::WordType multiplyAddWords(APInt::WordType *dst,
+                                        const APInt::WordType *src,
+                                        APInt::WordType multiplier,
+                                        APInt::WordType carry, unsigned parts) {
+  for (unsigned i = 0; i < parts; ++i) {
+    // The sum fits in two words, as (b - 1) * (b - 1) + 2 * (b - 1) < b^2.
+    APInt::WordType high, low = multiplyWords(src[i], multiplier, high);
+    low += carry;
+    high += low < carry;
+    low += dst[i];
+    high += low < dst[i];
+    dst[i] = low;
+    carry = high;
   }
-
-  return false;
+  return carry;
 }
 
-/// Shift a bignum left Cound bits in-place. Shifted in bits are zero. There are
-/// no restrictions on Count.
-void APInt::tcShiftLeft(WordType *Dst, unsigned Words, unsigned Count) {
-  // Don't bother performing a no-op shift.
-  if (!Count)
-    return;
-
-  // WordShift is the inter-part shift; BitShift is the intra-part shift.
-  unsigned WordShift = std::min(Count / APINT_BITS_PER_WORD, Words);
-  unsigned BitShift = Count % APINT_BITS_PER_WORD;
-
-  // Fastpath for moving by whole words.
-  if (BitShift == 0) {
-    std::memmove(Dst + WordShift, Dst, (Words - WordShift) * APINT_WORD_SIZE);
-  } else {
-    while (Words-- > WordShift) {
-      Dst[Words] = Dst[Words - WordShift] << BitShift;
-      if (Words > WordShift)
-        Dst[Words] |=
-          Dst[Words - WordShift - 1] >> (APINT_BITS_PER_WORD - BitShift);
-    }
+static APInt::WordType multiplyWordsBy(APInt::WordType *dst,
+                                       const APInt::WordType *src,
+                                       APInt::WordType multiplier,
+                                       APInt::WordType carry, unsigned parts) {
+  for (unsigned i = 0; i < parts; ++i) {
+    APInt::WordType high, low = multiplyWords(src[i], multiplier, high);
+    low += carry;
+    high += low < carry;
+    dst[i] = low;
+    carry = high;
   }
-
-  // Fill in the remainder with 0s.
-  std::memset(Dst, 0, WordShift * APINT_WORD_SIZE);
+  return carry;
+}
+
+#if BIJOU_HAS_X86_KERNELS
+// The loops below count an index in RCX up to zero, so that JRCXZ can end
+// them without disturbing the carry and overflow flags.
+
+/// multiplyAddWords on one word at a time. MULX leaves the flags alone, so
+/// the carry into the high word runs through ADCX while the sum with DST runs
+/// through ADOX.
+__attribute__((target("bmi2,adx")))
+static APInt::WordType multiplyAddWordsADX(APInt::WordType *dst,
+                                           const APInt::WordType *src,
+                                           APInt::WordType multiplier,
+                                           APInt::WordType carry,
+                                           unsigned parts) {
+  if (parts == 0)
+    return carry;
+  uint64_t Index = -uint64_t(parts), Low, High;
+  __asm__("xor %%eax, %%eax\n\t"
+          "1:\n\t"
+          "mulx (%[src],%[i],8), %[lo], %[hi]\n\t"
+          "adcx %[carry], %[lo]\n\t"
+          "adox (%[dst],%[i],8), %[lo]\n\t"
+          "mov %[lo], (%[dst],%[i],8)\n\t"
+          "mov %[hi], %[carry]\n\t"
+          "lea 1(%[i]), %[i]\n\t"
+          "jrcxz 2f\n\t"
+          "jmp 1b\n"
+          "2:\n\t"
+          "mov $0, %%eax\n\t"
+          "adcx %%rax, %[carry]\n\t"
+          "adox %%rax, %[carry]"
+          : [carry] "+&r"(carry), [i] "+&c"(Index), [lo] "=&r"(Low),
+            [hi] "=&r"(High)
+          : [src] "r"(src + parts), [dst] "r"(dst + parts), "d"(multiplier)
+          : "rax", "cc", "memory");
+  return carry;
+}
+
+/// multiplyAddWordsADX unrolled to four words at a time, for the inner loop
+/// of schoolbook multiplication.
+__attribute__((target("bmi2,adx")))
+static APInt::WordType multiplyAddWordsADX4(APInt::WordType *dst,
+                                            const APInt::WordType *src,
+                                            APInt::WordType multiplier,
+                                            APInt::WordType carry,
+                                            unsigned parts) {
+  unsigned Rest = parts % 4;
+  carry = multiplyAddWordsADX(dst, src, multiplier, carry, Rest);
+  if (parts == Rest)
+    return carry;
+  uint64_t Index = -uint64_t(parts - Rest), Low0, High0, Low1, High1;
+  __asm__("xor %%eax, %%eax\n\t"
+          "1:\n\t"
+          "mulx (%[src],%[i],8), %[lo0], %[hi0]\n\t"
+          "mulx 8(%[src],%[i],8), %[lo1], %[hi1]\n\t"
+          "adcx %[carry], %[lo0]\n\t"
+          "adox (%[dst],%[i],8), %[lo0]\n\t"
+          "mov %[lo0], (%[dst],%[i],8)\n\t"
+          "adcx %[hi0], %[lo1]\n\t"
+          "adox 8(%[dst],%[i],8), %[lo1]\n\t"
+          "mov %[lo1], 8(%[dst],%[i],8)\n\t"
+          "mulx 16(%[src],%[i],8), %[lo0], %[hi0]\n\t"
+          "mulx 24(%[src],%[i],8), %[lo1], %[carry]\n\t"
+          "adcx %[hi1], %[lo0]\n\t"
+          "adox 16(%[dst],%[i],8), %[lo0]\n\t"
+          "mov %[lo0], 16(%[dst],%[i],8)\n\t"
+          "adcx %[hi0], %[lo1]\n\t"
+          "adox 24(%[dst],%[i],8), %[lo1]\n\t"
+          "mov %[lo1], 24(%[dst],%[i],8)\n\t"
+          "lea 4(%[i]), %[i]\n\t"
+          "jrcxz 2f\n\t"
+          "jmp 1b\n"
+          "2:\n\t"
+          "mov $0, %%eax\n\t"
+          "adcx %%rax, %[carry]\n\t"
+          "adox %%rax, %[carry]"
+          : [carry] "+&r"(carry), [i] "+&c"(Index), [lo0] "=&r"(Low0),
+            [hi0] "=&r"(High0), [lo1] "=&r"(Low1), [hi1] "=&r"(High1)
+          : [src] "r"(src + parts), [dst] "r"(dst + parts), "d"(multiplier)
+          : "rax", "cc", "memory");
+  return carry;
+}
+
+/// multiplyWordsBy with MULX and a single ADCX chain.
+__attribute__((target("bmi2,adx")))
+static APInt::WordType multiplyWordsByADX(APInt::WordType *dst,
+                                          const APInt::WordType *src,
+                                          APInt::WordType multiplier,
+                                          APInt::WordType carry,
+                                          unsigned parts) {
+  if (parts == 0)
+    return carry;
+  uint64_t Index = -uint64_t(parts), Low, High;
+  __asm__("xor %%eax, %%eax\n\t"
+          "1:\n\t"
+          "mulx (%[src],%[i],8), %[lo], %[hi]\n\t"
+          "adcx %[carry], %[lo]\n\t"
+          "mov %[lo], (%[dst],%[i],8)\n\t"
+          "mov %[hi], %[carry]\n\t"
+          "lea 1(%[i]), %[i]\n\t"
+          "jrcxz 2f\n\t"
+          "jmp 1b\n"
+          "2:\n\t"
+          "mov $0, %%eax\n\t"
+          "adcx %%rax, %[carry]"
+          : [carry] "+&r"(carry), [i] "+&c"(Index), [lo] "=&r"(Low),
+            [hi] "=&r"(High)
+          : [src] "r"(src + parts), [dst] "r"(dst + parts), "d"(multiplier)
+          : "rax", "cc", "memory");
+  return carry;
+}
+#endif // BIJOU_HAS_X86_KERNELS
+
+namespace {
+/// The multiplication kernels for the host CPU.
+struct MultiplyKernels {
+  APInt::WordType (*MultiplyAdd)(APInt::WordType *, const APInt::WordType *,
+                                 APInt::WordType, APInt::WordType, unsigned);
+  APInt::WordType (*Multiply)(APInt::WordType *, const APInt::WordType *,
+                              APInt::WordType, APInt::WordType, unsigned);
+};
+} // end anonymous namespace
+
+static MultiplyKernels selectMultiplyKernels() {
+#if BIJOU_HAS_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx"))
+    return {multiplyAddWordsADX4, multiplyWordsByADX};
+#endif
+  return {multiplyAddWords, multiplyWordsBy};
 }
 
-/// Shift a bignum right Count bits in-place. Shifted in bits are zero. There
-/// are no restrictions on Count.
-void APInt::tcShiftRight(WordType *Dst, unsigned Words, unsigned Count) {
-  // Don't bother performing a no-op shift.
-  if (!Count)
-    return;
-
-  // WordShift is the inter-part shift; BitShift is the intra-part shift.
-  unsigned WordShift = std::min(Count / APINT_BITS_PER_WORD, Words);
-  unsigned BitShift = Count % APINT_BITS_PER_WORD;
+static const MultiplyKernels &getMultiplyKernels() {
+  static const MultiplyKernels Kernels = selectMultiplyKernels();
+  return Kernels;
+}
 
-  unsigned WordsToMove = Words - WordShift;
-  // Fastpath for moving by whole words.
-  if (BitShift == 0) {
-    std::memmove(Dst, Dst + WordShift, WordsToMove * APINT_WORD_SIZE);
-  } else {
-    for (unsigned i = 0; i != WordsToMove; ++i) {
-      Dst[i] = Dst[i + WordShift] >> BitShift;
-      if (i + 1 != WordsToMove)
-        Dst[i] |= Dst[i + WordShift + 1] << (APINT_BITS_PER_WORD - BitShift);
-    }
+APInt::WordType APInt::tcAddChain(WordType *dst, const WordType *rhs,
+                                  WordType c, unsigned parts) {
+#if BIJOU_HAS_X86_KERNELS
+  // Unrolled so that the carry is only moved out of the flags once for every
+  // four words.
+  unsigned char Carry = c;
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    unsigned long long S0, S1, S2, S3;
+    Carry = _addcarry_u64(Carry, dst[i], rhs[i], &S0);
+    Carry = _addcarry_u64(Carry, dst[i + 1], rhs[i + 1], &S1);
+    Carry = _addcarry_u64(Carry, dst[i + 2], rhs[i + 2], &S2);
+    Carry = _addcarry_u64(Carry, dst[i + 3], rhs[i + 3], &S3);
+    dst[i] = S0;
+    dst[i + 1] = S1;
+    dst[i + 2] = S2;
+    dst[i + 3] = S3;
+  }
+  for (; i < parts; ++i) {
+    unsigned long long S;
+    Carry = _addcarry_u64(Carry, dst[i], rhs[i], &S);
+    dst[i] = S;
+  }
+  return Carry;
+#else
+  for (unsigned i = 0; i < parts; ++i) {
+    WordType Sum = dst[i] + rhs[i] + c;
+    c = c ? Sum <= dst[i] : Sum < dst[i];
+    dst[i] = Sum;
   }
-
-  // Fill in the remainder with 0s.
-  std::memset(Dst + WordsToMove, 0, WordShift * APINT_WORD_SIZE);
+  return c;
+#endif
 }
 
-// Comparison (unsigned) of two bignums.
-int APInt::tcCompare(const WordType *lhs, const WordType *rhs,
-                     unsigned parts) {
-  while (parts) {
-    parts--;
-    if (lhs[parts] != rhs[parts])
-      return (lhs[parts] > rhs[parts]) ? 1 : -1;
+APInt::WordType APInt::tcSubtractChain(WordType *dst, const WordType *rhs,
+                                       WordType c, unsigned parts) {
+#if BIJOU_HAS_X86_KERNELS
+  unsigned char Borrow = c;
+  unsigned i = 0;
+  for (; i + 4 <= parts; i += 4) {
+    unsigned long long D0, D1, D2, D3;
+    Borrow = _subborrow_u64(Borrow, dst[i], rhs[i], &D0);
+    Borrow = _subborrow_u64(Borrow, dst[i + 1], rhs[i + 1], &D1);
+    Borrow = _subborrow_u64(Borrow, dst[i + 2], rhs[i + 2], &D2);
+    Borrow = _subborrow_u64(Borrow, dst[i + 3], rhs[i + 3], &D3);
+    dst[i] = D0;
+    dst[i + 1] = D1;
+    dst[i + 2] = D2;
+    dst[i + 3] = D3;
+  }
+  for (; i < parts; ++i) {
+    unsigned long long D;
+    Borrow = _subborrow_u64(Borrow, dst[i], rhs[i], &D);
+    dst[i] = D;
+  }
+  return Borrow;
+#else
+  for (unsigned i = 0; i < parts; ++i) {
+    WordType Difference = dst[i] - rhs[i] - c;
+    c = c ? Difference >= dst[i] : Difference > dst[i];
+    dst[i] = Difference;
   }
+  return c;
+#endif
+}
+
+APInt::WordType APInt::tcMultiplyAddChain(WordType *dst, const WordType *src,
+                                          WordType multiplier, WordType carry,
+                                          unsigned parts) {
+  return getMultiplyKernels().MultiplyAdd(dst, src, multiplier, carry, parts);
+}
 
-  return 0;
+APInt::WordType APInt::tcMultiplyChain(WordType *dst, const WordType *src,
+                                       WordType multiplier, WordType carry,
+                                       unsigned parts) {
+  return getMultiplyKernels().Multiply(dst, src, multiplier, carry, parts);
 }
 
 APInt bijou::APIntOps::RoundingUDiv(const APInt &A, const APInt &B,
@@ -0,0 +1,235 @@
+// APIntDivider.cpp - Division of APInts by an invariant divisor
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file implements the APIntDivider class, which divides many APInts by
+/// the same divisor using a precomputed reciprocal.
+///
+
+#include "bijou/APIntDivider.hpp"
+
+#include "bijou/Compiler.hpp"      // for BIJOU_HAS_INT128
+#include "bijou/Error.hpp"         // for bijou_unreachable
+#include "bijou/WordAllocator.hpp" // for ScratchWords
+
+#include <algorithm> // for std::min
+#include <bit>       // for std::countl_zero
+#include <cassert>
+
+using namespace bijou;
+
+using WordType = APIntDivider::WordType;
+
+namespace {
+
+/// @returns the low word of A * B and stores the high word in Hi.
+inline WordType mulWide(WordType A, WordType B, WordType &Hi) {
+#if BIJOU_HAS_INT128
+  unsigned __int128 P = (unsigned __int128)A * B;
+  Hi = WordType(P >> 64);
+  return WordType(P);
+#else
+  const WordType Mask = 0xffffffff;
+  WordType LL = (A & Mask) * (B & Mask);
+  WordType LH = (A & Mask) * (B >> 32);
+  WordType HL = (A >> 32) * (B & Mask);
+  WordType HH = (A >> 32) * (B >> 32);
+  WordType Mid = (LL >> 32) + (LH & Mask) + (HL & Mask);
+  Hi = HH + (LH >> 32) + (HL >> 32) + (Mid >> 32);
+  return (LL & Mask) | (Mid << 32);
+#endif
+}
+
+/// Divides the two word value U1:U0 by the normalized word D, given its
+/// reciprocal V = floor((2^128 - 1) / D) - 2^64. Requires U1 < D.
+/// This is algorithm 4 of Möller and Granlund.
+inline WordType divide2By1(WordType U1, WordType U0, WordType D, WordType V,
+                           WordType &R) {
+  WordType Q1;
+  WordType Q0 = mulWide(V, U1, Q1);
+  Q0 += U0;
+  Q1 += U1 + 1 + (Q0 < U0);
+  WordType Rem = U0 - Q1 * D;
+  if (Rem > Q0) {
+    --Q1;
+    Rem += D;
+  }
+  if (Rem >= D) {
+    ++Q1;
+    Rem -= D;
+  }
+  R = Rem;
+  return Q1;
+}
+
+} // end anonymous namespace
+
+APIntDivider::APIntDivider(const APInt &Divisor)
+    : Divisor(Divisor),
+      DivisorWords(APInt::getNumWords(Divisor.getActiveBits())), Shift(0),
+      IsPowerOf2(Divisor.isPowerOf2()), WordReciprocal(0) {
+  assert(!Divisor.isZero() && "Divide by zero?");
+
+  if (IsPowerOf2) {
+    Shift = Divisor.logBase2();
+    return;
+  }
+
+  if (DivisorWords == 1) {
+    const WordType D = Divisor.getRawData()[0];
+    Shift = std::countl_zero(D);
+    WordType Normalized = D << Shift;
+    APInt V = APInt::getAllOnes(128).udiv(APInt(128, Normalized));
+    WordReciprocal = V.getRawData()[0];
+    return;
+  }
+
+  // D is not a power of two, so floor(2^(128 * m) / D) < 2^(64 * (m + 1)).
+  const unsigned Bits = 2 * DivisorWords * APInt::APINT_BITS_PER_WORD + 1;
+  APInt V =
+      APInt::getOneBitSet(Bits, Bits - 1).udiv(Divisor.zextOrTrunc(Bits));
+  Reciprocal.assign(V.getRawData(), V.getRawData() + DivisorWords + 1);
+}
+
+void APIntDivider::divideByWord(const WordType *LHS, unsigned LHSWords,
+                                WordType *Quotient,
+                                WordType *Remainder) const {
+  const WordType D = Divisor.getRawData()[0] << Shift;
+  WordType R = 0;
+  if (Shift == 0) {
+    for (unsigned i = LHSWords; i-- > 0;)
+      Quotient[i] = divide2By1(R, LHS[i], D, WordReciprocal, R);
+  } else {
+    // Shift the dividend left by Shift bits on the fly.
+    R = LHS[LHSWords - 1] >> (APInt::APINT_BITS_PER_WORD - Shift);
+    for (unsigned i = LHSWords; i-- > 0;) {
+      WordType U = LHS[i] << Shift;
+      if (i)
+        U |= LHS[i - 1] >> (APInt::APINT_BITS_PER_WORD - Shift);
+      Quotient[i] = divide2By1(R, U, D, WordReciprocal, R);
+    }
+  }
+  Remainder[0] = R >> Shift;
+}
+
+void APIntDivider::barrettStep(const WordType *V, WordType *Quotient,
+                               WordType *Remainder, WordType *Product) const {
+  const unsigned M = DivisorWords;
+  const WordType *D = Divisor.getRawData();
+
+  // Q = floor(floor(V / 2^(64 * (m - 1))) * Reciprocal / 2^(64 * (m + 1))),
+  // which is at most two less than the true quotient.
+  APInt::tcFullMultiply(Product, V + (M - 1), Reciprocal.data(), M + 1,
+                        M + 1);
+  APInt::tcAssign(Quotient, Product + (M + 1), M + 1);
+
+  // R = V - Q * D, computed modulo 2^(64 * (m + 1)) since R < 3 * D.
+  APInt::tcFullMultiply(Product, Quotient, D, M + 1, M);
+  WordType *R = Product + 2 * M + 2;
+  APInt::tcAssign(R, V, M + 1);
+  APInt::tcSubtract(R, Product, 0, M + 1);
+  while (R[M] || APInt::tcCompare(R, D, M) >= 0) {
+    R[M] -= APInt::tcSubtract(R, D, 0, M);
+    APInt::tcAddPart(Quotient, 1, M + 1);
+  }
+  APInt::tcAssign(Remainder, R, M);
+}
+
+void APIntDivider::udivrem(const WordType *LHS, unsigned LHSWords,
+                           WordType *Quotient, WordType *Remainder) const {
+  const unsigned M = DivisorWords;
+  APInt::tcSet(Quotient, 0, LHSWords);
+  APInt::tcSet(Remainder, 0, M);
+
+  // Leading zero words only add zero words of quotient.
+  unsigned N = LHSWords;
+  while (N && !LHS[N - 1])
+    --N;
+  if (N < M) {
+    if (N)
+      APInt::tcAssign(Remainder, LHS, N);
+    return;
+  }
+
+  if (IsPowerOf2) {
+    APInt::tcAssign(Quotient, LHS, N);
+    APInt::tcShiftRight(Quotient, N, Shift);
+    APInt::tcAssign(Remainder, LHS, M);
+    Remainder[M - 1] &=
+        (WordType(1) << Shift % APInt::APINT_BITS_PER_WORD) - 1;
+    return;
+  }
+
+  if (M == 1) {
+    divideByWord(LHS, N, Quotient, Remainder);
+    return;
+  }
+
+  // Long division with m word digits: the first step takes the top 2 * m
+  // words, each later one the remainder so far and the next m words.
+  ScratchWords<6 * DIVIDER_STACK_WORDS + 4> Scratch(2 * M + (M + 1) +
+                                                   (3 * M + 3));
+  WordType *V = Scratch.data();
+  WordType *Q = V + 2 * M;
+  WordType *Product = Q + (M + 1);
+
+  unsigned Lo = N > 2 * M ? N - 2 * M : 0;
+  APInt::tcSet(V, 0, 2 * M);
+  APInt::tcAssign(V, LHS + Lo, N - Lo);
+  barrettStep(V, Q, Remainder, Product);
+  APInt::tcAssign(Quotient + Lo, Q, std::min(M + 1, N - Lo));
+
+  while (Lo) {
+    unsigned Next = Lo > M ? Lo - M : 0;
+    unsigned Count = Lo - Next;
+    APInt::tcSet(V, 0, 2 * M);
+    APInt::tcAssign(V, LHS + Next, Count);
+    APInt::tcAssign(V + Count, Remainder, M);
+    barrettStep(V, Q, Remainder, Product);
+    APInt::tcAssign(Quotient + Next, Q, Count);
+    Lo = Next;
+  }
+}
+
+void APIntDivider::udivrem(const APInt &LHS, APInt &Quotient,
+                           APInt &Remainder) const {
+  assert(LHS.getBitWidth() == getBitWidth() && "Bit widths must be the same");
+  APInt Q(getBitWidth(), 0), R(getBitWidth(), 0);
+  udivrem(LHS.getRawData(), LHS.getNumWords(), Q.getWords(), R.getWords());
+  Quotient = std::move(Q);
+  Remainder = std::move(R);
+}
+
+APInt APIntDivider::udiv(const APInt &LHS) const {
+  APInt Quotient, Remainder;
+  udivrem(LHS, Quotient, Remainder);
+  return Quotient;
+}
+
+APInt APIntDivider::urem(const APInt &LHS) const {
+  APInt Quotient, Remainder;
+  udivrem(LHS, Quotient, Remainder);
+  return Remainder;
+}
+
+APInt bijou::APIntOps::RoundingUDiv(const APInt &A, const APIntDivider &B,
+                                    APInt::Rounding RM) {
+  APInt Quo, Rem;
+  B.udivrem(A, Quo, Rem);
+  switch (RM) {
+  case APInt::Rounding::DOWN:
+  case APInt::Rounding::TOWARD_ZERO:
+    return Quo;
+  case APInt::Rounding::UP:
+    if (Rem.isZero())
+      return Quo;
+    return Quo + 1;
+  }
+  bijou_unreachable("Unknown APInt::Rounding enum");
+}
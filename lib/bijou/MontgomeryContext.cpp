@@ -0,0 +1,316 @@
+// MontgomeryContext.cpp - Modular arithmetic for a fixed odd modulus
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file implements the MontgomeryContext class, which does modular
+/// multiplication and exponentiation of APInts for a fixed odd modulus in
+/// Montgomery form.
+///
+
+#include "bijou/MontgomeryContext.hpp"
+
+#include "bijou/Compiler.hpp"      // for BIJOU_HAS_INT128
+#include "bijou/WordAllocator.hpp" // for ScratchWords
+
+#include <algorithm> // for std::min, std::max
+#include <cassert>
+#include <cstring> // for std::memcpy
+
+using namespace bijou;
+
+using WordType = MontgomeryContext::WordType;
+
+namespace {
+
+/// @returns the low word of A * B + C + D and stores the high word in Hi.
+/// The sum cannot overflow two words.
+inline WordType mulAdd(WordType A, WordType B, WordType C, WordType D,
+                       WordType &Hi) {
+#if BIJOU_HAS_INT128
+  unsigned __int128 P = (unsigned __int128)A * B + C + D;
+  Hi = WordType(P >> 64);
+  return WordType(P);
+#else
+  const WordType Mask = 0xffffffff;
+  WordType LL = (A & Mask) * (B & Mask);
+  WordType LH = (A & Mask) * (B >> 32);
+  WordType HL = (A >> 32) * (B & Mask);
+  WordType HH = (A >> 32) * (B >> 32);
+  WordType Mid = (LL >> 32) + (LH & Mask) + (HL & Mask);
+  WordType Lo = (LL & Mask) | (Mid << 32);
+  WordType High = HH + (LH >> 32) + (HL >> 32) + (Mid >> 32);
+  Lo += C;
+  High += Lo < C;
+  Lo += D;
+  High += Lo < D;
+  Hi = High;
+  return Lo;
+#endif
+}
+
+/// @returns the window size in bits powmod uses for an exponent with
+/// @p Bits significant bits. These are the sizes OpenSSL uses, which
+/// balance the cost of building the table against the multiplications it
+/// saves.
+unsigned getWindowSize(unsigned Bits) {
+  unsigned Window = Bits > 671 ? 6 : Bits > 239 ? 5 : Bits > 79 ? 4
+                  : Bits > 23 ? 3 : 1;
+  return std::min<unsigned>(Window, MontgomeryContext::MONTGOMERY_MAX_WINDOW);
+}
+
+} // end anonymous namespace
+
+MontgomeryContext::MontgomeryContext(const APInt &Modulus)
+    : Modulus(Modulus) {
+  assert(Modulus[0] && "Montgomery modulus must be odd");
+
+  const unsigned NumWords = getNumWords();
+  const unsigned RBits = NumWords * APInt::APINT_BITS_PER_WORD;
+
+  // R mod N and R * R mod N, computed by division once.
+  APInt Wide = Modulus.zext(2 * RBits + 1);
+  One = APInt::getOneBitSet(2 * RBits + 1, RBits).urem(Wide)
+            .trunc(getBitWidth());
+  RSquared = APInt::getOneBitSet(2 * RBits + 1, 2 * RBits).urem(Wide)
+                 .trunc(getBitWidth());
+
+  // Newton's iteration for the inverse of the low word doubles the number of
+  // correct bits each step. Any odd N0 is its own inverse modulo 8.
+  const WordType N0 = Modulus.getRawData()[0];
+  WordType Inverse = N0;
+  for (unsigned I = 0; I < 5; ++I)
+    Inverse *= 2 - N0 * Inverse;
+  assert(N0 * Inverse == 1 && "Newton iteration did not converge");
+  NegInverse = -Inverse;
+}
+
+/// This is the coarsely integrated operand scanning (CIOS) form of
+/// Montgomery multiplication, which interleaves one word of the product with
+/// one word of the reduction.
+void MontgomeryContext::multiply(WordType *Dst, const WordType *A,
+                                 const WordType *B, WordType *T) const {
+  const unsigned N = getNumWords();
+  const WordType *M = Modulus.getRawData();
+
+  APInt::tcSet(T, 0, N + 2);
+  for (unsigned I = 0; I < N; ++I) {
+    // T += A * B[I]
+    const WordType BI = B[I];
+    WordType Carry = 0;
+    for (unsigned J = 0; J < N; ++J)
+      T[J] = mulAdd(A[J], BI, T[J], Carry, Carry);
+    T[N] += Carry;
+    T[N + 1] = T[N] < Carry;
+
+    // T = (T + Q * M) / 2^64, with Q chosen so the low word vanishes.
+    const WordType Q = T[0] * NegInverse;
+    mulAdd(Q, M[0], T[0], 0, Carry);
+    for (unsigned J = 1; J < N; ++J)
+      T[J - 1] = mulAdd(Q, M[J], T[J], Carry, Carry);
+    T[N - 1] = T[N] + Carry;
+    T[N] = T[N + 1] + (T[N - 1] < Carry);
+  }
+
+  // T < 2 * M, twice the modulus, so one subtraction reduces it.
+  if (T[N] || APInt::tcCompare(T, M, N) >= 0)
+    APInt::tcSubtract(T, M, 0, N);
+  std::memcpy(Dst, T, N * sizeof(WordType));
+}
+
+/// This is the separated operand scanning (SOS) form, which squares A and
+/// then reduces the double width square one word at a time. Each cross
+/// product A[I] * A[J] is computed once and doubled, so squaring saves about
+/// a quarter of the word multiplications of multiply.
+void MontgomeryContext::square(WordType *Dst, const WordType *A,
+                               WordType *T) const {
+  const unsigned N = getNumWords();
+  const WordType *M = Modulus.getRawData();
+
+  // T = the cross products A[I] * A[J] with I < J.
+  APInt::tcSet(T, 0, 2 * N + 1);
+  for (unsigned I = 0; I + 1 < N; ++I) {
+    const WordType AI = A[I];
+    WordType Carry = 0;
+    for (unsigned J = I + 1; J < N; ++J)
+      T[I + J] = mulAdd(AI, A[J], T[I + J], Carry, Carry);
+    T[I + N] = Carry;
+  }
+
+  // T = 2 * T + the squares A[I] * A[I].
+  WordType Carry = 0, TopBit = 0;
+  for (unsigned I = 0; I < N; ++I) {
+    WordType Low = T[2 * I], High = T[2 * I + 1], Square;
+    T[2 * I] = mulAdd(A[I], A[I], Low << 1 | TopBit, Carry, Square);
+    WordType Doubled = High << 1 | Low >> 63;
+    T[2 * I + 1] = Doubled + Square;
+    Carry = T[2 * I + 1] < Square;
+    TopBit = High >> 63;
+  }
+
+  // The carry out of word I + N waits in Extra for the next row.
+  WordType Extra = 0;
+  for (unsigned I = 0; I < N; ++I) {
+    // T += Q * M * 2^(64 * I), with Q chosen so that word I vanishes.
+    const WordType Q = T[I] * NegInverse;
+    WordType Carry = 0;
+    for (unsigned J = 0; J < N; ++J)
+      T[I + J] = mulAdd(Q, M[J], T[I + J], Carry, Carry);
+    WordType Sum = T[I + N] + Carry;
+    WordType Overflow = Sum < Carry;
+    T[I + N] = Sum + Extra;
+    Extra = Overflow + (T[I + N] < Extra);
+  }
+  T[2 * N] = Extra;
+
+  // The high half is less than 2 * M, twice the modulus, so one subtraction
+  // reduces it.
+  WordType *High = T + N;
+  if (High[N] || APInt::tcCompare(High, M, N) >= 0)
+    APInt::tcSubtract(High, M, 0, N);
+  std::memcpy(Dst, High, N * sizeof(WordType));
+}
+
+void MontgomeryContext::assign(APInt &Result, const WordType *Words) const {
+  if (Result.getBitWidth() != getBitWidth())
+    Result = APInt(getBitWidth(), 0);
+  std::memcpy(Result.getWords(), Words, getNumWords() * sizeof(WordType));
+}
+
+void MontgomeryContext::toMontgomery(APInt &Result, const APInt &X) const {
+  assert(X.getBitWidth() == getBitWidth() && "Bit widths must match");
+  ScratchWords<2 * MONTGOMERY_STACK_WORDS + 2> Scratch(2 * getNumWords() + 2);
+  WordType *Dst = Scratch.data(), *T = Dst + getNumWords();
+  multiply(Dst, X.getRawData(), RSquared.getRawData(), T);
+  assign(Result, Dst);
+}
+
+APInt MontgomeryContext::toMontgomery(const APInt &X) const {
+  APInt Result(getBitWidth(), 0);
+  toMontgomery(Result, X);
+  return Result;
+}
+
+void MontgomeryContext::fromMontgomery(APInt &Result, const APInt &X) const {
+  assert(X.getBitWidth() == getBitWidth() && "Bit widths must match");
+  const unsigned N = getNumWords();
+  ScratchWords<3 * MONTGOMERY_STACK_WORDS + 2> Scratch(3 * N + 2);
+  WordType *Unit = Scratch.data(), *Dst = Unit + N, *T = Dst + N;
+  APInt::tcSet(Unit, 1, N);
+  multiply(Dst, X.getRawData(), Unit, T);
+  assign(Result, Dst);
+}
+
+APInt MontgomeryContext::fromMontgomery(const APInt &X) const {
+  APInt Result(getBitWidth(), 0);
+  fromMontgomery(Result, X);
+  return Result;
+}
+
+void MontgomeryContext::mulmod(APInt &Result, const APInt &LHS,
+                               const APInt &RHS) const {
+  assert(LHS.getBitWidth() == getBitWidth() &&
+         RHS.getBitWidth() == getBitWidth() && "Bit widths must match");
+  assert(LHS.ult(Modulus) && RHS.ult(Modulus) && "Operand not reduced");
+  ScratchWords<2 * MONTGOMERY_STACK_WORDS + 2> Scratch(2 * getNumWords() + 2);
+  WordType *Dst = Scratch.data(), *T = Dst + getNumWords();
+  multiply(Dst, LHS.getRawData(), RHS.getRawData(), T);
+  assign(Result, Dst);
+}
+
+APInt MontgomeryContext::mulmod(const APInt &LHS, const APInt &RHS) const {
+  APInt Result(getBitWidth(), 0);
+  mulmod(Result, LHS, RHS);
+  return Result;
+}
+
+void MontgomeryContext::sqrmod(APInt &Result, const APInt &X) const {
+  assert(X.getBitWidth() == getBitWidth() && "Bit widths must match");
+  assert(X.ult(Modulus) && "Operand not reduced");
+  ScratchWords<3 * MONTGOMERY_STACK_WORDS + 1> Scratch(3 * getNumWords() + 1);
+  WordType *Dst = Scratch.data(), *T = Dst + getNumWords();
+  square(Dst, X.getRawData(), T);
+  assign(Result, Dst);
+}
+
+APInt MontgomeryContext::sqrmod(const APInt &X) const {
+  APInt Result(getBitWidth(), 0);
+  sqrmod(Result, X);
+  return Result;
+}
+
+/// Scans the exponent from the top. A run of zero bits costs one squaring
+/// per bit; otherwise the window takes the longest run of at most Window bits
+/// that ends in a one, so its value is odd and the table only needs to hold
+/// the odd powers of the base.
+void MontgomeryContext::powmod(APInt &Result, const APInt &Base,
+                               const APInt &Exponent) const {
+  assert(Base.getBitWidth() == getBitWidth() && "Bit widths must match");
+  const unsigned N = getNumWords();
+  const unsigned Bits = Exponent.getActiveBits();
+  const unsigned Window = getWindowSize(Bits);
+  const unsigned TableSize = 1U << (Window - 1);
+
+  // The table of odd powers, the accumulator and the square scratch.
+  ScratchWords<((1U << (MONTGOMERY_MAX_WINDOW - 1)) + 3) *
+                   MONTGOMERY_STACK_WORDS + 1>
+      Scratch((TableSize + 3) * N + 1);
+  WordType *Table = Scratch.data();
+  WordType *Acc = Table + TableSize * N;
+  WordType *T = Acc + N;
+
+  // Table[I] holds Base^(2 * I + 1), with Acc briefly holding Base^2.
+  multiply(Table, Base.getRawData(), RSquared.getRawData(), T);
+  if (TableSize > 1) {
+    square(Acc, Table, T);
+    for (unsigned I = 1; I < TableSize; ++I)
+      multiply(Table + I * N, Table + (I - 1) * N, Acc, T);
+  }
+
+  bool AccIsOne = true;
+  for (int I = int(Bits) - 1; I >= 0;) {
+    if (!Exponent[I]) {
+      if (!AccIsOne)
+        square(Acc, Acc, T);
+      --I;
+      continue;
+    }
+
+    int Low = std::max(I - int(Window) + 1, 0);
+    while (!Exponent[Low])
+      ++Low;
+    unsigned Width = unsigned(I - Low + 1);
+    unsigned Value = unsigned(Exponent.extractBitsAsZExtValue(Width, Low));
+    const WordType *Power = Table + (Value >> 1) * N;
+
+    if (AccIsOne) {
+      std::memcpy(Acc, Power, N * sizeof(WordType));
+      AccIsOne = false;
+    } else {
+      for (unsigned J = 0; J < Width; ++J)
+        square(Acc, Acc, T);
+      multiply(Acc, Acc, Power, T);
+    }
+    I = Low - 1;
+  }
+
+  if (AccIsOne)
+    std::memcpy(Acc, One.getRawData(), N * sizeof(WordType));
+
+  // Leave Montgomery form by multiplying with 1, reusing the table.
+  APInt::tcSet(Table, 1, N);
+  multiply(Acc, Acc, Table, T);
+  assign(Result, Acc);
+}
+
+APInt MontgomeryContext::powmod(const APInt &Base,
+                                const APInt &Exponent) const {
+  APInt Result(getBitWidth(), 0);
+  powmod(Result, Base, Exponent);
+  return Result;
+}
@@ -0,0 +1,244 @@
+// WordAllocator.cpp - Allocation of APInt and APFloat word buffers
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+///
+/// @file
+/// @brief
+/// This file implements allocateWords and deallocateWords, with their
+/// per-thread word pool and arena scopes.
+///
+
+#include "bijou/WordAllocator.hpp"
+
+#include <algorithm> // for std::max, std::min
+#include <bit>       // for std::bit_width, std::has_single_bit
+#include <cassert>
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uintptr_t
+
+using namespace bijou;
+
+#if BIJOU_ENABLE_WORD_POOL
+
+namespace {
+
+/// Size class C holds buffers of 2^C words.
+constexpr unsigned NumSizeClasses = std::bit_width(WORD_POOL_MAX_WORDS);
+
+static_assert(std::has_single_bit(WORD_POOL_MAX_WORDS),
+              "WORD_POOL_MAX_WORDS must be a power of two");
+
+/// A free buffer, linked through its first word.
+struct FreeBuffer {
+  FreeBuffer *Next;
+};
+
+static_assert(sizeof(FreeBuffer) <= sizeof(uint64_t),
+              "A free buffer must fit in one word");
+
+/// @returns the size class of a buffer of NumWords words.
+inline unsigned getSizeClass(unsigned NumWords) {
+  return NumWords <= 1 ? 0 : std::bit_width(NumWords - 1);
+}
+
+/// The free lists and statistics of one thread.
+class ThreadWordPool {
+public:
+  ~ThreadWordPool();
+
+  uint64_t *allocate(unsigned NumWords);
+  void deallocate(uint64_t *Words, unsigned NumWords);
+  void trim();
+
+  WordPoolStatistics Stats;
+
+private:
+  FreeBuffer *FreeLists[NumSizeClasses] = {};
+  unsigned NumFree[NumSizeClasses] = {};
+};
+
+thread_local ThreadWordPool Pool;
+
+/// Set once the calling thread's pool is destroyed, after which buffers
+/// freed by later thread-exit or static destructors bypass it.
+thread_local bool PoolDestroyed = false;
+
+} // end anonymous namespace
+
+ThreadWordPool::~ThreadWordPool() {
+  trim();
+  PoolDestroyed = true;
+}
+
+uint64_t *ThreadWordPool::allocate(unsigned NumWords) {
+  if (NumWords > WORD_POOL_MAX_WORDS) {
+    Stats.Misses++;
+    return new uint64_t[NumWords];
+  }
+
+  unsigned Class = getSizeClass(NumWords);
+  if (FreeBuffer *Buffer = FreeLists[Class]) {
+    FreeLists[Class] = Buffer->Next;
+    NumFree[Class]--;
+    Stats.Hits++;
+    return reinterpret_cast<uint64_t *>(Buffer);
+  }
+
+  Stats.Misses++;
+  return new uint64_t[std::size_t(1) << Class];
+}
+
+void ThreadWordPool::deallocate(uint64_t *Words, unsigned NumWords) {
+  unsigned Class = getSizeClass(NumWords);
+  if (NumWords > WORD_POOL_MAX_WORDS ||
+      NumFree[Class] == WORD_POOL_MAX_FREE_BUFFERS) {
+    delete[] Words;
+    return;
+  }
+
+  FreeBuffer *Buffer = reinterpret_cast<FreeBuffer *>(Words);
+  Buffer->Next = FreeLists[Class];
+  FreeLists[Class] = Buffer;
+  NumFree[Class]++;
+}
+
+void ThreadWordPool::trim() {
+  for (unsigned Class = 0; Class < NumSizeClasses; ++Class) {
+    while (FreeBuffer *Buffer = FreeLists[Class]) {
+      FreeLists[Class] = Buffer->Next;
+      delete[] reinterpret_cast<uint64_t *>(Buffer);
+    }
+    NumFree[Class] = 0;
+  }
+}
+
+static uint64_t *allocatePooledWords(unsigned NumWords) {
+  if (PoolDestroyed) {
+    // The buffer may be freed into the pool of another thread, so it must
+    // have the capacity of its size class there.
+    if (NumWords <= WORD_POOL_MAX_WORDS)
+      return new uint64_t[std::size_t(1) << getSizeClass(NumWords)];
+    return new uint64_t[NumWords];
+  }
+  return Pool.allocate(NumWords);
+}
+
+static void deallocatePooledWords(uint64_t *Words, unsigned NumWords) {
+  if (PoolDestroyed) {
+    delete[] Words;
+    return;
+  }
+  Pool.deallocate(Words, NumWords);
+}
+
+WordPoolStatistics bijou::getWordPoolStatistics() {
+  return PoolDestroyed ? WordPoolStatistics() : Pool.Stats;
+}
+
+void bijou::resetWordPoolStatistics() {
+  if (!PoolDestroyed)
+    Pool.Stats = WordPoolStatistics();
+}
+
+void bijou::trimWordPool() {
+  if (!PoolDestroyed)
+    Pool.trim();
+}
+
+#else // !BIJOU_ENABLE_WORD_POOL
+
+static uint64_t *allocatePooledWords(unsigned NumWords) {
+  return new uint64_t[NumWords];
+}
+
+static void deallocatePooledWords(uint64_t *Words, unsigned) {
+  delete[] Words;
+}
+
+WordPoolStatistics bijou::getWordPoolStatistics() { return {}; }
+
+void bijou::resetWordPoolStatistics() {}
+
+void bijou::trimWordPool() {}
+
+#endif // BIJOU_ENABLE_WORD_POOL
+
+namespace {
+
+/// The innermost arena scope of the current thread.
+thread_local WordArenaScope *CurrentScope = nullptr;
+
+/// The number of live suspensions of the arenas of the current thread.
+thread_local unsigned NumSuspensions = 0;
+
+/// The size in words of the first slab of an arena. Each further slab is
+/// twice as large as the one before, up to MaxSlabWords.
+constexpr std::size_t FirstSlabWords = 4096;
+constexpr std::size_t MaxSlabWords = std::size_t(1) << 20;
+
+} // end anonymous namespace
+
+uint64_t *bijou::allocateWords(unsigned NumWords) {
+  assert(NumWords && "Allocating an empty buffer?");
+  if (CurrentScope && !NumSuspensions)
+    return CurrentScope->allocate(NumWords);
+  return allocatePooledWords(NumWords);
+}
+
+void bijou::deallocateWords(uint64_t *Words, unsigned NumWords) {
+  for (WordArenaScope *Scope = CurrentScope; Scope; Scope = Scope->Outer)
+    if (Scope->owns(Words))
+      return;
+  deallocatePooledWords(Words, NumWords);
+}
+
+WordArenaScope::WordArenaScope() : Outer(CurrentScope) {
+  CurrentScope = this;
+}
+
+WordArenaScope::~WordArenaScope() {
+  assert(CurrentScope == this && "Arena scopes must end in reverse order");
+  CurrentScope = Outer;
+}
+
+WordArenaScope::Suspension::Suspension() { NumSuspensions++; }
+
+WordArenaScope::Suspension::~Suspension() { NumSuspensions--; }
+
+uint64_t *WordArenaScope::allocate(unsigned NumWords) {
+  if (std::size_t(End - Cur) < NumWords) {
+    std::size_t Size =
+        Slabs.empty() ? FirstSlabWords
+                      : std::min(2 * Slabs.back().Size, MaxSlabWords);
+    Size = std::max<std::size_t>(Size, NumWords);
+    Slabs.push_back({std::unique_ptr<uint64_t[]>(new uint64_t[Size]), Size});
+    Cur = Slabs.back().Words.get();
+    End = Cur + Size;
+  }
+
+  uint64_t *Words = Cur;
+  Cur += NumWords;
+  return Words;
+}
+
+bool WordArenaScope::owns(const uint64_t *Words) const {
+  // Compare as integers, as the pointers need not be into the same array.
+  auto Addr = reinterpret_cast<std::uintptr_t>(Words);
+  for (const Slab &S : Slabs) {
+    auto Begin = reinterpret_cast<std::uintptr_t>(S.Words.get());
+    if (Addr >= Begin && Addr < Begin + S.Size * sizeof(uint64_t))
+      return true;
+  }
+  return false;
+}
+
+std::size_t WordArenaScope::getNumBytesReserved() const {
+  std::size_t Bytes = 0;
+  for (const Slab &S : Slabs)
+    Bytes += S.Size * sizeof(uint64_t);
+  return Bytes;
+}
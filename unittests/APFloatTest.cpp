@@ -19,7 +19,9 @@
 #include "bijou/Error.hpp"
 #include "bijou_unittest_helpers.hpp"
 #include <gtest/gtest.h>
+#include <cfenv>
 #include <cmath>
+#include <random>
 #include <string>
 #include <tuple>
 #include <format>
@@ -926,6 +928,514 @@ TEST(APFloatTest, fromDecimalString) {
   EXPECT_EQ(2.71828, convertToDoubleFromString("2.71828"));
 }
 
+TEST(APFloatTest, singleAndDoubleArithmeticRounding) {
+  // These hold whether or not the host FPU computes the operations.
+  enum { Add, Subtract, Multiply, Divide };
+  struct {
+    const fltSemantics &Sem;
+    int Operation;
+    uint64_t LHS, RHS;
+    APFloat::roundingMode RM;
+    uint64_t Bits;
+    APFloat::opStatus Status;
+  } Tests[] = {
+    // 1 + 2^-53 is halfway between 1 and the next double.
+    {APFloat::IEEEdouble(), Add, 0x3ff0000000000000, 0x3ca0000000000000,
+     APFloat::rmNearestTiesToEven, 0x3ff0000000000000, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Add, 0x3ff0000000000000, 0x3ca0000000000000,
+     APFloat::rmNearestTiesToAway, 0x3ff0000000000001, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Add, 0x3ff0000000000000, 0x3ca0000000000000,
+     APFloat::rmTowardPositive, 0x3ff0000000000001, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Subtract, 0xbff0000000000000, 0x3ca0000000000000,
+     APFloat::rmTowardNegative, 0xbff0000000000001, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Subtract, 0xbff0000000000000, 0x3ca0000000000000,
+     APFloat::rmTowardZero, 0xbff0000000000000, APFloat::opInexact},
+    // Exact zero sums are negative only when rounding downward.
+    {APFloat::IEEEdouble(), Subtract, 0x3ff0000000000000, 0x3ff0000000000000,
+     APFloat::rmNearestTiesToEven, 0x0000000000000000, APFloat::opOK},
+    {APFloat::IEEEdouble(), Subtract, 0x3ff0000000000000, 0x3ff0000000000000,
+     APFloat::rmTowardNegative, 0x8000000000000000, APFloat::opOK},
+    // (1 + 2^-52)^2 = 1 + 2^-51 + 2^-104.
+    {APFloat::IEEEdouble(), Multiply, 0x3ff0000000000001, 0x3ff0000000000001,
+     APFloat::rmNearestTiesToEven, 0x3ff0000000000002, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Multiply, 0x3ff0000000000001, 0xbff0000000000001,
+     APFloat::rmTowardNegative, 0xbff0000000000003, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Multiply, 0x3ff0000000000001, 0xbff0000000000001,
+     APFloat::rmTowardZero, 0xbff0000000000002, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Divide, 0x3ff0000000000000, 0x4008000000000000,
+     APFloat::rmNearestTiesToEven, 0x3fd5555555555555, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Divide, 0x3ff0000000000000, 0x4008000000000000,
+     APFloat::rmTowardPositive, 0x3fd5555555555556, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Divide, 0xbff0000000000000, 0x4008000000000000,
+     APFloat::rmTowardZero, 0xbfd5555555555555, APFloat::opInexact},
+    {APFloat::IEEEdouble(), Divide, 0x4022000000000000, 0xc008000000000000,
+     APFloat::rmTowardNegative, 0xc008000000000000, APFloat::opOK},
+    // Results that overflow or underflow.
+    {APFloat::IEEEdouble(), Multiply, 0x7fefffffffffffff, 0x4000000000000000,
+     APFloat::rmNearestTiesToEven, 0x7ff0000000000000,
+     (APFloat::opStatus)(APFloat::opOverflow | APFloat::opInexact)},
+    {APFloat::IEEEdouble(), Multiply, 0x0010000000000000, 0x3fe0000000000000,
+     APFloat::rmNearestTiesToEven, 0x0008000000000000, APFloat::opOK},
+    {APFloat::IEEEdouble(), Divide, 0x0010000000000000, 0x4338000000000000,
+     APFloat::rmTowardPositive, 0x0000000000000001,
+     (APFloat::opStatus)(APFloat::opUnderflow | APFloat::opInexact)},
+    {APFloat::IEEEsingle(), Divide, 0x3f800000, 0x40400000,
+     APFloat::rmNearestTiesToEven, 0x3eaaaaab, APFloat::opInexact},
+    {APFloat::IEEEsingle(), Divide, 0x3f800000, 0x40400000,
+     APFloat::rmTowardZero, 0x3eaaaaaa, APFloat::opInexact},
+    {APFloat::IEEEsingle(), Multiply, 0x3f800001, 0x3f800001,
+     APFloat::rmTowardPositive, 0x3f800003, APFloat::opInexact},
+    {APFloat::IEEEsingle(), Add, 0x3f800000, 0xb3000000,
+     APFloat::rmTowardNegative, 0x3f7fffff, APFloat::opInexact},
+    {APFloat::IEEEsingle(), Add, 0x3f800000, 0xb3000000,
+     APFloat::rmNearestTiesToEven, 0x3f800000, APFloat::opInexact},
+  };
+
+  for (const auto &T : Tests) {
+    unsigned Width = APFloat::getSizeInBits(T.Sem);
+    APFloat F(T.Sem, APInt(Width, T.LHS));
+    APFloat RHS(T.Sem, APInt(Width, T.RHS));
+    APFloat::opStatus Status;
+    switch (T.Operation) {
+    case Add:
+      Status = F.add(RHS, T.RM);
+      break;
+    case Subtract:
+      Status = F.subtract(RHS, T.RM);
+      break;
+    case Multiply:
+      Status = F.multiply(RHS, T.RM);
+      break;
+    default:
+      Status = F.divide(RHS, T.RM);
+      break;
+    }
+    EXPECT_EQ(T.Bits, F.bitcastToAPInt().getZExtValue())
+        << T.Operation << " " << T.LHS << " " << T.RHS;
+    EXPECT_EQ(T.Status, Status);
+  }
+
+  // (1 + 2^-52) * (1 - 2^-52) - 1 is exactly -2^-104.
+  APFloat F(APFloat::IEEEdouble(), APInt(64, 0x3ff0000000000001));
+  EXPECT_EQ(APFloat::opOK,
+            F.fusedMultiplyAdd(
+                APFloat(APFloat::IEEEdouble(), APInt(64, 0x3feffffffffffffe)),
+                APFloat(-1.0), APFloat::rmNearestTiesToEven));
+  EXPECT_EQ(0xb970000000000000, F.bitcastToAPInt().getZExtValue());
+}
+
+TEST(APFloatTest, x87DoubleExtendedArithmeticRounding) {
+  // These hold whether or not the host FPU computes the operations.
+  auto x87 = [](uint64_t Significand, uint64_t SignExponent) {
+    uint64_t Words[2] = {Significand, SignExponent};
+    return APFloat(APFloat::x87DoubleExtended(), APInt(80, Words));
+  };
+  auto expectBits = [](const APFloat &F, uint64_t Significand,
+                       uint64_t SignExponent) {
+    APInt Bits = F.bitcastToAPInt();
+    EXPECT_EQ(Significand, Bits.getRawData()[0]);
+    EXPECT_EQ(SignExponent, Bits.getRawData()[1]);
+  };
+  const APFloat One = x87(0x8000000000000000, 0x3fff);
+  const APFloat Three = x87(0xc000000000000000, 0x4000);
+
+  // 1 + 2^-64 is halfway between 1 and the next value.
+  APFloat F = One;
+  EXPECT_EQ(APFloat::opInexact, F.add(x87(0x8000000000000000, 0x3fbf),
+                                      APFloat::rmNearestTiesToEven));
+  expectBits(F, 0x8000000000000000, 0x3fff);
+  F = One;
+  EXPECT_EQ(APFloat::opInexact, F.add(x87(0x8000000000000000, 0x3fbf),
+                                      APFloat::rmTowardPositive));
+  expectBits(F, 0x8000000000000001, 0x3fff);
+  // 1 - 2^-65 rounds down to the largest value below one.
+  F = One;
+  EXPECT_EQ(APFloat::opInexact, F.subtract(x87(0x8000000000000000, 0x3fbe),
+                                           APFloat::rmTowardZero));
+  expectBits(F, 0xffffffffffffffff, 0x3ffe);
+
+  F = One;
+  EXPECT_EQ(APFloat::opInexact,
+            F.divide(Three, APFloat::rmNearestTiesToEven));
+  expectBits(F, 0xaaaaaaaaaaaaaaab, 0x3ffd);
+  F = One;
+  EXPECT_EQ(APFloat::opInexact, F.divide(Three, APFloat::rmTowardZero));
+  expectBits(F, 0xaaaaaaaaaaaaaaaa, 0x3ffd);
+  F = One;
+  F.changeSign();
+  EXPECT_EQ(APFloat::opInexact, F.divide(Three, APFloat::rmTowardNegative));
+  expectBits(F, 0xaaaaaaaaaaaaaaab, 0xbffd);
+
+  // (1 + 2^-63)^2 = 1 + 2^-62 + 2^-126.
+  F = x87(0x8000000000000001, 0x3fff);
+  EXPECT_EQ(APFloat::opInexact,
+            F.multiply(x87(0x8000000000000001, 0x3fff),
+                       APFloat::rmTowardPositive));
+  expectBits(F, 0x8000000000000003, 0x3fff);
+  F = Three;
+  EXPECT_EQ(APFloat::opOK, F.multiply(Three, APFloat::rmTowardNegative));
+  expectBits(F, 0x9000000000000000, 0x4002);
+
+  // Conversions between the formats with host types.
+  bool LosesInfo;
+  F = x87(0x8000000000000001, 0x3fff);
+  EXPECT_EQ(APFloat::opInexact, F.convert(APFloat::IEEEdouble(),
+                                          APFloat::rmNearestTiesToEven,
+                                          &LosesInfo));
+  EXPECT_TRUE(LosesInfo);
+  EXPECT_EQ(0x3ff0000000000000u, F.bitcastToAPInt().getZExtValue());
+  F = x87(0x8000000000000001, 0x3fff);
+  EXPECT_EQ(APFloat::opInexact,
+            F.convert(APFloat::IEEEdouble(), APFloat::rmTowardPositive,
+                      &LosesInfo));
+  EXPECT_EQ(0x3ff0000000000001u, F.bitcastToAPInt().getZExtValue());
+  F = APFloat(APFloat::IEEEdouble(), APInt(64, 0xbfd5555555555555));
+  EXPECT_EQ(APFloat::opInexact,
+            F.convert(APFloat::IEEEsingle(), APFloat::rmTowardZero,
+                      &LosesInfo));
+  EXPECT_TRUE(LosesInfo);
+  EXPECT_EQ(0xbeaaaaaau, F.bitcastToAPInt().getZExtValue());
+  F = APFloat(1.5f);
+  EXPECT_EQ(APFloat::opOK, F.convert(APFloat::x87DoubleExtended(),
+                                     APFloat::rmNearestTiesToEven,
+                                     &LosesInfo));
+  EXPECT_FALSE(LosesInfo);
+  expectBits(F, 0xc000000000000000, 0x3fff);
+  EXPECT_EQ(APFloat::opOK, F.convert(APFloat::IEEEdouble(),
+                                     APFloat::rmNearestTiesToEven,
+                                     &LosesInfo));
+  EXPECT_FALSE(LosesInfo);
+  EXPECT_EQ(1.5, F.convertToDouble());
+}
+
+// Checks IEEEquad arithmetic, which the host may compute, against exact
+// arithmetic on the significands in every rounding mode.
+TEST(APFloatTest, IEEEquadArithmeticRounding) {
+  // A finite value M * 2^E, with M signed.
+  struct Exact {
+    APInt M;
+    int E;
+  };
+  auto exact = [](const APFloat &F) {
+    APInt Bits = F.bitcastToAPInt();
+    APInt M = Bits.trunc(112).zext(1024);
+    int Exponent = Bits.extractBitsAsZExtValue(15, 112);
+    if (Exponent)
+      M.setBit(112);
+    else
+      Exponent = 1;
+    if (Bits[127])
+      M.negate();
+    return Exact{M, Exponent - 16383 - 112};
+  };
+  auto align = [](Exact &A, Exact &B) {
+    int E = std::min(A.E, B.E);
+    A.M <<= A.E - E;
+    B.M <<= B.E - E;
+    A.E = B.E = E;
+  };
+  auto add = [&](Exact A, Exact B) {
+    align(A, B);
+    return Exact{A.M + B.M, A.E};
+  };
+  auto multiply = [](const Exact &A, const Exact &B) {
+    return Exact{A.M * B.M, A.E + B.E};
+  };
+  auto compare = [&](Exact A, Exact B) {
+    align(A, B);
+    return A.M.slt(B.M) ? -1 : A.M == B.M ? 0 : 1;
+  };
+  // The sign of the exact result of OP on A and B minus X.
+  auto errorSign = [&](int Op, const APFloat &A, const APFloat &B, Exact X) {
+    Exact ExactB = exact(B);
+    switch (Op) {
+    case 0:
+      return compare(add(exact(A), ExactB), X);
+    case 1:
+      ExactB.M.negate();
+      return compare(add(exact(A), ExactB), X);
+    case 2:
+      return compare(multiply(exact(A), ExactB), X);
+    default:
+      return compare(exact(A), multiply(X, ExactB)) *
+             (B.isNegative() ? -1 : 1);
+    }
+  };
+
+  std::mt19937_64 Rng(22);
+  auto random = [&](int Exponent) {
+    uint64_t Words[2] = {Rng() % 4 ? Rng() : 0,
+                         (Rng() & 0x8000ffffffffffff) |
+                             uint64_t(Exponent + 16383) << 48};
+    return APFloat(APFloat::IEEEquad(), APInt(128, Words));
+  };
+  for (unsigned I = 0; I < 2000; ++I) {
+    APFloat A = random(int(Rng() % 64) - 32);
+    APFloat B = random(int(Rng() % 64) - 32);
+    switch (Rng() % 4) {
+    case 0:
+      // Cancel all but a few bits.
+      B = A;
+      B.next(Rng() % 2);
+      break;
+    case 1:
+      // Add bits beyond the last place.
+      B = random(ilogb(A) - 110 - int(Rng() % 8));
+      break;
+    }
+    for (int Op = 0; Op < 4; ++Op) {
+      for (APFloat::roundingMode RM :
+           {APFloat::rmNearestTiesToEven, APFloat::rmTowardPositive,
+            APFloat::rmTowardNegative, APFloat::rmTowardZero}) {
+        APFloat R = A;
+        APFloat::opStatus Status = Op == 0   ? R.add(B, RM)
+                                   : Op == 1 ? R.subtract(B, RM)
+                                   : Op == 2 ? R.multiply(B, RM)
+                                             : R.divide(B, RM);
+        int Error = errorSign(Op, A, B, exact(R));
+        EXPECT_EQ(Error ? APFloat::opInexact : APFloat::opOK, Status);
+        if (!Error)
+          continue;
+
+        APFloat Down = R, Up = R;
+        Down.next(true);
+        Up.next(false);
+        if (RM == APFloat::rmTowardZero)
+          RM = R.isNegative() ? APFloat::rmTowardPositive
+                              : APFloat::rmTowardNegative;
+        switch (RM) {
+        case APFloat::rmTowardPositive:
+          EXPECT_LT(Error, 0);
+          EXPECT_GT(errorSign(Op, A, B, exact(Down)), 0);
+          break;
+        case APFloat::rmTowardNegative:
+          EXPECT_GT(Error, 0);
+          EXPECT_LT(errorSign(Op, A, B, exact(Up)), 0);
+          break;
+        default: {
+          // Within half an ulp, and even on a tie.
+          Exact Below = add(exact(R), exact(Down));
+          Exact Above = add(exact(R), exact(Up));
+          Below.E--;
+          Above.E--;
+          int ErrorBelow = errorSign(Op, A, B, Below);
+          int ErrorAbove = errorSign(Op, A, B, Above);
+          EXPECT_GE(ErrorBelow, 0);
+          EXPECT_LE(ErrorAbove, 0);
+          if (!ErrorBelow || !ErrorAbove) {
+            EXPECT_FALSE(R.bitcastToAPInt()[0]);
+          }
+          break;
+        }
+        }
+      }
+    }
+  }
+}
+
+// The host may compute the arithmetic, but must leave the exception flags of
+// the caller's environment as they were, as the software arithmetic does.
+TEST(APFloatTest, ArithmeticKeepsHostExceptionFlags) {
+  for (const fltSemantics *Sem :
+       {&APFloat::IEEEsingle(), &APFloat::IEEEdouble(),
+        &APFloat::x87DoubleExtended(), &APFloat::IEEEquad()}) {
+    int Precision = APFloat::semanticsPrecision(*Sem);
+    APFloat One(*Sem, 1), Three(*Sem, 3);
+    APFloat Big = scalbn(One, APFloat::semanticsMaxExponent(*Sem) - Precision,
+                         APFloat::rmNearestTiesToEven);
+    APFloat Tiny =
+        scalbn(One, APFloat::semanticsMinExponent(*Sem) + 2 * Precision,
+               APFloat::rmNearestTiesToEven);
+
+    std::feclearexcept(FE_ALL_EXCEPT);
+    APFloat R = Big;
+    EXPECT_EQ(R.multiply(Big, APFloat::rmNearestTiesToEven),
+              APFloat::opOverflow | APFloat::opInexact);
+    R = Tiny;
+    EXPECT_EQ(R.multiply(Tiny, APFloat::rmNearestTiesToEven),
+              APFloat::opUnderflow | APFloat::opInexact);
+    R = One;
+    EXPECT_EQ(R.divide(Three, APFloat::rmNearestTiesToEven),
+              APFloat::opInexact);
+    EXPECT_EQ(std::fetestexcept(FE_ALL_EXCEPT), 0);
+  }
+}
+
+TEST(APFloatTest, halfAndBFloatRounding) {
+  // The operations computed in IEEEquad toward zero, with the last bit set
+  // when inexact, round to these narrower formats as the exact results do.
+  auto apply = [](int Op, APFloat &R, const APFloat &B, const APFloat &C,
+                  APFloat::roundingMode RM) {
+    switch (Op) {
+    case 0:
+      return R.add(B, RM);
+    case 1:
+      return R.subtract(B, RM);
+    case 2:
+      return R.multiply(B, RM);
+    case 3:
+      return R.divide(B, RM);
+    default:
+      return R.fusedMultiplyAdd(B, C, RM);
+    }
+  };
+  auto toQuad = [](APFloat F) {
+    bool LosesInfo;
+    F.convert(APFloat::IEEEquad(), APFloat::rmNearestTiesToEven, &LosesInfo);
+    return F;
+  };
+  auto roundOdd = [](APFloat Q, APFloat::opStatus Status) {
+    if ((Status & APFloat::opInexact) && Q.isFiniteNonZero()) {
+      APInt Bits = Q.bitcastToAPInt();
+      Bits.setBit(0);
+      Q = APFloat(APFloat::IEEEquad(), Bits);
+    }
+    return Q;
+  };
+  auto expectSame = [](const APFloat &Expected, APFloat::opStatus Status,
+                       const APFloat &R, APFloat::opStatus RStatus) {
+    EXPECT_EQ(Status, RStatus);
+    if (Expected.isNaN())
+      EXPECT_TRUE(R.isNaN());
+    else
+      EXPECT_EQ(Expected.bitcastToAPInt(), R.bitcastToAPInt());
+  };
+  const APFloat::roundingMode Modes[] = {
+      APFloat::rmNearestTiesToEven, APFloat::rmNearestTiesToAway,
+      APFloat::rmTowardPositive, APFloat::rmTowardNegative,
+      APFloat::rmTowardZero};
+
+  std::mt19937_64 Rng(23);
+  for (const fltSemantics *Sem : {&APFloat::IEEEhalf(), &APFloat::BFloat()}) {
+    // Mostly values near one, to make cancellations and ties likely.
+    unsigned Digits = APFloat::semanticsPrecision(*Sem) - 1;
+    int Bias = APFloat::semanticsMaxExponent(*Sem);
+    auto random = [&] {
+      for (;;) {
+        uint64_t Bits = Rng() & 0xffff;
+        if (Rng() % 4)
+          Bits = (Bits & (0x8000 | ((1 << Digits) - 1))) |
+                 uint64_t(Bias + int(Rng() % 8) - 4) << Digits;
+        APFloat F(*Sem, APInt(16, Bits));
+        if (!F.isNaN())
+          return F;
+      }
+    };
+    for (unsigned I = 0; I < 2000; ++I) {
+      APFloat A = random(), B = random(), C = random();
+      for (int Op = 0; Op < 5; ++Op) {
+        for (APFloat::roundingMode RM : Modes) {
+          APFloat R = A;
+          APFloat::opStatus Status = apply(Op, R, B, C, RM);
+
+          APFloat Q = toQuad(A);
+          APFloat::opStatus QStatus =
+              apply(Op, Q, toQuad(B), toQuad(C), APFloat::rmTowardZero);
+          // Zero sums take their sign from the rounding mode.
+          if (Q.isZero()) {
+            Q = toQuad(A);
+            QStatus = apply(Op, Q, toQuad(B), toQuad(C), RM);
+          }
+          Q = roundOdd(Q, QStatus);
+          bool LosesInfo;
+          APFloat::opStatus Expected = (APFloat::opStatus)(
+              Q.convert(*Sem, RM, &LosesInfo) |
+              (QStatus & (APFloat::opInvalidOp | APFloat::opDivByZero)));
+          expectSame(Q, Expected, R, Status);
+        }
+      }
+
+      // Values of float and double near those of the narrower format, and
+      // near the midpoints between them.
+      for (const fltSemantics *From :
+           {&APFloat::IEEEsingle(), &APFloat::IEEEdouble()}) {
+        APFloat X = A;
+        bool LosesInfo;
+        X.convert(*From, APFloat::rmNearestTiesToEven, &LosesInfo);
+        unsigned Width = APFloat::getSizeInBits(*From);
+        int64_t Half = int64_t(1) << (APFloat::semanticsPrecision(*From) -
+                                      APFloat::semanticsPrecision(*Sem) - 1);
+        int64_t Offset = int64_t(Rng() % 3) - 1 + int64_t(Rng() % 3) * Half;
+        X = APFloat(*From, X.bitcastToAPInt() + APInt(Width, Offset, true));
+        for (APFloat::roundingMode RM : Modes) {
+          APFloat R = X;
+          APFloat::opStatus Status = R.convert(*Sem, RM, &LosesInfo);
+          EXPECT_EQ(Status != APFloat::opOK, LosesInfo);
+          APFloat Expected = toQuad(X);
+          expectSame(Expected, Expected.convert(*Sem, RM, &LosesInfo), R,
+                     Status);
+        }
+      }
+    }
+  }
+}
+
+TEST(APFloatTest, fromDecimalStringRounding) {
+  struct {
+    const fltSemantics &Sem;
+    const char *Str;
+    APFloat::roundingMode RM;
+    uint64_t Bits;
+    APFloat::opStatus Status;
+  } Tests[] = {
+    // Halfway between 1 and the next half.
+    {APFloat::IEEEhalf(), "1.00048828125", APFloat::rmNearestTiesToEven,
+     0x3c00, APFloat::opInexact},
+    {APFloat::IEEEhalf(), "1.00048828125", APFloat::rmNearestTiesToAway,
+     0x3c01, APFloat::opInexact},
+    {APFloat::IEEEhalf(), "1.000488281250000001", APFloat::rmNearestTiesToEven,
+     0x3c01, APFloat::opInexact},
+    {APFloat::IEEEhalf(), "1.000488281249999999", APFloat::rmTowardPositive,
+     0x3c01, APFloat::opInexact},
+    {APFloat::IEEEhalf(), "-1.000488281249999999", APFloat::rmTowardZero,
+     0xbc00, APFloat::opInexact},
+    {APFloat::IEEEhalf(), "5.9604644775390625e-8", APFloat::rmTowardZero,
+     0x0001, APFloat::opOK},
+    {APFloat::BFloat(), "3.0078125", APFloat::rmNearestTiesToEven, 0x4040,
+     APFloat::opInexact},
+    {APFloat::IEEEsingle(), "1.4e-45", APFloat::rmNearestTiesToEven, 0x1,
+     (APFloat::opStatus)(APFloat::opInexact | APFloat::opUnderflow)},
+    {APFloat::IEEEsingle(), "1.4e-45", APFloat::rmTowardZero, 0x0,
+     (APFloat::opStatus)(APFloat::opInexact | APFloat::opUnderflow)},
+    {APFloat::IEEEsingle(), "3.4028235e38", APFloat::rmTowardPositive,
+     0x7f800000,
+     (APFloat::opStatus)(APFloat::opInexact | APFloat::opOverflow)},
+    {APFloat::IEEEdouble(), "9.017807469069554e-21",
+     APFloat::rmNearestTiesToEven, 0x3bc54aee1dd744e0, APFloat::opInexact},
+    {APFloat::IEEEdouble(), "9.017807469069554e-21", APFloat::rmTowardPositive,
+     0x3bc54aee1dd744e1, APFloat::opInexact},
+    {APFloat::IEEEdouble(), "9.017807469069554e-21", APFloat::rmTowardNegative,
+     0x3bc54aee1dd744e0, APFloat::opInexact},
+    {APFloat::IEEEdouble(), "4.9406564584124654e-324",
+     APFloat::rmNearestTiesToEven, 0x1,
+     (APFloat::opStatus)(APFloat::opInexact | APFloat::opUnderflow)},
+    {APFloat::IEEEdouble(), "7.7772157192230224609375",
+     APFloat::rmNearestTiesToEven, 0x401f1bde70000000, APFloat::opOK},
+    // The exact computation is needed for these.
+    {APFloat::IEEEdouble(), "1.38493240634089106081e-42",
+     APFloat::rmTowardPositive, 0x373ee290fabde14c, APFloat::opInexact},
+    {APFloat::IEEEdouble(), "1.38493240634089106081e-42",
+     APFloat::rmTowardNegative, 0x373ee290fabde14b, APFloat::opInexact},
+    {APFloat::IEEEdouble(), "-1.653880076253160635e+285",
+     APFloat::rmNearestTiesToEven, 0xfb263e884c803a2c, APFloat::opInexact},
+    {APFloat::IEEEdouble(), "2.4703282292062327208828439643411068618e-324",
+     APFloat::rmNearestTiesToEven, 0x0,
+     (APFloat::opStatus)(APFloat::opInexact | APFloat::opUnderflow)},
+    {APFloat::IEEEdouble(), "2.4703282292062327208828439643411068619e-324",
+     APFloat::rmNearestTiesToEven, 0x1,
+     (APFloat::opStatus)(APFloat::opInexact | APFloat::opUnderflow)},
+  };
+
+  for (const auto &Test : Tests) {
+    APFloat F(Test.Sem);
+    auto StatusOrErr = F.convertFromString(Test.Str, Test.RM);
+    ASSERT_TRUE(!!StatusOrErr) << Test.Str;
+    EXPECT_EQ(*StatusOrErr, Test.Status) << Test.Str << " " << int(Test.RM);
+    EXPECT_EQ(F.bitcastToAPInt().getZExtValue(), Test.Bits)
+        << Test.Str << " " << int(Test.RM);
+  }
+}
+
 TEST(APFloatTest, fromStringSpecials) {
   const fltSemantics &Sem = APFloat::IEEEdouble();
   const unsigned Precision = 53;
@@ -1183,6 +1693,128 @@ TEST(APFloatTest, toString) {
   }
 }
 
+TEST(APFloatTest, toStringAllFormats) {
+  auto toString = [](const fltSemantics &Sem, const char *Value,
+                     unsigned FormatPrecision, unsigned FormatMaxPadding) {
+    std::string Str;
+    APFloat(Sem, Value).toString(Str, FormatPrecision, FormatMaxPadding);
+    return Str;
+  };
+  const fltSemantics &Half = APFloat::IEEEhalf();
+  const fltSemantics &Double = APFloat::IEEEdouble();
+  const fltSemantics &X87 = APFloat::x87DoubleExtended();
+  const fltSemantics &Quad = APFloat::IEEEquad();
+
+  EXPECT_EQ("1.0E+22", toString(Double, "1e22", 0, 3));
+  EXPECT_EQ("9.9999999999999991E+22", toString(Double, "1e23", 0, 0));
+  EXPECT_EQ("1.2345678901234568E+29",
+            toString(Double, "123456789012345678901234567890", 0, 3));
+  EXPECT_EQ("9007199254740992", toString(Double, "9007199254740993", 0, 30));
+  EXPECT_EQ("0.100000000000000005551115123126",
+            toString(Double, "0.1", 30, 3));
+  EXPECT_EQ("65504", toString(Half, "65504", 0, 3));
+  EXPECT_EQ("5.9605E-8", toString(Half, "5.9604645e-8", 0, 3));
+  EXPECT_EQ("3.64519953188247460253E-4951",
+            toString(X87, "3.6451995318824746025e-4951", 0, 3));
+  EXPECT_EQ("1.18973149535723176502E+4932",
+            toString(X87, "1.18973149535723176502e+4932", 0, 3));
+  EXPECT_EQ("6.47517511943802511092443895822764655E-4966",
+            toString(Quad, "6.475175119438025110924438958227646552e-4966", 0,
+                     3));
+  EXPECT_EQ("1.18973149535723176508575932662800702E+4932",
+            toString(Quad, "1.189731495357231765085759326628007016e+4932", 0,
+                     3));
+  EXPECT_EQ("9.99999999999999999999999999999999962E+99",
+            toString(Quad, "1e100", 36, 3));
+  EXPECT_EQ("0.29999999999999999999999999999999999",
+            toString(Quad, "0.3", 0, 3));
+}
+
+TEST(APFloatTest, toChars) {
+  char Buf[128];
+  for (const fltSemantics *Sem :
+       {&APFloat::IEEEhalf(), &APFloat::BFloat(), &APFloat::IEEEsingle(),
+        &APFloat::IEEEdouble(), &APFloat::x87DoubleExtended(),
+        &APFloat::IEEEquad(), &APFloat::PPCDoubleDouble()}) {
+    for (APFloat V :
+         {APFloat::getZero(*Sem, true), APFloat::getInf(*Sem, true),
+          APFloat::getNaN(*Sem), APFloat::getLargest(*Sem),
+          APFloat::getSmallest(*Sem, true), APFloat::getSmallestNormalized(*Sem),
+          APFloat(*Sem, "0.1"), APFloat(*Sem, "-12345.678"),
+          APFloat(*Sem, "1e10")}) {
+      for (auto [FP, FMP, TZ] : {std::make_tuple(0u, 3u, true),
+                                 std::make_tuple(0u, 0u, true),
+                                 std::make_tuple(5u, 2u, false),
+                                 std::make_tuple(40u, 0u, false)}) {
+        std::string Expected;
+        V.toString(Expected, FP, FMP, TZ);
+        unsigned Max = APFloat::getMaxChars(*Sem, FP, FMP);
+        ASSERT_LE(Max, sizeof(Buf));
+        std::to_chars_result Result = V.toChars(Buf, Buf + Max, FP, FMP, TZ);
+        ASSERT_EQ(std::errc(), Result.ec);
+        EXPECT_EQ(Expected, std::string(Buf, Result.ptr));
+
+        Result = V.toChars(Buf, Buf + Expected.size() - 1, FP, FMP, TZ);
+        EXPECT_EQ(std::errc::value_too_large, Result.ec);
+        EXPECT_EQ(Buf + Expected.size() - 1, Result.ptr);
+
+        // The default format round-trips.
+        if (FP == 0 && !V.isNaN()) {
+          APFloat Parsed(*Sem);
+          std::from_chars_result Parse =
+              Parsed.fromChars(Expected.data(), Expected.data() + Expected.size());
+          EXPECT_EQ(std::errc(), Parse.ec);
+          EXPECT_EQ(Expected.data() + Expected.size(), Parse.ptr);
+          EXPECT_TRUE(V.bitwiseIsEqual(Parsed)) << Expected;
+        }
+      }
+    }
+  }
+}
+
+TEST(APFloatTest, fromChars) {
+  auto Parse = [](APFloat &V, std::string_view Str) {
+    std::from_chars_result Result =
+        V.fromChars(Str.data(), Str.data() + Str.size());
+    return std::make_pair(Result.ptr - Str.data(), Result.ec);
+  };
+  using R = std::pair<std::ptrdiff_t, std::errc>;
+
+  APFloat V(APFloat::IEEEdouble());
+  EXPECT_EQ(R(4, std::errc()), Parse(V, "1.25,"));
+  EXPECT_EQ(1.25, V.convertToDouble());
+  EXPECT_EQ(R(6, std::errc()), Parse(V, "-2.5e1e"));
+  EXPECT_EQ(-25.0, V.convertToDouble());
+  EXPECT_EQ(R(2, std::errc()), Parse(V, "+3e+"));
+  EXPECT_EQ(3.0, V.convertToDouble());
+  EXPECT_EQ(R(2, std::errc()), Parse(V, ".5"));
+  EXPECT_EQ(0.5, V.convertToDouble());
+  EXPECT_EQ(R(7, std::errc()), Parse(V, "0x1.8p1 "));
+  EXPECT_EQ(3.0, V.convertToDouble());
+  EXPECT_EQ(R(1, std::errc()), Parse(V, "0x1.8"));
+  EXPECT_EQ(0.0, V.convertToDouble());
+  EXPECT_EQ(R(4, std::errc()), Parse(V, "-inf]"));
+  EXPECT_TRUE(V.isInfinity() && V.isNegative());
+  EXPECT_EQ(R(8, std::errc()), Parse(V, "nan(123)+"));
+  EXPECT_TRUE(V.isNaN());
+
+  // Errors leave the value unchanged.
+  V = APFloat(7.0);
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, ""));
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, "-"));
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, "."));
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, "e5"));
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, "infinite"));
+  EXPECT_EQ(R(6, std::errc::result_out_of_range), Parse(V, "1e1000"));
+  EXPECT_EQ(R(7, std::errc::result_out_of_range), Parse(V, "1e-1000"));
+  EXPECT_EQ(7.0, V.convertToDouble());
+
+  APFloat H(APFloat::IEEEhalf());
+  EXPECT_EQ(R(5, std::errc::result_out_of_range), Parse(H, "70000"));
+  EXPECT_EQ(R(5, std::errc()), Parse(H, "65504"));
+  EXPECT_EQ(65504.0, H.convertToDouble());
+}
+
 TEST(APFloatTest, toInteger) {
   bool isExact = false;
   APSInt result(5, /*isUnsigned=*/true);
@@ -4477,6 +5109,104 @@ TEST(APFloatTest, PPCDoubleDoubleRoundToIntegral) {
     EXPECT_EQ(APFloat::cmpEqual,
               APFloat(APFloat::PPCDoubleDouble(), "2").compare(A));
   }
+
+  using DataType = std::tuple<uint64_t, uint64_t, uint64_t, uint64_t,
+                              APFloat::roundingMode>;
+  DataType Data[] = {
+      // 2.5 + 2^-60 = 3
+      std::make_tuple(0x4004000000000000ull, 0x3c30000000000000ull,
+                      0x4008000000000000ull, 0, APFloat::rmNearestTiesToEven),
+      // 2^60 + 0.5 = 2^60
+      std::make_tuple(0x43b0000000000000ull, 0x3fe0000000000000ull,
+                      0x43b0000000000000ull, 0, APFloat::rmNearestTiesToEven),
+      // 2^60 + 0.5 = 2^60 + 1
+      std::make_tuple(0x43b0000000000000ull, 0x3fe0000000000000ull,
+                      0x43b0000000000000ull, 0x3ff0000000000000ull,
+                      APFloat::rmNearestTiesToAway),
+      // -2^60 + 0.25 = -2^60 + 1
+      std::make_tuple(0xc3b0000000000000ull, 0x3fd0000000000000ull,
+                      0xc3b0000000000000ull, 0x3ff0000000000000ull,
+                      APFloat::rmTowardZero),
+  };
+
+  for (auto Tp : Data) {
+    uint64_t Op[2], Expected[2];
+    APFloat::roundingMode RM;
+    std::tie(Op[0], Op[1], Expected[0], Expected[1], RM) = Tp;
+
+    APFloat A(APFloat::PPCDoubleDouble(), APInt(128, 2, Op));
+    EXPECT_EQ(APFloat::opInexact, A.roundToIntegral(RM));
+
+    EXPECT_EQ(Expected[0], A.bitcastToAPInt().getRawData()[0])
+        << std::format("roundToIntegral({0:x} + {1:x})", Op[0], Op[1]);
+    EXPECT_EQ(Expected[1], A.bitcastToAPInt().getRawData()[1])
+        << std::format("roundToIntegral({0:x} + {1:x})", Op[0], Op[1]);
+  }
+}
+
+TEST(APFloatTest, PPCDoubleDoubleNext) {
+  using DataType = std::tuple<uint64_t, uint64_t, bool, uint64_t, uint64_t>;
+  DataType Data[] = {
+      // nextDown(1) = 1 - 2^-106
+      std::make_tuple(0x3ff0000000000000ull, 0, true, 0x3ff0000000000000ull,
+                      0xb950000000000000ull),
+      // nextUp(1) = 1 + 2^-105
+      std::make_tuple(0x3ff0000000000000ull, 0, false, 0x3ff0000000000000ull,
+                      0x3960000000000000ull),
+      // nextUp(1 - 2^-106) = 1
+      std::make_tuple(0x3ff0000000000000ull, 0xb950000000000000ull, false,
+                      0x3ff0000000000000ull, 0),
+  };
+
+  for (auto Tp : Data) {
+    uint64_t Op[2], Expected[2];
+    bool NextDown;
+    std::tie(Op[0], Op[1], NextDown, Expected[0], Expected[1]) = Tp;
+
+    APFloat A(APFloat::PPCDoubleDouble(), APInt(128, 2, Op));
+    EXPECT_EQ(APFloat::opOK, A.next(NextDown));
+
+    EXPECT_EQ(Expected[0], A.bitcastToAPInt().getRawData()[0])
+        << std::format("next({0:x} + {1:x}, {2})", Op[0], Op[1], NextDown);
+    EXPECT_EQ(Expected[1], A.bitcastToAPInt().getRawData()[1])
+        << std::format("next({0:x} + {1:x}, {2})", Op[0], Op[1], NextDown);
+  }
+}
+
+TEST(APFloatTest, PPCDoubleDoubleConvertToInteger) {
+  using DataType = std::tuple<uint64_t, uint64_t, APFloat::roundingMode,
+                              uint64_t, APFloat::opStatus>;
+  DataType Data[] = {
+      // 2^63 - 0.5 = 2^63 - 1
+      std::make_tuple(0x43e0000000000000ull, 0xbfe0000000000000ull,
+                      APFloat::rmTowardZero, 0x7fffffffffffffffull,
+                      APFloat::opInexact),
+      // 2^63 - 0.5 rounds up out of range
+      std::make_tuple(0x43e0000000000000ull, 0xbfe0000000000000ull,
+                      APFloat::rmTowardPositive, 0x7fffffffffffffffull,
+                      APFloat::opInvalidOp),
+      // -2^63 - 0.5 = -2^63
+      std::make_tuple(0xc3e0000000000000ull, 0xbfe0000000000000ull,
+                      APFloat::rmTowardZero, 0x8000000000000000ull,
+                      APFloat::opInexact),
+  };
+
+  for (auto Tp : Data) {
+    uint64_t Op[2], Expected;
+    APFloat::roundingMode RM;
+    APFloat::opStatus ExpectedStatus;
+    std::tie(Op[0], Op[1], RM, Expected, ExpectedStatus) = Tp;
+
+    APFloat A(APFloat::PPCDoubleDouble(), APInt(128, 2, Op));
+    APFloat::integerPart Result;
+    bool IsExact;
+    EXPECT_EQ(ExpectedStatus,
+              A.convertToInteger(std::span<APFloat::integerPart>(&Result, 1),
+                                 64, true, RM, &IsExact));
+    EXPECT_FALSE(IsExact);
+    EXPECT_EQ(Expected, Result)
+        << std::format("convertToInteger({0:x} + {1:x})", Op[0], Op[1]);
+  }
 }
 
 TEST(APFloatTest, PPCDoubleDoubleCompare) {
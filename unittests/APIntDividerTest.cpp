@@ -0,0 +1,100 @@
+// APIntDividerTest.cpp - APIntDivider unit tests
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "bijou/APIntDivider.hpp"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+using namespace bijou;
+
+namespace {
+
+APInt randomAPInt(std::mt19937_64 &Rng, unsigned BitWidth) {
+  std::vector<uint64_t> Words(APInt::getNumWords(BitWidth));
+  for (uint64_t &Word : Words)
+    Word = Rng();
+  return APInt(BitWidth, Words);
+}
+
+void testDivider(const APInt &Divisor, const APInt &Dividend) {
+  APIntDivider Divider(Divisor);
+  APInt Quo, Rem;
+  APInt::udivrem(Dividend, Divisor, Quo, Rem);
+
+  APInt Q, R;
+  Divider.udivrem(Dividend, Q, R);
+  EXPECT_EQ(Q, Quo);
+  EXPECT_EQ(R, Rem);
+  EXPECT_EQ(Divider.udiv(Dividend), Quo);
+  EXPECT_EQ(Divider.urem(Dividend), Rem);
+}
+
+TEST(APIntDividerTest, Random) {
+  std::mt19937_64 Rng(3);
+  for (unsigned BitWidth : {7u, 64u, 65u, 128u, 200u, 1024u, 3000u}) {
+    for (unsigned DivisorBits = 1; DivisorBits <= BitWidth;
+         DivisorBits = DivisorBits * 3 / 2 + 1) {
+      for (unsigned I = 0; I < 4; ++I) {
+        APInt Divisor =
+            randomAPInt(Rng, BitWidth).lshr(BitWidth - DivisorBits);
+        Divisor.setBit(DivisorBits - 1);
+        APInt Dividend = randomAPInt(Rng, BitWidth);
+        testDivider(Divisor, Dividend);
+        testDivider(Divisor, Dividend.lshr(Rng() % BitWidth));
+        testDivider(Divisor, Divisor);
+        testDivider(Divisor, Divisor - 1);
+        testDivider(Divisor, APInt::getAllOnes(BitWidth));
+      }
+    }
+  }
+}
+
+TEST(APIntDividerTest, PowersOfTwo) {
+  std::mt19937_64 Rng(4);
+  for (unsigned BitWidth : {1u, 64u, 300u})
+    for (unsigned Bit = 0; Bit < BitWidth; Bit += 7)
+      testDivider(APInt::getOneBitSet(BitWidth, Bit),
+                  randomAPInt(Rng, BitWidth));
+}
+
+TEST(APIntDividerTest, Extremes) {
+  // Divisors whose quotient estimates are furthest off.
+  for (unsigned BitWidth : {64u, 128u, 256u, 512u}) {
+    APInt AllOnes = APInt::getAllOnes(BitWidth);
+    testDivider(AllOnes, AllOnes);
+    testDivider(AllOnes, AllOnes - 1);
+    testDivider(AllOnes.lshr(1), AllOnes);
+    testDivider(APInt::getSignedMinValue(BitWidth) + 1, AllOnes);
+    testDivider(APInt(BitWidth, 3), AllOnes);
+    testDivider(APInt(BitWidth, 10000000000000000000ULL), AllOnes);
+  }
+}
+
+TEST(APIntDividerTest, Aliasing) {
+  APIntDivider Divider(APInt(128, 1000));
+  APInt X(128, 123456789);
+  APInt R;
+  Divider.udivrem(X, X, R);
+  EXPECT_EQ(X, 123456);
+  EXPECT_EQ(R, 789);
+}
+
+TEST(APIntDividerTest, RoundingUDiv) {
+  APIntDivider Divider(APInt(96, 7));
+  EXPECT_EQ(APIntOps::RoundingUDiv(APInt(96, 50), Divider,
+                                   APInt::Rounding::DOWN), 7);
+  EXPECT_EQ(APIntOps::RoundingUDiv(APInt(96, 50), Divider,
+                                   APInt::Rounding::TOWARD_ZERO), 7);
+  EXPECT_EQ(APIntOps::RoundingUDiv(APInt(96, 50), Divider,
+                                   APInt::Rounding::UP), 8);
+  EXPECT_EQ(APIntOps::RoundingUDiv(APInt(96, 49), Divider,
+                                   APInt::Rounding::UP), 7);
+}
+
+} // end anonymous namespace
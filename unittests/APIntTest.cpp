@@ -16,10 +16,15 @@
 #include "bijou/APInt.hpp"
 #include "bijou/Error.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <charconv>
+#include <random>
 #include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 using namespace bijou;
 
@@ -600,6 +605,12 @@ TEST(APIntTest, binaryOpsWithRawIntegers) {
   EXPECT_EQ(A2 ^ UINT64_MAX, A2 - N + ~N);
 }
 
+// Moving an APInt only hands over its storage when the value lives on the heap;
+// values that fit in the inline buffer are copied instead.
+bool reusesStorage(const APInt &V, const uint64_t *RawData) {
+  return !V.needsCleanup() || V.getRawData() == RawData;
+}
+
 TEST(APIntTest, rvalue_arithmetic) {
   // Test all combinations of lvalue/rvalue lhs/rhs of add/sub
 
@@ -626,15 +637,15 @@ TEST(APIntTest, rvalue_arithmetic) {
 
     APInt AddLR = One + getRValue("1", RawDataR);
     EXPECT_EQ(AddLR, Two);
-    EXPECT_EQ(AddLR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AddLR, RawDataR));
 
     APInt AddRL = getRValue("1", RawDataL) + One;
     EXPECT_EQ(AddRL, Two);
-    EXPECT_EQ(AddRL.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(AddRL, RawDataL));
 
     APInt AddRR = getRValue("1", RawDataL) + getRValue("1", RawDataR);
     EXPECT_EQ(AddRR, Two);
-    EXPECT_EQ(AddRR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AddRR, RawDataR));
 
     // LValue's and constants
     APInt AddLK = One + 1;
@@ -646,11 +657,11 @@ TEST(APIntTest, rvalue_arithmetic) {
     // RValue's and constants
     APInt AddRK = getRValue("1", RawDataL) + 1;
     EXPECT_EQ(AddRK, Two);
-    EXPECT_EQ(AddRK.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(AddRK, RawDataL));
 
     APInt AddKR = 1 + getRValue("1", RawDataR);
     EXPECT_EQ(AddKR, Two);
-    EXPECT_EQ(AddKR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AddKR, RawDataR));
   }
 
   {
@@ -663,16 +674,16 @@ TEST(APIntTest, rvalue_arithmetic) {
 
     APInt AddLR = AllOnes + getRValue("2", RawDataR);
     EXPECT_EQ(AddLR, HighOneLowOne);
-    EXPECT_EQ(AddLR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AddLR, RawDataR));
 
     APInt AddRL = getRValue("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", RawDataL) + Two;
     EXPECT_EQ(AddRL, HighOneLowOne);
-    EXPECT_EQ(AddRL.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(AddRL, RawDataL));
 
     APInt AddRR = getRValue("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", RawDataL) +
                   getRValue("2", RawDataR);
     EXPECT_EQ(AddRR, HighOneLowOne);
-    EXPECT_EQ(AddRR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AddRR, RawDataR));
 
     // LValue's and constants
     APInt AddLK = AllOnes + 2;
@@ -684,11 +695,11 @@ TEST(APIntTest, rvalue_arithmetic) {
     // RValue's and constants
     APInt AddRK = getRValue("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", RawDataL) + 2;
     EXPECT_EQ(AddRK, HighOneLowOne);
-    EXPECT_EQ(AddRK.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(AddRK, RawDataL));
 
     APInt AddKR = 2 + getRValue("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", RawDataR);
     EXPECT_EQ(AddKR, HighOneLowOne);
-    EXPECT_EQ(AddKR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AddKR, RawDataR));
   }
 
   {
@@ -698,15 +709,15 @@ TEST(APIntTest, rvalue_arithmetic) {
 
     APInt SubLR = Two - getRValue("1", RawDataR);
     EXPECT_EQ(SubLR, One);
-    EXPECT_EQ(SubLR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(SubLR, RawDataR));
 
     APInt SubRL = getRValue("2", RawDataL) - One;
     EXPECT_EQ(SubRL, One);
-    EXPECT_EQ(SubRL.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(SubRL, RawDataL));
 
     APInt SubRR = getRValue("2", RawDataL) - getRValue("1", RawDataR);
     EXPECT_EQ(SubRR, One);
-    EXPECT_EQ(SubRR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(SubRR, RawDataR));
 
     // LValue's and constants
     APInt SubLK = Two - 1;
@@ -718,11 +729,11 @@ TEST(APIntTest, rvalue_arithmetic) {
     // RValue's and constants
     APInt SubRK = getRValue("2", RawDataL) - 1;
     EXPECT_EQ(SubRK, One);
-    EXPECT_EQ(SubRK.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(SubRK, RawDataL));
 
     APInt SubKR = 2 - getRValue("1", RawDataR);
     EXPECT_EQ(SubKR, One);
-    EXPECT_EQ(SubKR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(SubKR, RawDataR));
   }
 
   {
@@ -736,17 +747,17 @@ TEST(APIntTest, rvalue_arithmetic) {
     APInt SubLR = HighOneLowOne -
                   getRValue("0FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", RawDataR);
     EXPECT_EQ(SubLR, Two);
-    EXPECT_EQ(SubLR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(SubLR, RawDataR));
 
     APInt SubRL = getRValue("100000000000000000000000000000001", RawDataL) -
                   AllOnes;
     EXPECT_EQ(SubRL, Two);
-    EXPECT_EQ(SubRL.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(SubRL, RawDataL));
 
     APInt SubRR = getRValue("100000000000000000000000000000001", RawDataL) -
                   getRValue("0FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", RawDataR);
     EXPECT_EQ(SubRR, Two);
-    EXPECT_EQ(SubRR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(SubRR, RawDataR));
 
     // LValue's and constants
     // 0x100...0001 - 0x2 = 0x0,FFFF...FFFF
@@ -761,11 +772,11 @@ TEST(APIntTest, rvalue_arithmetic) {
     // 0x100...0001 - 0x2 = 0x0,FFFF...FFFF
     APInt SubRK = getRValue("100000000000000000000000000000001", RawDataL) - 2;
     EXPECT_EQ(SubRK, AllOnes);
-    EXPECT_EQ(SubRK.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(SubRK, RawDataL));
 
     APInt SubKR = 2 - getRValue("1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", RawDataR);
     EXPECT_EQ(SubKR, Three);
-    EXPECT_EQ(SubKR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(SubKR, RawDataR));
   }
 }
 
@@ -793,15 +804,15 @@ TEST(APIntTest, rvalue_bitwise) {
 
     APInt AndLR = Ten & getRValue("C", RawDataR);
     EXPECT_EQ(AndLR, 0x8);
-    EXPECT_EQ(AndLR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AndLR, RawDataR));
 
     APInt AndRL = getRValue("A", RawDataL) & Twelve;
     EXPECT_EQ(AndRL, 0x8);
-    EXPECT_EQ(AndRL.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(AndRL, RawDataL));
 
     APInt AndRR = getRValue("A", RawDataL) & getRValue("C", RawDataR);
     EXPECT_EQ(AndRR, 0x8);
-    EXPECT_EQ(AndRR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AndRR, RawDataR));
 
     // LValue's and constants
     APInt AndLK = Ten & 0xc;
@@ -813,11 +824,11 @@ TEST(APIntTest, rvalue_bitwise) {
     // RValue's and constants
     APInt AndRK = getRValue("A", RawDataL) & 0xc;
     EXPECT_EQ(AndRK, 0x8);
-    EXPECT_EQ(AndRK.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(AndRK, RawDataL));
 
     APInt AndKR = 0xa & getRValue("C", RawDataR);
     EXPECT_EQ(AndKR, 0x8);
-    EXPECT_EQ(AndKR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(AndKR, RawDataR));
   }
 
   {
@@ -827,15 +838,15 @@ TEST(APIntTest, rvalue_bitwise) {
 
     APInt OrLR = Ten | getRValue("C", RawDataR);
     EXPECT_EQ(OrLR, 0xe);
-    EXPECT_EQ(OrLR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(OrLR, RawDataR));
 
     APInt OrRL = getRValue("A", RawDataL) | Twelve;
     EXPECT_EQ(OrRL, 0xe);
-    EXPECT_EQ(OrRL.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(OrRL, RawDataL));
 
     APInt OrRR = getRValue("A", RawDataL) | getRValue("C", RawDataR);
     EXPECT_EQ(OrRR, 0xe);
-    EXPECT_EQ(OrRR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(OrRR, RawDataR));
 
     // LValue's and constants
     APInt OrLK = Ten | 0xc;
@@ -847,11 +858,11 @@ TEST(APIntTest, rvalue_bitwise) {
     // RValue's and constants
     APInt OrRK = getRValue("A", RawDataL) | 0xc;
     EXPECT_EQ(OrRK, 0xe);
-    EXPECT_EQ(OrRK.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(OrRK, RawDataL));
 
     APInt OrKR = 0xa | getRValue("C", RawDataR);
     EXPECT_EQ(OrKR, 0xe);
-    EXPECT_EQ(OrKR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(OrKR, RawDataR));
   }
 
   {
@@ -861,15 +872,15 @@ TEST(APIntTest, rvalue_bitwise) {
 
     APInt XorLR = Ten ^ getRValue("C", RawDataR);
     EXPECT_EQ(XorLR, 0x6);
-    EXPECT_EQ(XorLR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(XorLR, RawDataR));
 
     APInt XorRL = getRValue("A", RawDataL) ^ Twelve;
     EXPECT_EQ(XorRL, 0x6);
-    EXPECT_EQ(XorRL.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(XorRL, RawDataL));
 
     APInt XorRR = getRValue("A", RawDataL) ^ getRValue("C", RawDataR);
     EXPECT_EQ(XorRR, 0x6);
-    EXPECT_EQ(XorRR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(XorRR, RawDataR));
 
     // LValue's and constants
     APInt XorLK = Ten ^ 0xc;
@@ -881,11 +892,11 @@ TEST(APIntTest, rvalue_bitwise) {
     // RValue's and constants
     APInt XorRK = getRValue("A", RawDataL) ^ 0xc;
     EXPECT_EQ(XorRK, 0x6);
-    EXPECT_EQ(XorRK.getRawData(), RawDataL);
+    EXPECT_TRUE(reusesStorage(XorRK, RawDataL));
 
     APInt XorKR = 0xa ^ getRValue("C", RawDataR);
     EXPECT_EQ(XorKR, 0x6);
-    EXPECT_EQ(XorKR.getRawData(), RawDataR);
+    EXPECT_TRUE(reusesStorage(XorKR, RawDataR));
   }
 }
 
@@ -910,7 +921,7 @@ TEST(APIntTest, rvalue_invert) {
 
     APInt NegR = ~getRValue("1", RawData);
     EXPECT_EQ(NegR, NegativeTwo);
-    EXPECT_EQ(NegR.getRawData(), RawData);
+    EXPECT_TRUE(reusesStorage(NegR, RawData));
   }
 }
 
@@ -1010,6 +1021,21 @@ TEST(APIntTest, divrem_big7) {
           {224, "80000000800000010000000f", 16});
 }
 
+TEST(APIntTest, divrem_big8) {
+  // Tests KnuthDiv rare step D6 with 64-bit digits.
+  testDiv({256, "800000000000000000000000000000000000000000000001", 16},
+          {256, "fffffffffffffffe", 16},
+          {256, "7fffffffffffffffffffffffffffffff0000000000000002", 16});
+}
+
+TEST(APIntTest, divrem_big9) {
+  // Tests KnuthDiv with a 64-bit top dividend digit equal to the top divisor
+  // digit, where the quotient digit estimate would overflow.
+  testDiv({256, "ffffffffffffffff0000000000000000", 16},
+          {256, "10000000000000001", 16},
+          {256, "10000000000000000", 16});
+}
+
 void testDiv(APInt a, uint64_t b, APInt c) {
   auto p = a * b + c;
 
@@ -1259,6 +1285,47 @@ TEST(APIntTest, SaturatingMath) {
   EXPECT_EQ(APInt(8, -128), APInt(8, -1).sshl_sat(APInt(8, 8)));
 }
 
+TEST(APIntTest, fromStringWide) {
+  // Accumulate one digit at a time, as a reference.
+  auto slowFromString = [](unsigned Bits, const std::string &Str,
+                           unsigned Radix) {
+    APInt V(Bits, 0);
+    for (char C : Str) {
+      V *= Radix;
+      V += C <= '9' ? C - '0' : (C | 0x20) - 'a' + 10;
+    }
+    return V;
+  };
+
+  uint64_t Seed = 1;
+  for (unsigned Radix : {2u, 8u, 10u, 16u, 36u}) {
+    for (unsigned Len : {1u, 7u, 8u, 9u, 19u, 20u, 38u, 100u, 700u, 2500u}) {
+      std::string Str;
+      for (unsigned i = 0; i < Len; i++) {
+        Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        unsigned Digit = (Seed >> 33) % Radix;
+        char Letter = Seed & 1 ? 'a' : 'A';
+        Str.push_back(Digit < 10 ? '0' + Digit : Letter + Digit - 10);
+      }
+
+      unsigned Bits = Len * 6 + 64;
+      APInt Expected = slowFromString(Bits, Str, Radix);
+      EXPECT_EQ(Expected, APInt(Bits, Str, Radix)) << Radix << " " << Str;
+      EXPECT_EQ(-Expected, APInt(Bits, "-" + Str, Radix)) << Radix;
+
+      // Leading zeros don't change the value.
+      EXPECT_EQ(Expected, APInt(Bits + 96, "000" + Str, Radix).trunc(Bits));
+
+      // Values wider than the APInt wrap around.
+      if (Radix == 10 || Radix == 36) {
+        unsigned Narrow = std::max(1u, (Len - 1) * 64 / 22);
+        EXPECT_EQ(slowFromString(Narrow, Str, Radix),
+                  APInt(Narrow, Str, Radix)) << Radix << " " << Str;
+      }
+    }
+  }
+}
+
 TEST(APIntTest, FromArray) {
   uint64_t arr[1] = {1};
   EXPECT_EQ(APInt(32, uint64_t(1)), APInt(32, std::span<uint64_t>(arr)));
@@ -1416,6 +1483,137 @@ TEST(APIntTest, toString) {
   S.clear();
 }
 
+TEST(APIntTest, toStringWide) {
+  // Convert one digit at a time, as a reference.
+  auto slowToString = [](APInt V, unsigned Radix) {
+    std::string S;
+    while (V.getBoolValue()) {
+      uint64_t Digit;
+      APInt::udivrem(V, Radix, V, Digit);
+      S.push_back("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[Digit]);
+    }
+    std::reverse(S.begin(), S.end());
+    return S.empty() ? std::string("0") : S;
+  };
+
+  for (unsigned Words : {2u, 23u, 24u, 50u, 97u, 160u}) {
+    unsigned Bits = Words * APInt::APINT_BITS_PER_WORD;
+    std::vector<uint64_t> Random(Words);
+    uint64_t Seed = Words;
+    for (uint64_t &W : Random)
+      W = Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    APInt PowerOf10(Bits, 1);
+    while (PowerOf10.countLeadingZeros() > 4)
+      PowerOf10 *= 10;
+
+    for (const APInt &V : {APInt(Bits, Random), APInt::getAllOnes(Bits),
+                           APInt::getSignedMaxValue(Bits), PowerOf10,
+                           PowerOf10 - 1, PowerOf10 + 1}) {
+      for (unsigned Radix : {10u, 36u}) {
+        std::string Expected = slowToString(V, Radix);
+        EXPECT_EQ(Expected, V.toStringUnsigned(Radix)) << Radix;
+        EXPECT_EQ(V, APInt(Bits, Expected, Radix));
+      }
+      if (V.isNegative()) {
+        std::string Signed = V.toStringSigned();
+        EXPECT_EQ('-', Signed[0]);
+        EXPECT_EQ(slowToString(-V, 10), Signed.substr(1));
+      }
+    }
+  }
+}
+
+TEST(APIntTest, toChars) {
+  char Buf[1200];
+  for (unsigned Bits : {1u, 7u, 64u, 65u, 128u, 200u, 1100u}) {
+    for (const APInt &V :
+         {APInt(Bits, 0), APInt(Bits, 1), APInt::getAllOnes(Bits),
+          APInt::getSignedMinValue(Bits), APInt::getSignedMaxValue(Bits),
+          APInt::getOneBitSet(Bits, Bits / 2)}) {
+      for (unsigned Radix : {2u, 8u, 10u, 16u, 36u}) {
+        for (bool Signed : {false, true}) {
+          unsigned Max = APInt::getMaxChars(Bits, Radix, Signed);
+          ASSERT_LE(Max, sizeof(Buf));
+          std::to_chars_result Result =
+              V.toChars(Buf, Buf + Max, Radix, Signed);
+          ASSERT_EQ(std::errc(), Result.ec);
+          std::string Str(Buf, Result.ptr), Expected;
+          V.toString(Expected, Radix, Signed);
+          EXPECT_EQ(Expected, Str);
+
+          // Output that does not fit is an error, not a truncation.
+          Result = V.toChars(Buf, Buf + Str.size() - 1, Radix, Signed);
+          EXPECT_EQ(std::errc::value_too_large, Result.ec);
+          EXPECT_EQ(Buf + Str.size() - 1, Result.ptr);
+
+          APInt Parsed(Bits, 0);
+          std::from_chars_result Parse = Parsed.fromChars(
+              Str.data(), Str.data() + Str.size(), Radix, Signed);
+          EXPECT_EQ(std::errc(), Parse.ec);
+          EXPECT_EQ(Str.data() + Str.size(), Parse.ptr);
+          EXPECT_EQ(V, Parsed);
+        }
+      }
+    }
+  }
+
+  std::to_chars_result Result =
+      APInt(32, 255).toChars(Buf, Buf + 4, 16, false, true);
+  EXPECT_EQ("0xFF", std::string(Buf, Result.ptr));
+  Result = APInt(32, -255).toChars(Buf, Buf + 4, 10, true);
+  EXPECT_EQ("-255", std::string(Buf, Result.ptr));
+  Result = APInt(0, 0).toChars(Buf, Buf + 1, 10, false);
+  EXPECT_EQ("0", std::string(Buf, Result.ptr));
+
+  EXPECT_EQ(10u, APInt::getMaxChars(32, 16, false, true));
+  EXPECT_EQ(11u, APInt::getMaxChars(32, 10, true));
+  EXPECT_EQ(20u, APInt::getMaxChars(64, 10, false));
+  EXPECT_EQ(1u, APInt::getMaxChars(0, 10, false));
+}
+
+TEST(APIntTest, fromChars) {
+  auto Parse = [](APInt &V, std::string_view Str, unsigned Radix = 10,
+                  bool Signed = false) {
+    std::from_chars_result Result =
+        V.fromChars(Str.data(), Str.data() + Str.size(), Radix, Signed);
+    return std::make_pair(Result.ptr - Str.data(), Result.ec);
+  };
+  using R = std::pair<std::ptrdiff_t, std::errc>;
+
+  APInt V(8, 7);
+  EXPECT_EQ(R(3, std::errc()), Parse(V, "123abc"));
+  EXPECT_EQ(123u, V);
+  EXPECT_EQ(R(6, std::errc()), Parse(V, "000255"));
+  EXPECT_EQ(255u, V);
+  EXPECT_EQ(R(2, std::errc()), Parse(V, "7f ", 16));
+  EXPECT_EQ(127u, V);
+
+  // Errors leave the value unchanged.
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, ""));
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, "-1"));
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, "-", 10, true));
+  EXPECT_EQ(R(0, std::errc::invalid_argument), Parse(V, "+1"));
+  EXPECT_EQ(R(3, std::errc::result_out_of_range), Parse(V, "256"));
+  EXPECT_EQ(R(3, std::errc::result_out_of_range), Parse(V, "128", 10, true));
+  EXPECT_EQ(R(4, std::errc::result_out_of_range), Parse(V, "-129", 10, true));
+  EXPECT_EQ(R(30, std::errc::result_out_of_range),
+            Parse(V, "123456789012345678901234567890"));
+  EXPECT_EQ(127u, V);
+
+  EXPECT_EQ(R(4, std::errc()), Parse(V, "-128", 10, true));
+  EXPECT_EQ(-128, V.getSExtValue());
+  EXPECT_EQ(R(2, std::errc()), Parse(V, "-0", 10, true));
+  EXPECT_EQ(0u, V);
+
+  APInt W(200, 0);
+  std::string Max = APInt::getAllOnes(200).toStringUnsigned(36);
+  EXPECT_EQ(R(Max.size(), std::errc()), Parse(W, Max, 36));
+  EXPECT_TRUE(W.isAllOnes());
+  EXPECT_EQ(R(Max.size() + 1, std::errc::result_out_of_range),
+            Parse(W, Max + "0", 36));
+}
+
 TEST(APIntTest, Log2) {
   EXPECT_EQ(APInt(15, 7).logBase2(), 2U);
   EXPECT_EQ(APInt(15, 7).ceilLogBase2(), 3U);
@@ -2569,6 +2767,55 @@ TEST(APIntTest, isSubsetOf) {
   EXPECT_TRUE(i128_3.isSubsetOf(i128_3));
 }
 
+TEST(APIntTest, WideBitwise) {
+  // Cover both full vectors and the remaining words of each kernel.
+  std::mt19937_64 Rng(13);
+  for (unsigned BitWidth : {65u, 128u, 200u, 256u, 320u, 511u, 512u, 576u,
+                            960u, 1000u, 2048u, 2113u, 4096u}) {
+    unsigned NumWords = APInt::getNumWords(BitWidth);
+    std::vector<uint64_t> LHS(NumWords), RHS(NumWords);
+    for (unsigned I = 0; I < NumWords; ++I) {
+      LHS[I] = Rng();
+      RHS[I] = Rng();
+    }
+    APInt A(BitWidth, LHS), B(BitWidth, RHS);
+    LHS.assign(A.getRawData(), A.getRawData() + NumWords);
+    RHS.assign(B.getRawData(), B.getRawData() + NumWords);
+
+    unsigned Population = 0;
+    for (uint64_t Word : LHS)
+      Population += std::popcount(Word);
+    EXPECT_EQ(A.countPopulation(), Population);
+
+    APInt And = A & B, Or = A | B, Xor = A ^ B, Not = ~A;
+    for (unsigned I = 0; I < NumWords; ++I) {
+      EXPECT_EQ(And.getRawData()[I], LHS[I] & RHS[I]);
+      EXPECT_EQ(Or.getRawData()[I], LHS[I] | RHS[I]);
+      EXPECT_EQ(Xor.getRawData()[I], LHS[I] ^ RHS[I]);
+    }
+    EXPECT_EQ(Not.countPopulation(), BitWidth - Population);
+    EXPECT_EQ(Not ^ A, APInt::getAllOnes(BitWidth));
+
+    EXPECT_TRUE(A.intersects(Or));
+    EXPECT_TRUE(And.isSubsetOf(A));
+    EXPECT_TRUE(A.isSubsetOf(Or));
+    EXPECT_FALSE(A.intersects(Not));
+    EXPECT_FALSE(A.isSubsetOf(Not));
+
+    // A single differing bit, in every word.
+    for (unsigned Bit = 0; Bit < BitWidth; Bit += 61) {
+      APInt OneBit = APInt::getOneBitSet(BitWidth, Bit);
+      APInt Flipped = A ^ OneBit;
+      EXPECT_NE(Flipped, A);
+      EXPECT_EQ(Flipped ^ OneBit, A);
+      EXPECT_EQ(OneBit.intersects(A), A[Bit]);
+      EXPECT_EQ(OneBit.isSubsetOf(A), A[Bit]);
+      EXPECT_EQ(Not.intersects(OneBit), !A[Bit]);
+      EXPECT_EQ(OneBit.countPopulation(), 1u);
+    }
+  }
+}
+
 TEST(APIntTest, sext) {
   EXPECT_EQ(0, APInt(1, 0).sext(64));
   EXPECT_EQ(~uint64_t(0), APInt(1, 1).sext(64));
@@ -3032,4 +3279,328 @@ TEST(APIntTest, ScaleBitMask) {
             APInt::getOneBitSet(256, 2));
 }
 
+TEST(APIntTest, InlineStorage) {
+  const unsigned InlineBits =
+      APInt::APINT_INLINE_WORDS * APInt::APINT_BITS_PER_WORD;
+  EXPECT_FALSE(APInt(64, 0).needsCleanup());
+  EXPECT_FALSE(APInt(InlineBits, 0).needsCleanup());
+  EXPECT_TRUE(APInt(InlineBits + 1, 0).needsCleanup());
+
+  // Copy and move values between inline, multi-word and heap storage.
+  for (unsigned Width : {65u, InlineBits, InlineBits + 1, 2 * InlineBits}) {
+    APInt V = APInt::getAllOnes(Width).lshr(3) - 12345;
+    APInt Copy(V);
+    EXPECT_EQ(V, Copy);
+
+    APInt Narrow(64, 42);
+    Narrow = V;
+    EXPECT_EQ(V, Narrow);
+
+    APInt Wide = APInt::getOneBitSet(3 * InlineBits, 7);
+    Wide = V;
+    EXPECT_EQ(V, Wide);
+
+    APInt Moved(std::move(Copy));
+    EXPECT_EQ(V, Moved);
+    Narrow = std::move(Moved);
+    EXPECT_EQ(V, Narrow);
+
+    APInt Ext = V.zext(Width + 64);
+    EXPECT_EQ(V, Ext.trunc(Width));
+    EXPECT_EQ(V * V, (Ext * Ext).trunc(Width));
+  }
+}
+
+
+TEST(APIntTest, MultiplyAlgorithms) {
+  using WordType = APInt::WordType;
+
+  auto schoolbook = [](const std::vector<WordType> &LHS,
+                       const std::vector<WordType> &RHS) {
+    std::vector<WordType> Dst(LHS.size() + RHS.size());
+    APInt::tcSet(Dst.data(), 0, RHS.size());
+    for (unsigned i = 0; i < LHS.size(); i++)
+      APInt::tcMultiplyPart(&Dst[i], RHS.data(), LHS[i], 0, RHS.size(),
+                            RHS.size() + 1, true);
+    return Dst;
+  };
+
+  // Pseudo-random words, all ones to stress the carries, and a value whose
+  // low half is zero.
+  auto operand = [](unsigned Parts, unsigned Kind, WordType Seed) {
+    std::vector<WordType> V(Parts);
+    for (unsigned i = 0; i < Parts; i++) {
+      Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      V[i] = Kind == 0 ? Seed : Kind == 1 || i >= Parts / 2 ? ~WordType(0) : 0;
+    }
+    return V;
+  };
+
+  for (unsigned Parts : {2u, 3u, 5u, 7u, 8u, 13u, 24u, 25u, 40u, 97u, 130u}) {
+    for (unsigned Kind = 0; Kind < 3; Kind++) {
+      std::vector<WordType> LHS = operand(Parts, Kind, Parts);
+      std::vector<WordType> RHS = operand(Parts, Kind == 2 ? 0 : Kind, ~Parts);
+      std::vector<WordType> Expected = schoolbook(LHS, RHS);
+      std::vector<WordType> Dst(2 * Parts);
+
+      APInt::tcKaratsubaMultiply(Dst.data(), LHS.data(), RHS.data(), Parts);
+      EXPECT_EQ(Expected, Dst) << "karatsuba, " << Parts << " words";
+
+      if (Parts >= 5) {
+        APInt::tcToom3Multiply(Dst.data(), LHS.data(), RHS.data(), Parts);
+        EXPECT_EQ(Expected, Dst) << "toom3, " << Parts << " words";
+      }
+
+      APInt::tcFullMultiply(Dst.data(), LHS.data(), RHS.data(), Parts, Parts);
+      EXPECT_EQ(Expected, Dst) << "full, " << Parts << " words";
+    }
+  }
+
+  // Unbalanced operands are multiplied blockwise.
+  for (unsigned LHSParts : {30u, 100u}) {
+    std::vector<WordType> LHS = operand(LHSParts, 0, 1);
+    std::vector<WordType> RHS = operand(250, 0, 2);
+    std::vector<WordType> Expected = schoolbook(LHS, RHS);
+    std::vector<WordType> Dst(LHSParts + 250);
+    APInt::tcFullMultiply(Dst.data(), LHS.data(), RHS.data(), LHSParts, 250);
+    EXPECT_EQ(Expected, Dst);
+    APInt::tcFullMultiply(Dst.data(), RHS.data(), LHS.data(), 250, LHSParts);
+    EXPECT_EQ(Expected, Dst);
+  }
+
+  // APInt multiplication, with and without overflow.
+  const unsigned Bits = 200 * APInt::APINT_BITS_PER_WORD;
+  for (unsigned Parts : {60u, 100u, 120u}) {
+    std::vector<WordType> LHS = operand(Parts, 0, 3);
+    std::vector<WordType> RHS = operand(Parts, 0, 4);
+    std::vector<WordType> Full = schoolbook(LHS, RHS);
+    APInt A(Bits, LHS), B(Bits, RHS);
+    APInt Expected(Bits, std::span<const WordType>(Full).first(
+                             std::min(200u, 2 * Parts)));
+    bool ExpectedOverflow = std::any_of(Full.begin() + std::min(200u, 2 * Parts),
+                                        Full.end(),
+                                        [](WordType W) { return W != 0; });
+
+    EXPECT_EQ(Expected, A * B);
+    bool Overflow;
+    EXPECT_EQ(Expected, A.umul_ov(B, Overflow));
+    EXPECT_EQ(ExpectedOverflow, Overflow);
+  }
+}
+
+
+TEST(APIntTest, Square) {
+  using WordType = APInt::WordType;
+
+  auto operand = [](unsigned Parts, unsigned Kind, WordType Seed) {
+    std::vector<WordType> V(Parts);
+    for (unsigned i = 0; i < Parts; i++) {
+      Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      V[i] = Kind == 0 ? Seed : Kind == 1 ? ~WordType(0) : i < Parts / 2 ? Seed
+                                                                         : 0;
+    }
+    return V;
+  };
+
+  // Squares through the algorithms of each size, including operands whose
+  // high half is zero.
+  for (unsigned Parts : {1u, 2u, 3u, 4u, 5u, 8u, 13u, 19u, 20u, 21u, 40u,
+                         95u, 96u, 97u, 130u, 200u}) {
+    for (unsigned Kind = 0; Kind < 3; Kind++) {
+      std::vector<WordType> Src = operand(Parts, Kind, Parts);
+      std::vector<WordType> Copy = Src;
+      std::vector<WordType> Expected(2 * Parts), Dst(2 * Parts);
+      APInt::tcFullMultiply(Expected.data(), Src.data(), Copy.data(), Parts,
+                            Parts);
+
+      APInt::tcSquare(Dst.data(), Src.data(), Parts, 2 * Parts);
+      EXPECT_EQ(Expected, Dst) << Parts << " words, kind " << Kind;
+      std::fill(Dst.begin(), Dst.end(), 0);
+      APInt::tcFullMultiply(Dst.data(), Src.data(), Src.data(), Parts, Parts);
+      EXPECT_EQ(Expected, Dst) << Parts << " words, kind " << Kind;
+
+      for (unsigned DstParts : {1u, Parts, 2 * Parts - 1}) {
+        std::vector<WordType> Truncated(DstParts, 42);
+        APInt::tcSquare(Truncated.data(), Src.data(), Parts, DstParts);
+        EXPECT_TRUE(std::equal(Truncated.begin(), Truncated.end(),
+                               Expected.begin()))
+            << Parts << " words, kind " << Kind << ", " << DstParts;
+      }
+
+      std::vector<WordType> Product(Parts), Square(Parts);
+      int Overflow =
+          APInt::tcMultiply(Product.data(), Src.data(), Copy.data(), Parts);
+      EXPECT_EQ(APInt::tcMultiply(Square.data(), Src.data(), Src.data(),
+                                  Parts),
+                Overflow);
+      EXPECT_EQ(Product, Square);
+    }
+  }
+
+  for (unsigned BitWidth : {1u, 63u, 64u, 65u, 128u, 200u, 1000u, 9000u}) {
+    APInt X = APInt::getAllOnes(BitWidth).lshr(BitWidth / 3) - 12345;
+    APInt Copy = X;
+    EXPECT_EQ(X.sqr(), X * Copy);
+    EXPECT_EQ(X * X, X * Copy);
+    EXPECT_EQ(X.sqr().getBitWidth(), BitWidth);
+  }
+
+  static_assert(APInt(8, 16).sqr() == 0);
+  static_assert(APInt(300, 3).shl(100).sqr() == APInt(300, 9).shl(200));
+  static_assert(APInt::getAllOnes(300).sqr() == 1);
+  EXPECT_EQ(APInt(1000, 1000000007).sqrt(), APInt(1000, 31623));
+}
+
+
+// APInt values fold at compile time, and wide ones may allocate transiently.
+static_assert((APInt(128, 1) << 100).countTrailingZeros() == 100);
+static_assert(APInt::getAllOnes(256).countPopulation() == 256);
+static_assert((APInt(128, UINT64_MAX) * APInt(128, UINT64_MAX)).lshr(64) ==
+              UINT64_MAX - 1);
+static_assert(APInt(200, 1000).shl(150).udiv(APInt(200, 1000)) ==
+              APInt::getOneBitSet(200, 150));
+static_assert(APInt(96, -7, true).sdiv(APInt(96, 2)).getSExtValue() == -3);
+static_assert(APInt(96, -7, true).srem(APInt(96, 2)).getSExtValue() == -1);
+static_assert(APInt(70, -1, true).sext(130).isAllOnes());
+static_assert(APInt(70, -1, true).zext(130).countLeadingZeros() == 60);
+static_assert(APInt(130, 0x1234).rotl(128).trunc(64) == 0x48d);
+static_assert(APInt::getSignedMinValue(1000).countTrailingZeros() == 999);
+static_assert((APInt::getAllOnes(1000) * APInt::getAllOnes(1000)) == 1);
+static_assert(APInt::getOneBitSet(1000, 900).urem(APInt(1000, 1000007)) ==
+              APInt::getOneBitSet(1000, 900).urem(1000007));
+
+constexpr uint64_t tcMultiplyAndAdd() {
+  APInt::WordType LHS[2] = {UINT64_MAX, 1}, RHS[2] = {3, 0}, Dst[4] = {};
+  APInt::tcFullMultiply(Dst, LHS, RHS, 2, 2);
+  APInt::tcAdd(Dst, LHS, 0, 2);
+  return Dst[1];
+}
+static_assert(tcMultiplyAndAdd() == 7);
+
+// Constinit values must be stored inline, and 30! needs two words.
+#if BIJOU_APINT_INLINE_WORDS >= 2
+constinit const APInt Factorial30 = [] {
+  APInt Result(128, 1);
+  for (unsigned I = 2; I <= 30; ++I)
+    Result *= I;
+  return Result;
+}();
+
+TEST(APIntTest, ConstantEvaluation) {
+  APInt Expected(128, 1);
+  for (unsigned I = 2; I <= 30; ++I)
+    Expected *= I;
+  EXPECT_EQ(Factorial30, Expected);
+  EXPECT_EQ(Factorial30.toStringUnsigned(10), "265252859812191058636308480000000");
+}
+#endif
+
+// Adds, subtracts and multiplies pseudo-random operands of 1 to 24 words.
+// Constant evaluation uses the word loops of APInt.hpp and run time the
+// carry chain kernels, so the two results must agree.
+constexpr std::array<uint64_t, 24> carryChainChecksums() {
+  using WordType = APInt::WordType;
+  std::array<uint64_t, 24> Checksums = {};
+  uint64_t State = 0x243f6a8885a308d3;
+  auto Next = [&State] {
+    State = State * 6364136223846793005 + 1442695040888963407;
+    return State ^ (State >> 29);
+  };
+  for (unsigned Parts = 1; Parts <= 24; ++Parts) {
+    WordType LHS[24] = {}, RHS[24] = {}, Dst[49] = {};
+    for (unsigned I = 0; I < Parts; ++I) {
+      LHS[I] = Next();
+      // Long runs of carries.
+      RHS[I] = I % 5 == 3 ? ~WordType(0) : Next();
+    }
+    uint64_t Sum = 0;
+    auto Mix = [&Sum](uint64_t V) { Sum = (Sum ^ V) * 0x100000001b3; };
+
+    APInt::tcAssign(Dst, LHS, Parts);
+    Mix(APInt::tcAdd(Dst, RHS, Parts % 2, Parts));
+    Mix(APInt::tcSubtract(Dst, LHS, 1, Parts));
+    Mix(APInt::tcSubtract(Dst, RHS, 0, Parts));
+    Mix(APInt::tcMultiplyPart(Dst, LHS, RHS[0], RHS[1], Parts, Parts + 1,
+                              true));
+    Mix(APInt::tcMultiplyPart(Dst, Dst, ~WordType(0), 3, Parts, Parts,
+                              false));
+    Mix(APInt::tcMultiply(Dst + Parts, LHS, RHS, Parts));
+    for (unsigned I = 0; I < 2 * Parts; ++I)
+      Mix(Dst[I]);
+    APInt::tcFullMultiply(Dst, LHS, RHS, Parts, Parts);
+    for (unsigned I = 0; I < 2 * Parts; ++I)
+      Mix(Dst[I]);
+    Checksums[Parts - 1] = Sum;
+  }
+  return Checksums;
+}
+
+TEST(APIntTest, CarryChainKernels) {
+  constexpr std::array<uint64_t, 24> Expected = carryChainChecksums();
+  std::array<uint64_t, 24> Checksums = carryChainChecksums();
+  for (unsigned I = 0; I < 24; ++I)
+    EXPECT_EQ(Checksums[I], Expected[I]) << (I + 1) << " words";
+}
+
+TEST(APIntTest, UnrolledKernels) {
+  // The two to four word kernels must agree with the generic loops, which
+  // run for the same values zero extended to five words.
+  using WordType = APInt::WordType;
+  std::mt19937_64 Rng(16);
+  const WordType Patterns[] = {0, 1, ~WordType(0), WordType(1) << 63};
+  for (unsigned Parts = 2; Parts <= 4; ++Parts) {
+    for (unsigned Iter = 0; Iter < 2000; ++Iter) {
+      WordType L[5] = {}, R[5] = {};
+      for (unsigned I = 0; I < Parts; ++I) {
+        L[I] = Rng() % 3 ? Rng() : Patterns[Rng() % 4];
+        R[I] = Rng() % 3 ? Rng() : Patterns[Rng() % 4];
+      }
+      if (Iter % 7 == 0)
+        std::copy_n(L, Parts, R);
+      const unsigned Count = Rng() % (64 * Parts + 70);
+      const WordType C = Rng() % 2;
+
+      WordType Dst[5], Wide[5];
+      std::copy_n(L, 5, Dst);
+      std::copy_n(L, 5, Wide);
+      WordType Carry = APInt::tcAdd(Dst, R, C, Parts);
+      EXPECT_EQ(APInt::tcAdd(Wide, R, C, 5), 0u);
+      EXPECT_EQ(Carry, Wide[Parts]);
+      EXPECT_TRUE(std::equal(Dst, Dst + Parts, Wide));
+
+      std::copy_n(L, 5, Dst);
+      std::copy_n(L, 5, Wide);
+      WordType Borrow = APInt::tcSubtract(Dst, R, C, Parts);
+      EXPECT_EQ(Borrow, APInt::tcSubtract(Wide, R, C, 5));
+      EXPECT_TRUE(std::equal(Dst, Dst + Parts, Wide));
+
+      std::copy_n(L, 5, Dst);
+      std::copy_n(L, 5, Wide);
+      APInt::tcShiftLeft(Dst, Parts, Count);
+      APInt::tcShiftLeft(Wide, 5, Count);
+      EXPECT_TRUE(std::equal(Dst, Dst + Parts, Wide)) << Parts << " " << Count;
+
+      std::copy_n(L, 5, Dst);
+      std::copy_n(L, 5, Wide);
+      APInt::tcShiftRight(Dst, Parts, Count);
+      APInt::tcShiftRight(Wide, 5, Count);
+      EXPECT_TRUE(std::equal(Dst, Dst + Parts, Wide)) << Parts << " " << Count;
+
+      EXPECT_EQ(APInt::tcCompare(L, R, Parts), APInt::tcCompare(L, R, 5));
+
+      WordType Full[10] = {};
+      APInt::tcMultiply(Wide, L, R, 5);
+      APInt::tcFullMultiply(Full, L, R, Parts, Parts);
+      int Overflow = APInt::tcMultiply(Dst, L, R, Parts);
+      EXPECT_TRUE(std::equal(Dst, Dst + Parts, Wide));
+      EXPECT_EQ(Overflow, APInt::tcMSB(Full + Parts, Parts) != -1U);
+    }
+  }
+
+  static_assert((APInt(192, 1) << 130).lshr(129) == 2);
+  static_assert(APInt(256, -1, true) * APInt(256, -1, true) == 1);
+  static_assert(APInt(128, 5) - APInt(128, 7) == APInt(128, -2, true));
+  static_assert(APInt(192, 3).shl(128).ugt(APInt(192, 1).shl(129)));
+}
+
 } // end anonymous namespace
@@ -31,7 +31,11 @@ TEST(APSIntTest, MoveTest) {
   APSInt C(B);
   EXPECT_FALSE(C.isUnsigned());
 
-  APInt Wide(256, 0);
+  // Use a width that does not fit in the inline buffer, so that the value
+  // lives on the heap and moving it hands over the allocation.
+  const unsigned HeapBits =
+      (APInt::APINT_INLINE_WORDS + 1) * APInt::APINT_BITS_PER_WORD;
+  APInt Wide(HeapBits, 0);
   const uint64_t *Bits = Wide.getRawData();
   APSInt D(std::move(Wide));
   EXPECT_TRUE(D.isUnsigned());
@@ -40,7 +44,7 @@ TEST(APSIntTest, MoveTest) {
   A = APSInt(64, true);
   EXPECT_TRUE(A.isUnsigned());
 
-  Wide = APInt(128, 1);
+  Wide = APInt(HeapBits, 1);
   Bits = Wide.getRawData();
   A = std::move(Wide);
   EXPECT_TRUE(A.isUnsigned());
@@ -180,6 +184,25 @@ TEST(APSIntTest, FromStringBitWidth) {
   EXPECT_EQ(APSInt("-17").getBitWidth(), 6U);
 }
 
+TEST(APSIntTest, Chars) {
+  char Buf[8];
+  APSInt S(APInt(8, -100), false), U(APInt(8, 200), true);
+  EXPECT_EQ("-100", std::string(Buf, S.toChars(Buf, Buf + 8).ptr));
+  EXPECT_EQ("200", std::string(Buf, U.toChars(Buf, Buf + 8).ptr));
+  EXPECT_EQ("C8", std::string(Buf, U.toChars(Buf, Buf + 8, 16).ptr));
+
+  std::string_view Str = "-128";
+  EXPECT_EQ(std::errc(), S.fromChars(Str.data(), Str.data() + 4).ec);
+  EXPECT_EQ(-128, S.getExtValue());
+  EXPECT_EQ(std::errc::invalid_argument,
+            U.fromChars(Str.data(), Str.data() + 4).ec);
+  Str = "255";
+  EXPECT_EQ(std::errc::result_out_of_range,
+            S.fromChars(Str.data(), Str.data() + 3).ec);
+  EXPECT_EQ(std::errc(), U.fromChars(Str.data(), Str.data() + 3).ec);
+  EXPECT_EQ(255, U.getExtValue());
+}
+
 #if defined(GTEST_HAS_DEATH_TEST) && !defined(NDEBUG)
 
 TEST(APSIntTest, StringDeath) {
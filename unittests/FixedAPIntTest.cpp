@@ -0,0 +1,140 @@
+// FixedAPIntTest.cpp - FixedAPInt unit tests
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "bijou/FixedAPInt.hpp"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+using namespace bijou;
+
+namespace {
+
+// The operations fold at compile time.
+static_assert((FixedAPInt<128>(1) << 100).countTrailingZeros() == 100);
+static_assert(FixedAPInt<256>::getAllOnes().countPopulation() == 256);
+static_assert((FixedAPInt<128>(UINT64_MAX) * FixedAPInt<128>(UINT64_MAX))
+                  .lshr(64) == FixedAPInt<128>(UINT64_MAX - 1));
+static_assert(FixedAPInt<200>(1000).shl(150).udiv(FixedAPInt<200>(1000)) ==
+              FixedAPInt<200>(1).shl(150));
+static_assert(FixedAPInt<96>(-7, true).sdiv(FixedAPInt<96>(2)) ==
+              FixedAPInt<96>(-3, true));
+static_assert(FixedAPInt<96>(-7, true).srem(FixedAPInt<96>(2)) ==
+              FixedAPInt<96>(-1, true));
+static_assert(FixedAPInt<70>(-1, true).sext<130>().isAllOnes());
+static_assert(FixedAPInt<70>(-1, true).zext<130>().countLeadingZeros() == 60);
+
+APInt randomAPInt(std::mt19937_64 &Rng, unsigned BitWidth) {
+  std::vector<uint64_t> Words(APInt::getNumWords(BitWidth));
+  for (uint64_t &Word : Words)
+    Word = Rng();
+  APInt Result(BitWidth, Words);
+  // Vary the number of active bits.
+  return Result.lshr(Rng() % BitWidth);
+}
+
+template <unsigned Bits> void testAgainstAPInt(std::mt19937_64 &Rng) {
+  using F = FixedAPInt<Bits>;
+  for (unsigned I = 0; I < 200; ++I) {
+    APInt A = randomAPInt(Rng, Bits), B = randomAPInt(Rng, Bits);
+    if (I % 4 == 0)
+      A.negate();
+    if (I % 5 == 0)
+      B.negate();
+    F FA(A), FB(B);
+    unsigned Shift = Rng() % (Bits + 1);
+
+    EXPECT_EQ(FA.toAPInt(), A);
+    EXPECT_EQ((FA + FB).toAPInt(), A + B);
+    EXPECT_EQ((FA - FB).toAPInt(), A - B);
+    EXPECT_EQ((FA * FB).toAPInt(), A * B);
+    EXPECT_EQ((FA & FB).toAPInt(), A & B);
+    EXPECT_EQ((FA | FB).toAPInt(), A | B);
+    EXPECT_EQ((FA ^ FB).toAPInt(), A ^ B);
+    EXPECT_EQ((~FA).toAPInt(), ~A);
+    EXPECT_EQ((-FA).toAPInt(), -A);
+    EXPECT_EQ(FA.shl(Shift).toAPInt(), A.shl(Shift));
+    EXPECT_EQ(FA.lshr(Shift).toAPInt(), A.lshr(Shift));
+    EXPECT_EQ(FA.ashr(Shift).toAPInt(), A.ashr(Shift));
+    EXPECT_EQ(FA.rotl(Shift).toAPInt(), A.rotl(Shift));
+    EXPECT_EQ(FA.rotr(Shift).toAPInt(), A.rotr(Shift));
+
+    EXPECT_EQ(FA.ult(FB), A.ult(B));
+    EXPECT_EQ(FA.ule(FB), A.ule(B));
+    EXPECT_EQ(FA.slt(FB), A.slt(B));
+    EXPECT_EQ(FA.sge(FB), A.sge(B));
+    EXPECT_EQ(FA == FB, A == B);
+
+    EXPECT_EQ(FA.countLeadingZeros(), A.countLeadingZeros());
+    EXPECT_EQ(FA.countLeadingOnes(), A.countLeadingOnes());
+    EXPECT_EQ(FA.countTrailingZeros(), A.countTrailingZeros());
+    EXPECT_EQ(FA.countTrailingOnes(), A.countTrailingOnes());
+    EXPECT_EQ(FA.countPopulation(), A.countPopulation());
+    EXPECT_EQ(FA.getActiveBits(), A.getActiveBits());
+    EXPECT_EQ(FA.getMinSignedBits(), A.getMinSignedBits());
+
+    if (!B.isZero()) {
+      EXPECT_EQ(FA.udiv(FB).toAPInt(), A.udiv(B));
+      EXPECT_EQ(FA.urem(FB).toAPInt(), A.urem(B));
+      EXPECT_EQ(FA.sdiv(FB).toAPInt(), A.sdiv(B));
+      EXPECT_EQ(FA.srem(FB).toAPInt(), A.srem(B));
+    }
+
+    EXPECT_EQ(FA.template zext<Bits + 65>().toAPInt(), A.zext(Bits + 65));
+    EXPECT_EQ(FA.template sext<Bits + 65>().toAPInt(), A.sext(Bits + 65));
+    if constexpr (Bits > 1) {
+      EXPECT_EQ(FA.template trunc<Bits / 2 + 1>().toAPInt(),
+                A.trunc(Bits / 2 + 1));
+    }
+  }
+}
+
+TEST(FixedAPIntTest, MatchesAPInt) {
+  std::mt19937_64 Rng(10);
+  testAgainstAPInt<1>(Rng);
+  testAgainstAPInt<7>(Rng);
+  testAgainstAPInt<64>(Rng);
+  testAgainstAPInt<65>(Rng);
+  testAgainstAPInt<128>(Rng);
+  testAgainstAPInt<200>(Rng);
+  testAgainstAPInt<256>(Rng);
+  testAgainstAPInt<512>(Rng);
+}
+
+TEST(FixedAPIntTest, Values) {
+  using F = FixedAPInt<130>;
+  EXPECT_EQ(F::getSignedMaxValue().toAPInt(), APInt::getSignedMaxValue(130));
+  EXPECT_EQ(F::getSignedMinValue().toAPInt(), APInt::getSignedMinValue(130));
+  EXPECT_EQ(F::getLowBitsSet(70).toAPInt(), APInt::getLowBitsSet(130, 70));
+  EXPECT_EQ(F::getHighBitsSet(70).toAPInt(), APInt::getHighBitsSet(130, 70));
+  EXPECT_EQ(F(-5, true).getSExtValue(), -5);
+  EXPECT_EQ(F(12345).getZExtValue(), 12345u);
+  EXPECT_EQ(FixedAPInt<7>(-5, true).getSExtValue(), -5);
+  EXPECT_EQ(F(1000).logBase2(), 9u);
+  EXPECT_TRUE(F::getOneBitSet(129).isPowerOf2());
+  EXPECT_EQ(F(-42, true).toStringSigned(), "-42");
+  EXPECT_EQ(F(255).toStringUnsigned(16), "FF");
+
+  F X(7);
+  EXPECT_EQ(X++, 7u);
+  EXPECT_EQ(--X, 7u);
+  X *= F(6);
+  X <<= 65;
+  EXPECT_EQ(X.lshr(65), 42u);
+}
+
+TEST(FixedAPIntTest, DivRemAliasing) {
+  FixedAPInt<192> X = FixedAPInt<192>(1).shl(150) + FixedAPInt<192>(3);
+  FixedAPInt<192> Y(1000), R;
+  FixedAPInt<192> Expected = X.udiv(Y);
+  FixedAPInt<192>::udivrem(X, Y, X, R);
+  EXPECT_EQ(X, Expected);
+  EXPECT_EQ(R, (FixedAPInt<192>(1).shl(150) + FixedAPInt<192>(3)).urem(Y));
+}
+
+} // end anonymous namespace
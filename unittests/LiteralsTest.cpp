@@ -0,0 +1,114 @@
+// LiteralsTest.cpp - APInt, APSInt and APFloat literal unit tests
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "bijou/Literals.hpp"
+#include "gtest/gtest.h"
+
+using namespace bijou;
+using namespace bijou::literals;
+
+namespace {
+
+using detail::LiteralError;
+
+// Malformed literals are compile errors, so test the parsers directly.
+static_assert(detail::parseIntegerLiteral<64>("1.5").Error ==
+              LiteralError::NotAnInteger);
+static_assert(detail::parseIntegerLiteral<64>("1e5").Error ==
+              LiteralError::NotAnInteger);
+static_assert(detail::parseIntegerLiteral<64>("0x1e5").Error ==
+              LiteralError::None);
+static_assert(detail::parseIntegerLiteral<64>("0b102").Error ==
+              LiteralError::InvalidDigit);
+static_assert(detail::parseIntegerLiteral<64>("018").Error ==
+              LiteralError::InvalidDigit);
+static_assert(detail::parseIntegerLiteral<64>("0x1'0000'0000'0000'0000")
+                  .Error == LiteralError::TooWide);
+static_assert(detail::parseIntegerLiteral<65>("0x1'0000'0000'0000'0000")
+                  .Words[1] == 1);
+static_assert(detail::getIntegerLiteralWidth("0") == 1);
+static_assert(detail::getIntegerLiteralWidth("255") == 8);
+static_assert(detail::parseIEEELiteral<113, 16383, 128>("1e4933").Error ==
+              LiteralError::Overflow);
+static_assert(detail::parseIEEELiteral<113, 16383, 128>("1e-4966").Error ==
+              LiteralError::Underflow);
+static_assert(detail::parseIEEELiteral<113, 16383, 128>("0x1.8").Error ==
+              LiteralError::InvalidDigit);
+static_assert(detail::parseIEEELiteral<113, 16383, 128>("1e+").Error ==
+              LiteralError::InvalidDigit);
+// The format parameters are those of IEEEdouble here.
+static_assert(detail::parseIEEELiteral<53, 1023, 64>("0.1").Words[0] ==
+              0x3fb999999999999a);
+static_assert(detail::parseIEEELiteral<53, 1023, 64>("4.9406564584124654e-324")
+                  .Words[0] == 1);
+static_assert(detail::parseIEEELiteral<53, 1023, 64>("1.7976931348623157e308")
+                  .Words[0] == 0x7fefffffffffffff);
+
+TEST(LiteralsTest, APInt) {
+  EXPECT_EQ(0_apint, APInt(1, 0));
+  EXPECT_EQ(255_apint, APInt(8, 255));
+  EXPECT_EQ(0xffff'ffff'ffff'ffff'ffff_apint, APInt::getAllOnes(80));
+  EXPECT_EQ(0b1010_apint, APInt(4, 10));
+  EXPECT_EQ(0777_apint, APInt(9, 511));
+  EXPECT_EQ(42_apint64, APInt(64, 42));
+  EXPECT_EQ(1'000'000'000'000'000'000'000_apint128,
+            APInt(128, "1000000000000000000000", 10));
+  EXPECT_EQ(
+      0xffffffff'ffffffff'ffffffff'ffffffff'ffffffff'ffffffff'ffffffff'fffffed1_apint256,
+      APInt::getAllOnes(256) - 302);
+  EXPECT_EQ(
+      115792089237316195423570985008687907853269984665640564039457584007913129639936_apint512,
+      APInt::getOneBitSet(512, 256));
+}
+
+TEST(LiteralsTest, APSInt) {
+  APSInt I = 12345678901234567890123_apsint;
+  EXPECT_TRUE(I.isUnsigned());
+  EXPECT_EQ(I, APSInt("12345678901234567890123"));
+  EXPECT_EQ(I.getBitWidth(), APSInt("12345678901234567890123").getBitWidth());
+  EXPECT_EQ((0_apsint).getBitWidth(), 1u);
+}
+
+TEST(LiteralsTest, Quad) {
+  auto ExpectParsed = [](const APFloat &Literal, const char *Str) {
+    APFloat Expected(APFloat::IEEEquad(), Str);
+    EXPECT_TRUE(Literal.bitwiseIsEqual(Expected)) << Str;
+  };
+  ExpectParsed(0.0_quad, "0");
+  ExpectParsed(1.1_quad, "1.1");
+  ExpectParsed(-1.1_quad, "-1.1");
+  ExpectParsed(.5_quad, "0.5");
+  ExpectParsed(1e10_quad, "1e10");
+  ExpectParsed(1'000'000.25_quad, "1000000.25");
+  ExpectParsed(3.14159265358979323846264338327950288419716939937510_quad,
+               "3.14159265358979323846264338327950288419716939937510");
+  ExpectParsed(123456789012345678901234567890e-20_quad,
+               "123456789012345678901234567890e-20");
+  // Halfway between 1 and the next quad, and just above.
+  ExpectParsed(
+      1.00000000000000000000000000000000009629649721936179265279889712924636592690508241076940976199740427352_quad,
+      "1.00000000000000000000000000000000009629649721936179265279889712924636592690508241076940976199740427352");
+  ExpectParsed(
+      1.000000000000000000000000000000000096296497219361792652798897129246365926905082410769409761997404273520000001_quad,
+      "1.000000000000000000000000000000000096296497219361792652798897129246365926905082410769409761997404273520000001");
+  ExpectParsed(1.18973149535723176508575932662800702e4932_quad,
+               "1.18973149535723176508575932662800702e4932");
+  ExpectParsed(3.3621031431120935062626778173217526e-4932_quad,
+               "3.3621031431120935062626778173217526e-4932");
+  ExpectParsed(6.4751751194380251109244389582276465524996e-4966_quad,
+               "6.4751751194380251109244389582276465524996e-4966");
+
+  EXPECT_TRUE((0x1.8p3_quad).bitwiseIsEqual(APFloat(APFloat::IEEEquad(), 12)));
+  EXPECT_TRUE((0x1F_quad).bitwiseIsEqual(APFloat(APFloat::IEEEquad(), 31)));
+  EXPECT_TRUE((017_quad).bitwiseIsEqual(APFloat(APFloat::IEEEquad(), 15)));
+  EXPECT_TRUE((0x1p-16494_quad).bitwiseIsEqual(
+      APFloat::getSmallest(APFloat::IEEEquad())));
+  EXPECT_TRUE((0x1.ffffffffffffffffffffffffffffp16383_quad)
+                  .bitwiseIsEqual(APFloat::getLargest(APFloat::IEEEquad())));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,116 @@
+// MontgomeryContextTest.cpp - MontgomeryContext unit tests
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "bijou/MontgomeryContext.hpp"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+using namespace bijou;
+
+namespace {
+
+APInt randomAPInt(std::mt19937_64 &Rng, unsigned BitWidth) {
+  std::vector<uint64_t> Words(APInt::getNumWords(BitWidth));
+  for (uint64_t &Word : Words)
+    Word = Rng();
+  return APInt(BitWidth, Words);
+}
+
+/// @returns A * B mod N, computed by division.
+APInt referenceMulMod(const APInt &A, const APInt &B, const APInt &N) {
+  unsigned Wide = 2 * N.getBitWidth();
+  return (A.zext(Wide) * B.zext(Wide)).urem(N.zext(Wide))
+      .trunc(N.getBitWidth());
+}
+
+TEST(MontgomeryContextTest, MulMod) {
+  std::mt19937_64 Rng(1);
+  for (unsigned BitWidth : {7u, 64u, 100u, 256u, 1000u, 4096u, 4200u}) {
+    APInt N = randomAPInt(Rng, BitWidth);
+    N.setBit(0);
+    N.setBit(BitWidth - 1);
+    MontgomeryContext Ctx(N);
+    EXPECT_EQ(Ctx.getBitWidth(), BitWidth);
+
+    for (unsigned I = 0; I < 8; ++I) {
+      APInt A = randomAPInt(Rng, BitWidth).urem(N);
+      APInt B = randomAPInt(Rng, BitWidth).urem(N);
+      APInt AM = Ctx.toMontgomery(A);
+      APInt BM = Ctx.toMontgomery(B);
+      EXPECT_EQ(Ctx.fromMontgomery(AM), A);
+
+      APInt Expected = referenceMulMod(A, B, N);
+      EXPECT_EQ(Ctx.fromMontgomery(Ctx.mulmod(AM, BM)), Expected);
+      EXPECT_EQ(Ctx.fromMontgomery(Ctx.sqrmod(AM)),
+                referenceMulMod(A, A, N));
+
+      // The result may alias the operands.
+      Ctx.mulmod(AM, AM, BM);
+      Ctx.fromMontgomery(AM, AM);
+      EXPECT_EQ(AM, Expected);
+      Ctx.sqrmod(BM, BM);
+      EXPECT_EQ(Ctx.fromMontgomery(BM), referenceMulMod(B, B, N));
+    }
+  }
+}
+
+TEST(MontgomeryContextTest, MulModEdgeCases) {
+  // The largest odd modulus of its width, with operands next to it.
+  APInt N = APInt::getAllOnes(256);
+  MontgomeryContext Ctx(N);
+  APInt A = N - 1;
+  APInt B = N - 2;
+  EXPECT_EQ(Ctx.fromMontgomery(Ctx.mulmod(Ctx.toMontgomery(A),
+                                          Ctx.toMontgomery(B))),
+            referenceMulMod(A, B, N));
+  EXPECT_EQ(Ctx.toMontgomery(APInt(256, 0)), APInt(256, 0));
+
+  MontgomeryContext OneCtx(APInt(64, 1));
+  EXPECT_EQ(OneCtx.powmod(APInt(64, 0), APInt(64, 5)), APInt(64, 0));
+}
+
+TEST(MontgomeryContextTest, PowMod) {
+  std::mt19937_64 Rng(2);
+  for (unsigned BitWidth : {64u, 256u, 521u, 2048u}) {
+    APInt N = randomAPInt(Rng, BitWidth);
+    N.setBit(0);
+    MontgomeryContext Ctx(N);
+
+    // Exponents of a size that picks each window width.
+    for (unsigned ExpBits : {1u, 2u, 20u, 64u, 200u, 300u, 700u}) {
+      APInt Base = randomAPInt(Rng, BitWidth).urem(N);
+      APInt Exp = randomAPInt(Rng, ExpBits);
+
+      APInt Expected(BitWidth, 1);
+      Expected = Expected.urem(N);
+      for (unsigned I = ExpBits; I-- > 0;) {
+        Expected = referenceMulMod(Expected, Expected, N);
+        if (Exp[I])
+          Expected = referenceMulMod(Expected, Base, N);
+      }
+      EXPECT_EQ(Ctx.powmod(Base, Exp), Expected);
+    }
+
+    APInt Base = randomAPInt(Rng, BitWidth).urem(N);
+    EXPECT_EQ(Ctx.powmod(Base, APInt(32, 0)), APInt(BitWidth, 1));
+    EXPECT_EQ(Ctx.powmod(Base, APInt(32, 1)), Base);
+  }
+}
+
+TEST(MontgomeryContextTest, Fermat) {
+  // 2^521 - 1 is prime, so a^(p-1) = 1 mod p.
+  APInt P = APInt::getAllOnes(521);
+  MontgomeryContext Ctx(P);
+  for (uint64_t A : {2u, 3u, 12345u}) {
+    EXPECT_EQ(Ctx.powmod(APInt(521, A), P - 1), APInt(521, 1));
+    EXPECT_EQ(Ctx.powmod(APInt(521, A), P), APInt(521, A));
+  }
+}
+
+} // end anonymous namespace
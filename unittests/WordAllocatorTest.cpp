@@ -0,0 +1,210 @@
+// WordAllocatorTest.cpp - allocateWords and word pool unit tests
+//
+// Part of the bijou Project, under the Apache License v2.0 with LLVM Exceptions.
+//
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "bijou/WordAllocator.hpp"
+#include "bijou/APFloat.hpp"
+#include "bijou/APInt.hpp"
+#include "gtest/gtest.h"
+
+#include <string_view>
+#include <thread>
+
+using namespace bijou;
+
+namespace {
+
+TEST(WordAllocatorTest, AllocateAndFree) {
+  for (unsigned NumWords : {1u, 2u, 3u, 17u, 1024u, 1025u, 5000u}) {
+    uint64_t *Words = allocateWords(NumWords);
+    for (unsigned I = 0; I < NumWords; ++I)
+      Words[I] = I;
+    EXPECT_EQ(Words[NumWords - 1], NumWords - 1);
+    deallocateWords(Words, NumWords);
+  }
+}
+
+TEST(WordAllocatorTest, Statistics) {
+  trimWordPool();
+  resetWordPoolStatistics();
+
+  deallocateWords(allocateWords(20), 20);
+  deallocateWords(allocateWords(30), 30);
+  deallocateWords(allocateWords(5000), 5000);
+  WordPoolStatistics Stats = getWordPoolStatistics();
+
+#if BIJOU_ENABLE_WORD_POOL
+  // 20 and 30 words share the 32 word size class.
+  EXPECT_EQ(Stats.Hits, 1u);
+  EXPECT_EQ(Stats.Misses, 2u);
+#else
+  EXPECT_EQ(Stats.Hits, 0u);
+  EXPECT_EQ(Stats.Misses, 0u);
+#endif
+
+  resetWordPoolStatistics();
+  Stats = getWordPoolStatistics();
+  EXPECT_EQ(Stats.Hits, 0u);
+  EXPECT_EQ(Stats.Misses, 0u);
+  trimWordPool();
+}
+
+TEST(WordAllocatorTest, APIntAndAPFloat) {
+  resetWordPoolStatistics();
+  for (unsigned I = 0; I < 100; ++I) {
+    APInt X = APInt::getAllOnes(1000) * APInt(1000, I);
+    EXPECT_EQ(X.countTrailingZeros(), I ? APInt(32, I).countTrailingZeros()
+                                        : 1000u);
+    APFloat F(APFloat::IEEEquad(), I);
+    F.multiply(F, APFloat::rmNearestTiesToEven);
+    EXPECT_EQ(F.compare(APFloat(APFloat::IEEEquad(), I * I)),
+              APFloat::cmpEqual);
+  }
+#if BIJOU_ENABLE_WORD_POOL
+  EXPECT_GT(getWordPoolStatistics().Hits, 0u);
+#endif
+}
+
+TEST(WordAllocatorTest, CrossThreadFree) {
+  // Buffers may be freed by a different thread than allocated them.
+  APInt X = APInt::getAllOnes(4096);
+  std::thread([&] {
+    APInt Y = X;
+    X = APInt(64, 1);
+    Y.flipAllBits();
+    EXPECT_TRUE(Y.isZero());
+  }).join();
+  EXPECT_EQ(X, 1u);
+}
+
+/// Allocates a buffer of three words when its thread exits, after the word
+/// pool of the thread, which it is constructed before, is destroyed.
+struct LateAllocation {
+  static inline uint64_t *Words = nullptr;
+  ~LateAllocation() { Words = allocateWords(3); }
+};
+
+thread_local LateAllocation Late;
+
+TEST(WordAllocatorTest, CrossThreadFreeAfterPoolDestroyed) {
+  std::thread([] {
+    // Constructs Late, then the word pool.
+    (void)&Late;
+    deallocateWords(allocateWords(1), 1);
+  }).join();
+  ASSERT_TRUE(LateAllocation::Words);
+  // The buffer joins the free list of four word buffers of this thread, so
+  // it must hold four words.
+  trimWordPool();
+  resetWordPoolStatistics();
+  deallocateWords(LateAllocation::Words, 3);
+  uint64_t *Words = allocateWords(4);
+  for (unsigned I = 0; I < 4; ++I)
+    Words[I] = I;
+  EXPECT_EQ(Words[3], 3u);
+#if BIJOU_ENABLE_WORD_POOL
+  EXPECT_EQ(Words, LateAllocation::Words);
+  EXPECT_EQ(getWordPoolStatistics().Hits, 1u);
+#endif
+  deallocateWords(Words, 4);
+}
+
+TEST(WordAllocatorTest, ArenaScope) {
+  APInt Outside = APInt::getAllOnes(1000);
+  APInt Detached;
+  APFloat DetachedFloat(APFloat::IEEEquad());
+  {
+    WordArenaScope Scope;
+    APInt Sum(1000, 0);
+    for (unsigned I = 0; I < 1000; ++I)
+      Sum += APInt(1000, I) * APInt(1000, I);
+    EXPECT_TRUE(Scope.owns(Sum.getRawData()));
+    EXPECT_FALSE(Scope.owns(Outside.getRawData()));
+    EXPECT_GT(Scope.getNumBytesReserved(), 0u);
+
+    // Values from before the scope may be freed inside it.
+    Outside = Sum.zext(2000);
+    EXPECT_TRUE(Scope.owns(Outside.getRawData()));
+
+    Detached = WordArenaScope::detach(Sum);
+    EXPECT_FALSE(Scope.owns(Detached.getRawData()));
+
+    APFloat F(APFloat::IEEEquad(), 3);
+    F.multiply(F, APFloat::rmNearestTiesToEven);
+    DetachedFloat = WordArenaScope::detach(F);
+
+    // Arena values must not outlive the scope.
+    Outside = APInt(64, 0);
+  }
+  EXPECT_EQ(Detached, APInt(1000, 332833500));
+  EXPECT_EQ(DetachedFloat.compare(APFloat(APFloat::IEEEquad(), 9)),
+            APFloat::cmpEqual);
+}
+
+TEST(WordAllocatorTest, BuiltinFloatArithmeticDoesNotAllocate) {
+  for (const fltSemantics *Sem :
+       {&APFloat::IEEEquad(), &APFloat::x87DoubleExtended()}) {
+    // Parsing decimal strings uses wider significands.
+    APFloat X(*Sem, 3), Y(*Sem, "0.1"), Z(*Sem, "-1e-30");
+    WordArenaScope Scope;
+    APFloat R = X;
+    R.add(Y, APFloat::rmNearestTiesToEven);
+    R.subtract(Z, APFloat::rmTowardZero);
+    R.multiply(Y, APFloat::rmNearestTiesToEven);
+    R.divide(X, APFloat::rmTowardPositive);
+    R.fusedMultiplyAdd(Y, Z, APFloat::rmNearestTiesToEven);
+    R.fusedMultiplyAdd(X, neg(R), APFloat::rmTowardNegative);
+    APFloat S = R;
+    bool LosesInfo;
+    S.convert(APFloat::IEEEdouble(), APFloat::rmNearestTiesToEven, &LosesInfo);
+    S.convert(*Sem, APFloat::rmNearestTiesToEven, &LosesInfo);
+    EXPECT_TRUE(R.isFiniteNonZero());
+    EXPECT_TRUE(S.isFiniteNonZero());
+    EXPECT_EQ(Scope.getNumBytesReserved(), 0u);
+  }
+}
+
+TEST(WordAllocatorTest, BuiltinFloatCharsDoNotAllocate) {
+  for (const fltSemantics *Sem :
+       {&APFloat::IEEEhalf(), &APFloat::IEEEsingle(), &APFloat::IEEEdouble(),
+        &APFloat::x87DoubleExtended(), &APFloat::IEEEquad()}) {
+    // Near halfway cases need more than the first working precision, and
+    // large exponents wide powers of five.
+    for (std::string_view Str :
+         {"1.5", "0.1", "-1e-30", "123456789012345678901234567890123456",
+          "1.0000000000000000000000000000000000000001", "4.9e-324",
+          "1.18973149535723176502e+4932", "-1.234567e-4900", "1e4000"}) {
+      APFloat X(*Sem);
+      char Buffer[64];
+      WordArenaScope Scope;
+      X.fromChars(Str.data(), Str.data() + Str.size());
+      EXPECT_EQ(X.toChars(std::begin(Buffer), std::end(Buffer)).ec,
+                std::errc());
+      EXPECT_EQ(Scope.getNumBytesReserved(), 0u) << Str;
+    }
+  }
+}
+
+TEST(WordAllocatorTest, NestedArenaScopes) {
+  WordArenaScope Outer;
+  APInt X = APInt::getAllOnes(500);
+  EXPECT_TRUE(Outer.owns(X.getRawData()));
+  {
+    WordArenaScope Inner;
+    APInt Y = X + 1;
+    EXPECT_TRUE(Inner.owns(Y.getRawData()));
+    EXPECT_FALSE(Outer.owns(Y.getRawData()));
+    // Freeing a buffer of the outer arena from the inner scope.
+    X = APInt(64, 5);
+    // A buffer larger than a slab.
+    APInt Huge = APInt::getAllOnes(1 << 20);
+    EXPECT_TRUE(Inner.owns(Huge.getRawData()));
+    EXPECT_TRUE(Huge.isAllOnes());
+  }
+  EXPECT_EQ(X, 5u);
+}
+
+} // end anonymous namespace